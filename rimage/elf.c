@@ -16,63 +16,50 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "rimage.h"
 #include "cse.h"
 #include "manifest.h"
 
+/* get pointer to ELF file data, NULL if the range is outside the file */
+void *elf_get_data(struct module *module, uint32_t offset, uint32_t size)
+{
+	if (offset > module->file_size || size > module->file_size - offset)
+		return NULL;
+
+	return (char *)module->elf + offset;
+}
+
 static int elf_read_sections(struct image *image, struct module *module)
 {
 	Elf32_Ehdr *hdr = &module->hdr;
-	Elf32_Shdr *section = module->section;
-	size_t count;
-	int i, ret;
+	Elf32_Shdr *section;
+	int i;
 	uint32_t valid = (SHF_WRITE | SHF_ALLOC | SHF_EXECINSTR);
 	int man_section_idx;
 
-	/* read in section header */
-	ret = fseek(module->fd, hdr->shoff, SEEK_SET);
-	if (ret < 0) {
-		fprintf(stderr, "error: can't seek to %s section header %d\n",
-			module->elf_file, ret);
-		return ret;
+	/* section headers are used in place from the mapped file */
+	section = elf_get_data(module, hdr->shoff,
+			       hdr->shnum * sizeof(Elf32_Shdr));
+	if (!section || hdr->shstrndx >= hdr->shnum) {
+		fprintf(stderr, "error: invalid %s section header\n",
+			module->elf_file);
+		return -EINVAL;
 	}
-
-	/* allocate space for each section header */
-	section = calloc(sizeof(Elf32_Shdr), hdr->shnum);
-	if (!section)
-		return -ENOMEM;
 	module->section = section;
 
-	/* read in sections */
-	count = fread(section, sizeof(Elf32_Shdr), hdr->shnum, module->fd);
-	if (count != hdr->shnum) {
-		fprintf(stderr, "error: failed to read %s section header %d\n",
-			module->elf_file, -errno);
-		return -errno;
-	}
-
-	/* read in strings */
-	module->strings = calloc(1, section[hdr->shstrndx].size);
+	/* section name strings */
+	module->strings = elf_get_data(module, section[hdr->shstrndx].off,
+				       section[hdr->shstrndx].size);
 	if (!module->strings) {
-		fprintf(stderr, "error: failed %s to read ELF strings for %d\n",
-			module->elf_file, -errno);
-			return -errno;
-	}
-
-	ret = fseek(module->fd, section[hdr->shstrndx].off, SEEK_SET);
-	if (ret < 0) {
-		fprintf(stderr, "error: can't seek to %s stringss %d\n",
-			module->elf_file, ret);
-		return ret;
-	}
-
-	count = fread(module->strings, 1, section[hdr->shstrndx].size,
-		      module->fd);
-	if (count != section[hdr->shstrndx].size) {
-		fprintf(stderr, "error: failed to read %s strings %d\n",
-			module->elf_file, -errno);
-		return -errno;
+		fprintf(stderr, "error: invalid %s ELF strings\n",
+			module->elf_file);
+		return -EINVAL;
 	}
+	module->strings_size = section[hdr->shstrndx].size;
 
 	/* find manifest module data */
 	man_section_idx = elf_find_section(image, module, ".bss");
@@ -149,32 +136,18 @@ static int elf_read_sections(struct image *image, struct module *module)
 static int elf_read_programs(struct image *image, struct module *module)
 {
 	Elf32_Ehdr *hdr = &module->hdr;
-	Elf32_Phdr *prg = module->prg;
-	size_t count;
-	int i, ret;
+	Elf32_Phdr *prg;
+	int i;
 
-	/* read in program header */
-	ret = fseek(module->fd, hdr->phoff, SEEK_SET);
-	if (ret < 0) {
-		fprintf(stderr, "error: cant seek to %s program header %d\n",
-			module->elf_file, ret);
-		return ret;
+	/* program headers are used in place from the mapped file */
+	prg = elf_get_data(module, hdr->phoff, hdr->phnum * sizeof(Elf32_Phdr));
+	if (!prg) {
+		fprintf(stderr, "error: invalid %s program header\n",
+			module->elf_file);
+		return -EINVAL;
 	}
-
-	/* allocate space for programs */
-	prg = calloc(sizeof(Elf32_Phdr), hdr->phnum);
-	if (!prg)
-		return -ENOMEM;
 	module->prg = prg;
 
-	/* read in programs */
-	count = fread(prg, sizeof(Elf32_Phdr), hdr->phnum, module->fd);
-	if (count != hdr->phnum) {
-		fprintf(stderr, "error: failed to read %s program header %d\n",
-			module->elf_file, -errno);
-		return -errno;
-	}
-
 	/* check each program */
 	for (i = 0; i < hdr->phnum; i++) {
 		if (prg[i].filesz == 0)
@@ -205,15 +178,9 @@ static int elf_read_programs(struct image *image, struct module *module)
 static int elf_read_hdr(struct image *image, struct module *module)
 {
 	Elf32_Ehdr *hdr = &module->hdr;
-	size_t count;
 
-	/* read in elf header */
-	count = fread(hdr, sizeof(*hdr), 1, module->fd);
-	if (count != 1) {
-		fprintf(stderr, "error: failed to read %s elf header %d\n",
-			module->elf_file, -errno);
-		return -errno;
-	}
+	/* file size has already been checked against the header size */
+	memcpy(hdr, module->elf, sizeof(*hdr));
 
 	if (!image->verbose)
 		return 0;
@@ -485,56 +452,32 @@ int elf_find_section(struct image *image, struct module *module,
 		     const char *name)
 {
 	Elf32_Ehdr *hdr = &module->hdr;
-	Elf32_Shdr *section, *s;
-	char *buffer;
-	size_t count;
-	int ret, i;
-
-	section = &module->section[hdr->shstrndx];
-
-	/* alloc data data */
-	buffer = calloc(1, section->size);
-	if (!buffer)
-		return -ENOMEM;
-
-	/* read in section string data */
-	ret = fseek(module->fd, section->off, SEEK_SET);
-	if (ret < 0) {
-		fprintf(stderr, "error: cant seek to string section %d\n", ret);
-		goto out;
-	}
-
-	count = fread(buffer, 1, section->size, module->fd);
-	if (count != section->size) {
-		fprintf(stderr, "error: can't read string section %d\n",
-			-errno);
-		ret = -errno;
-		goto out;
-	}
+	Elf32_Shdr *s;
+	size_t len = strlen(name);
+	int i;
 
-	/* find section with name */
+	/* find section with name, names must be terminated within strings */
 	for (i = 0; i < hdr->shnum; i++) {
 		s = &module->section[i];
-		if (!strcmp(name, buffer + s->name)) {
-			ret = i;
-			goto out;
-		}
+		if (s->name >= module->strings_size ||
+		    len >= module->strings_size - s->name)
+			continue;
+
+		if (!memcmp(name, module->strings + s->name, len + 1))
+			return i;
 	}
 
 	fprintf(stderr, "error: can't find section %s in module %s\n", name,
 		module->elf_file);
-	ret = -EINVAL;
-
-out:
-	free(buffer);
-	return ret;
+	return -EINVAL;
 }
 
 int elf_parse_module(struct image *image, int module_index, const char *name)
 {
 	struct module *module;
+	struct stat st;
 	uint32_t rem;
-	int ret = 0;
+	int fd, ret = 0;
 
 	/* validate module index */
 	if (module_index >= MAX_MODULES) {
@@ -544,23 +487,30 @@ int elf_parse_module(struct image *image, int module_index, const char *name)
 
 	module = &image->module[module_index];
 
-	/* open the elf input file */
-	module->fd = fopen(name, "rb");
-	if (!module->fd) {
+	/* open and map the elf input file */
+	fd = open(name, O_RDONLY);
+	if (fd < 0) {
 		fprintf(stderr, "error: unable to open %s for reading %d\n",
 			name, errno);
 		return -EINVAL;
 	}
 	module->elf_file = name;
 
-	/* get file size */
-	ret = fseek(module->fd, 0, SEEK_END);
-	if (ret < 0)
-		goto hdr_err;
-	module->file_size = ftell(module->fd);
-	ret = fseek(module->fd, 0, SEEK_SET);
-	if (ret < 0)
-		goto hdr_err;
+	if (fstat(fd, &st) < 0 || st.st_size < sizeof(Elf32_Ehdr)) {
+		fprintf(stderr, "error: invalid ELF file %s\n", name);
+		close(fd);
+		return -EINVAL;
+	}
+	module->file_size = st.st_size;
+
+	module->elf = mmap(NULL, module->file_size, PROT_READ, MAP_PRIVATE,
+			   fd, 0);
+	close(fd);
+	if (module->elf == MAP_FAILED) {
+		fprintf(stderr, "error: unable to map %s %d\n", name, errno);
+		module->elf = NULL;
+		return -errno;
+	}
 
 	/* read in elf header */
 	ret = elf_read_hdr(image, module);
@@ -580,7 +530,7 @@ int elf_parse_module(struct image *image, int module_index, const char *name)
 	if (ret < 0) {
 		fprintf(stderr, "error: failed to read base sections %d\n",
 			ret);
-		goto sec_err;
+		goto hdr_err;
 	}
 
 	/* check limits */
@@ -617,10 +567,9 @@ int elf_parse_module(struct image *image, int module_index, const char *name)
 
 	return 0;
 
-sec_err:
-	free(module->prg);
 hdr_err:
-	fclose(module->fd);
+	munmap(module->elf, module->file_size);
+	module->elf = NULL;
 
 	return ret;
 }
@@ -629,8 +578,8 @@ void elf_free_module(struct image *image, int module_index)
 {
 	struct module *module = &image->module[module_index];
 
-	free(module->prg);
-	free(module->section);
-	free(module->strings);
-	fclose(module->fd);
+	/* headers and strings point into the mapping */
+	if (module->elf)
+		munmap(module->elf, module->file_size);
+	module->elf = NULL;
 }
@@ -79,4 +79,43 @@ struct snd_sof_logs_header {
 	uint32_t data_offset;	/* offset to first entry in this file */
 	struct sof_ipc_fw_version version;
 };
+
+#define SND_SOF_LDC_SIG		"Ldic"
+#define SND_SOF_LDC_VERSION	1
+
+/*
+ * Indexed logs dictionary file header.
+ *
+ * The dictionary is a header, an index of entries sorted by address and a
+ * table of NUL terminated strings. File names and format strings used by
+ * many entries are stored once in the string table.
+ */
+struct snd_sof_ldc_header {
+	unsigned char sig[SND_SOF_LOGS_SIG_SIZE]; /* "Ldic" */
+	uint32_t ldc_version;	/* SND_SOF_LDC_VERSION */
+	uint32_t header_size;	/* size of this header */
+	uint32_t base_address;	/* address of log entries section */
+	uint32_t data_length;	/* size of log entries section */
+	uint32_t entry_count;	/* number of entries in the index */
+	uint32_t entry_offset;	/* file offset of the index */
+	uint32_t entry_size;	/* size of one index entry */
+	uint32_t strings_offset;	/* file offset of the string table */
+	uint32_t strings_size;	/* size of the string table */
+	struct sof_ipc_fw_version version;
+};
+
+/*
+ * Logs dictionary index entry.
+ */
+struct snd_sof_ldc_entry {
+	uint32_t address;	/* entry address minus base_address */
+	uint32_t file_name;	/* string table offset of the file name */
+	uint32_t text;		/* string table offset of the format */
+	uint32_t component_class;
+	uint32_t line_idx;
+	uint8_t level;
+	uint8_t has_ids;
+	uint8_t params_num;	/* number of trace parameters */
+	uint8_t reserved;
+};
 #endif
@@ -74,6 +74,7 @@ static int write_block(struct image *image, struct module *module,
 {
 	const struct adsp *adsp = image->adsp;
 	struct snd_sof_blk_hdr block;
+	static const uint8_t zero[4];
 	uint32_t padding = 0;
 	size_t count;
 	void *buffer;
@@ -102,45 +103,31 @@ static int write_block(struct image *image, struct module *module,
 	if (count != 1)
 		return -errno;
 
-	/* alloc data data */
-	buffer = calloc(1, section->size);
-	if (!buffer)
-		return -ENOMEM;
-
-	/* read in section data */
-	ret = fseek(module->fd, section->off, SEEK_SET);
-	if (ret < 0) {
-		fprintf(stderr, "error: cant seek to section %d\n", ret);
-		goto out;
-	}
-	count = fread(buffer, 1, section->size, module->fd);
-	if (count != section->size) {
-		fprintf(stderr, "error: cant read section %d\n", -errno);
-		ret = -errno;
-		goto out;
+	/* section data is written straight from the mapped file */
+	buffer = elf_get_data(module, section->off, section->size);
+	if (!buffer) {
+		fprintf(stderr, "error: cant read section at 0x%x\n",
+			section->off);
+		return -EINVAL;
 	}
 
-	/* write out section data */
-	count = fwrite(buffer, 1, block.size, image->out_fd);
+	/* write out section data and zero padding */
+	count = fwrite(buffer, 1, section->size, image->out_fd);
+	if (count == section->size && padding)
+		count += fwrite(zero, 1, padding, image->out_fd);
 	if (count != block.size) {
 		fprintf(stderr, "error: cant write section %d\n", -errno);
 		fprintf(stderr, " foffset %d size 0x%x mem addr 0x%x\n",
 			section->off, section->size, section->vaddr);
-		ret = -errno;
-		goto out;
+		return -errno;
 	}
 
 	fprintf(stdout, "\t%d\t0x%8.8x\t0x%8.8x\t0x%8.8lx\t%s\n", block_idx++,
 		section->vaddr, section->size, ftell(image->out_fd),
 		block.type == SOF_FW_BLK_TYPE_IRAM ? "TEXT" : "DATA");
 
-out:
-	free(buffer);
 	/* return padding size */
-	if (ret >= 0)
-		return padding;
-
-	return ret;
+	return padding;
 }
 
 static int simple_write_module(struct image *image, struct module *module)
@@ -223,8 +210,6 @@ static int write_block_reloc(struct image *image, struct module *module)
 {
 	struct snd_sof_blk_hdr block;
 	size_t count;
-	void *buffer;
-	int ret;
 
 	block.size = module->file_size;
 	block.type = SOF_FW_BLK_TYPE_DRAM;
@@ -235,39 +220,18 @@ static int write_block_reloc(struct image *image, struct module *module)
 	if (count != 1)
 		return -errno;
 
-	/* alloc data data */
-	buffer = calloc(1, module->file_size);
-	if (!buffer)
-		return -ENOMEM;
-
-	/* read in section data */
-	ret = fseek(module->fd, 0, SEEK_SET);
-	if (ret < 0) {
-		fprintf(stderr, "error: can't seek to section %d\n", ret);
-		goto out;
-	}
-	count = fread(buffer, 1, module->file_size, module->fd);
-	if (count != module->file_size) {
-		fprintf(stderr, "error: can't read section %d\n", -errno);
-		ret = -errno;
-		goto out;
-	}
-
-	/* write out section data */
-	count = fwrite(buffer, 1, module->file_size, image->out_fd);
+	/* write out the whole mapped file */
+	count = fwrite(module->elf, 1, module->file_size, image->out_fd);
 	if (count != module->file_size) {
 		fprintf(stderr, "error: can't write section %d\n", -errno);
-		ret = -errno;
-		goto out;
+		return -errno;
 	}
 
 	fprintf(stdout, "\t%d\t0x%8.8x\t0x%8.8x\t0x%8.8lx\t%s\n", block_idx++,
 		0, module->file_size, ftell(image->out_fd),
 		block.type == SOF_FW_BLK_TYPE_IRAM ? "TEXT" : "DATA");
 
-out:
-	free(buffer);
-	return ret;
+	return 0;
 }
 
 static int simple_write_module_reloc(struct image *image, struct module *module)
@@ -369,96 +333,6 @@ static int simple_write_firmware(struct image *image)
 	return 0;
 }
 
-int write_logs_dictionary(struct image *image)
-{
-	struct snd_sof_logs_header header;
-	int i, ret = 0;
-	void *buffer = NULL;
-
-	memcpy(header.sig, SND_SOF_LOGS_SIG, SND_SOF_LOGS_SIG_SIZE);
-	header.data_offset = sizeof(struct snd_sof_logs_header);
-
-	for (i = 0; i < image->num_modules; i++) {
-		struct module *module = &image->module[i];
-
-		/* extract fw_version from fw_ready message located
-		 * in .fw_ready section
-		 */
-		if (module->fw_ready_index > 0) {
-			Elf32_Shdr *section =
-				&module->section[module->fw_ready_index];
-
-			buffer = calloc(1, sizeof(struct sof_ipc_fw_ready));
-			if (!buffer)
-				return -ENOMEM;
-
-			fseek(module->fd, section->off, SEEK_SET);
-			size_t count = fread(buffer, 1,
-				sizeof(struct sof_ipc_fw_ready), module->fd);
-
-			if (count != sizeof(struct sof_ipc_fw_ready)) {
-				fprintf(stderr,
-					"error: can't read ready section %d\n",
-					-errno);
-				ret = -errno;
-				goto out;
-			}
-
-			memcpy(&header.version,
-			       &((struct sof_ipc_fw_ready *)buffer)->version,
-			       sizeof(header.version));
-
-			free(buffer);
-			buffer = NULL;
-		}
-
-		if (module->logs_index > 0) {
-			Elf32_Shdr *section =
-				&module->section[module->logs_index];
-
-			header.base_address = section->vaddr;
-			header.data_length = section->size;
-
-			fwrite(&header, sizeof(struct snd_sof_logs_header), 1,
-			       image->ldc_out_fd);
-
-			buffer = calloc(1, section->size);
-			if (!buffer)
-				return -ENOMEM;
-
-			fseek(module->fd, section->off, SEEK_SET);
-			size_t count = fread(buffer, 1, section->size,
-				module->fd);
-			if (count != section->size) {
-				fprintf(stderr,
-					"error: can't read logs section %d\n",
-					-errno);
-				ret = -errno;
-				goto out;
-			}
-			count = fwrite(buffer, 1, section->size,
-				       image->ldc_out_fd);
-			if (count != section->size) {
-				fprintf(stderr,
-					"error: can't write section %d\n",
-					-errno);
-				ret = -errno;
-				goto out;
-			}
-
-			fprintf(stdout, "logs dictionary: size %u\n",
-				header.data_length + header.data_offset);
-			fprintf(stdout, "including fw version of size: %lu\n\n",
-				(unsigned long)sizeof(header.version));
-		}
-	}
-out:
-	if (buffer)
-		free(buffer);
-
-	return ret;
-}
-
 const struct adsp machine_byt = {
 	.name = "byt",
 	.mem_zones = {
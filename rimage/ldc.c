@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2019, Intel Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ */
+
+/*
+ * Indexed logs dictionary.
+ *
+ * The .static_log_entries section holds one variable length entry per
+ * trace call site. rimage walks the section once and writes a sorted
+ * index with fixed size entries plus a string table where every file
+ * name and format string is stored only once.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include "rimage.h"
+#include "file_format.h"
+
+#define LDC_MAX_PARAMS		4
+
+/* log entry header as declared by _DECLARE_LOG_ENTRY in the firmware */
+struct ldc_fw_entry {
+	uint32_t level;
+	uint32_t component_class;
+	uint32_t has_ids;
+	uint32_t params_num;
+	uint32_t line_idx;
+	uint32_t file_name_len;
+	uint32_t text_len;
+};
+
+/* deduplicated string table with an open addressing hash */
+struct ldc_strings {
+	char *data;
+	uint32_t size;
+	uint32_t alloc;
+	uint32_t *slot;		/* string offset + 1, 0 for a free slot */
+	uint32_t slots;		/* power of two */
+};
+
+static uint32_t ldc_hash(const char *s)
+{
+	uint32_t h = 2166136261u;
+
+	while (*s)
+		h = (h ^ (uint8_t)*s++) * 16777619u;
+
+	return h;
+}
+
+/* returns the string table offset of s, adding it if needed */
+static int ldc_string_add(struct ldc_strings *st, const char *s)
+{
+	uint32_t len = strlen(s) + 1;
+	uint32_t i = ldc_hash(s) & (st->slots - 1);
+	uint32_t offset;
+	char *data;
+
+	while (st->slot[i]) {
+		offset = st->slot[i] - 1;
+		if (!strcmp(st->data + offset, s))
+			return offset;
+		i = (i + 1) & (st->slots - 1);
+	}
+
+	if (st->size + len > st->alloc) {
+		data = realloc(st->data, (st->size + len) * 2);
+		if (!data)
+			return -ENOMEM;
+		st->data = data;
+		st->alloc = (st->size + len) * 2;
+	}
+
+	offset = st->size;
+	memcpy(st->data + offset, s, len);
+	st->size += len;
+	st->slot[i] = offset + 1;
+
+	return offset;
+}
+
+/* entry size including the strings, entries are word aligned */
+static uint32_t ldc_fw_entry_size(const struct ldc_fw_entry *fw)
+{
+	return (sizeof(*fw) + fw->file_name_len + fw->text_len + 3) & ~3;
+}
+
+/* check entry at pos fits in the section and holds two C strings */
+static int ldc_fw_entry_valid(const uint8_t *data, uint32_t size,
+			      uint32_t pos)
+{
+	const struct ldc_fw_entry *fw = (const void *)(data + pos);
+	const char *file_name = (const char *)(fw + 1);
+
+	if (size - pos < sizeof(*fw))
+		return 0;
+
+	if (!fw->file_name_len || !fw->text_len ||
+	    fw->file_name_len > size || fw->text_len > size ||
+	    size - pos - sizeof(*fw) < fw->file_name_len + fw->text_len)
+		return 0;
+
+	return fw->params_num <= LDC_MAX_PARAMS &&
+		file_name[fw->file_name_len - 1] == '\0' &&
+		file_name[fw->file_name_len + fw->text_len - 1] == '\0';
+}
+
+/* build index and string table from the raw log entries section */
+static int ldc_build(const uint8_t *data, uint32_t size,
+		     struct snd_sof_ldc_entry **index, uint32_t *count,
+		     struct ldc_strings *st)
+{
+	const struct ldc_fw_entry *fw;
+	struct snd_sof_ldc_entry *e;
+	uint32_t max = size / sizeof(*fw) + 1;
+	uint32_t pos = 0;
+	int file_name;
+	int text;
+
+	*count = 0;
+	*index = calloc(max, sizeof(**index));
+
+	/* at most two strings per entry, keep the hash half empty */
+	st->slots = 1;
+	while (st->slots < max * 4)
+		st->slots <<= 1;
+	st->slot = calloc(st->slots, sizeof(*st->slot));
+	if (!*index || !st->slot)
+		return -ENOMEM;
+
+	while (pos + sizeof(uint32_t) <= size) {
+		fw = (const void *)(data + pos);
+
+		/* skip alignment padding between object files */
+		if (!fw->level) {
+			pos += sizeof(uint32_t);
+			continue;
+		}
+
+		if (!ldc_fw_entry_valid(data, size, pos)) {
+			fprintf(stderr,
+				"error: invalid log entry at offset 0x%x\n",
+				pos);
+			return -EINVAL;
+		}
+
+		file_name = ldc_string_add(st, (const char *)(fw + 1));
+		text = ldc_string_add(st, (const char *)(fw + 1) +
+				      fw->file_name_len);
+		if (file_name < 0 || text < 0)
+			return -ENOMEM;
+
+		/* section walk is in address order so index is sorted */
+		e = &(*index)[(*count)++];
+		e->address = pos;
+		e->file_name = file_name;
+		e->text = text;
+		e->component_class = fw->component_class;
+		e->line_idx = fw->line_idx;
+		e->level = fw->level;
+		e->has_ids = fw->has_ids;
+		e->params_num = fw->params_num;
+
+		pos += ldc_fw_entry_size(fw);
+	}
+
+	return 0;
+}
+
+/* write dictionary for the log entries section of module */
+static int ldc_write(struct image *image, struct module *module,
+		     struct snd_sof_ldc_header *header)
+{
+	Elf32_Shdr *section = &module->section[module->logs_index];
+	struct snd_sof_ldc_entry *index = NULL;
+	struct ldc_strings st;
+	uint32_t count;
+	uint8_t *data;
+	int ret;
+
+	data = elf_get_data(module, section->off, section->size);
+	if (!data) {
+		fprintf(stderr, "error: can't read logs section\n");
+		return -EINVAL;
+	}
+
+	memset(&st, 0, sizeof(st));
+	ret = ldc_build(data, section->size, &index, &count, &st);
+	if (ret < 0)
+		goto out;
+
+	header->base_address = section->vaddr;
+	header->data_length = section->size;
+	header->entry_count = count;
+	header->entry_offset = sizeof(*header);
+	header->strings_offset = header->entry_offset +
+		count * sizeof(*index);
+	header->strings_size = st.size;
+
+	if (fwrite(header, sizeof(*header), 1, image->ldc_out_fd) != 1 ||
+	    fwrite(index, sizeof(*index), count, image->ldc_out_fd) != count ||
+	    fwrite(st.data, 1, st.size, image->ldc_out_fd) != st.size) {
+		fprintf(stderr, "error: can't write logs dictionary %d\n",
+			-errno);
+		ret = -errno;
+		goto out;
+	}
+
+	fprintf(stdout, "logs dictionary: size %u from section of %u\n",
+		header->strings_offset + header->strings_size,
+		section->size);
+	fprintf(stdout, "%u entries, %u bytes of strings\n\n", count,
+		st.size);
+
+out:
+	free(st.slot);
+	free(st.data);
+	free(index);
+	return ret;
+}
+
+int write_logs_dictionary(struct image *image)
+{
+	struct snd_sof_ldc_header header;
+	struct sof_ipc_fw_ready *ready;
+	int ret;
+	int i;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.sig, SND_SOF_LDC_SIG, SND_SOF_LOGS_SIG_SIZE);
+	header.ldc_version = SND_SOF_LDC_VERSION;
+	header.header_size = sizeof(header);
+	header.entry_size = sizeof(struct snd_sof_ldc_entry);
+
+	for (i = 0; i < image->num_modules; i++) {
+		struct module *module = &image->module[i];
+
+		/* extract fw_version from fw_ready message located
+		 * in .fw_ready section
+		 */
+		if (module->fw_ready_index > 0) {
+			Elf32_Shdr *section =
+				&module->section[module->fw_ready_index];
+
+			ready = elf_get_data(module, section->off,
+					     sizeof(*ready));
+			if (!ready) {
+				fprintf(stderr,
+					"error: can't read ready section\n");
+				return -EINVAL;
+			}
+
+			memcpy(&header.version, &ready->version,
+			       sizeof(header.version));
+		}
+
+		if (module->logs_index > 0) {
+			ret = ldc_write(image, module, &header);
+			if (ret < 0)
+				return ret;
+		}
+	}
+
+	return 0;
+}
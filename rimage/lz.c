@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2019, Intel Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <sof/lz.h>
+
+#include "lz.h"
+
+#define LZ_HASH_BITS	16
+#define LZ_HASH_SIZE	(1 << LZ_HASH_BITS)
+#define LZ_CHAIN_DEPTH	64
+
+static inline uint32_t lz_hash(const uint8_t *p)
+{
+	uint32_t v = p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+
+	return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+/* write extension bytes of a length that did not fit in its nibble */
+static uint8_t *lz_put_ext(uint8_t *op, uint32_t len)
+{
+	len -= LZ_NIBBLE_MAX;
+	while (len >= LZ_EXT_MAX) {
+		*op++ = LZ_EXT_MAX;
+		len -= LZ_EXT_MAX;
+	}
+	*op++ = len;
+
+	return op;
+}
+
+/* emit one block, a match_len of 0 ends the stream with literals only */
+static int lz_put_block(uint8_t **op, uint8_t *op_end, const uint8_t *lit,
+			uint32_t lit_len, uint32_t offset, uint32_t match_len)
+{
+	uint32_t ml = match_len ? match_len - LZ_MIN_MATCH : 0;
+	uint8_t *p = *op;
+	uint8_t token;
+
+	/* worst case block size */
+	if (op_end - p < 1 + lit_len / LZ_EXT_MAX + 1 + lit_len + 2 +
+	    ml / LZ_EXT_MAX + 1)
+		return -ENOSPC;
+
+	token = (lit_len < LZ_NIBBLE_MAX ? lit_len : LZ_NIBBLE_MAX) << 4;
+	if (match_len)
+		token |= ml < LZ_NIBBLE_MAX ? ml : LZ_NIBBLE_MAX;
+	*p++ = token;
+
+	if (lit_len >= LZ_NIBBLE_MAX)
+		p = lz_put_ext(p, lit_len);
+	memcpy(p, lit, lit_len);
+	p += lit_len;
+
+	if (match_len) {
+		*p++ = offset & 0xff;
+		*p++ = offset >> 8;
+		if (ml >= LZ_NIBBLE_MAX)
+			p = lz_put_ext(p, ml);
+	}
+
+	*op = p;
+	return 0;
+}
+
+int lz_compress(const void *in, uint32_t size, void *out, uint32_t out_size)
+{
+	const uint8_t *ip = in;
+	uint8_t *op = out;
+	uint8_t *op_end = op + out_size;
+	int32_t *head;
+	int32_t *prev;
+	uint32_t anchor = 0;
+	uint32_t pos = 0;
+	uint32_t best_len, best_off, len, max_len;
+	int32_t cand;
+	int depth;
+	int ret = 0;
+	uint32_t h;
+
+	head = malloc(LZ_HASH_SIZE * sizeof(*head));
+	prev = malloc((size ? size : 1) * sizeof(*prev));
+	if (!head || !prev) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	memset(head, 0xff, LZ_HASH_SIZE * sizeof(*head));
+
+	/* greedy parse with hash chains over a 64k window */
+	while (pos + LZ_MIN_MATCH <= size) {
+		h = lz_hash(ip + pos);
+		max_len = size - pos;
+		best_len = 0;
+		best_off = 0;
+
+		for (cand = head[h], depth = LZ_CHAIN_DEPTH;
+		     cand >= 0 && pos - cand <= LZ_MAX_OFFSET && depth;
+		     cand = prev[cand], depth--) {
+			for (len = 0; len < max_len; len++) {
+				if (ip[cand + len] != ip[pos + len])
+					break;
+			}
+
+			if (len > best_len) {
+				best_len = len;
+				best_off = pos - cand;
+				if (len == max_len)
+					break;
+			}
+		}
+
+		prev[pos] = head[h];
+		head[h] = pos;
+
+		if (best_len < LZ_MIN_MATCH) {
+			pos++;
+			continue;
+		}
+
+		ret = lz_put_block(&op, op_end, ip + anchor, pos - anchor,
+				   best_off, best_len);
+		if (ret < 0)
+			goto out;
+
+		/* index the matched data for later matches */
+		for (len = 1; len < best_len; len++) {
+			if (pos + len + LZ_MIN_MATCH > size)
+				break;
+			h = lz_hash(ip + pos + len);
+			prev[pos + len] = head[h];
+			head[h] = pos + len;
+		}
+
+		pos += best_len;
+		anchor = pos;
+	}
+
+	ret = lz_put_block(&op, op_end, ip + anchor, size - anchor, 0, 0);
+	if (ret == 0)
+		ret = op - (uint8_t *)out;
+
+out:
+	free(head);
+	free(prev);
+	return ret;
+}
+
+int lz_verify(const void *in, uint32_t size, const void *data,
+	      uint32_t data_size, uint32_t chunk)
+{
+	const uint8_t *ip = in;
+	struct lz_dec dec;
+	uint32_t used;
+	uint8_t *out;
+	int ret = 0;
+
+	out = malloc(data_size ? data_size : 1);
+	if (!out)
+		return -ENOMEM;
+
+	lz_dec_init(&dec, out, data_size);
+
+	while (!lz_dec_done(&dec)) {
+		ret = lz_dec_run(&dec, ip, size, &used, chunk);
+		if (ret < 0)
+			break;
+		if (!ret && !used) {
+			ret = -EINVAL;
+			break;
+		}
+		ip += used;
+		size -= used;
+	}
+
+	if (ret >= 0 && (size || memcmp(out, data, data_size)))
+		ret = -EINVAL;
+
+	free(out);
+	return ret < 0 ? ret : 0;
+}
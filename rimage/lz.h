@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2019, Intel Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ */
+
+#ifndef __LZ_H__
+#define __LZ_H__
+
+#include <stdint.h>
+
+/* worst case compressed size, all literals */
+#define LZ_COMPRESS_BOUND(size)	((size) + (size) / 255 + 16)
+
+/*
+ * Compress size bytes of data into the stream format decoded by
+ * src/lib/lz.c. Returns compressed size or negative error code.
+ */
+int lz_compress(const void *in, uint32_t size, void *out, uint32_t out_size);
+
+/* decode a whole stream in chunk sized steps, returns 0 on success */
+int lz_verify(const void *in, uint32_t size, const void *data,
+	      uint32_t data_size, uint32_t chunk);
+
+#endif
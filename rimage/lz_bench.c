@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2019, Intel Corporation.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ */
+
+/*
+ * Compare raw and LZ compressed firmware loading on the host.
+ *
+ * Each input file is compressed like rimage -c does, then decoded in
+ * chunks like the boot loader does. Sizes, compression time and the
+ * decode time against a plain copy are reported, together with an
+ * estimated load time for a host to DSP link of the given rate.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sof/lz.h>
+#include "lz.h"
+
+#define BENCH_REPS	20
+#define BENCH_CHUNK	4096
+#define BENCH_RATE	100	/* link rate in MB/s */
+
+static uint64_t bench_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int bench_read(const char *name, uint8_t **data, uint32_t *size)
+{
+	FILE *fp;
+	long len;
+
+	fp = fopen(name, "rb");
+	if (!fp) {
+		fprintf(stderr, "error: can't open %s\n", name);
+		return -EINVAL;
+	}
+
+	fseek(fp, 0, SEEK_END);
+	len = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if (len <= 0) {
+		fprintf(stderr, "error: %s is empty\n", name);
+		fclose(fp);
+		return -EINVAL;
+	}
+
+	*data = malloc(len);
+	if (!*data) {
+		fclose(fp);
+		return -ENOMEM;
+	}
+
+	if (fread(*data, 1, len, fp) != len) {
+		fprintf(stderr, "error: can't read %s\n", name);
+		free(*data);
+		fclose(fp);
+		return -EIO;
+	}
+
+	*size = len;
+	fclose(fp);
+	return 0;
+}
+
+/* decode the whole stream in chunks, returns 0 on success */
+static int bench_decode(const uint8_t *in, uint32_t in_size, uint8_t *out,
+			uint32_t out_size, uint32_t chunk)
+{
+	struct lz_dec dec;
+	uint32_t used;
+	int ret;
+
+	lz_dec_init(&dec, out, out_size);
+	while (!lz_dec_done(&dec)) {
+		ret = lz_dec_run(&dec, in, in_size, &used, chunk);
+		if (ret < 0)
+			return ret;
+		if (!ret && !used)
+			return -EINVAL;
+		in += used;
+		in_size -= used;
+	}
+
+	return 0;
+}
+
+static int bench_file(const char *name, uint32_t chunk, uint32_t rate)
+{
+	uint8_t *data;
+	uint8_t *lz;
+	uint8_t *out;
+	uint32_t size;
+	uint32_t bound;
+	uint64_t t_comp;
+	uint64_t t_copy = ~0ULL;
+	uint64_t t_dec = ~0ULL;
+	uint64_t t;
+	uint64_t load_raw;
+	uint64_t load_lz;
+	int csize;
+	int ret;
+	int i;
+
+	ret = bench_read(name, &data, &size);
+	if (ret < 0)
+		return ret;
+
+	bound = LZ_COMPRESS_BOUND(size);
+	lz = malloc(bound);
+	out = malloc(size);
+	if (!lz || !out) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	t = bench_ns();
+	csize = lz_compress(data, size, lz, bound);
+	t_comp = bench_ns() - t;
+	if (csize < 0) {
+		fprintf(stderr, "error: can't compress %s\n", name);
+		ret = csize;
+		goto out;
+	}
+
+	/* best of several runs for the copy and the decode */
+	for (i = 0; i < BENCH_REPS; i++) {
+		t = bench_ns();
+		memcpy(out, data, size);
+		t = bench_ns() - t;
+		if (t < t_copy)
+			t_copy = t;
+
+		t = bench_ns();
+		ret = bench_decode(lz, csize, out, size, chunk);
+		t = bench_ns() - t;
+		if (ret < 0 || memcmp(out, data, size)) {
+			fprintf(stderr, "error: %s does not decode\n", name);
+			ret = -EINVAL;
+			goto out;
+		}
+		if (t < t_dec)
+			t_dec = t;
+	}
+
+	/* bytes at rate MB/s take bytes * 1000 / rate ns */
+	load_raw = (uint64_t)size * 1000 / rate + t_copy;
+	load_lz = (uint64_t)csize * 1000 / rate + t_dec;
+
+	fprintf(stdout, "%s\n", name);
+	fprintf(stdout, "  size raw %u lz %d ratio %u%%\n", size, csize,
+		(uint32_t)((uint64_t)csize * 100 / size));
+	fprintf(stdout, "  compress %llu us\n",
+		(unsigned long long)t_comp / 1000);
+	fprintf(stdout, "  memcpy %llu us decode %llu us (%u byte chunks)\n",
+		(unsigned long long)t_copy / 1000,
+		(unsigned long long)t_dec / 1000, chunk);
+	fprintf(stdout, "  load at %u MB/s raw %llu us lz %llu us\n", rate,
+		(unsigned long long)load_raw / 1000,
+		(unsigned long long)load_lz / 1000);
+	ret = 0;
+
+out:
+	free(out);
+	free(lz);
+	free(data);
+	return ret;
+}
+
+static void usage(char *name)
+{
+	fprintf(stdout, "%s:\t [options] file...\n", name);
+	fprintf(stdout, "\t -c decode chunk size in bytes, default %d\n",
+		BENCH_CHUNK);
+	fprintf(stdout, "\t -r host to DSP link rate in MB/s, default %d\n",
+		BENCH_RATE);
+	exit(0);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t chunk = BENCH_CHUNK;
+	uint32_t rate = BENCH_RATE;
+	int opt;
+	int ret = 0;
+	int i;
+
+	while ((opt = getopt(argc, argv, "hc:r:")) != -1) {
+		switch (opt) {
+		case 'c':
+			chunk = atoi(optarg);
+			break;
+		case 'r':
+			rate = atoi(optarg);
+			break;
+		case 'h':
+		default:
+			usage(argv[0]);
+			break;
+		}
+	}
+
+	if (optind >= argc || !chunk || !rate)
+		usage(argv[0]);
+
+	for (i = optind; i < argc; i++) {
+		ret = bench_file(argv[i], chunk, rate);
+		if (ret < 0)
+			break;
+	}
+
+	return ret < 0 ? 1 : 0;
+}
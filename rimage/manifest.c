@@ -20,6 +20,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
+#include <pthread.h>
 #include <time.h>
 #include <sys/time.h>
 
@@ -31,6 +32,7 @@
 #include "cse.h"
 #include "plat_auth.h"
 #include "manifest.h"
+#include "lz.h"
 
 static int man_open_rom_file(struct image *image)
 {
@@ -164,7 +166,7 @@ static int man_copy_sram(struct image *image, Elf32_Shdr *section,
 	uint32_t end = offset + section->size;
 	int seg_type = -1;
 	void *buffer = image->fw_image + offset;
-	size_t count;
+	void *data;
 
 	switch (section->type) {
 	case SHT_PROGBITS:
@@ -188,11 +190,12 @@ static int man_copy_sram(struct image *image, Elf32_Shdr *section,
 	    man_module->segment[seg_type].file_offset == 0)
 		man_module->segment[seg_type].file_offset = offset;
 
-	count = fread(buffer, 1, section->size, module->fd);
-	if (count != section->size) {
-		fprintf(stderr, "error: cant read section %d\n", -errno);
-		return -errno;
+	data = elf_get_data(module, section->off, section->size);
+	if (!data || end > image->adsp->image_size) {
+		fprintf(stderr, "error: invalid section %d\n", section_idx);
+		return -EINVAL;
 	}
+	memcpy(buffer, data, section->size);
 
 	/* get module end offset  ? */
 	if (end > image->image_end)
@@ -209,15 +212,6 @@ static int man_copy_elf_section(struct image *image, Elf32_Shdr *section,
 				struct module *module,
 				struct sof_man_module *man_module, int idx)
 {
-	int ret;
-
-	/* seek to ELF section */
-	ret = fseek(module->fd, section->off, SEEK_SET);
-	if (ret < 0) {
-		fprintf(stderr, "error: can't seek to section %d\n", ret);
-		return ret;
-	}
-
 	/* write data to DRAM or ROM image */
 	if (!elf_is_rom(image, section))
 		return man_copy_sram(image, section, module, man_module, idx);
@@ -231,8 +225,9 @@ static int man_get_module_manifest(struct image *image, struct module *module,
 	Elf32_Shdr *section;
 	struct sof_man_segment_desc *segment;
 	struct sof_man_module_manifest sof_mod;
-	size_t count;
-	int ret, man_section_idx;
+	uint32_t offset;
+	void *data;
+	int man_section_idx;
 
 	fprintf(stdout, "Module Write: %s\n", module->elf_file);
 
@@ -248,21 +243,17 @@ static int man_get_module_manifest(struct image *image, struct module *module,
 	/* load in manifest data */
 	/* module built using xcc has preceding bytes */
 	if (section->size > sizeof(sof_mod))
-		ret = fseek(module->fd,
-			    section->off + XCC_MOD_OFFSET, SEEK_SET);
+		offset = section->off + XCC_MOD_OFFSET;
 	else
-		ret = fseek(module->fd, section->off, SEEK_SET);
+		offset = section->off;
 
-	if (ret < 0) {
-		fprintf(stderr, "error: can't seek to section %d\n", ret);
-		return ret;
-	}
-
-	count = fread(&sof_mod, 1, sizeof(sof_mod), module->fd);
-	if (count != sizeof(sof_mod)) {
-		fprintf(stderr, "error: can't read section %d\n", -errno);
-		return -errno;
+	data = elf_get_data(module, offset, sizeof(sof_mod));
+	if (!data) {
+		fprintf(stderr, "error: can't read section %d\n",
+			man_section_idx);
+		return -EINVAL;
 	}
+	memcpy(&sof_mod, data, sizeof(sof_mod));
 
 	/* configure man_module with sofmod data */
 	memcpy(man_module->struct_id, "$AME", 4);
@@ -497,7 +488,6 @@ static int man_module_create_reloc(struct image *image, struct module *module,
 	int err;
 	unsigned int pages;
 	void *buffer = image->fw_image + module->foffset;
-	size_t count;
 
 	image->image_end = 0;
 
@@ -547,18 +537,13 @@ static int man_module_create_reloc(struct image *image, struct module *module,
 
 	fprintf(stdout, "\tNo\tAddress\t\tSize\t\tFile\tType\n");
 
-	/* seek to beginning of file */
-	err = fseek(module->fd, 0, SEEK_SET);
-	if (err < 0) {
-		fprintf(stderr, "error: can't seek to section %d\n", err);
-		return err;
-	}
-
-	count = fread(buffer, 1, module->file_size, module->fd);
-	if (count != module->file_size) {
-		fprintf(stderr, "error: can't read section %d\n", -errno);
-		return -errno;
+	/* relocatable modules are copied whole */
+	if (module->foffset + module->file_size > image->adsp->image_size) {
+		fprintf(stderr, "error: module %s too big for image\n",
+			module->elf_file);
+		return -EINVAL;
 	}
+	memcpy(buffer, module->elf, module->file_size);
 
 	fprintf(stdout, "\t%d\t0x%8.8x\t0x%8.8x\t0x%x\t%s\n", 0,
 		0, module->file_size, 0, "DATA");
@@ -580,6 +565,122 @@ static int man_module_create_reloc(struct image *image, struct module *module,
 	return 0;
 }
 
+/* store segment at file offset pos, LZ compressed if that saves space */
+static int man_segment_compress(struct image *image,
+				struct sof_man_segment_desc *segment,
+				const uint8_t *data, uint32_t pos)
+{
+	struct sof_man_lz_header *lz = image->fw_image + pos;
+	uint32_t size = segment->flags.r.length * MAN_PAGE_SIZE;
+	uint32_t bound = LZ_COMPRESS_BOUND(size);
+	uint8_t *buffer;
+	int csize;
+	int ret;
+
+	segment->file_offset = pos;
+	if (!size)
+		return pos;
+
+	buffer = malloc(bound);
+	if (!buffer)
+		return -ENOMEM;
+
+	csize = lz_compress(data, size, buffer, bound);
+	if (csize < 0) {
+		ret = csize;
+		goto out;
+	}
+
+	/* keep the segment raw if compression does not help */
+	if (sizeof(*lz) + csize >= size) {
+		memcpy(image->fw_image + pos, data, size);
+		fprintf(stdout, "\tLZ\t0x%8.8x\t0x%x\t\traw\n",
+			segment->v_base_addr, size);
+		ret = pos + size;
+		goto out;
+	}
+
+	/* decode in page sized chunks like the boot loader does */
+	ret = lz_verify(buffer, csize, data, size, MAN_PAGE_SIZE);
+	if (ret < 0) {
+		fprintf(stderr, "error: LZ verify failed for segment 0x%x\n",
+			segment->v_base_addr);
+		goto out;
+	}
+
+	lz->magic = SOF_MAN_LZ_MAGIC;
+	lz->size = csize;
+	lz->data_size = size;
+	lz->reserved = 0;
+	memcpy(lz + 1, buffer, csize);
+	segment->flags.r.compressed = 1;
+
+	fprintf(stdout, "\tLZ\t0x%8.8x\t0x%x\t\t0x%x\t%d%%\n",
+		segment->v_base_addr, size, csize, csize * 100 / size);
+
+	/* keep the next header word aligned */
+	ret = pos + ((sizeof(*lz) + csize + 3) & ~3);
+
+out:
+	free(buffer);
+	return ret;
+}
+
+/* repack text and data segments of a module, compressing them */
+static int man_module_compress(struct image *image, struct module *module,
+			       struct sof_man_module *man_module)
+{
+	struct sof_man_segment_desc *segment;
+	uint32_t start = module->foffset;
+	uint32_t size = image->image_end - start;
+	uint32_t end;
+	uint8_t *raw;
+	int pos = start;
+	int i;
+
+	raw = malloc(size);
+	if (!raw)
+		return -ENOMEM;
+
+	memcpy(raw, image->fw_image + start, size);
+	memset(image->fw_image + start, 0, size);
+
+	for (i = SOF_MAN_SEGMENT_TEXT; i <= SOF_MAN_SEGMENT_RODATA; i++) {
+		segment = &man_module->segment[i];
+
+		end = segment->file_offset +
+			segment->flags.r.length * MAN_PAGE_SIZE;
+		if (segment->flags.r.length &&
+		    (segment->file_offset < start || end > start + size)) {
+			fprintf(stderr, "error: segment %d outside module\n",
+				i);
+			pos = -EINVAL;
+			break;
+		}
+
+		pos = man_segment_compress(image, segment,
+					   raw + segment->file_offset - start,
+					   pos);
+		if (pos < 0)
+			break;
+	}
+
+	free(raw);
+	if (pos < 0)
+		return pos;
+
+	/* round module end up to nearest page */
+	image->image_end = pos;
+	if (image->image_end % MAN_PAGE_SIZE) {
+		image->image_end = (image->image_end / MAN_PAGE_SIZE) + 1;
+		image->image_end *= MAN_PAGE_SIZE;
+	}
+
+	fprintf(stdout, " Compressed module file size 0x%x of 0x%x\n\n",
+		image->image_end - start, size);
+	return 0;
+}
+
 static int man_write_unsigned_mod(struct image *image, int meta_start_offset,
 				  int meta_end_offset)
 {
@@ -677,16 +778,62 @@ static int man_create_modules(struct image *image, struct sof_man_fw_desc *desc,
 
 		if (err < 0)
 			return err;
+
+		/*
+		 * the first module is loaded by ROM so it stays raw, skl/kbl
+		 * have no SOF boot loader so ROM loads every module there.
+		 */
+		if (image->compress && i > 0 && !image->reloc &&
+		    !image->adsp->man_v1_5) {
+			err = man_module_compress(image, module, man_module);
+			if (err < 0)
+				return err;
+		}
 	}
 
 	return 0;
 }
 
+struct man_hash_job {
+	pthread_t thread;
+	int started;
+	void *data;
+	size_t size;
+	uint8_t *hash;
+};
+
+static void *man_hash_thread(void *arg)
+{
+	struct man_hash_job *job = arg;
+
+	ri_sha256(job->data, job->size, job->hash);
+	return NULL;
+}
+
+/* file bytes of a segment, compressed segments are smaller than pages */
+static uint32_t man_segment_file_size(struct image *image,
+				      struct sof_man_segment_desc *segment)
+{
+	struct sof_man_lz_header *lz;
+
+	if (!segment->flags.r.compressed)
+		return segment->flags.r.length * MAN_PAGE_SIZE;
+
+	lz = image->fw_image + segment->file_offset;
+	return sizeof(*lz) + lz->size;
+}
+
+/* modules are independent so hash each one on its own thread */
 static int man_hash_modules(struct image *image, struct sof_man_fw_desc *desc)
 {
+	struct man_hash_job job[MAX_MODULES];
 	struct sof_man_module *man_module;
+	struct sof_man_segment_desc *text;
+	struct sof_man_segment_desc *rodata;
 	int i;
 
+	memset(job, 0, sizeof(job));
+
 	for (i = 0; i < image->num_modules; i++) {
 		man_module = sof_man_get_module(desc, i);
 
@@ -696,11 +843,30 @@ static int man_hash_modules(struct image *image, struct sof_man_fw_desc *desc)
 			continue;
 		}
 
-		ri_hash(image,
-			man_module->segment[SOF_MAN_SEGMENT_TEXT].file_offset,
-			(man_module->segment[SOF_MAN_SEGMENT_TEXT].flags.r.length +
-			man_module->segment[SOF_MAN_SEGMENT_RODATA].flags.r.length) *
-			MAN_PAGE_SIZE, man_module->hash);
+		text = &man_module->segment[SOF_MAN_SEGMENT_TEXT];
+		rodata = &man_module->segment[SOF_MAN_SEGMENT_RODATA];
+
+		/* hash the module data as stored in the file */
+		job[i].data = image->fw_image + text->file_offset;
+		if (text->flags.r.compressed || rodata->flags.r.compressed)
+			job[i].size = rodata->file_offset - text->file_offset +
+				man_segment_file_size(image, rodata);
+		else
+			job[i].size = (text->flags.r.length +
+				       rodata->flags.r.length) * MAN_PAGE_SIZE;
+		job[i].hash = man_module->hash;
+
+		/* fall back to hashing in place if no thread is available */
+		if (!pthread_create(&job[i].thread, NULL, man_hash_thread,
+				    &job[i]))
+			job[i].started = 1;
+		else
+			man_hash_thread(&job[i]);
+	}
+
+	for (i = 0; i < image->num_modules; i++) {
+		if (job[i].started)
+			pthread_join(job[i].thread, NULL);
 	}
 
 	return 0;
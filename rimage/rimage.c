@@ -18,6 +18,8 @@
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
 
 #include "rimage.h"
 #include "file_format.h"
@@ -37,6 +39,9 @@ static const struct adsp *machine[] = {
 	&machine_skl,
 };
 
+/* at most one image per supported machine in a single run */
+#define MAX_TARGETS	ARRAY_SIZE(machine)
+
 static void usage(char *name)
 {
 	fprintf(stdout, "%s:\t -m machine -o outfile -k [key] ELF files\n",
@@ -46,47 +51,252 @@ static void usage(char *name)
 	fprintf(stdout, "\t -s MEU signing offset\n");
 	fprintf(stdout, "\t -p log dictionary outfile\n");
 	fprintf(stdout, "\t -i set IMR type\n");
+	fprintf(stdout, "\t -j max number of images built in parallel\n");
+	fprintf(stdout, "\t -c LZ compress modules loaded by boot loader\n");
+	fprintf(stdout, "\t -m apl,cnl builds outfile-apl and outfile-cnl\n");
 	exit(0);
 }
 
+static const struct adsp *find_machine(const char *mach)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(machine); i++) {
+		if (!strcmp(mach, machine[i]->name))
+			return machine[i];
+	}
+
+	fprintf(stderr, "error: machine %s not found\n", mach);
+	fprintf(stderr, "error: available machines ");
+	for (i = 0; i < ARRAY_SIZE(machine); i++)
+		fprintf(stderr, "%s, ", machine[i]->name);
+	fprintf(stderr, "\n");
+
+	return NULL;
+}
+
+/* insert machine name before the file extension, sof.ri -> sof-apl.ri */
+static char *target_file_name(const char *file, const char *mach)
+{
+	const char *ext = strrchr(file, '.');
+	const char *dir = strrchr(file, '/');
+	size_t len = strlen(file) + strlen(mach) + 2;
+	char *name;
+
+	if (!ext || (dir && ext < dir))
+		ext = file + strlen(file);
+
+	name = malloc(len);
+	if (!name)
+		return NULL;
+
+	snprintf(name, len, "%.*s-%s%s", (int)(ext - file), file, mach, ext);
+	return name;
+}
+
+/* parse ELF modules then write the firmware image and log dictionary */
+static int image_build(struct image *image, int imr_type, char *elf_files[],
+		       int num_elf)
+{
+	int ret, i;
+
+	/* set IMR Type in found machine definition */
+	if (image->adsp->man_v1_8)
+		image->adsp->man_v1_8->adsp_file_ext.imr_type = imr_type;
+
+	/* parse input ELF files */
+	image->num_modules = num_elf;
+	for (i = 0; i < num_elf; i++) {
+		fprintf(stdout, "\nModule Reading %s\n", elf_files[i]);
+		ret = elf_parse_module(image, i, elf_files[i]);
+		if (ret < 0) {
+			image->num_modules = i;
+			goto out;
+		}
+	}
+
+	/* validate all modules */
+	ret = elf_validate_modules(image);
+	if (ret < 0)
+		goto out;
+
+	/* open outfile for writing */
+	unlink(image->out_file);
+	image->out_fd = fopen(image->out_file, "wb");
+	if (!image->out_fd) {
+		fprintf(stderr, "error: unable to open %s for writing %d\n",
+			image->out_file, errno);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	/* process and write output */
+	if (image->meu_offset)
+		ret = image->adsp->write_firmware_meu(image);
+	else
+		ret = image->adsp->write_firmware(image);
+
+	unlink(image->ldc_out_file);
+	image->ldc_out_fd = fopen(image->ldc_out_file, "wb");
+	if (!image->ldc_out_fd) {
+		fprintf(stderr, "error: unable to open %s for writing %d\n",
+			image->ldc_out_file, errno);
+		ret = -EINVAL;
+		goto out;
+	}
+	ret = write_logs_dictionary(image);
+out:
+	/* close files */
+	if (image->out_fd)
+		fclose(image->out_fd);
+
+	if (image->ldc_out_fd)
+		fclose(image->ldc_out_fd);
+
+	for (i = 0; i < image->num_modules; i++)
+		elf_free_module(image, i);
+
+	return ret;
+}
+
+/* state of one machine image build */
+struct target_job {
+	pid_t pid;
+	int status;
+	FILE *log;
+};
+
+/*
+ * Each target is built by a child process so targets share no state and
+ * the log of each target is kept in a temporary file and printed in order.
+ */
+static int image_build_targets(struct image *image, int num_targets, int jobs,
+			       int imr_type, char *elf_files[], int num_elf)
+{
+	struct target_job job[MAX_TARGETS];
+	char line[256];
+	int running = 0;
+	int ret = 0;
+	pid_t done;
+	int i, j, st;
+
+	for (i = 0; i < num_targets; i++) {
+		/* wait for a free job slot */
+		while (running >= jobs) {
+			done = wait(&st);
+			if (done < 0)
+				break;
+			for (j = 0; j < i; j++) {
+				if (job[j].pid == done)
+					job[j].status = st;
+			}
+			running--;
+		}
+
+		/* make sure buffered output is not duplicated in the child */
+		fflush(stdout);
+		fflush(stderr);
+
+		job[i].log = tmpfile();
+		job[i].pid = job[i].log ? fork() : -1;
+		if (job[i].pid == 0) {
+			dup2(fileno(job[i].log), STDOUT_FILENO);
+			st = image_build(&image[i], imr_type, elf_files,
+					 num_elf);
+			fflush(stdout);
+			_exit(st < 0 ? 1 : 0);
+		}
+
+		if (job[i].pid < 0) {
+			/* no child, build this target in place */
+			job[i].status = image_build(&image[i], imr_type,
+						    elf_files, num_elf) < 0;
+			continue;
+		}
+
+		job[i].status = -1;
+		running++;
+	}
+
+	/* reap remaining children */
+	while (running > 0) {
+		done = wait(&st);
+		if (done < 0)
+			break;
+		for (j = 0; j < num_targets; j++) {
+			if (job[j].pid == done)
+				job[j].status = st;
+		}
+		running--;
+	}
+
+	for (i = 0; i < num_targets; i++) {
+		if (job[i].log) {
+			rewind(job[i].log);
+			while (fgets(line, sizeof(line), job[i].log))
+				fputs(line, stdout);
+			fclose(job[i].log);
+		}
+
+		if (job[i].status) {
+			fprintf(stderr, "error: failed to build %s image %s\n",
+				image[i].adsp->name, image[i].out_file);
+			ret = -EINVAL;
+		}
+	}
+
+	return ret;
+}
+
 int main(int argc, char *argv[])
 {
-	struct image image;
-	const char *mach = NULL;
+	struct image image[MAX_TARGETS];
+	struct image *target;
+	const char *out_file, *ldc_out_file;
+	char *mach = NULL;
+	char *name, *saveptr;
 	int opt, ret, i, elf_argc = 0;
 	int imr_type = MAN_DEFAULT_IMR_TYPE;
+	int num_targets = 0;
+	int jobs = sysconf(_SC_NPROCESSORS_ONLN);
 
-	memset(&image, 0, sizeof(image));
+	memset(image, 0, sizeof(image));
 
-	while ((opt = getopt(argc, argv, "ho:p:m:vba:s:k:l:ri:")) != -1) {
+	while ((opt = getopt(argc, argv, "ho:p:m:vba:s:k:l:ri:j:c")) != -1) {
 		switch (opt) {
 		case 'o':
-			image.out_file = optarg;
+			image[0].out_file = optarg;
 			break;
 		case 'p':
-			image.ldc_out_file = optarg;
+			image[0].ldc_out_file = optarg;
 			break;
 		case 'm':
 			mach = optarg;
 			break;
 		case 'v':
-			image.verbose = 1;
+			image[0].verbose = 1;
 			break;
 		case 's':
-			image.meu_offset = atoi(optarg);
+			image[0].meu_offset = atoi(optarg);
 			break;
 		case 'a':
-			image.abi = atoi(optarg);
+			image[0].abi = atoi(optarg);
 			break;
 		case 'k':
-			image.key_name = optarg;
+			image[0].key_name = optarg;
 			break;
 		case 'r':
-			image.reloc = 1;
+			image[0].reloc = 1;
 			break;
 		case 'i':
 			imr_type = atoi(optarg);
 			break;
+		case 'j':
+			jobs = atoi(optarg);
+			break;
+		case 'c':
+			image[0].compress = 1;
+			break;
 		case 'h':
 			usage(argv[0]);
 			break;
@@ -98,79 +308,58 @@ int main(int argc, char *argv[])
 	elf_argc = optind;
 
 	/* make sure we have an outfile and machine */
-	if (!image.out_file || !mach)
+	if (!image[0].out_file || !mach)
 		usage(argv[0]);
 
-	if (!image.ldc_out_file)
-		image.ldc_out_file = "out.ldc";
+	if (!image[0].ldc_out_file)
+		image[0].ldc_out_file = "out.ldc";
 
-	/* find machine */
-	for (i = 0; i < ARRAY_SIZE(machine); i++) {
-		if (!strcmp(mach, machine[i]->name)) {
-			image.adsp = machine[i];
-			goto found;
-		}
-	}
-	fprintf(stderr, "error: machine %s not found\n", mach);
-	fprintf(stderr, "error: available machines ");
-	for (i = 0; i < ARRAY_SIZE(machine); i++)
-		fprintf(stderr, "%s, ", machine[i]->name);
-	fprintf(stderr, "\n");
+	if (jobs < 1)
+		jobs = 1;
 
-	return -EINVAL;
+	/* find machines, every target starts with the same options */
+	for (name = strtok_r(mach, ",", &saveptr); name;
+	     name = strtok_r(NULL, ",", &saveptr)) {
+		if (num_targets == MAX_TARGETS) {
+			fprintf(stderr, "error: too many machines\n");
+			return -EINVAL;
+		}
 
-found:
+		target = &image[num_targets];
+		if (num_targets)
+			*target = image[0];
 
-	/* set IMR Type in found machine definition */
-	if (image.adsp->man_v1_8)
-		image.adsp->man_v1_8->adsp_file_ext.imr_type = imr_type;
+		target->adsp = find_machine(name);
+		if (!target->adsp)
+			return -EINVAL;
 
-	/* parse input ELF files */
-	image.num_modules = argc - elf_argc;
-	for (i = elf_argc; i < argc; i++) {
-		fprintf(stdout, "\nModule Reading %s\n", argv[i]);
-		ret = elf_parse_module(&image, i - elf_argc, argv[i]);
-		if (ret < 0)
-			goto out;
+		num_targets++;
 	}
 
-	/* validate all modules */
-	ret = elf_validate_modules(&image);
-	if (ret < 0)
-		goto out;
+	if (num_targets == 1)
+		return image_build(&image[0], imr_type, argv + elf_argc,
+				   argc - elf_argc);
 
-	/* open outfile for writing */
-	unlink(image.out_file);
-	image.out_fd = fopen(image.out_file, "wb");
-	if (!image.out_fd) {
-		fprintf(stderr, "error: unable to open %s for writing %d\n",
-			image.out_file, errno);
-		ret = -EINVAL;
-		goto out;
+	/* several machines, name output files after each machine */
+	out_file = image[0].out_file;
+	ldc_out_file = image[0].ldc_out_file;
+	for (i = 0; i < num_targets; i++) {
+		target = &image[i];
+		target->out_file = target_file_name(out_file,
+						    target->adsp->name);
+		target->ldc_out_file = target_file_name(ldc_out_file,
+							target->adsp->name);
+		if (!target->out_file || !target->ldc_out_file)
+			return -ENOMEM;
 	}
 
-	/* process and write output */
-	if (image.meu_offset)
-		ret = image.adsp->write_firmware_meu(&image);
-	else
-		ret = image.adsp->write_firmware(&image);
+	ret = image_build_targets(image, num_targets, jobs, imr_type,
+				  argv + elf_argc, argc - elf_argc);
 
-	unlink(image.ldc_out_file);
-	image.ldc_out_fd = fopen(image.ldc_out_file, "wb");
-	if (!image.ldc_out_fd) {
-		fprintf(stderr, "error: unable to open %s for writing %d\n",
-			image.ldc_out_file, errno);
-		ret = -EINVAL;
-		goto out;
+	for (i = 0; i < num_targets; i++) {
+		free((char *)image[i].out_file);
+		free((char *)image[i].ldc_out_file);
 	}
-	ret = write_logs_dictionary(&image);
-out:
-	/* close files */
-	if (image.out_fd)
-		fclose(image.out_fd);
-
-	if (image.ldc_out_fd)
-		fclose(image.ldc_out_fd);
 
 	return ret;
 }
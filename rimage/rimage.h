@@ -54,12 +54,14 @@ enum machine_id {
  */
 struct module {
 	const char *elf_file;
-	FILE *fd;
+	void *elf;	/* read only mapping of the ELF file */
 
+	/* section and program headers and strings point into the mapping */
 	Elf32_Ehdr hdr;
 	Elf32_Shdr *section;
 	Elf32_Phdr *prg;
 	char *strings;
+	uint32_t strings_size;
 
 	uint32_t text_start;
 	uint32_t text_end;
@@ -109,6 +111,7 @@ struct image {
 	int abi;
 	int verbose;
 	int reloc;	/* ELF data is relocatable */
+	int compress;	/* LZ compress modules loaded by the boot loader */
 	int num_modules;
 	struct module module[MAX_MODULES];
 	uint32_t image_end;/* module end, equal to output image size */
@@ -163,6 +166,7 @@ void module_sha256_complete(struct image *image, uint8_t *hash);
 int ri_manifest_sign_v1_5(struct image *image);
 int ri_manifest_sign_v1_8(struct image *image);
 void ri_hash(struct image *image, unsigned offset, unsigned size, uint8_t *hash);
+void ri_sha256(const void *data, size_t bytes, uint8_t *hash);
 
 int pkcs_v1_5_sign_man_v1_5(struct image *image,
 			    struct fw_image_manifest_v1_5 *man,
@@ -172,6 +176,7 @@ int pkcs_v1_5_sign_man_v1_8(struct image *image,
 			    void *ptr1, unsigned int size1, void *ptr2,
 			    unsigned int size2);
 
+void *elf_get_data(struct module *module, uint32_t offset, uint32_t size);
 int elf_parse_module(struct image *image, int module_index, const char *name);
 void elf_free_module(struct image *image, int module_index);
 int elf_is_rom(struct image *image, Elf32_Shdr *section);
@@ -21,20 +21,27 @@ fs_in="48000"
 fs_out="96000"
 
 # topology file
-# please use simple volume/src topologies for now
+# volume, src, eq_fir, eq_iir, mixer, mux, selector, tone, kpb and
+# keyword detect widgets are loaded from their host modules
 
 topology_file="./tools/test/topology/test-playback-ssp2-I2S-volume-s16le-s32le-48k-24576k-codec.tplg"
 
 #example src topology
 #topology_file="./tools/test/topology/test-playback-ssp5-LEFT_J-src-s24le-s24le-48k-19200k-codec.tplg"
 
-#optional libraries to override
-libraries="vol=libsof_volume.so,src=libsof_src.so"
+#optional libraries to override, add -a $libraries to use them
+#by default the best CPU optimized module variants are loaded
+libraries="vol=libsof_volume.so,src=libsof_src.so,eq_iir=libsof_eq_iir.so"
+
+#optional CPU variant to force, add -c $cpu_variant to use it
+cpu_variant="generic"
 
 # Use -d to enable debug prints
 
 # run volume testbench
-./src/host/testbench -i $input_file -o $output_file -b $bits_in -t $topology_file -a $libraries -d
+./src/host/testbench -i $input_file -o $output_file -b $bits_in \
+	-t $topology_file -d
 
 # run src testbench
-#./src/host/testbench -i $input_file -o $output_file -b $bits_in -t $topology_file -a $libraries -r $fs_in -R $fs_out -d
+#./src/host/testbench -i $input_file -o $output_file -b $bits_in \
+#	-t $topology_file -r $fs_in -R $fs_out -d
@@ -32,6 +32,7 @@
 #ifndef __INCLUDE_ARCH_SOF__
 #define __INCLUDE_ARCH_SOF__
 
+#include <config.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <stddef.h>
@@ -35,6 +35,7 @@
 #include <arch/interrupt.h>
 #include <stdint.h>
 #include <errno.h>
+#include <time.h>
 
 struct timer {
 };
@@ -49,4 +50,14 @@ static inline int arch_timer_set(struct timer *timer,
 	uint64_t ticks) {return 0; }
 static inline void arch_timer_clear(struct timer *timer) {}
 
+/* host has no cycle counter, count nanoseconds instead */
+static inline uint32_t arch_timer_get_ccount(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
 #endif
@@ -32,6 +32,7 @@
 #include <arch/wait.h>
 #include <sof/trace.h>
 #include <sof/io.h>
+#include <sof/lz.h>
 #include <uapi/user/manifest.h>
 #include <platform/platform.h>
 #include <platform/memory.h>
@@ -74,6 +75,41 @@ static inline void bbzero(void *dest, size_t bytes)
 	dcache_writeback_region(dest, bytes);
 }
 
+/* decode compressed segment one chunk at a time */
+static inline void bdecompress(void *dest, void *src, size_t bytes)
+{
+	struct sof_man_lz_header *lz = src;
+	uint8_t *in = (uint8_t *)(lz + 1);
+	uint32_t in_left = lz->size;
+	uint32_t used;
+	struct lz_dec dec;
+	void *chunk;
+	int ret;
+
+	if (lz->magic != SOF_MAN_LZ_MAGIC || lz->data_size > bytes) {
+		platform_panic(SOF_IPC_PANIC_MEM);
+		return;
+	}
+
+	lz_dec_init(&dec, dest, lz->data_size);
+
+	while (!lz_dec_done(&dec)) {
+		chunk = (uint8_t *)dest + dec.out_pos;
+		ret = lz_dec_run(&dec, in, in_left, &used, HOST_PAGE_SIZE);
+		if (ret < 0 || (!ret && !used)) {
+			platform_panic(SOF_IPC_PANIC_MEM);
+			return;
+		}
+
+		dcache_writeback_region(chunk, ret);
+		in += used;
+		in_left -= used;
+	}
+
+	/* clear the tail of the last page */
+	bbzero((uint8_t *)dest + lz->data_size, bytes - lz->data_size);
+}
+
 static void parse_module(struct sof_man_fw_header *hdr,
 	struct sof_man_module *mod)
 {
@@ -90,10 +126,17 @@ static void parse_module(struct sof_man_fw_header *hdr,
 			bias = (mod->segment[i].file_offset -
 				SOF_MAN_ELF_TEXT_OFFSET);
 
-			/* copy from IMR to SRAM */
-			bmemcpy((void *)mod->segment[i].v_base_addr,
-				(void *)((int)hdr + bias),
-				mod->segment[i].flags.r.length * HOST_PAGE_SIZE);
+			/* copy or decode from IMR to SRAM */
+			if (mod->segment[i].flags.r.compressed)
+				bdecompress((void *)mod->segment[i].v_base_addr,
+					    (void *)((int)hdr + bias),
+					    mod->segment[i].flags.r.length *
+					    HOST_PAGE_SIZE);
+			else
+				bmemcpy((void *)mod->segment[i].v_base_addr,
+					(void *)((int)hdr + bias),
+					mod->segment[i].flags.r.length *
+					HOST_PAGE_SIZE);
 			break;
 		case SOF_MAN_SEGMENT_BSS:
 			/* copy from IMR to SRAM */
@@ -87,4 +87,10 @@ static inline void arch_timer_clear(struct timer *timer)
 	arch_interrupt_clear(timer->irq);
 }
 
+/* core clock cycle counter */
+static inline uint32_t arch_timer_get_ccount(void)
+{
+	return xthal_get_ccount();
+}
+
 #endif
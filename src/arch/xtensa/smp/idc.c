@@ -38,11 +38,15 @@
 #include <sof/ipc.h>
 #include <sof/lock.h>
 #include <sof/notifier.h>
+#include <sof/audio/pipeline.h>
 
 #include <arch/idc.h>
 
 extern struct ipc *_ipc;
 
+/** \brief Message rings in shared memory, indexed by sender and receiver. */
+static struct idc_ring idc_rings[PLATFORM_CORE_COUNT][PLATFORM_CORE_COUNT];
+
 /**
  * \brief Returns IDC data.
  * \return Pointer to pointer of IDC data.
@@ -66,6 +70,36 @@ void idc_enable_interrupts(int target_core, int source_core)
 	platform_interrupt_unmask(PLATFORM_IDC_INTERRUPT(target_core), 0);
 }
 
+/**
+ * \brief Runs completion callbacks of messages finished by target core.
+ * \param[in,out] idc Pointer to IDC data of the sender.
+ * \param[in] target Target core id.
+ */
+static void idc_ring_complete(struct idc *idc, int target)
+{
+	struct idc_ring *ring = &idc_rings[arch_cpu_get_id()][target];
+	struct idc_ring_slot *slot;
+	struct idc_ring_cb *cb;
+	uint32_t done = idc->ring_done[target];
+
+	dcache_invalidate_region(&ring->tail, sizeof(ring->tail));
+
+	while (done != ring->tail) {
+		slot = &ring->slots[done % IDC_RING_SIZE];
+		cb = &idc->ring_cb[target][done % IDC_RING_SIZE];
+
+		dcache_invalidate_region(slot, sizeof(*slot));
+
+		if (cb->cb)
+			cb->cb(cb->cb_data, slot->ret);
+		cb->cb = NULL;
+
+		done++;
+	}
+
+	idc->ring_done[target] = done;
+}
+
 /**
  * \brief IDC interrupt handler.
  * \param[in,out] arg Pointer to IDC data.
@@ -113,13 +147,94 @@ static void idc_irq_handler(void *arg)
 			idc_write(IPC_IDCIETC(i), core,
 				  idcietc | IPC_IDCIETC_DONE);
 
-			break;
+			spin_lock(&idc->lock);
+			idc_ring_complete(idc, i);
+			spin_unlock(&idc->lock);
 		}
 	}
 }
 
+/**
+ * \brief Sends IDC message directly through the doorbell registers.
+ * \param[in,out] idc Pointer to IDC data.
+ * \param[in,out] msg Pointer to IDC message.
+ */
+static void idc_send_raw(struct idc *idc, struct idc_msg *msg)
+{
+	int core = arch_cpu_get_id();
+	uint32_t flags;
+
+	spin_lock_irq(&idc->lock, flags);
+
+	idc_write(IPC_IDCIETC(msg->core), core, msg->extension);
+	idc_write(IPC_IDCITC(msg->core), core, msg->header | IPC_IDCITC_BUSY);
+
+	spin_unlock_irq(&idc->lock, flags);
+}
+
+/** \brief Completion of a blocking message, accessed under IDC lock. */
+struct idc_wait {
+	int done;	/**< set when target completed the message */
+	int ret;	/**< result of the message */
+};
+
+static void idc_wait_cb(void *cb_data, int ret)
+{
+	struct idc_wait *wait = cb_data;
+
+	wait->ret = ret;
+	wait->done = 1;
+}
+
+/**
+ * \brief Waits for completion of a queued message with interrupts enabled.
+ * \param[in,out] idc Pointer to IDC data.
+ * \param[in] target Target core id.
+ * \param[in] seq Ring position of the message.
+ * \param[in,out] wait Completion of the message.
+ * \return Error code.
+ */
+static int idc_ring_wait(struct idc *idc, int target, uint32_t seq,
+			 struct idc_wait *wait)
+{
+	uint32_t timeout = 0;
+	uint32_t flags;
+	int done;
+
+	do {
+		idelay(PLATFORM_DEFAULT_DELAY);
+		timeout += PLATFORM_DEFAULT_DELAY;
+
+		spin_lock_irq(&idc->lock, flags);
+
+		idc_ring_complete(idc, target);
+		done = wait->done;
+
+		/* late completion must not touch the waiter stack */
+		if (!done && timeout >= IDC_TIMEOUT)
+			idc->ring_cb[target][seq % IDC_RING_SIZE].cb = NULL;
+
+		spin_unlock_irq(&idc->lock, flags);
+	} while (!done && timeout < IDC_TIMEOUT);
+
+	if (!done) {
+		trace_idc_error("arch_idc_send_msg() error: timeout");
+		return -ETIME;
+	}
+
+	return wait->ret;
+}
+
 /**
  * \brief Sends IDC message.
+ *
+ * Messages are queued in the ring of the core pair and a doorbell is only
+ * rung when the target has no doorbell pending, so messages queued before
+ * the target drains the ring are batched. Non-blocking messages return once
+ * queued and report completion through their callback. Blocking messages
+ * wait for the target result without holding the lock or masking
+ * interrupts.
+ *
  * \param[in,out] msg Pointer to IDC message.
  * \param[in] mode Is message blocking or not.
  * \return Error code.
@@ -128,35 +243,77 @@ int arch_idc_send_msg(struct idc_msg *msg, uint32_t mode)
 {
 	struct idc *idc = *idc_get();
 	int core = arch_cpu_get_id();
-	int ret = 0;
-	uint32_t timeout = 0;
-	uint32_t idcietc;
+	struct idc_ring *ring = &idc_rings[core][msg->core];
+	struct idc_ring_slot *slot;
+	struct idc_ring_cb *cb;
+	struct idc_wait wait = { 0 };
+	uint32_t seq;
 	uint32_t flags;
 
 	tracev_idc("arch_idc_send_msg()");
 
+	/* power messages are handled by ROM or never complete */
+	if (iTS(msg->header) == iTS(IDC_MSG_POWER_UP) ||
+	    iTS(msg->header) == iTS(IDC_MSG_POWER_DOWN)) {
+		idc_send_raw(idc, msg);
+		return 0;
+	}
+
+	if (msg->data_size > IDC_MSG_DATA_SIZE) {
+		trace_idc_error("arch_idc_send_msg() error: data_size = %u",
+				msg->data_size);
+		return -EINVAL;
+	}
+
 	spin_lock_irq(&idc->lock, flags);
 
-	idc_write(IPC_IDCIETC(msg->core), core, msg->extension);
-	idc_write(IPC_IDCITC(msg->core), core, msg->header | IPC_IDCITC_BUSY);
+	/* free slots of completed messages */
+	idc_ring_complete(idc, msg->core);
 
+	seq = ring->head;
+	if (seq - idc->ring_done[msg->core] >= IDC_RING_SIZE) {
+		spin_unlock_irq(&idc->lock, flags);
+		trace_idc_error("arch_idc_send_msg() error: ring full, "
+				"core = %u", msg->core);
+		return -EBUSY;
+	}
+
+	slot = &ring->slots[seq % IDC_RING_SIZE];
+	slot->header = msg->header;
+	slot->extension = msg->extension;
+	slot->ret = 0;
+	slot->data_size = msg->data_size;
+	if (msg->data_size)
+		memcpy_s(slot->data, sizeof(slot->data), msg->data,
+			 msg->data_size);
+
+	cb = &idc->ring_cb[msg->core][seq % IDC_RING_SIZE];
 	if (mode == IDC_BLOCKING) {
-		do {
-			idelay(PLATFORM_DEFAULT_DELAY);
-			timeout += PLATFORM_DEFAULT_DELAY;
-			idcietc = idc_read(IPC_IDCIETC(msg->core), core);
-		} while (!(idcietc & IPC_IDCIETC_DONE) &&
-			 timeout < IDC_TIMEOUT);
-
-		if (timeout >= IDC_TIMEOUT) {
-			trace_idc_error("arch_idc_send_msg() error: timeout");
-			ret = -ETIME;
-		}
+		cb->cb = idc_wait_cb;
+		cb->cb_data = &wait;
+	} else {
+		cb->cb = msg->cb;
+		cb->cb_data = msg->cb_data;
+	}
+
+	/* message must reach memory before the new head does */
+	dcache_writeback_region(slot, sizeof(*slot));
+	ring->head = seq + 1;
+	dcache_writeback_region(&ring->head, sizeof(ring->head));
+
+	/* pending doorbell already covers this message */
+	if (!(idc_read(IPC_IDCITC(msg->core), core) & IPC_IDCITC_BUSY)) {
+		idc_write(IPC_IDCIETC(msg->core), core, IDC_MSG_RING_EXT);
+		idc_write(IPC_IDCITC(msg->core), core,
+			  IDC_MSG_RING | IPC_IDCITC_BUSY);
 	}
 
 	spin_unlock_irq(&idc->lock, flags);
 
-	return ret;
+	if (mode == IDC_BLOCKING)
+		return idc_ring_wait(idc, msg->core, seq, &wait);
+
+	return 0;
 }
 
 /**
@@ -232,30 +389,121 @@ static int idc_component_command(uint32_t cmd)
 	return ret;
 }
 
+/**
+ * \brief Executes IDC notify message.
+ * \param[in,out] msg Pointer to IDC message.
+ * \return Error code.
+ */
+static int idc_notify(struct idc_msg *msg)
+{
+	struct notify_data *notify_data = msg->data;
+
+	if (msg->data_size < sizeof(*notify_data))
+		return -EINVAL;
+
+	/* event data is copied behind the notify data if it fitted */
+	if (msg->data_size > sizeof(*notify_data))
+		notify_data->data = notify_data + 1;
+	else if (notify_data->data_size)
+		dcache_invalidate_region(notify_data->data,
+					 notify_data->data_size);
+
+	notifier_notify(notify_data);
+
+	return 0;
+}
+
+/**
+ * \brief Executes IDC bulk control update message.
+ * \param[in,out] msg Pointer to IDC message.
+ * \return Error code.
+ */
+static int idc_ctrl_bulk(struct idc_msg *msg)
+{
+	struct pipeline_ctrl_bulk *bulk;
+	struct pipeline_ctrl_bulk *copy;
+	struct pipeline *p;
+
+	if (msg->data_size != sizeof(bulk))
+		return -EINVAL;
+
+	/* the sender frees its bulk when the message completes */
+	bulk = *(struct pipeline_ctrl_bulk **)msg->data;
+	dcache_invalidate_region(bulk, sizeof(*bulk));
+	dcache_invalidate_region(bulk, bulk->size);
+
+	/* check whether we are executing from the right core */
+	p = bulk->update[0].dev->pipeline;
+	if (arch_cpu_get_id() != p->ipc_pipe.core)
+		return -EINVAL;
+
+	copy = rmalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM, bulk->size);
+	if (!copy)
+		return -ENOMEM;
+
+	assert(!memcpy_s(copy, bulk->size, bulk, bulk->size));
+
+	return pipeline_ctrl_bulk_queue(p, copy);
+}
+
 /**
  * \brief Executes IDC message based on type.
  * \param[in,out] msg Pointer to IDC message.
+ * \return Error code.
  */
-static void idc_cmd(struct idc_msg *msg)
+static int idc_cmd(struct idc_msg *msg)
 {
 	uint32_t type = iTS(msg->header);
 
 	switch (type) {
 	case iTS(IDC_MSG_POWER_DOWN):
 		cpu_power_down_core();
-		break;
+		return 0;
 	case iTS(IDC_MSG_PPL_TRIGGER):
-		idc_pipeline_trigger(msg->extension);
-		break;
+		return idc_pipeline_trigger(msg->extension);
 	case iTS(IDC_MSG_COMP_CMD):
-		idc_component_command(msg->extension);
-		break;
+		return idc_component_command(msg->extension);
 	case iTS(IDC_MSG_NOTIFY):
-		notifier_notify();
-		break;
+		return idc_notify(msg);
+	case iTS(IDC_MSG_CTRL_BULK):
+		return idc_ctrl_bulk(msg);
 	default:
 		trace_idc_error("idc_cmd() error: invalid msg->header = %u",
 				msg->header);
+		return -EINVAL;
+	}
+}
+
+/**
+ * \brief Executes messages queued by initiator core.
+ * \param[in] initiator Initiator core id.
+ */
+static void idc_ring_drain(int initiator)
+{
+	struct idc_ring *ring = &idc_rings[initiator][arch_cpu_get_id()];
+	struct idc_ring_slot *slot;
+	struct idc_msg msg;
+
+	dcache_invalidate_region(&ring->head, sizeof(ring->head));
+
+	while (ring->tail != ring->head) {
+		slot = &ring->slots[ring->tail % IDC_RING_SIZE];
+		dcache_invalidate_region(slot, sizeof(*slot));
+
+		msg.header = slot->header;
+		msg.extension = slot->extension;
+		msg.core = initiator;
+		msg.data = slot->data;
+		msg.data_size = slot->data_size;
+
+		slot->ret = idc_cmd(&msg);
+
+		/* result must reach memory before the new tail does */
+		dcache_writeback_region(slot, sizeof(*slot));
+		ring->tail++;
+		dcache_writeback_region(&ring->tail, sizeof(ring->tail));
+
+		dcache_invalidate_region(&ring->head, sizeof(ring->head));
 	}
 }
 
@@ -268,15 +516,23 @@ static uint64_t idc_do_cmd(void *data)
 	struct idc *idc = data;
 	int core = arch_cpu_get_id();
 	int initiator = idc->received_msg.core;
+	int ring = iTS(idc->received_msg.header) == iTS(IDC_MSG_RING);
 
 	trace_idc("idc_do_cmd()");
 
-	idc_cmd(&idc->received_msg);
+	if (ring)
+		idc_ring_drain(initiator);
+	else
+		idc_cmd(&idc->received_msg);
 
 	/* clear BUSY bit */
 	idc_write(IPC_IDCTFC(initiator), core,
 		  idc_read(IPC_IDCTFC(initiator), core) | IPC_IDCTFC_BUSY);
 
+	/* messages queued while BUSY was still set came without doorbell */
+	if (ring)
+		idc_ring_drain(initiator);
+
 	/* enable BUSY interrupt */
 	idc_write(IPC_IDCCTL, core, idc->busy_bit_mask | idc->done_bit_mask);
 
@@ -293,13 +549,10 @@ static uint32_t idc_get_busy_bit_mask(int core)
 	uint32_t busy_mask = 0;
 	int i;
 
-	if (core == PLATFORM_MASTER_CORE_ID) {
-		for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
-			if (i != PLATFORM_MASTER_CORE_ID)
-				busy_mask |= IPC_IDCCTL_IDCTBIE(i);
-		}
-	} else {
-		busy_mask = IPC_IDCCTL_IDCTBIE(PLATFORM_MASTER_CORE_ID);
+	/* every core pair has its own message ring */
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		if (i != core)
+			busy_mask |= IPC_IDCCTL_IDCTBIE(i);
 	}
 
 	return busy_mask;
@@ -315,13 +568,10 @@ static uint32_t idc_get_done_bit_mask(int core)
 	uint32_t done_mask = 0;
 	int i;
 
-	if (core == PLATFORM_MASTER_CORE_ID) {
-		for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
-			if (i != PLATFORM_MASTER_CORE_ID)
-				done_mask |= IPC_IDCCTL_IDCIDIE(i);
-		}
-	} else {
-		done_mask = 0;
+	/* completions of queued messages are run on DONE */
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		if (i != core)
+			done_mask |= IPC_IDCCTL_IDCIDIE(i);
 	}
 
 	return done_mask;
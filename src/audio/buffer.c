@@ -32,6 +32,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <errno.h>
+#include <config.h>
 #include <sof/sof.h>
 #include <sof/lock.h>
 #include <sof/list.h>
@@ -44,9 +45,14 @@
 #include <sof/audio/component.h>
 #include <sof/audio/pipeline.h>
 #include <sof/audio/buffer.h>
+#include <sof/audio/format.h>
 
-/* create a new component in the pipeline */
-struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc)
+/* frames faded out before and in after a concealed xrun */
+#define BUFFER_FADE_FRAMES	64
+
+/* create a new buffer, audio memory is allocated unless addr is given */
+static struct comp_buffer *buffer_alloc(struct sof_ipc_buffer *desc,
+					void *addr)
 {
 	struct comp_buffer *buffer;
 	int err;
@@ -68,7 +74,9 @@ struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc)
 		return NULL;
 	}
 
-	buffer->addr = rballoc(RZONE_BUFFER, desc->caps, desc->size);
+	buffer->pool = addr != NULL;
+	buffer->addr = addr ? addr :
+		rballoc(RZONE_BUFFER, desc->caps, desc->size);
 	if (!buffer->addr) {
 		rfree(buffer);
 		trace_buffer_error("buffer_new() error: "
@@ -94,6 +102,9 @@ struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc)
 	buffer->w_ptr = buffer->addr;
 	buffer->r_ptr = buffer->addr;
 	buffer->end_addr = buffer->addr + buffer->ipc_buffer.size;
+	buffer->layout = SOF_IPC_BUFFER_INTERLEAVED;
+	buffer->planes = 1;
+	buffer->plane_size = buffer->ipc_buffer.size;
 	buffer->free = buffer->ipc_buffer.size;
 	buffer->avail = 0;
 
@@ -104,6 +115,18 @@ struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc)
 	return buffer;
 }
 
+/* create a new component in the pipeline */
+struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc)
+{
+	return buffer_alloc(desc, NULL);
+}
+
+/* create a new component using audio memory of a buffer pool at addr */
+struct comp_buffer *buffer_new_pool(struct sof_ipc_buffer *desc, void *addr)
+{
+	return buffer_alloc(desc, addr);
+}
+
 /* free component in the pipeline */
 void buffer_free(struct comp_buffer *buffer)
 {
@@ -111,15 +134,288 @@ void buffer_free(struct comp_buffer *buffer)
 
 	list_item_del(&buffer->source_list);
 	list_item_del(&buffer->sink_list);
-	rfree(buffer->addr);
+	if (!buffer->pool)
+		rfree(buffer->addr);
 	rfree(buffer);
 }
 
+/* bytes of all channels from read position to write position */
+static uint32_t buffer_pos_diff(struct comp_buffer *buffer, void *from,
+				void *to)
+{
+	if (from < to)
+		return (to - from) * buffer->planes;
+
+	return buffer->size - (from - to) * buffer->planes;
+}
+
+/* run cache operation on bytes of all channels starting at ptr */
+static void buffer_cache_op(struct comp_buffer *buffer, void *ptr,
+			    uint32_t bytes,
+			    void (*op)(void *addr, size_t size))
+{
+	uint32_t plane_bytes = bytes / buffer->planes;
+	uint32_t head = plane_bytes;
+	uint32_t tail = 0;
+	uint32_t offset;
+	uint32_t i;
+
+	/* calculate head and tail size for dcache circular wrap ops */
+	if (ptr + plane_bytes > buffer->end_addr) {
+		head = buffer->end_addr - ptr;
+		tail = plane_bytes - head;
+	}
+
+	for (i = 0; i < buffer->planes; i++) {
+		offset = i * buffer->plane_size;
+		op(ptr + offset, head);
+		if (tail)
+			op(buffer->addr + offset, tail);
+	}
+}
+
+/*
+ * Cross-core buffers have a single producer and a single consumer running on
+ * different cores. Each side only writes its own position cache line and
+ * reads the other one after invalidating it, so no lock is shared between
+ * the cores. Free running byte counters keep a full buffer distinguishable
+ * from an empty one.
+ */
+#define BUFFER_PRODUCER_SIZE			\
+	(offsetof(struct comp_buffer, r_ptr) -	\
+	 offsetof(struct comp_buffer, w_ptr))
+#define BUFFER_CONSUMER_SIZE			\
+	(offsetof(struct comp_buffer, size) -	\
+	 offsetof(struct comp_buffer, r_ptr))
+
+void buffer_xcore_producer_sync(struct comp_buffer *buffer)
+{
+	dcache_invalidate_region(&buffer->r_ptr, BUFFER_CONSUMER_SIZE);
+
+	buffer->free = buffer->size - (buffer->produced - buffer->consumed);
+}
+
+void buffer_xcore_consumer_sync(struct comp_buffer *buffer)
+{
+	uint32_t avail;
+
+	dcache_invalidate_region(&buffer->w_ptr, BUFFER_PRODUCER_SIZE);
+
+	avail = buffer->produced - buffer->consumed;
+
+	/* drop stale lines of data produced since the last sync */
+	if (avail > buffer->avail && !buffer->sink->is_dma_connected)
+		buffer_cache_op(buffer, buffer_pos_add(buffer, buffer->r_ptr,
+						       buffer->avail),
+				avail - buffer->avail,
+				&dcache_invalidate_region);
+
+	buffer->avail = avail;
+}
+
+static void buffer_xcore_produce(struct comp_buffer *buffer, uint32_t bytes)
+{
+	/* data must reach memory before the new position does */
+	if (!buffer->source->is_dma_connected)
+		buffer_cache_op(buffer, buffer->w_ptr, bytes,
+				&dcache_writeback_region);
+
+	buffer->w_ptr = buffer_pos_add(buffer, buffer->w_ptr, bytes);
+	buffer->produced += bytes;
+	dcache_writeback_region(&buffer->w_ptr, BUFFER_PRODUCER_SIZE);
+
+	buffer_xcore_producer_sync(buffer);
+
+	if (buffer->cb && buffer->cb_type & BUFF_CB_TYPE_PRODUCE)
+		buffer->cb(buffer->cb_data, bytes);
+}
+
+static void buffer_xcore_consume(struct comp_buffer *buffer, uint32_t bytes)
+{
+	buffer->r_ptr = buffer_pos_add(buffer, buffer->r_ptr, bytes);
+	buffer->consumed += bytes;
+	buffer->avail -= bytes;
+	dcache_writeback_region(&buffer->r_ptr, BUFFER_CONSUMER_SIZE);
+
+	buffer_xcore_consumer_sync(buffer);
+
+	if (buffer->cb && buffer->cb_type & BUFF_CB_TYPE_CONSUME)
+		buffer->cb(buffer->cb_data, bytes);
+}
+
+/* frames of bytes to fade, limited to the fade length */
+static uint32_t buffer_fade_frames(struct comp_buffer *buffer, uint32_t bytes)
+{
+	uint32_t frame_bytes = comp_frame_bytes(buffer->source);
+
+	if (!frame_bytes)
+		return 0;
+
+	return MIN(bytes / frame_bytes, BUFFER_FADE_FRAMES);
+}
+
+/* scale sample idx from ptr by Q1.15 gain */
+static void buffer_fade_sample(struct comp_buffer *buffer, void *ptr,
+			       uint32_t idx, int32_t gain)
+{
+	int16_t *s16;
+	int32_t *s32;
+#if CONFIG_FORMAT_FLOAT
+	float *f;
+#endif
+
+	switch (buffer->source->params.frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		s16 = buffer_get_frag(buffer, ptr, idx, sizeof(int16_t));
+		*s16 = (gain * *s16) >> 15;
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		s32 = buffer_get_frag(buffer, ptr, idx, sizeof(int32_t));
+		*s32 = ((int64_t)sign_extend_s24(*s32) * gain) >> 15;
+		break;
+	case SOF_IPC_FRAME_S32_LE:
+		s32 = buffer_get_frag(buffer, ptr, idx, sizeof(int32_t));
+		*s32 = ((int64_t)gain * *s32) >> 15;
+		break;
+#if CONFIG_FORMAT_FLOAT
+	case SOF_IPC_FRAME_FLOAT:
+		f = buffer_get_frag(buffer, ptr, idx, sizeof(float));
+		*f *= gain * (1.0f / 32768.0f);
+		break;
+#endif
+	default:
+		break;
+	}
+}
+
+/* apply a linear gain ramp to frames starting at ptr */
+static void buffer_fade(struct comp_buffer *buffer, void *ptr,
+			uint32_t frames, bool fade_in)
+{
+	uint32_t channels = buffer->source->params.channels;
+	uint32_t bytes = frames * comp_frame_bytes(buffer->source);
+	int32_t gain;
+	uint32_t i;
+	uint32_t j;
+
+	if (!frames)
+		return;
+
+	if (buffer->source->is_dma_connected)
+		buffer_cache_op(buffer, ptr, bytes, &dcache_invalidate_region);
+
+	for (i = 0; i < frames; i++) {
+		gain = (fade_in ? i : frames - 1 - i) * 32768 / frames;
+		for (j = 0; j < channels; j++)
+			buffer_fade_sample(buffer, ptr, i * channels + j, gain);
+	}
+
+	/* DMA and later cache invalidations must see the faded samples */
+	if (buffer->source->is_dma_connected ||
+	    buffer->sink->is_dma_connected)
+		buffer_cache_op(buffer, ptr, bytes, &dcache_writeback_region);
+}
+
+/* zero bytes of all channels starting at ptr */
+static void buffer_silence(struct comp_buffer *buffer, void *ptr,
+			   uint32_t bytes)
+{
+	uint32_t plane_bytes = bytes / buffer->planes;
+	uint32_t head = plane_bytes;
+	uint32_t tail = 0;
+	uint32_t offset;
+	uint32_t i;
+
+	if (ptr + plane_bytes > buffer->end_addr) {
+		head = buffer->end_addr - ptr;
+		tail = plane_bytes - head;
+	}
+
+	for (i = 0; i < buffer->planes; i++) {
+		offset = i * buffer->plane_size;
+		bzero(ptr + offset, head);
+		if (tail)
+			bzero(buffer->addr + offset, tail);
+	}
+
+	if (buffer->source->is_dma_connected ||
+	    buffer->sink->is_dma_connected)
+		buffer_cache_op(buffer, ptr, bytes, &dcache_writeback_region);
+}
+
+void buffer_conceal_underrun(struct comp_buffer *buffer, uint32_t bytes)
+{
+	uint32_t frames = buffer_fade_frames(buffer, buffer->avail);
+	uint32_t fade_bytes = frames * comp_frame_bytes(buffer->source);
+
+	trace_buffer("buffer_conceal_underrun(), buffer %u bytes %u",
+		     buffer->ipc_buffer.comp.id, bytes);
+
+	/* fade out the tail of the queued audio */
+	buffer_fade(buffer, buffer_pos_add(buffer, buffer->r_ptr,
+					   buffer->avail - fade_bytes),
+		    frames, false);
+
+	buffer_silence(buffer, buffer->w_ptr, bytes);
+	comp_update_buffer_produce(buffer, bytes);
+
+	buffer->fade_in = true;
+}
+
+void buffer_conceal_overrun(struct comp_buffer *buffer, uint32_t bytes)
+{
+	trace_buffer("buffer_conceal_overrun(), buffer %u bytes %u",
+		     buffer->ipc_buffer.comp.id, bytes);
+
+	comp_update_buffer_consume(buffer, bytes);
+
+	/* fade in the audio following the dropped bytes */
+	buffer_fade(buffer, buffer->r_ptr,
+		    buffer_fade_frames(buffer, buffer->avail), true);
+}
+
+/* move both positions past bytes the DMA already went through */
+static void buffer_skip(struct comp_buffer *buffer, uint32_t bytes)
+{
+	uint32_t flags;
+
+	spin_lock_irq(&buffer->lock, flags);
+
+	buffer->w_ptr = buffer_pos_add(buffer, buffer->w_ptr, bytes);
+	buffer->r_ptr = buffer_pos_add(buffer, buffer->r_ptr, bytes);
+
+	spin_unlock_irq(&buffer->lock, flags);
+}
+
+void buffer_conceal_dma_underrun(struct comp_buffer *buffer, uint32_t bytes)
+{
+	trace_buffer("buffer_conceal_dma_underrun(), buffer %u bytes %u",
+		     buffer->ipc_buffer.comp.id, bytes);
+
+	/* DMA played stale audio there, keep its next lap silent */
+	buffer_silence(buffer, buffer->w_ptr, bytes);
+	buffer_skip(buffer, bytes);
+
+	buffer->fade_in = true;
+}
+
+void buffer_conceal_dma_overrun(struct comp_buffer *buffer, uint32_t bytes)
+{
+	trace_buffer("buffer_conceal_dma_overrun(), buffer %u bytes %u",
+		     buffer->ipc_buffer.comp.id, bytes);
+
+	/* DMA replaced the oldest audio with the newest */
+	buffer_cache_op(buffer, buffer->w_ptr, bytes,
+			&dcache_invalidate_region);
+	buffer_skip(buffer, bytes);
+
+	buffer_fade(buffer, buffer->r_ptr,
+		    buffer_fade_frames(buffer, buffer->avail), true);
+}
+
 void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 {
 	uint32_t flags;
-	uint32_t head = bytes;
-	uint32_t tail = 0;
 
 	/* return if no bytes */
 	if (!bytes) {
@@ -128,14 +424,20 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 		return;
 	}
 
-	spin_lock_irq(&buffer->lock, flags);
+	/* audio resuming after a concealed underrun fades in */
+	if (buffer->fade_in) {
+		buffer->fade_in = false;
+		buffer_fade(buffer, buffer->w_ptr,
+			    buffer_fade_frames(buffer, bytes), true);
+	}
 
-	/* calculate head and tail size for dcache circular wrap ops */
-	if (buffer->w_ptr + bytes > buffer->end_addr) {
-		head = buffer->end_addr - buffer->w_ptr;
-		tail = bytes - head;
+	if (buffer->xcore) {
+		buffer_xcore_produce(buffer, bytes);
+		return;
 	}
 
+	spin_lock_irq(&buffer->lock, flags);
+
 	/*
 	 * new data produce, handle consistency for buffer and cache:
 	 * 1. source(DMA) --> buffer --> sink(non-DMA): invalidate cache.
@@ -146,30 +448,23 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 	if (buffer->source->is_dma_connected &&
 	    !buffer->sink->is_dma_connected) {
 		/* need invalidate cache for sink component to use */
-		dcache_invalidate_region(buffer->w_ptr, head);
-		if (tail)
-			dcache_invalidate_region(buffer->addr, tail);
+		buffer_cache_op(buffer, buffer->w_ptr, bytes,
+				&dcache_invalidate_region);
 	} else if (!buffer->source->is_dma_connected &&
 		   buffer->sink->is_dma_connected) {
 		/* need write back to memory for sink component to use */
-		dcache_writeback_region(buffer->w_ptr, head);
-		if (tail)
-			dcache_writeback_region(buffer->addr, tail);
+		buffer_cache_op(buffer, buffer->w_ptr, bytes,
+				&dcache_writeback_region);
 	}
 
-	buffer->w_ptr += bytes;
-
-	/* check for pointer wrap */
-	if (buffer->w_ptr >= buffer->end_addr)
-		buffer->w_ptr = buffer->addr + (buffer->w_ptr - buffer->end_addr);
+	buffer->w_ptr = buffer_pos_add(buffer, buffer->w_ptr, bytes);
 
 	/* calculate available bytes */
-	if (buffer->r_ptr < buffer->w_ptr)
-		buffer->avail = buffer->w_ptr - buffer->r_ptr;
-	else if (buffer->r_ptr == buffer->w_ptr)
+	if (buffer->r_ptr == buffer->w_ptr)
 		buffer->avail = buffer->size; /* full */
 	else
-		buffer->avail = buffer->size - (buffer->r_ptr - buffer->w_ptr);
+		buffer->avail = buffer_pos_diff(buffer, buffer->r_ptr,
+						buffer->w_ptr);
 
 	/* calculate free bytes */
 	buffer->free = buffer->size - buffer->avail;
@@ -201,29 +496,29 @@ void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
 		return;
 	}
 
-	spin_lock_irq(&buffer->lock, flags);
+	if (buffer->xcore) {
+		buffer_xcore_consume(buffer, bytes);
+		return;
+	}
 
-	buffer->r_ptr += bytes;
+	spin_lock_irq(&buffer->lock, flags);
 
-	/* check for pointer wrap */
-	if (buffer->r_ptr >= buffer->end_addr)
-		buffer->r_ptr = buffer->addr +
-			(buffer->r_ptr - buffer->end_addr);
+	buffer->r_ptr = buffer_pos_add(buffer, buffer->r_ptr, bytes);
 
 	/* calculate available bytes */
-	if (buffer->r_ptr < buffer->w_ptr)
-		buffer->avail = buffer->w_ptr - buffer->r_ptr;
-	else if (buffer->r_ptr == buffer->w_ptr)
+	if (buffer->r_ptr == buffer->w_ptr)
 		buffer->avail = 0; /* empty */
 	else
-		buffer->avail = buffer->size - (buffer->r_ptr - buffer->w_ptr);
+		buffer->avail = buffer_pos_diff(buffer, buffer->r_ptr,
+						buffer->w_ptr);
 
 	/* calculate free bytes */
 	buffer->free = buffer->size - buffer->avail;
 
 	if (buffer->sink->is_dma_connected &&
 	    !buffer->source->is_dma_connected)
-		dcache_writeback_region(buffer->r_ptr, bytes);
+		buffer_cache_op(buffer, buffer->r_ptr, bytes,
+				&dcache_writeback_region);
 
 	if (buffer->cb && buffer->cb_type & BUFF_CB_TYPE_CONSUME)
 		buffer->cb(buffer->cb_data, bytes);
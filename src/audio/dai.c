@@ -131,8 +131,11 @@ static void dai_buffer_process(struct comp_dev *dev, struct dma_sg_elem *next)
 			comp_underrun(dev, dd->dma_buffer, bytes, 0);
 		}
 
-		/* recalc available buffer space */
-		comp_update_buffer_consume(dd->dma_buffer, bytes);
+		/* recalc available buffer space, the pipeline task
+		 * conceals the rest of a short underrun
+		 */
+		comp_update_buffer_consume(dd->dma_buffer,
+					   MIN(bytes, dd->dma_buffer->avail));
 
 		buffer_ptr = dd->dma_buffer->r_ptr;
 	} else {
@@ -145,8 +148,11 @@ static void dai_buffer_process(struct comp_dev *dev, struct dma_sg_elem *next)
 			comp_overrun(dev, dd->dma_buffer, bytes, 0);
 		}
 
-		/* recalc available buffer space */
-		comp_update_buffer_produce(dd->dma_buffer, bytes);
+		/* recalc available buffer space, the pipeline task
+		 * conceals the rest of a short overrun
+		 */
+		comp_update_buffer_produce(dd->dma_buffer,
+					   MIN(bytes, dd->dma_buffer->free));
 
 		buffer_ptr = dd->dma_buffer->w_ptr;
 	}
@@ -231,12 +231,12 @@ static struct comp_dev *test_keyword_new(struct sof_ipc_comp *comp)
 		return NULL;
 	}
 
+	comp_set_drvdata(dev, cd);
+
 	/* using default processing function */
 	cd->detect_func = default_detect_test;
 
 	test_keyword_set_default_config(dev);
-
-	comp_set_drvdata(dev, cd);
 	dev->state = COMP_STATE_READY;
 	return dev;
 }
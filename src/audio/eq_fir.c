@@ -49,6 +49,12 @@
 #include "fir_hifi3.h"
 #endif
 
+#if FIR_X86
+#include "fir_x86.h"
+#endif
+
+#include "fir_float.h"
+
 #ifdef MODULE_TEST
 #include <stdio.h>
 #endif
@@ -74,6 +80,14 @@ struct comp_data {
 			    struct comp_buffer *source,
 			    struct comp_buffer *sink,
 			    int frames, int nch);
+#if CONFIG_FORMAT_FLOAT
+	/**< float filters state, shares the delay allocation */
+	struct fir_state_float fir_float[PLATFORM_MAX_CHANNELS];
+	void (*eq_fir_float_func)(struct fir_state_float fir[],
+				  struct comp_buffer *source,
+				  struct comp_buffer *sink,
+				  int frames, int nch);
+#endif
 };
 
 /* The optimized FIR functions variants need to be updated into function
@@ -118,6 +132,24 @@ static inline void set_s32_fir(struct comp_data *cd)
 	cd->eq_fir_func_even = eq_fir_2x_s32_hifiep;
 	cd->eq_fir_func = eq_fir_s32_hifiep;
 }
+#elif FIR_X86
+static inline void set_s16_fir(struct comp_data *cd)
+{
+	cd->eq_fir_func_even = eq_fir_s16_x86;
+	cd->eq_fir_func = eq_fir_s16_x86;
+}
+
+static inline void set_s24_fir(struct comp_data *cd)
+{
+	cd->eq_fir_func_even = eq_fir_s24_x86;
+	cd->eq_fir_func = eq_fir_s24_x86;
+}
+
+static inline void set_s32_fir(struct comp_data *cd)
+{
+	cd->eq_fir_func_even = eq_fir_s32_x86;
+	cd->eq_fir_func = eq_fir_s32_x86;
+}
 #else
 /* FIR_GENERIC */
 static inline void set_s16_fir(struct comp_data *cd)
@@ -156,6 +188,12 @@ static inline int set_fir_func(struct comp_dev *dev)
 		trace_eq("set_fir_func(), SOF_IPC_FRAME_S32_LE");
 		set_s32_fir(cd);
 		break;
+#if CONFIG_FORMAT_FLOAT
+	case SOF_IPC_FRAME_FLOAT:
+		trace_eq("set_fir_func(), SOF_IPC_FRAME_FLOAT");
+		cd->eq_fir_float_func = eq_fir_float;
+		break;
+#endif
 	default:
 		trace_eq_error("set_fir_func(), invalid frame_fmt");
 		return -EINVAL;
@@ -215,6 +253,9 @@ static inline int set_pass_func(struct comp_dev *dev)
 		break;
 	case SOF_IPC_FRAME_S24_4LE:
 	case SOF_IPC_FRAME_S32_LE:
+#if CONFIG_FORMAT_FLOAT
+	case SOF_IPC_FRAME_FLOAT:
+#endif
 		trace_eq("set_pass_func(), SOF_IPC_FRAME_S32_LE");
 		cd->eq_fir_func_even = eq_fir_s32_passthrough;
 		cd->eq_fir_func = eq_fir_s32_passthrough;
@@ -246,14 +287,53 @@ static void eq_fir_free_delaylines(struct comp_data *cd)
 	 * each FIR channel delay line to NULL.
 	 */
 	rfree(cd->fir_delay);
+	cd->fir_delay = NULL;
 	cd->fir_delay_size = 0;
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
 		fir[i].delay = NULL;
+#if CONFIG_FORMAT_FLOAT
+		cd->fir_float[i].delay = NULL;
+#endif
+	}
 }
 
-static int eq_fir_setup(struct comp_data *cd, int nch)
+static void eq_fir_reset_channel(struct comp_data *cd, int ch)
+{
+	fir_reset(&cd->fir[ch]);
+#if CONFIG_FORMAT_FLOAT
+	fir_float_reset(&cd->fir_float[ch]);
+#endif
+}
+
+static size_t eq_fir_init_coef(struct comp_data *cd, int ch,
+			       struct sof_eq_fir_coef_data *eq,
+			       uint32_t frame_fmt)
+{
+#if CONFIG_FORMAT_FLOAT
+	if (frame_fmt == SOF_IPC_FRAME_FLOAT)
+		return fir_float_init_coef(&cd->fir_float[ch], eq);
+#endif
+	return fir_init_coef(&cd->fir[ch], eq);
+}
+
+static void eq_fir_init_delay(struct comp_data *cd, int ch, int32_t **data,
+			      uint32_t frame_fmt)
+{
+#if CONFIG_FORMAT_FLOAT
+	float *fdata;
+
+	if (frame_fmt == SOF_IPC_FRAME_FLOAT) {
+		fdata = (float *)*data;
+		fir_float_init_delay(&cd->fir_float[ch], &fdata);
+		*data = (int32_t *)fdata;
+		return;
+	}
+#endif
+	fir_init_delay(&cd->fir[ch], data);
+}
+
+static int eq_fir_setup(struct comp_data *cd, int nch, uint32_t frame_fmt)
 {
-	struct fir_state_32x16 *fir = cd->fir;
 	struct sof_eq_fir_config *config = cd->config;
 	struct sof_eq_fir_coef_data *lookup[SOF_EQ_FIR_MAX_RESPONSES];
 	struct sof_eq_fir_coef_data *eq;
@@ -317,7 +397,7 @@ static int eq_fir_setup(struct comp_data *cd, int nch)
 			/* Initialize EQ channel to bypass and continue with
 			 * next channel response.
 			 */
-			fir_reset(&fir[i]);
+			eq_fir_reset_channel(cd, i);
 			continue;
 		}
 
@@ -326,7 +406,7 @@ static int eq_fir_setup(struct comp_data *cd, int nch)
 
 		/* Initialize EQ coefficients. */
 		eq = lookup[resp];
-		s = fir_init_coef(&fir[i], eq);
+		s = eq_fir_init_coef(cd, i, eq, frame_fmt);
 		if (s > 0)
 			size_sum += s;
 		else
@@ -357,7 +437,7 @@ static int eq_fir_setup(struct comp_data *cd, int nch)
 	for (i = 0; i < nch; i++) {
 		resp = assign_response[i];
 		if (resp >= 0) {
-			fir_init_delay(&fir[i], &fir_delay);
+			eq_fir_init_delay(cd, i, &fir_delay, frame_fmt);
 		}
 	}
 
@@ -426,6 +506,11 @@ static struct comp_dev *eq_fir_new(struct sof_ipc_comp *comp)
 
 	comp_set_drvdata(dev, cd);
 
+#if FIR_GENERIC || FIR_X86
+	/* the kernels walk one channel at a time */
+	dev->layout = SOF_IPC_BUFFER_NONINTERLEAVED;
+#endif
+
 	cd->eq_fir_func_even = eq_fir_s32_passthrough;
 	cd->eq_fir_func = eq_fir_s32_passthrough;
 	cd->config = NULL;
@@ -451,7 +536,7 @@ static struct comp_dev *eq_fir_new(struct sof_ipc_comp *comp)
 	}
 
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		fir_reset(&cd->fir[i]);
+		eq_fir_reset_channel(cd, i);
 
 	dev->state = COMP_STATE_READY;
 	return dev;
@@ -669,14 +754,38 @@ static int eq_fir_trigger(struct comp_dev *dev, int cmd)
 	return comp_set_state(dev, cmd);
 }
 
+/* process stream data from source to sink, sink can be the same as source */
+static int eq_fir_process(struct comp_dev *dev, struct comp_buffer *source,
+			  struct comp_buffer *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct fir_state_32x16 *fir = cd->fir;
+	int nch = dev->params.channels;
+
+	tracev_comp("eq_fir_process()");
+
+#if CONFIG_FORMAT_FLOAT
+	if (cd->eq_fir_float_func) {
+		cd->eq_fir_float_func(cd->fir_float, source, sink, frames,
+				      nch);
+		return 0;
+	}
+#endif
+
+	/* Run EQ function */
+	if (frames & 1)
+		cd->eq_fir_func(fir, source, sink, frames, nch);
+	else
+		cd->eq_fir_func_even(fir, source, sink, frames, nch);
+
+	return 0;
+}
+
 /* copy and process stream data from source to sink buffers */
 static int eq_fir_copy(struct comp_dev *dev)
 {
 	struct comp_copy_limits cl;
-	struct comp_data *cd = comp_get_drvdata(dev);
 	int ret;
-	struct fir_state_32x16 *fir = cd->fir;
-	int nch = dev->params.channels;
 
 	tracev_comp("eq_fir_copy()");
 
@@ -687,11 +796,7 @@ static int eq_fir_copy(struct comp_dev *dev)
 		return ret;
 	}
 
-	/* Run EQ function */
-	if (cl.frames & 1)
-		cd->eq_fir_func(fir, cl.source, cl.sink, cl.frames, nch);
-	else
-		cd->eq_fir_func_even(fir, cl.source, cl.sink, cl.frames, nch);
+	eq_fir_process(dev, cl.source, cl.sink, cl.frames);
 
 	/* calc new free and available */
 	comp_update_buffer_consume(cl.source, cl.source_bytes);
@@ -749,8 +854,12 @@ static int eq_fir_prepare(struct comp_dev *dev)
 	}
 
 	/* Initialize EQ */
+#if CONFIG_FORMAT_FLOAT
+	cd->eq_fir_float_func = NULL;
+#endif
 	if (cd->config) {
-		ret = eq_fir_setup(cd, dev->params.channels);
+		ret = eq_fir_setup(cd, dev->params.channels,
+				   dev->params.frame_fmt);
 		if (ret < 0) {
 			trace_eq_error("eq_fir_prepare() error: "
 				       "eq_fir_setup failed.");
@@ -780,8 +889,11 @@ static int eq_fir_reset(struct comp_dev *dev)
 
 	cd->eq_fir_func_even = eq_fir_s32_passthrough;
 	cd->eq_fir_func = eq_fir_s32_passthrough;
+#if CONFIG_FORMAT_FLOAT
+	cd->eq_fir_float_func = NULL;
+#endif
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		fir_reset(&cd->fir[i]);
+		eq_fir_reset_channel(cd, i);
 
 	comp_set_state(dev, COMP_TRIGGER_RESET);
 	return 0;
@@ -838,6 +950,7 @@ struct comp_driver comp_eq_fir = {
 		.cmd = eq_fir_cmd,
 		.trigger = eq_fir_trigger,
 		.copy = eq_fir_copy,
+		.process = eq_fir_process,
 		.prepare = eq_fir_prepare,
 		.reset = eq_fir_reset,
 		.cache = eq_fir_cache,
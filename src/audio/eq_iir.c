@@ -44,6 +44,7 @@
 #include <uapi/user/eq.h>
 #include "eq_iir.h"
 #include "iir.h"
+#include "iir_float.h"
 
 #ifdef MODULE_TEST
 #include <stdio.h>
@@ -66,12 +67,17 @@ struct comp_data {
 			    struct comp_buffer *source,
 			    struct comp_buffer *sink,
 			    uint32_t frames);
+#if CONFIG_FORMAT_FLOAT
+	/**< float filters state, shares the delay allocation */
+	struct iir_state_float iir_float[PLATFORM_MAX_CHANNELS];
+#endif
 };
 
 /*
  * EQ IIR algorithm code
  */
 
+#if IIR_GENERIC
 static void eq_iir_s16_default(struct comp_dev *dev,
 			       struct comp_buffer *source,
 			       struct comp_buffer *sink,
@@ -80,23 +86,35 @@ static void eq_iir_s16_default(struct comp_dev *dev,
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct iir_state_df2t *filter;
-	int16_t *x;
-	int16_t *y;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int16_t *xp;
+	int16_t *yp;
 	int32_t z;
+	int left;
+	int n;
 	int ch;
 	int i;
-	int idx;
 	int nch = dev->params.channels;
 
 	for (ch = 0; ch < nch; ch++) {
 		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = buffer_read_frag_s16(source, idx);
-			y = buffer_write_frag_s16(sink, idx);
-			z = iir_df2t(filter, *x << 16);
-			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
-			idx += nch;
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(int16_t), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(int16_t), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				z = iir_df2t(filter, *xp << 16);
+				*yp = sat_int16(Q_SHIFT_RND(z, 31, 15));
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
 		}
 	}
 }
@@ -109,23 +127,35 @@ static void eq_iir_s24_default(struct comp_dev *dev,
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct iir_state_df2t *filter;
-	int32_t *x;
-	int32_t *y;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int32_t *xp;
+	int32_t *yp;
 	int32_t z;
-	int idx;
+	int left;
+	int n;
 	int ch;
 	int i;
 	int nch = dev->params.channels;
 
 	for (ch = 0; ch < nch; ch++) {
 		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = buffer_read_frag_s32(source, idx);
-			y = buffer_write_frag_s32(sink, idx);
-			z = iir_df2t(filter, *x << 8);
-			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
-			idx += nch;
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(int32_t), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(int32_t), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				z = iir_df2t(filter, *xp << 8);
+				*yp = sat_int24(Q_SHIFT_RND(z, 31, 23));
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
 		}
 	}
 }
@@ -138,21 +168,33 @@ static void eq_iir_s32_default(struct comp_dev *dev,
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct iir_state_df2t *filter;
-	int32_t *x;
-	int32_t *y;
-	int idx;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int32_t *xp;
+	int32_t *yp;
+	int left;
+	int n;
 	int ch;
 	int i;
 	int nch = dev->params.channels;
 
 	for (ch = 0; ch < nch; ch++) {
 		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = buffer_read_frag_s32(source, idx);
-			y = buffer_write_frag_s32(sink, idx);
-			*y = iir_df2t(filter, *x);
-			idx += nch;
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(int32_t), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(int32_t), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				*yp = iir_df2t(filter, *xp);
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
 		}
 	}
 }
@@ -165,23 +207,35 @@ static void eq_iir_s32_16_default(struct comp_dev *dev,
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct iir_state_df2t *filter;
-	int32_t *x;
-	int16_t *y;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int32_t *xp;
+	int16_t *yp;
 	int32_t z;
-	int idx;
+	int left;
+	int n;
 	int ch;
 	int i;
 	int nch = dev->params.channels;
 
 	for (ch = 0; ch < nch; ch++) {
 		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = buffer_read_frag_s32(source, idx);
-			y = buffer_write_frag_s16(sink, idx);
-			z = iir_df2t(filter, *x);
-			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
-			idx += nch;
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(int32_t), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(int16_t), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				z = iir_df2t(filter, *xp);
+				*yp = sat_int16(Q_SHIFT_RND(z, 31, 15));
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
 		}
 	}
 }
@@ -194,27 +248,191 @@ static void eq_iir_s32_24_default(struct comp_dev *dev,
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct iir_state_df2t *filter;
-	int32_t *x;
-	int32_t *y;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int32_t *xp;
+	int32_t *yp;
 	int32_t z;
-	int idx;
+	int left;
+	int n;
+	int ch;
+	int i;
+	int nch = dev->params.channels;
+
+	for (ch = 0; ch < nch; ch++) {
+		filter = &cd->iir[ch];
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(int32_t), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(int32_t), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				z = iir_df2t(filter, *xp);
+				*yp = sat_int24(Q_SHIFT_RND(z, 31, 23));
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
+		}
+	}
+}
+
+#endif
+
+#if IIR_X86
+/* Output sample conversions of the x86 processing functions */
+enum eq_iir_x86_out {
+	EQ_IIR_X86_S16,
+	EQ_IIR_X86_S24,
+	EQ_IIR_X86_S32,
+};
+
+static inline int32_t eq_iir_x86_read(const void *x, const int in_s16,
+				      const int in_shift)
+{
+	if (in_s16)
+		return *(const int16_t *)x << in_shift;
+
+	return *(const int32_t *)x << in_shift;
+}
+
+static inline void eq_iir_x86_write(void *y, int32_t z,
+				    const enum eq_iir_x86_out out)
+{
+	switch (out) {
+	case EQ_IIR_X86_S16:
+		*(int16_t *)y = sat_int16(Q_SHIFT_RND(z, 31, 15));
+		break;
+	case EQ_IIR_X86_S24:
+		*(int32_t *)y = sat_int24(Q_SHIFT_RND(z, 31, 23));
+		break;
+	default:
+		*(int32_t *)y = z;
+		break;
+	}
+}
+
+/* Same as the default functions but channels pairs with the same filter
+ * structure are processed together with iir_df2t_2x().
+ */
+static inline void eq_iir_x86(struct comp_dev *dev,
+			      struct comp_buffer *source,
+			      struct comp_buffer *sink,
+			      uint32_t frames, const int in_s16,
+			      const int in_shift,
+			      const enum eq_iir_x86_out out)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct iir_state_df2t *filter;
+	struct buffer_channel x0;
+	struct buffer_channel x1;
+	struct buffer_channel y0;
+	struct buffer_channel y1;
+	int in_bytes = in_s16 ? sizeof(int16_t) : sizeof(int32_t);
+	int out_bytes = out == EQ_IIR_X86_S16 ?
+		sizeof(int16_t) : sizeof(int32_t);
+	int32_t z0;
+	int32_t z1;
+	int left;
+	int n;
 	int ch;
 	int i;
 	int nch = dev->params.channels;
 
 	for (ch = 0; ch < nch; ch++) {
 		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = buffer_read_frag_s32(source, idx);
-			y = buffer_write_frag_s32(sink, idx);
-			z = iir_df2t(filter, *x);
-			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
-			idx += nch;
+		buffer_channel_init(source, source->r_ptr, ch, nch, in_bytes,
+				    &x0);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch, out_bytes,
+				    &y0);
+		if (ch + 1 < nch && filter[0].biquads &&
+		    filter[0].biquads == filter[1].biquads &&
+		    filter[0].biquads_in_series ==
+		    filter[1].biquads_in_series) {
+			buffer_channel_init(source, source->r_ptr, ch + 1, nch,
+					    in_bytes, &x1);
+			buffer_channel_init(sink, sink->w_ptr, ch + 1, nch,
+					    out_bytes, &y1);
+			for (left = frames; left; left -= n) {
+				n = buffer_channel_run(&x0, &y0, left);
+				n = buffer_channel_run(&x1, &y1, n);
+				for (i = 0; i < n; i++) {
+					z0 = eq_iir_x86_read(x0.ptr, in_s16,
+							     in_shift);
+					z1 = eq_iir_x86_read(x1.ptr, in_s16,
+							     in_shift);
+					iir_df2t_2x(&filter[0], &filter[1],
+						    &z0, &z1);
+					eq_iir_x86_write(y0.ptr, z0, out);
+					eq_iir_x86_write(y1.ptr, z1, out);
+					buffer_channel_advance(&x0, 1);
+					buffer_channel_advance(&x1, 1);
+					buffer_channel_advance(&y0, 1);
+					buffer_channel_advance(&y1, 1);
+				}
+			}
+			ch++;
+			continue;
+		}
+
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x0, &y0, left);
+			for (i = 0; i < n; i++) {
+				z0 = eq_iir_x86_read(x0.ptr, in_s16, in_shift);
+				eq_iir_x86_write(y0.ptr, iir_df2t(filter, z0),
+						 out);
+				buffer_channel_advance(&x0, 1);
+				buffer_channel_advance(&y0, 1);
+			}
 		}
 	}
 }
 
+static void eq_iir_s16_x86(struct comp_dev *dev,
+			   struct comp_buffer *source,
+			   struct comp_buffer *sink,
+			   uint32_t frames)
+{
+	eq_iir_x86(dev, source, sink, frames, 1, 16, EQ_IIR_X86_S16);
+}
+
+static void eq_iir_s24_x86(struct comp_dev *dev,
+			   struct comp_buffer *source,
+			   struct comp_buffer *sink,
+			   uint32_t frames)
+{
+	eq_iir_x86(dev, source, sink, frames, 0, 8, EQ_IIR_X86_S24);
+}
+
+static void eq_iir_s32_x86(struct comp_dev *dev,
+			   struct comp_buffer *source,
+			   struct comp_buffer *sink,
+			   uint32_t frames)
+{
+	eq_iir_x86(dev, source, sink, frames, 0, 0, EQ_IIR_X86_S32);
+}
+
+static void eq_iir_s32_16_x86(struct comp_dev *dev,
+			      struct comp_buffer *source,
+			      struct comp_buffer *sink,
+			      uint32_t frames)
+{
+	eq_iir_x86(dev, source, sink, frames, 0, 0, EQ_IIR_X86_S16);
+}
+
+static void eq_iir_s32_24_x86(struct comp_dev *dev,
+			      struct comp_buffer *source,
+			      struct comp_buffer *sink,
+			      uint32_t frames)
+{
+	eq_iir_x86(dev, source, sink, frames, 0, 0, EQ_IIR_X86_S24);
+}
+#endif
+
 static void eq_iir_s16_pass(struct comp_dev *dev,
 			    struct comp_buffer *source,
 			    struct comp_buffer *sink,
@@ -283,6 +501,182 @@ static void eq_iir_s32_s24_pass(struct comp_dev *dev,
 	}
 }
 
+#if CONFIG_FORMAT_FLOAT
+static inline float eq_iir_float_read(const void *x,
+				      const enum sof_ipc_frame fmt)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return s16_to_float(*(const int16_t *)x);
+	case SOF_IPC_FRAME_S24_4LE:
+		return s24_to_float(*(const int32_t *)x);
+	case SOF_IPC_FRAME_S32_LE:
+		return s32_to_float(*(const int32_t *)x);
+	default:
+		return *(const float *)x;
+	}
+}
+
+static inline void eq_iir_float_write(void *y, float z,
+				      const enum sof_ipc_frame fmt)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		*(int16_t *)y = float_to_s16(z);
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		*(int32_t *)y = float_to_s24(z);
+		break;
+	case SOF_IPC_FRAME_S32_LE:
+		*(int32_t *)y = float_to_s32(z);
+		break;
+	default:
+		*(float *)y = z;
+		break;
+	}
+}
+
+/* Float IIR, a fixed point source or sink is converted here so a float
+ * pipeline is requantized only at its boundaries.
+ */
+static inline void eq_iir_float(struct comp_dev *dev,
+				struct comp_buffer *source,
+				struct comp_buffer *sink,
+				uint32_t frames,
+				const enum sof_ipc_frame in_fmt,
+				const enum sof_ipc_frame out_fmt)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct iir_state_float *filter;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int in_bytes = in_fmt == SOF_IPC_FRAME_S16_LE ?
+		sizeof(int16_t) : sizeof(int32_t);
+	int out_bytes = out_fmt == SOF_IPC_FRAME_S16_LE ?
+		sizeof(int16_t) : sizeof(int32_t);
+	float z;
+	int left;
+	int n;
+	int ch;
+	int i;
+	int nch = dev->params.channels;
+
+	for (ch = 0; ch < nch; ch++) {
+		filter = &cd->iir_float[ch];
+		buffer_channel_init(source, source->r_ptr, ch, nch, in_bytes,
+				    &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch, out_bytes,
+				    &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			for (i = 0; i < n; i++) {
+				z = eq_iir_float_read(x.ptr, in_fmt);
+				eq_iir_float_write(y.ptr, iir_float(filter, z),
+						   out_fmt);
+				buffer_channel_advance(&x, 1);
+				buffer_channel_advance(&y, 1);
+			}
+		}
+	}
+}
+
+static void eq_iir_float_float(struct comp_dev *dev,
+			       struct comp_buffer *source,
+			       struct comp_buffer *sink,
+			       uint32_t frames)
+{
+	eq_iir_float(dev, source, sink, frames, SOF_IPC_FRAME_FLOAT,
+		     SOF_IPC_FRAME_FLOAT);
+}
+
+static void eq_iir_s16_float(struct comp_dev *dev,
+			     struct comp_buffer *source,
+			     struct comp_buffer *sink,
+			     uint32_t frames)
+{
+	eq_iir_float(dev, source, sink, frames, SOF_IPC_FRAME_S16_LE,
+		     SOF_IPC_FRAME_FLOAT);
+}
+
+static void eq_iir_s24_float(struct comp_dev *dev,
+			     struct comp_buffer *source,
+			     struct comp_buffer *sink,
+			     uint32_t frames)
+{
+	eq_iir_float(dev, source, sink, frames, SOF_IPC_FRAME_S24_4LE,
+		     SOF_IPC_FRAME_FLOAT);
+}
+
+static void eq_iir_s32_float(struct comp_dev *dev,
+			     struct comp_buffer *source,
+			     struct comp_buffer *sink,
+			     uint32_t frames)
+{
+	eq_iir_float(dev, source, sink, frames, SOF_IPC_FRAME_S32_LE,
+		     SOF_IPC_FRAME_FLOAT);
+}
+
+static void eq_iir_float_s16(struct comp_dev *dev,
+			     struct comp_buffer *source,
+			     struct comp_buffer *sink,
+			     uint32_t frames)
+{
+	eq_iir_float(dev, source, sink, frames, SOF_IPC_FRAME_FLOAT,
+		     SOF_IPC_FRAME_S16_LE);
+}
+
+static void eq_iir_float_s24(struct comp_dev *dev,
+			     struct comp_buffer *source,
+			     struct comp_buffer *sink,
+			     uint32_t frames)
+{
+	eq_iir_float(dev, source, sink, frames, SOF_IPC_FRAME_FLOAT,
+		     SOF_IPC_FRAME_S24_4LE);
+}
+
+static void eq_iir_float_s32(struct comp_dev *dev,
+			     struct comp_buffer *source,
+			     struct comp_buffer *sink,
+			     uint32_t frames)
+{
+	eq_iir_float(dev, source, sink, frames, SOF_IPC_FRAME_FLOAT,
+		     SOF_IPC_FRAME_S32_LE);
+}
+
+/* Float processing and conversion for both configured and pass-through
+ * modes, the float filters are in bypass when not configured.
+ */
+const struct eq_iir_func_map fm_float[] = {
+	{SOF_IPC_FRAME_FLOAT,   SOF_IPC_FRAME_FLOAT,   eq_iir_float_float},
+	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_FLOAT,   eq_iir_s16_float},
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_FLOAT,   eq_iir_s24_float},
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_FLOAT,   eq_iir_s32_float},
+	{SOF_IPC_FRAME_FLOAT,   SOF_IPC_FRAME_S16_LE,  eq_iir_float_s16},
+	{SOF_IPC_FRAME_FLOAT,   SOF_IPC_FRAME_S24_4LE, eq_iir_float_s24},
+	{SOF_IPC_FRAME_FLOAT,   SOF_IPC_FRAME_S32_LE,  eq_iir_float_s32},
+};
+
+/* float processing when either side of the EQ is float */
+static inline bool eq_iir_is_float(struct comp_data *cd)
+{
+	return cd->source_format == SOF_IPC_FRAME_FLOAT ||
+		cd->sink_format == SOF_IPC_FRAME_FLOAT;
+}
+#endif
+
+#if IIR_X86
+const struct eq_iir_func_map fm_configured[] = {
+	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_s16_x86},
+	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S24_4LE, NULL},
+	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S32_LE,  NULL},
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S16_LE,  NULL},
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, eq_iir_s24_x86},
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE,  NULL},
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_s32_16_x86},
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S24_4LE, eq_iir_s32_24_x86},
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S32_LE,  eq_iir_s32_x86},
+};
+#else
 const struct eq_iir_func_map fm_configured[] = {
 	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_s16_default},
 	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S24_4LE, NULL},
@@ -294,6 +688,7 @@ const struct eq_iir_func_map fm_configured[] = {
 	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S24_4LE, eq_iir_s32_24_default},
 	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S32_LE,  eq_iir_s32_default},
 };
+#endif
 
 const struct eq_iir_func_map fm_passthrough[] = {
 	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_s16_pass},
@@ -341,14 +736,52 @@ static void eq_iir_free_delaylines(struct comp_data *cd)
 	 * each IIR channel delay line to NULL.
 	 */
 	rfree(cd->iir_delay);
+	cd->iir_delay = NULL;
 	cd->iir_delay_size = 0;
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
 		iir[i].delay = NULL;
+#if CONFIG_FORMAT_FLOAT
+		cd->iir_float[i].delay = NULL;
+#endif
+	}
+}
+
+static void eq_iir_reset_channel(struct comp_data *cd, int ch)
+{
+	iir_reset_df2t(&cd->iir[ch]);
+#if CONFIG_FORMAT_FLOAT
+	iir_float_reset(&cd->iir_float[ch]);
+#endif
+}
+
+static size_t eq_iir_init_coef(struct comp_data *cd, int ch,
+			       struct sof_eq_iir_header_df2t *eq)
+{
+#if CONFIG_FORMAT_FLOAT
+	if (eq_iir_is_float(cd))
+		return iir_float_init_coef(&cd->iir_float[ch], eq);
+#endif
+	return iir_init_coef_df2t(&cd->iir[ch], eq);
+}
+
+static void eq_iir_init_delay(struct comp_data *cd, int ch, int64_t **delay)
+{
+#if CONFIG_FORMAT_FLOAT
+	float *data;
+
+	/* float state is a multiple of 8 bytes per biquad */
+	if (eq_iir_is_float(cd)) {
+		data = (float *)*delay;
+		iir_float_init_delay(&cd->iir_float[ch], &data);
+		*delay = (int64_t *)data;
+		return;
+	}
+#endif
+	iir_init_delay_df2t(&cd->iir[ch], delay);
 }
 
 static int eq_iir_setup(struct comp_data *cd, int nch)
 {
-	struct iir_state_df2t *iir = cd->iir;
 	struct sof_eq_iir_config *config = cd->config;
 	struct sof_eq_iir_header_df2t *lookup[SOF_EQ_IIR_MAX_RESPONSES];
 	struct sof_eq_iir_header_df2t *eq;
@@ -415,7 +848,7 @@ static int eq_iir_setup(struct comp_data *cd, int nch)
 			/* Initialize EQ channel to bypass and continue with
 			 * next channel response.
 			 */
-			iir_reset_df2t(&iir[i]);
+			eq_iir_reset_channel(cd, i);
 			continue;
 		}
 
@@ -424,7 +857,7 @@ static int eq_iir_setup(struct comp_data *cd, int nch)
 
 		/* Initialize EQ coefficients */
 		eq = lookup[resp];
-		s = iir_init_coef_df2t(&iir[i], eq);
+		s = eq_iir_init_coef(cd, i, eq);
 		if (s > 0)
 			size_sum += s;
 		else
@@ -453,7 +886,7 @@ static int eq_iir_setup(struct comp_data *cd, int nch)
 	for (i = 0; i < nch; i++) {
 		resp = assign_response[i];
 		if (resp >= 0)
-			iir_init_delay_df2t(&iir[i], &iir_delay);
+			eq_iir_init_delay(cd, i, &iir_delay);
 	}
 	return 0;
 }
@@ -520,6 +953,9 @@ static struct comp_dev *eq_iir_new(struct sof_ipc_comp *comp)
 
 	comp_set_drvdata(dev, cd);
 
+	/* the kernels walk one channel at a time */
+	dev->layout = SOF_IPC_BUFFER_NONINTERLEAVED;
+
 	cd->eq_iir_func = eq_iir_s32_pass;
 	cd->iir_delay = NULL;
 	cd->iir_delay_size = 0;
@@ -547,7 +983,7 @@ static struct comp_dev *eq_iir_new(struct sof_ipc_comp *comp)
 	}
 
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		iir_reset_df2t(&cd->iir[i]);
+		eq_iir_reset_channel(cd, i);
 
 	dev->state = COMP_STATE_READY;
 	return dev;
@@ -740,11 +1176,24 @@ static int eq_iir_trigger(struct comp_dev *dev, int cmd)
 	return comp_set_state(dev, cmd);
 }
 
+/* process stream data from source to sink, sink can be the same as source */
+static int eq_iir_process(struct comp_dev *dev, struct comp_buffer *source,
+			  struct comp_buffer *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	tracev_comp("eq_iir_process()");
+
+	/* Run EQ function */
+	cd->eq_iir_func(dev, source, sink, frames);
+
+	return 0;
+}
+
 /* copy and process stream data from source to sink buffers */
 static int eq_iir_copy(struct comp_dev *dev)
 {
 	struct comp_copy_limits cl;
-	struct comp_data *cd = comp_get_drvdata(dev);
 	int ret;
 
 	tracev_comp("eq_iir_copy()");
@@ -756,8 +1205,7 @@ static int eq_iir_copy(struct comp_dev *dev)
 		return ret;
 	}
 
-	/* Run EQ function */
-	cd->eq_iir_func(dev, cl.source, cl.sink, cl.frames);
+	eq_iir_process(dev, cl.source, cl.sink, cl.frames);
 
 	/* calc new free and available */
 	comp_update_buffer_consume(cl.source, cl.source_bytes);
@@ -775,6 +1223,9 @@ static int eq_iir_prepare(struct comp_dev *dev)
 	uint32_t source_period_bytes;
 	uint32_t sink_period_bytes;
 	int ret;
+#if CONFIG_FORMAT_FLOAT
+	int i;
+#endif
 
 	trace_eq("eq_iir_prepare()");
 
@@ -817,6 +1268,30 @@ static int eq_iir_prepare(struct comp_dev *dev)
 	/* Initialize EQ */
 	trace_eq("eq_iir_prepare(), source_format=%d, sink_format=%d",
 		 cd->source_format, cd->sink_format);
+#if CONFIG_FORMAT_FLOAT
+	if (eq_iir_is_float(cd)) {
+		for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
+			eq_iir_reset_channel(cd, i);
+
+		ret = cd->config ? eq_iir_setup(cd, dev->params.channels) : 0;
+		if (ret < 0) {
+			trace_eq_error("eq_iir_prepare() error: "
+				       "eq_iir_setup failed.");
+			goto err;
+		}
+		cd->eq_iir_func = eq_iir_find_func(cd, fm_float,
+						   ARRAY_SIZE(fm_float));
+		if (!cd->eq_iir_func) {
+			trace_eq_error("eq_iir_prepare() error: "
+				       "No float processing function.");
+			cd->eq_iir_func = eq_iir_s32_pass;
+			ret = -EINVAL;
+			goto err;
+		}
+		trace_eq("eq_iir_prepare(), float mode.");
+		return 0;
+	}
+#endif
 	if (cd->config) {
 		ret = eq_iir_setup(cd, dev->params.channels);
 		if (ret < 0) {
@@ -864,9 +1339,13 @@ static int eq_iir_reset(struct comp_dev *dev)
 
 	eq_iir_free_delaylines(cd);
 
+#if IIR_X86
+	cd->eq_iir_func = eq_iir_s32_x86;
+#else
 	cd->eq_iir_func = eq_iir_s32_default;
+#endif
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
-		iir_reset_df2t(&cd->iir[i]);
+		eq_iir_reset_channel(cd, i);
 
 	comp_set_state(dev, COMP_TRIGGER_RESET);
 	return 0;
@@ -924,6 +1403,7 @@ struct comp_driver comp_eq_iir = {
 		.cmd = eq_iir_cmd,
 		.trigger = eq_iir_trigger,
 		.copy = eq_iir_copy,
+		.process = eq_iir_process,
 		.prepare = eq_iir_prepare,
 		.reset = eq_iir_reset,
 		.cache = eq_iir_cache,
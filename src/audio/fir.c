@@ -85,22 +85,35 @@ void eq_fir_s16(struct fir_state_32x16 fir[], struct comp_buffer *source,
 		struct comp_buffer *sink, int frames, int nch)
 {
 	struct fir_state_32x16 *filter;
-	int16_t *x;
-	int16_t *y;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int16_t *xp;
+	int16_t *yp;
 	int32_t z;
-	int idx;
+	int left;
+	int n;
 	int ch;
 	int i;
 
+	/* one channel at a time, unit stride with planar buffers */
 	for (ch = 0; ch < nch; ch++) {
 		filter = &fir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = buffer_read_frag_s16(source, idx);
-			y = buffer_write_frag_s16(sink, idx);
-			z = fir_32x16(filter, *x << 16);
-			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
-			idx += nch;
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(int16_t), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(int16_t), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				z = fir_32x16(filter, *xp << 16);
+				*yp = sat_int16(Q_SHIFT_RND(z, 31, 15));
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
 		}
 	}
 }
@@ -109,22 +122,35 @@ void eq_fir_s24(struct fir_state_32x16 fir[], struct comp_buffer *source,
 		struct comp_buffer *sink, int frames, int nch)
 {
 	struct fir_state_32x16 *filter;
-	int32_t *x;
-	int32_t *y;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int32_t *xp;
+	int32_t *yp;
 	int32_t z;
-	int idx;
+	int left;
+	int n;
 	int ch;
 	int i;
 
+	/* one channel at a time, unit stride with planar buffers */
 	for (ch = 0; ch < nch; ch++) {
 		filter = &fir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = buffer_read_frag_s32(source, idx);
-			y = buffer_write_frag_s32(sink, idx);
-			z = fir_32x16(filter, *x << 8);
-			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
-			idx += nch;
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(int32_t), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(int32_t), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				z = fir_32x16(filter, *xp << 8);
+				*yp = sat_int24(Q_SHIFT_RND(z, 31, 23));
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
 		}
 	}
 }
@@ -133,20 +159,33 @@ void eq_fir_s32(struct fir_state_32x16 fir[], struct comp_buffer *source,
 		struct comp_buffer *sink, int frames, int nch)
 {
 	struct fir_state_32x16 *filter;
-	int32_t *x;
-	int32_t *y;
-	int idx;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int32_t *xp;
+	int32_t *yp;
+	int left;
+	int n;
 	int ch;
 	int i;
 
+	/* one channel at a time, unit stride with planar buffers */
 	for (ch = 0; ch < nch; ch++) {
 		filter = &fir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = buffer_read_frag_s32(source, idx);
-			y = buffer_write_frag_s32(sink, idx);
-			*y = fir_32x16(filter, *x);
-			idx += nch;
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(int32_t), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(int32_t), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				*yp = fir_32x16(filter, *xp);
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
 		}
 	}
 }
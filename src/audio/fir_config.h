@@ -48,6 +48,7 @@
 #define FIR_GENERIC	0
 #define FIR_HIFIEP	0
 #define FIR_HIFI3	1
+#define FIR_X86		0
 #endif
 
 /* Select optimized code variant when xt-xcc compiler is used */
@@ -55,6 +56,7 @@
 #if defined __XCC__
 #include <xtensa/config/core-isa.h>
 #define FIR_GENERIC	0
+#define FIR_X86		0
 #if XCHAL_HAVE_HIFI2EP == 1
 #define FIR_HIFIEP	1
 #define FIR_HIFI3	0
@@ -65,8 +67,14 @@
 #error "No HIFIEP or HIFI3 found. Cannot build FIR module."
 #endif
 #else
-/* GCC */
+/* GCC, use SSE4.2 and AVX2 code in x86 host builds */
+#if defined(__SSE4_2__)
+#define FIR_GENERIC	0
+#define FIR_X86		1
+#else
 #define FIR_GENERIC	1
+#define FIR_X86		0
+#endif
 #define FIR_HIFIEP	0
 #define FIR_HIFI3	0
 #endif
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <sof/audio/component.h>
+#include <uapi/user/eq.h>
+#include "fir_float.h"
+
+#if CONFIG_FORMAT_FLOAT
+
+void fir_float_reset(struct fir_state_float *fir)
+{
+	fir->rwi = 0;
+	fir->length = 0;
+	fir->out_shift = 0;
+	fir->coef_q15 = NULL;
+	fir->coef = NULL;
+	/* The beginning of the dynamic allocation is needed after reset so
+	 * fir->delay is not set to NULL.
+	 */
+}
+
+size_t fir_float_init_coef(struct fir_state_float *fir,
+			   struct sof_eq_fir_coef_data *config)
+{
+	fir->rwi = 0;
+	fir->length = (int)config->length;
+	fir->out_shift = (int)config->out_shift;
+	fir->coef_q15 = &config->coef[0];
+	fir->coef = NULL;
+	fir->delay = NULL;
+
+	if (fir->length > SOF_EQ_FIR_MAX_LENGTH || fir->length < 1)
+		return -EINVAL;
+
+	/* coefficients and a delay line of twice the length */
+	return 3 * fir->length * sizeof(float);
+}
+
+void fir_float_init_delay(struct fir_state_float *fir, float **data)
+{
+	float scale = 1.0f / ((int64_t)1 << (15 + fir->out_shift));
+	int i;
+
+	/* Q1.15 coefficients with the output shift folded in */
+	fir->coef = *data;
+	for (i = 0; i < fir->length; i++)
+		fir->coef[i] = fir->coef_q15[i] * scale;
+
+	fir->delay = fir->coef + fir->length;
+	for (i = 0; i < 2 * fir->length; i++)
+		fir->delay[i] = 0.0f;
+
+	*data += 3 * fir->length; /* Point to next FIR data start */
+}
+
+void eq_fir_float(struct fir_state_float fir[], struct comp_buffer *source,
+		  struct comp_buffer *sink, int frames, int nch)
+{
+	struct fir_state_float *filter;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	float *xp;
+	float *yp;
+	int left;
+	int n;
+	int ch;
+	int i;
+
+	/* one channel at a time, unit stride with planar buffers */
+	for (ch = 0; ch < nch; ch++) {
+		filter = &fir[ch];
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(float), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(float), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				*yp = fir_float(filter, *xp);
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FIR_FLOAT_H
+#define FIR_FLOAT_H
+
+#include <config.h>
+
+#if CONFIG_FORMAT_FLOAT
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sof/audio/component.h>
+#include <uapi/user/eq.h>
+
+struct fir_state_float {
+	int rwi; /* Circular write index */
+	int length; /* Number of FIR taps */
+	int out_shift; /* Output shift of the fixed point coefficients */
+	const int16_t *coef_q15; /* Coefficients in the setup blob */
+	float *coef; /* Coefficients scaled with output shift */
+	float *delay; /* Pointer to FIR delay line, 2 x length */
+};
+
+void fir_float_reset(struct fir_state_float *fir);
+
+size_t fir_float_init_coef(struct fir_state_float *fir,
+			   struct sof_eq_fir_coef_data *config);
+
+void fir_float_init_delay(struct fir_state_float *fir, float **data);
+
+void eq_fir_float(struct fir_state_float fir[], struct comp_buffer *source,
+		  struct comp_buffer *sink, int frames, int nch);
+
+/* The delay line is stored twice so the taps never wrap */
+static inline float fir_float(struct fir_state_float *fir, float x)
+{
+	float *d;
+	float y = 0.0f;
+	int i;
+
+	/* Bypass is set with length set to zero. */
+	if (!fir->length)
+		return x;
+
+	fir->delay[fir->rwi] = x;
+	fir->delay[fir->rwi + fir->length] = x;
+	d = &fir->delay[fir->rwi + fir->length];
+	for (i = 0; i < fir->length; i++)
+		y += fir->coef[i] * d[-i];
+
+	if (++fir->rwi == fir->length)
+		fir->rwi = 0;
+
+	return y;
+}
+
+#endif
+#endif
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <uapi/user/eq.h>
+#include "fir_config.h"
+
+#if FIR_X86
+
+#include "fir_x86.h"
+
+/*
+ * EQ FIR algorithm code
+ */
+
+void fir_reset(struct fir_state_32x16 *fir)
+{
+	fir->rwi = 0;
+	fir->length = 0;
+	fir->out_shift = 0;
+	fir->coef = NULL;
+	/* There may need to know the beginning of dynamic allocation after
+	 * reset so omitting setting also fir->delay to NULL.
+	 */
+}
+
+size_t fir_init_coef(struct fir_state_32x16 *fir,
+		     struct sof_eq_fir_coef_data *config)
+{
+	fir->rwi = 0;
+	fir->length = (int)config->length;
+	fir->out_shift = (int)config->out_shift;
+	fir->coef = &config->coef[0];
+	fir->delay = NULL;
+
+	/* Check for sane FIR length. The length is constrained to be a
+	 * multiple of 4 for optimized code.
+	 */
+	if (fir->length > SOF_EQ_FIR_MAX_LENGTH || fir->length < 1)
+		return -EINVAL;
+
+	/* The delay line is duplicated for linear access */
+	return 2 * fir->length * sizeof(int32_t);
+}
+
+void fir_init_delay(struct fir_state_32x16 *fir, int32_t **data)
+{
+	fir->delay = *data;
+	*data += 2 * fir->length; /* Point to next delay line start */
+}
+
+void eq_fir_s16_x86(struct fir_state_32x16 fir[], struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch)
+{
+	struct fir_state_32x16 *filter;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int16_t *xp;
+	int16_t *yp;
+	int32_t z;
+	int left;
+	int n;
+	int ch;
+	int i;
+
+	/* one channel at a time, unit stride with planar buffers */
+	for (ch = 0; ch < nch; ch++) {
+		filter = &fir[ch];
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(int16_t), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(int16_t), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				z = fir_32x16_x86(filter, *xp << 16);
+				*yp = sat_int16(Q_SHIFT_RND(z, 31, 15));
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
+		}
+	}
+}
+
+void eq_fir_s24_x86(struct fir_state_32x16 fir[], struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch)
+{
+	struct fir_state_32x16 *filter;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int32_t *xp;
+	int32_t *yp;
+	int32_t z;
+	int left;
+	int n;
+	int ch;
+	int i;
+
+	/* one channel at a time, unit stride with planar buffers */
+	for (ch = 0; ch < nch; ch++) {
+		filter = &fir[ch];
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(int32_t), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(int32_t), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				z = fir_32x16_x86(filter, *xp << 8);
+				*yp = sat_int24(Q_SHIFT_RND(z, 31, 23));
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
+		}
+	}
+}
+
+void eq_fir_s32_x86(struct fir_state_32x16 fir[], struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch)
+{
+	struct fir_state_32x16 *filter;
+	struct buffer_channel x;
+	struct buffer_channel y;
+	int32_t *xp;
+	int32_t *yp;
+	int left;
+	int n;
+	int ch;
+	int i;
+
+	/* one channel at a time, unit stride with planar buffers */
+	for (ch = 0; ch < nch; ch++) {
+		filter = &fir[ch];
+		buffer_channel_init(source, source->r_ptr, ch, nch,
+				    sizeof(int32_t), &x);
+		buffer_channel_init(sink, sink->w_ptr, ch, nch,
+				    sizeof(int32_t), &y);
+		for (left = frames; left; left -= n) {
+			n = buffer_channel_run(&x, &y, left);
+			xp = x.ptr;
+			yp = y.ptr;
+			for (i = 0; i < n; i++) {
+				*yp = fir_32x16_x86(filter, *xp);
+				xp += x.stride / sizeof(*xp);
+				yp += y.stride / sizeof(*yp);
+			}
+			buffer_channel_advance(&x, n);
+			buffer_channel_advance(&y, n);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FIR_X86_H
+#define FIR_X86_H
+
+#include "fir_config.h"
+
+#if FIR_X86
+
+#include <sof/audio/format.h>
+#include <sof/audio/format_x86.h>
+
+struct fir_state_32x16 {
+	int rwi; /* Circular read and write index */
+	int length; /* Number of FIR taps */
+	int out_shift; /* Amount of right shifts at output */
+	int16_t *coef; /* Pointer to FIR coefficients */
+	int32_t *delay; /* Pointer to FIR delay line, 2 x length */
+};
+
+void fir_reset(struct fir_state_32x16 *fir);
+
+size_t fir_init_coef(struct fir_state_32x16 *fir,
+		     struct sof_eq_fir_coef_data *config);
+
+void fir_init_delay(struct fir_state_32x16 *fir, int32_t **data);
+
+void eq_fir_s16_x86(struct fir_state_32x16 *fir, struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch);
+
+void eq_fir_s24_x86(struct fir_state_32x16 *fir, struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch);
+
+void eq_fir_s32_x86(struct fir_state_32x16 *fir, struct comp_buffer *source,
+		    struct comp_buffer *sink, int frames, int nch);
+
+/* The next functions are inlined to optmize execution speed */
+
+/* Data is Q8.24, coef is Q1.15, product is Q9.39. The 16 bit coefficients
+ * are widened to 32 bits so the vector products are exact and summed in
+ * 64 bit accumulators like in the generic version.
+ */
+static inline int64_t fir_dot_32x16_x86(const int16_t c[], const int32_t d[],
+					int taps)
+{
+	q_vec even = q_vec_zero();
+	q_vec odd = q_vec_zero();
+	int64_t y;
+	int n;
+
+	for (n = 0; n + Q_VEC_LANES <= taps; n += Q_VEC_LANES)
+		q_vec_mac_32x32(&even, &odd, q_vec_load_s16(&c[n]),
+				q_vec_load_s32(&d[n]));
+
+	y = q_vec_hsum64(q_vec_add64(even, odd));
+	for (; n < taps; n++)
+		y += (int64_t)c[n] * d[n];
+
+	return y;
+}
+
+static inline int32_t fir_32x16_x86(struct fir_state_32x16 *fir, int32_t x)
+{
+	int32_t *d;
+	int64_t y;
+
+	/* Bypass is set with length set to zero. */
+	if (!fir->length)
+		return x;
+
+	/* The delay line is stored twice so the newest to oldest samples
+	 * are always found linearly from the write index without wrap.
+	 */
+	fir->rwi = fir->rwi ? fir->rwi - 1 : fir->length - 1;
+	d = &fir->delay[fir->rwi];
+	d[0] = x;
+	d[fir->length] = x;
+
+	y = fir_dot_32x16_x86(fir->coef, d, fir->length);
+
+	/* Q9.39 -> Q9.24, saturate to Q8.24 */
+	return sat_int32(y >> (15 + fir->out_shift));
+}
+
+#endif
+#endif
@@ -363,6 +363,10 @@ static struct comp_dev *host_new(struct sof_ipc_comp *comp)
 	err = memcpy_s(host, sizeof(*host),
 	   ipc_host, sizeof(struct sof_ipc_comp_host));
 
+	/* deep buffer is not sent by older hosts */
+	if (ipc_host->comp.hdr.size < sizeof(struct sof_ipc_comp_host))
+		host->deep_buffer = 0;
+
 	hd = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM, sizeof(*hd));
 	if (!hd) {
 		rfree(dev);
@@ -34,6 +34,7 @@
 #define IIR_H
 
 #include <uapi/user/eq.h>
+#include "iir_config.h"
 
 #define IIR_DF2T_NUM_DELAYS 2
 
@@ -48,6 +49,11 @@ struct iir_state_df2t {
 
 int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x);
 
+#if IIR_X86
+void iir_df2t_2x(struct iir_state_df2t *iir0, struct iir_state_df2t *iir1,
+		 int32_t *x0, int32_t *x1);
+#endif
+
 size_t iir_init_coef_df2t(struct iir_state_df2t *iir,
 			  struct sof_eq_iir_header_df2t *config);
 
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <uapi/user/eq.h>
+#include "iir_float.h"
+
+#if CONFIG_FORMAT_FLOAT
+
+/* Series DF2T IIR with float data, coefficients and state. Same structure
+ * as iir_df2t() without the saturation between sections.
+ */
+float iir_float(struct iir_state_float *iir, float x)
+{
+	const float *c = iir->coef;
+	float *d = iir->delay;
+	float in;
+	float tmp;
+	float out = 0.0f;
+	int i;
+	int j;
+
+	/* Bypass is set with number of biquads set to zero. */
+	if (!iir->biquads)
+		return x;
+
+	in = x;
+	for (j = 0; j < iir->biquads; j += iir->biquads_in_series) {
+		for (i = 0; i < iir->biquads_in_series; i++) {
+			tmp = c[4] * in + d[0];
+			d[0] = d[1] + c[3] * in + c[1] * tmp;
+			d[1] = c[2] * in + c[0] * tmp;
+			in = c[5] * tmp;
+
+			c += IIR_FLOAT_NCOEF;
+			d += IIR_FLOAT_NDELAY;
+		}
+		out += in;
+	}
+
+	return out;
+}
+
+size_t iir_float_init_coef(struct iir_state_float *iir,
+			   struct sof_eq_iir_header_df2t *config)
+{
+	iir->biquads = config->num_sections;
+	iir->biquads_in_series = config->num_sections_in_series;
+	iir->coef_q = config->biquads;
+	iir->coef = NULL;
+	iir->delay = NULL;
+
+	if (iir->biquads > SOF_EQ_IIR_DF2T_BIQUADS_MAX ||
+	    iir->biquads == 0) {
+		iir_float_reset(iir);
+		return -EINVAL;
+	}
+
+	/* coefficients and delay line */
+	return iir->biquads * (IIR_FLOAT_NCOEF + IIR_FLOAT_NDELAY) *
+		sizeof(float);
+}
+
+void iir_float_init_delay(struct iir_state_float *iir, float **data)
+{
+	const int32_t *q = iir->coef_q;
+	float *c;
+	int i;
+
+	/* Blob order is {a2, a1, b2, b1, b0, shift, gain}, the filter
+	 * coefficients are Q2.30 and the gain is Q2.14.
+	 */
+	iir->coef = *data;
+	c = iir->coef;
+	for (i = 0; i < iir->biquads; i++) {
+		c[0] = q[0] * (1.0f / (1 << 30));
+		c[1] = q[1] * (1.0f / (1 << 30));
+		c[2] = q[2] * (1.0f / (1 << 30));
+		c[3] = q[3] * (1.0f / (1 << 30));
+		c[4] = q[4] * (1.0f / (1 << 30));
+		c[5] = q[6] * (1.0f / ((int64_t)1 << (14 + q[5])));
+		c += IIR_FLOAT_NCOEF;
+		q += SOF_EQ_IIR_NBIQUAD_DF2T;
+	}
+
+	iir->delay = iir->coef + iir->biquads * IIR_FLOAT_NCOEF;
+	*data = iir->delay + iir->biquads * IIR_FLOAT_NDELAY;
+}
+
+void iir_float_reset(struct iir_state_float *iir)
+{
+	iir->biquads = 0;
+	iir->biquads_in_series = 0;
+	iir->coef_q = NULL;
+	iir->coef = NULL;
+	/* Note: May need to know the beginning of dynamic allocation after so
+	 * omitting setting iir->delay to NULL.
+	 */
+}
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef IIR_FLOAT_H
+#define IIR_FLOAT_H
+
+#include <config.h>
+
+#if CONFIG_FORMAT_FLOAT
+
+#include <stdint.h>
+#include <stddef.h>
+#include <uapi/user/eq.h>
+
+/* Float biquad coefficients {a2, a1, b2, b1, b0, gain}, the gain includes
+ * the fixed point output shift.
+ */
+#define IIR_FLOAT_NCOEF		6
+#define IIR_FLOAT_NDELAY	2
+
+struct iir_state_float {
+	unsigned int biquads; /* Number of IIR 2nd order sections total */
+	unsigned int biquads_in_series; /* Number of IIR 2nd order sections
+					 * in series.
+					 */
+	const int32_t *coef_q; /* Coefficients in the setup blob */
+	float *coef; /* Pointer to float IIR coefficients */
+	float *delay; /* Pointer to IIR delay line */
+};
+
+float iir_float(struct iir_state_float *iir, float x);
+
+size_t iir_float_init_coef(struct iir_state_float *iir,
+			   struct sof_eq_iir_header_df2t *config);
+
+void iir_float_init_delay(struct iir_state_float *iir, float **data);
+
+void iir_float_reset(struct iir_state_float *iir);
+
+#endif
+#endif
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sof/audio/format.h>
+#include <uapi/user/eq.h>
+#include "iir_config.h"
+
+#if IIR_X86
+
+#include <immintrin.h>
+#include "iir.h"
+
+/* Arithmetic right shift of the two 64 bit lanes by own amounts */
+static inline __m128i iir_sra64_2x(__m128i x, int s0, int s1)
+{
+	__m128i sign = _mm_cmpgt_epi64(_mm_setzero_si128(), x);
+	__m128i y = _mm_xor_si128(x, sign);
+
+	if (s0 == s1)
+		y = _mm_srl_epi64(y, _mm_cvtsi32_si128(s0));
+	else
+		y = _mm_blend_epi16(_mm_srl_epi64(y, _mm_cvtsi32_si128(s0)),
+				    _mm_srl_epi64(y, _mm_cvtsi32_si128(s1)),
+				    0xf0);
+
+	return _mm_xor_si128(y, sign);
+}
+
+/* Saturate the two 64 bit lanes to 32 bit range */
+static inline __m128i iir_sat32_2x(__m128i x)
+{
+	const __m128i max = _mm_set1_epi64x(INT32_MAX);
+	const __m128i min = _mm_set1_epi64x(INT32_MIN);
+
+	x = _mm_blendv_epi8(x, max, _mm_cmpgt_epi64(x, max));
+	return _mm_blendv_epi8(x, min, _mm_cmpgt_epi64(min, x));
+}
+
+/* Coefficient of two filters to 64 bit lanes, only the low 32 bits are
+ * used by the multiplies.
+ */
+static inline __m128i iir_coef_2x(const int32_t *c0, const int32_t *c1,
+				  int i)
+{
+	return _mm_set_epi32(0, c1[i], 0, c0[i]);
+}
+
+/* Same as iir_df2t() for two filters with the same number of biquads and
+ * biquads in series. Channel 0 is in the low and channel 1 in the high
+ * 64 bit lane, and every operation is exact so the results are identical.
+ */
+void iir_df2t_2x(struct iir_state_df2t *iir0, struct iir_state_df2t *iir1,
+		 int32_t *x0, int32_t *x1)
+{
+	const __m128i one = _mm_set1_epi64x(1);
+	const int32_t *c0 = iir0->coef;
+	const int32_t *c1 = iir1->coef;
+	int64_t *d0 = iir0->delay;
+	int64_t *d1 = iir1->delay;
+	__m128i out = _mm_setzero_si128();
+	__m128i in;
+	__m128i tmp;
+	__m128i acc;
+	__m128i a1;
+	__m128i a2;
+	__m128i b0;
+	__m128i b1;
+	__m128i b2;
+	__m128i gain;
+	int i;
+	int j;
+
+	/* Bypass is set with number of biquads set to zero. */
+	if (!iir0->biquads)
+		return;
+
+	/* Coefficients order in coef[] is {a2, a1, b2, b1, b0, shift, gain} */
+	in = _mm_set_epi64x(*x1, *x0);
+	for (j = 0; j < iir0->biquads; j += iir0->biquads_in_series) {
+		for (i = 0; i < iir0->biquads_in_series; i++) {
+			a2 = iir_coef_2x(c0, c1, 0);
+			a1 = iir_coef_2x(c0, c1, 1);
+			b2 = iir_coef_2x(c0, c1, 2);
+			b1 = iir_coef_2x(c0, c1, 3);
+			b0 = iir_coef_2x(c0, c1, 4);
+			gain = iir_coef_2x(c0, c1, 6);
+
+			/* Compute output: Delay is Q3.61
+			 * Q2.30 x Q1.31 -> Q3.61
+			 * Shift Q3.61 to Q3.31 with rounding, the low 32 bits
+			 * used as tmp don't depend on the sign fill.
+			 */
+			acc = _mm_add_epi64(_mm_mul_epi32(b0, in),
+					    _mm_set_epi64x(d1[0], d0[0]));
+			tmp = _mm_add_epi64(_mm_srli_epi64(acc, 29), one);
+			tmp = _mm_srli_epi64(tmp, 1);
+
+			/* Compute 1st delay */
+			acc = _mm_set_epi64x(d1[1], d0[1]);
+			acc = _mm_add_epi64(acc, _mm_mul_epi32(b1, in));
+			acc = _mm_add_epi64(acc, _mm_mul_epi32(a1, tmp));
+			d0[0] = _mm_cvtsi128_si64(acc);
+			d1[0] = _mm_extract_epi64(acc, 1);
+
+			/* Compute 2nd delay */
+			acc = _mm_add_epi64(_mm_mul_epi32(b2, in),
+					    _mm_mul_epi32(a2, tmp));
+			d0[1] = _mm_cvtsi128_si64(acc);
+			d1[1] = _mm_extract_epi64(acc, 1);
+
+			/* Apply gain Q2.14 x Q1.31 -> Q3.45 */
+			acc = _mm_mul_epi32(gain, tmp);
+
+			/* Apply biquad output shift right parameter
+			 * simultaneously with Q3.45 to Q3.31 conversion. Then
+			 * saturate to 32 bits Q1.31 and prepare for next
+			 * biquad.
+			 */
+			acc = iir_sra64_2x(acc, 13 + c0[5], 13 + c1[5]);
+			acc = iir_sra64_2x(_mm_add_epi64(acc, one), 1, 1);
+			in = iir_sat32_2x(acc);
+
+			/* Proceed to next biquad coefficients and delay
+			 * lines.
+			 */
+			c0 += SOF_EQ_IIR_NBIQUAD_DF2T;
+			c1 += SOF_EQ_IIR_NBIQUAD_DF2T;
+			d0 += IIR_DF2T_NUM_DELAYS;
+			d1 += IIR_DF2T_NUM_DELAYS;
+		}
+		/* Output of previous section is in variable in */
+		out = iir_sat32_2x(_mm_add_epi64(out, in));
+	}
+
+	*x0 = _mm_cvtsi128_si32(out);
+	*x1 = _mm_extract_epi32(out, 2);
+}
+
+#endif
@@ -264,9 +264,10 @@ static size_t kpb_allocate_history_buffer(struct comp_data *kpb)
  */
 static void kpb_free_history_buffer(struct hb *buff)
 {
+	struct hb *first_buff = buff;
 	struct hb *_buff;
 
-	/* Free history buffer/s */
+	/* Free history buffer/s, the list of buffers is circular */
 	while (buff) {
 		/* first reclaim HB internal memory, then HB itself. */
 		if (buff->start_addr)
@@ -274,7 +275,7 @@ static void kpb_free_history_buffer(struct hb *buff)
 
 		_buff = buff->next;
 		rfree(buff);
-		buff = _buff;
+		buff = _buff != first_buff ? _buff : NULL;
 	}
 }
 
@@ -475,6 +476,12 @@ static int kpb_copy(struct comp_dev *dev)
 
 	/* Sink and source are both ready and have space */
 	copy_bytes = MIN(sink->free, source->avail);
+
+	/* do not copy past the end of either circular buffer */
+	copy_bytes = MIN(copy_bytes, (uintptr_t)sink->end_addr -
+			 (uintptr_t)sink->w_ptr);
+	copy_bytes = MIN(copy_bytes, (uintptr_t)source->end_addr -
+			 (uintptr_t)source->r_ptr);
 	memcpy(sink->w_ptr, source->r_ptr, copy_bytes);
 
 	/* Buffer source data internally in history buffer for future
@@ -516,7 +523,8 @@ static void kpb_buffer_data(struct comp_data *kpb, struct comp_buffer *source,
 	/* Let's store audio stream data in internal history buffer */
 	while (size_to_copy) {
 		/* Check how much space there is in current write buffer */
-		space_avail = (uint32_t)buff->end_addr - (uint32_t)buff->w_ptr;
+		space_avail = (uintptr_t)buff->end_addr -
+			      (uintptr_t)buff->w_ptr;
 
 		if (size_to_copy > space_avail) {
 			/* We have more data to copy than available space
@@ -695,12 +703,12 @@ static void kpb_init_draining(struct comp_data *kpb, struct kpb_client *cli)
 			local_buffered = 0;
 			buff->r_ptr = buff->start_addr;
 			if (buff->state == KPB_BUFFER_FREE) {
-				local_buffered = (uint32_t)buff->w_ptr -
-						 (uint32_t)buff->start_addr;
+				local_buffered = (uintptr_t)buff->w_ptr -
+						 (uintptr_t)buff->start_addr;
 				buffered += local_buffered;
 			} else if (buff->state == KPB_BUFFER_FULL) {
-				local_buffered = (uint32_t)buff->end_addr -
-						 (uint32_t)buff->start_addr;
+				local_buffered = (uintptr_t)buff->end_addr -
+						 (uintptr_t)buff->start_addr;
 				buffered += local_buffered;
 			} else {
 				trace_kpb_error("kpb_init_draining() error: "
@@ -720,8 +728,8 @@ static void kpb_init_draining(struct comp_data *kpb, struct kpb_client *cli)
 					 * and buffer's end address.
 					 */
 					buff = buff->prev;
-					buffered += (uint32_t)buff->end_addr -
-						    (uint32_t)buff->w_ptr;
+					buffered += (uintptr_t)buff->end_addr -
+						    (uintptr_t)buff->w_ptr;
 					buff->r_ptr = buff->w_ptr + (buffered -
 						      history_depth);
 					break;
@@ -748,6 +756,7 @@ static void kpb_init_draining(struct comp_data *kpb, struct kpb_client *cli)
 
 		/* Pause selector copy. */
 		kpb->rt_sink->sink->state = COMP_STATE_PAUSED;
+		pipeline_comp_state_changed(kpb->rt_sink->sink);
 
 		/* Set host-sink copy mode to blocking */
 		comp_set_attribute(kpb->cli_sink->sink,
@@ -778,7 +787,8 @@ static uint64_t kpb_draining_task(void *arg)
 	trace_kpb("kpb_draining_task(), start.");
 
 	while (history_depth > 0) {
-		size_to_read = (uint32_t)buff->end_addr - (uint32_t)buff->r_ptr;
+		size_to_read = (uintptr_t)buff->end_addr -
+			       (uintptr_t)buff->r_ptr;
 
 		if (size_to_read > sink->free) {
 			if (sink->free >= history_depth) {
@@ -835,7 +845,7 @@ static void kpb_clear_history_buffer(struct hb *buff)
 
 	do {
 		start_addr = buff->start_addr;
-		size = start_addr - buff->end_addr;
+		size = buff->end_addr - start_addr;
 
 		bzero(start_addr, size);
 
@@ -870,16 +880,16 @@ static bool kpb_has_enough_history_data(struct comp_data *kpb,
 		if (buff->state == KPB_BUFFER_FREE) {
 			if (buff->w_ptr == buff->start_addr &&
 			    buff->next->state == KPB_BUFFER_FULL) {
-				buffered_data += ((uint32_t)buff->end_addr -
-						  (uint32_t)buff->start_addr);
+				buffered_data += ((uintptr_t)buff->end_addr -
+						  (uintptr_t)buff->start_addr);
 			} else {
-				buffered_data += ((uint32_t)buff->w_ptr -
-						  (uint32_t)buff->start_addr);
+				buffered_data += ((uintptr_t)buff->w_ptr -
+						  (uintptr_t)buff->start_addr);
 			}
 
 		} else {
-			buffered_data += ((uint32_t)buff->end_addr -
-					  (uint32_t)buff->start_addr);
+			buffered_data += ((uintptr_t)buff->end_addr -
+					  (uintptr_t)buff->start_addr);
 		}
 
 		if (buff->next && buff->next != first_buff)
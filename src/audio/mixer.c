@@ -48,12 +48,6 @@
 #define trace_mixer_error(__e, ...) \
 	trace_error(TRACE_CLASS_MIXER, __e, ##__VA_ARGS__)
 
-/* mixer component private data */
-struct mixer_data {
-	void (*mix_func)(struct comp_dev *dev, struct comp_buffer *sink,
-		struct comp_buffer **sources, uint32_t count, uint32_t frames);
-};
-
 /* Mix n 16 bit PCM source streams to one sink stream */
 static void mix_n_s16(struct comp_dev *dev, struct comp_buffer *sink,
 		      struct comp_buffer **sources, uint32_t num_sources,
@@ -118,6 +112,40 @@ static void mix_n_s32(struct comp_dev *dev, struct comp_buffer *sink,
 	}
 }
 
+#if CONFIG_FORMAT_FLOAT
+/* Mix n float PCM source streams to one sink stream, float has headroom
+ * so the sum is not saturated here
+ */
+static void mix_n_float(struct comp_dev *dev, struct comp_buffer *sink,
+			struct comp_buffer **sources, uint32_t num_sources,
+			uint32_t frames)
+{
+	float *src;
+	float *dest;
+	float val;
+	int i;
+	int j;
+	int channel;
+	uint32_t frag = 0;
+
+	for (i = 0; i < frames; i++) {
+		for (channel = 0; channel < dev->params.channels; channel++) {
+			val = 0.0f;
+
+			for (j = 0; j < num_sources; j++) {
+				src = buffer_read_frag_float(sources[j], frag);
+				val += *src;
+			}
+
+			dest = buffer_write_frag_float(sink, frag);
+			*dest = val;
+
+			frag++;
+		}
+	}
+}
+#endif
+
 static struct comp_dev *mixer_new(struct sof_ipc_comp *comp)
 {
 	struct comp_dev *dev;
@@ -388,8 +416,19 @@ static int mixer_prepare(struct comp_dev *dev)
 	/* does mixer already have active source streams ? */
 	if (dev->state != COMP_STATE_ACTIVE) {
 		/* currently inactive so setup mixer */
-		md->mix_func = dev->params.frame_fmt == SOF_IPC_FRAME_S16_LE ?
-			mix_n_s16 : mix_n_s32;
+		switch (dev->params.frame_fmt) {
+		case SOF_IPC_FRAME_S16_LE:
+			md->mix_func = mix_n_s16;
+			break;
+#if CONFIG_FORMAT_FLOAT
+		case SOF_IPC_FRAME_FLOAT:
+			md->mix_func = mix_n_float;
+			break;
+#endif
+		default:
+			md->mix_func = mix_n_s32;
+			break;
+		}
 
 		ret = comp_set_state(dev, COMP_TRIGGER_PREPARE);
 		if (ret < 0)
@@ -32,6 +32,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <errno.h>
+#include <config.h>
 #include <sof/sof.h>
 #include <sof/lock.h>
 #include <sof/list.h>
@@ -46,8 +47,10 @@
 #include <sof/audio/pipeline.h>
 #include <sof/drivers/timer.h>
 #include <sof/cpu.h>
+#include <sof/clk.h>
 #include <sof/idc.h>
 #include <platform/idc.h>
+#include <platform/clk.h>
 #include <sof/schedule.h>
 
 /* generic pipeline data used by pipeline_comp_* functions */
@@ -81,6 +84,7 @@ struct pipeline *pipeline_new(struct sof_ipc_pipe_new *pipe_desc,
 	/* init pipeline */
 	p->sched_comp = cd;
 	p->status = COMP_STATE_INIT;
+	p->batch_periods = 1;
 
 	spinlock_init(&p->lock);
 	err = memcpy_s(&p->ipc_pipe, sizeof(p->ipc_pipe),
@@ -112,9 +116,28 @@ int pipeline_connect(struct comp_dev *comp, struct comp_buffer *buffer,
 	buffer_set_comp(buffer, comp, dir);
 	spin_unlock(&comp->lock);
 
+	pipeline_comp_state_changed(comp);
+
 	return 0;
 }
 
+/* Outdates precompiled copy lists containing the component. Component can
+ * be scheduled either by its own pipeline or by the pipeline owning its
+ * scheduling component.
+ */
+void pipeline_comp_state_changed(struct comp_dev *dev)
+{
+	struct pipeline *p = dev->pipeline;
+
+	if (!p)
+		return;
+
+	pipeline_copy_list_invalidate(p);
+
+	if (p->sched_comp && p->sched_comp->pipeline)
+		pipeline_copy_list_invalidate(p->sched_comp->pipeline);
+}
+
 /* Generic method for walking the graph upstream or downstream.
  * It requires function pointer for recursion.
  */
@@ -172,7 +195,8 @@ static int pipeline_comp_complete(struct comp_dev *current, void *data,
 
 	/* complete component init */
 	current->pipeline = ppl_data->p;
-	current->frames = ppl_data->p->ipc_pipe.frames_per_sched;
+	current->frames = ppl_data->p->ipc_pipe.frames_per_sched *
+		ppl_data->p->batch_periods;
 
 	pipeline_for_each_comp(current, &pipeline_comp_complete, data,
 			       NULL, dir);
@@ -180,6 +204,25 @@ static int pipeline_comp_complete(struct comp_dev *current, void *data,
 	return 0;
 }
 
+/* Deep buffer PCMs fetch and process several pipeline periods at once,
+ * trading latency for fewer DSP wake ups. All pipeline components,
+ * including DAI DMA, then work with a multiple of period frames.
+ */
+static uint32_t pipeline_batch_periods(struct comp_dev *source,
+				       struct comp_dev *sink)
+{
+	struct sof_ipc_comp_host *host;
+
+	if (source->comp.type == SOF_COMP_HOST)
+		host = COMP_GET_IPC(source, sof_ipc_comp_host);
+	else if (sink->comp.type == SOF_COMP_HOST)
+		host = COMP_GET_IPC(sink, sof_ipc_comp_host);
+	else
+		return 1;
+
+	return host->deep_buffer ? host->deep_buffer : 1;
+}
+
 int pipeline_complete(struct pipeline *p, struct comp_dev *source,
 		      struct comp_dev *sink)
 {
@@ -197,6 +240,11 @@ int pipeline_complete(struct pipeline *p, struct comp_dev *source,
 	data.start = source;
 	data.p = p;
 
+	p->batch_periods = pipeline_batch_periods(source, sink);
+	if (p->batch_periods > 1)
+		trace_pipe_with_ids(p, "pipeline_complete(), deep buffer "
+				    "batch_periods = %u", p->batch_periods);
+
 	/* now walk downstream from source component and
 	 * complete component task and pipeline initialization
 	 */
@@ -205,6 +253,7 @@ int pipeline_complete(struct pipeline *p, struct comp_dev *source,
 	p->source_comp = source;
 	p->sink_comp = sink;
 	p->status = COMP_STATE_READY;
+	pipeline_copy_list_invalidate(p);
 
 	/* show heap status */
 	heap_trace_all(0);
@@ -239,6 +288,24 @@ static int pipeline_comp_free(struct comp_dev *current, void *data, int dir)
 	return 0;
 }
 
+/* free queued bulk control updates without applying them */
+static void pipeline_ctrl_bulk_discard(struct pipeline *p)
+{
+	struct pipeline_ctrl_bulk *bulk;
+	struct pipeline_ctrl_bulk *next;
+	uint32_t flags;
+
+	spin_lock_irq(&p->lock, flags);
+	bulk = p->ctrl_bulk;
+	p->ctrl_bulk = NULL;
+	spin_unlock_irq(&p->lock, flags);
+
+	for (; bulk; bulk = next) {
+		next = bulk->next;
+		rfree(bulk);
+	}
+}
+
 /* pipelines must be inactive */
 int pipeline_free(struct pipeline *p)
 {
@@ -258,12 +325,17 @@ int pipeline_free(struct pipeline *p)
 	/* remove from any scheduling */
 	schedule_task_free(&p->pipe_task);
 
+	/* drop control updates still queued, components are going away */
+	pipeline_ctrl_bulk_discard(p);
+
 	data.start = p->source_comp;
 
 	/* disconnect components */
 	pipeline_comp_free(p->source_comp, &data, PPL_DIR_DOWNSTREAM);
 
 	/* now free the pipeline */
+	rfree(p->copy_list);
+	rfree(p->fused_block);
 	rfree(p);
 
 	/* show heap status */
@@ -272,6 +344,39 @@ int pipeline_free(struct pipeline *p)
 	return 0;
 }
 
+/* Buffers between two components preferring planar layout get a channel
+ * ring each, all others stay interleaved. Host and DAI DMA need
+ * interleaved data, so the components next to them convert while they
+ * process. Buffers of running components keep their layout.
+ */
+static void pipeline_comp_layout(struct comp_dev *current, uint32_t channels,
+				 int dir)
+{
+	struct list_item *clist;
+	struct comp_buffer *buffer;
+	struct comp_dev *next;
+	uint32_t layout;
+
+	list_for_item(clist, comp_buffer_list(current, dir)) {
+		buffer = buffer_from_list(clist, struct comp_buffer, dir);
+		next = buffer_get_comp(buffer, dir);
+		if (!next || next->state == COMP_STATE_ACTIVE)
+			continue;
+
+		if (current->layout == SOF_IPC_BUFFER_NONINTERLEAVED &&
+		    next->layout == SOF_IPC_BUFFER_NONINTERLEAVED)
+			layout = SOF_IPC_BUFFER_NONINTERLEAVED;
+		else
+			layout = SOF_IPC_BUFFER_INTERLEAVED;
+
+		buffer_set_layout(buffer, layout, channels);
+
+		tracev_pipe("pipeline_comp_layout(), buffer %u layout %u "
+			    "planes %u", buffer->ipc_buffer.comp.id,
+			    buffer->layout, buffer->planes);
+	}
+}
+
 static int pipeline_comp_params(struct comp_dev *current, void *data, int dir)
 {
 	struct pipeline_data *ppl_data = data;
@@ -284,6 +389,9 @@ static int pipeline_comp_params(struct comp_dev *current, void *data, int dir)
 	if (current->state == COMP_STATE_ACTIVE)
 		return 0;
 
+	/* new stream, start load accounting again */
+	perf_cnt_reset(&current->perf);
+
 	/* send current params to the component */
 	current->params = ppl_data->params->params;
 
@@ -294,6 +402,8 @@ static int pipeline_comp_params(struct comp_dev *current, void *data, int dir)
 	/* save params changes made by component */
 	ppl_data->params->params = current->params;
 
+	pipeline_comp_layout(current, current->params.channels, dir);
+
 	return pipeline_for_each_comp(current, &pipeline_comp_params, data,
 				      NULL, dir);
 }
@@ -323,6 +433,9 @@ int pipeline_params(struct pipeline *p, struct comp_dev *host,
 
 	spin_lock_irq(&p->lock, flags);
 
+	perf_cnt_reset(&p->perf);
+	bzero(&p->telemetry, sizeof(p->telemetry));
+
 	ret = pipeline_comp_params(host, &data, host->params.direction);
 	if (ret < 0) {
 		trace_pipe_error("pipeline_params() error: ret = %d, host->"
@@ -334,6 +447,22 @@ int pipeline_params(struct pipeline *p, struct comp_dev *host,
 	return ret;
 }
 
+/* buffers between components run by different cores drop the lock and
+ * hand over positions through separate cache lines
+ */
+static void pipeline_buffer_prepare(struct comp_buffer *buffer)
+{
+	buffer->xcore = buffer->source && buffer->sink &&
+		buffer->source->pipeline->ipc_pipe.core !=
+		buffer->sink->pipeline->ipc_pipe.core;
+
+	buffer_reset_pos(buffer);
+
+	/* the other core reads the reset positions from memory */
+	if (buffer->xcore)
+		dcache_writeback_invalidate_region(buffer, sizeof(*buffer));
+}
+
 static int pipeline_comp_prepare(struct comp_dev *current, void *data, int dir)
 {
 	int err = 0;
@@ -342,11 +471,12 @@ static int pipeline_comp_prepare(struct comp_dev *current, void *data, int dir)
 		    current->comp.id, dir);
 
 	err = comp_prepare(current);
+	pipeline_comp_state_changed(current);
 	if (err < 0 || err == PPL_STATUS_PATH_STOP)
 		return err;
 
 	return pipeline_for_each_comp(current, &pipeline_comp_prepare, data,
-				      &buffer_reset_pos, dir);
+				      &pipeline_buffer_prepare, dir);
 }
 
 /* prepare the pipeline for usage - preload host buffers here */
@@ -359,6 +489,10 @@ int pipeline_prepare(struct pipeline *p, struct comp_dev *dev)
 
 	spin_lock_irq(&p->lock, flags);
 
+	p->xrun_conceal_us = 0;
+	p->xrun_concealed = false;
+	p->xrun_conceal_dma = false;
+
 	ret = pipeline_comp_prepare(dev, NULL, dev->params.direction);
 	if (ret < 0) {
 		trace_pipe_error("pipeline_prepare() error: ret = %d,"
@@ -482,6 +616,7 @@ static int pipeline_comp_trigger(struct comp_dev *current, void *data, int dir)
 
 	/* send command to the component and update pipeline state */
 	err = comp_trigger(current, ppl_data->cmd);
+	pipeline_comp_state_changed(current);
 	if (err < 0 || err == PPL_STATUS_PATH_STOP)
 		return err;
 
@@ -556,6 +691,11 @@ int pipeline_trigger(struct pipeline *p, struct comp_dev *host, int cmd)
 	}
 
 	spin_unlock_irq(&p->lock, flags);
+
+	/* updates queued for a period that will not run are applied now */
+	if (p->status != COMP_STATE_ACTIVE)
+		pipeline_ctrl_bulk_apply(p);
+
 	return ret;
 }
 
@@ -567,6 +707,7 @@ static int pipeline_comp_reset(struct comp_dev *current, void *data, int dir)
 		    current->comp.id, dir);
 
 	err = comp_reset(current);
+	pipeline_comp_state_changed(current);
 	if (err < 0 || err == PPL_STATUS_PATH_STOP)
 		return err;
 
@@ -582,6 +723,11 @@ int pipeline_reset(struct pipeline *p, struct comp_dev *host)
 
 	trace_pipe_with_ids(p, "pipeline_reset()");
 
+	if (p->perf.count)
+		trace_pipe_with_ids(p, "pipeline_reset(), cycles min %u "
+				    "avg %u max %u", p->perf.min,
+				    perf_cnt_avg(&p->perf), p->perf.max);
+
 	spin_lock_irq(&p->lock, flags);
 
 	ret = pipeline_comp_reset(host, NULL, host->params.direction);
@@ -594,91 +740,515 @@ int pipeline_reset(struct pipeline *p, struct comp_dev *host)
 	return ret;
 }
 
-static int pipeline_comp_copy(struct comp_dev *current, void *data, int dir)
+/* checks if component is connected to any cross-core buffer */
+static bool pipeline_comp_is_xcore(struct comp_dev *comp)
+{
+	struct list_item *clist;
+	struct comp_buffer *buffer;
+
+	list_for_item(clist, &comp->bsource_list) {
+		buffer = container_of(clist, struct comp_buffer, sink_list);
+		if (buffer->xcore)
+			return true;
+	}
+
+	list_for_item(clist, &comp->bsink_list) {
+		buffer = container_of(clist, struct comp_buffer, source_list);
+		if (buffer->xcore)
+			return true;
+	}
+
+	return false;
+}
+
+/* pick up positions moved by the other core in cross-core buffers */
+static void pipeline_xcore_sync(struct pipeline *p)
+{
+	struct list_item *clist;
+	struct comp_buffer *buffer;
+	struct comp_dev *comp;
+	uint32_t i;
+
+	for (i = 0; i < p->copy_count; i++) {
+		comp = p->copy_list[i].comp;
+
+		list_for_item(clist, &comp->bsource_list) {
+			buffer = container_of(clist, struct comp_buffer,
+					      sink_list);
+			if (buffer->xcore)
+				buffer_xcore_consumer_sync(buffer);
+		}
+
+		list_for_item(clist, &comp->bsink_list) {
+			buffer = container_of(clist, struct comp_buffer,
+					      source_list);
+			if (buffer->xcore)
+				buffer_xcore_producer_sync(buffer);
+		}
+	}
+}
+
+/* add component to the copy list, returns entry index */
+static uint32_t pipeline_copy_list_add(struct pipeline *p,
+				       struct comp_dev *comp)
+{
+	uint32_t index = p->copy_count++;
+	struct pipeline_copy_entry *entry;
+
+	/* list too small, only count entries and grow it later */
+	if (index >= p->copy_size)
+		return index;
+
+	if (pipeline_comp_is_xcore(comp))
+		p->copy_xcore = true;
+
+	entry = &p->copy_list[index];
+	entry->comp = comp;
+	entry->copy = comp->drv->ops.copy;
+	entry->skip = index + 1;
+	entry->fused = 0;
+
+	return index;
+}
+
+static int pipeline_comp_copy_list(struct comp_dev *current, void *data,
+				   int dir)
 {
 	struct pipeline_data *ppl_data = data;
+	struct pipeline *p = ppl_data->p;
 	int is_single_ppl = comp_is_single_pipeline(current, ppl_data->start);
-	int is_same_sched =
-		pipeline_is_same_sched_comp(current->pipeline, ppl_data->p);
-	int err = 0;
+	int is_same_sched = pipeline_is_same_sched_comp(current->pipeline, p);
+	uint32_t index;
 
-	tracev_pipe("pipeline_comp_copy(), current->comp.id = %u, dir = %u",
-		    current->comp.id, dir);
+	tracev_pipe("pipeline_comp_copy_list(), current->comp.id = %u, "
+		    "dir = %u", current->comp.id, dir);
 
 	if (!is_single_ppl && !is_same_sched) {
-		tracev_pipe("pipeline_comp_copy(), current is from another "
-			    "pipeline and can't be scheduled together");
-		return err;
+		tracev_pipe("pipeline_comp_copy_list(), current is from "
+			    "another pipeline and can't be scheduled together");
+		return 0;
 	}
 
 	if (!comp_is_active(current)) {
-		tracev_pipe("pipeline_comp_copy(), current is not active");
-		return err;
+		tracev_pipe("pipeline_comp_copy_list(), current is not active");
+		return 0;
 	}
 
-	/* copy to downstream immediately */
+	/* downstream copies current before its branch and path stop
+	 * skips the whole branch, upstream copies current after its branch
+	 */
 	if (dir == PPL_DIR_DOWNSTREAM) {
-		err = comp_copy(current);
-		if (err < 0 || err == PPL_STATUS_PATH_STOP)
-			return err;
+		index = pipeline_copy_list_add(p, current);
+		pipeline_for_each_comp(current, &pipeline_comp_copy_list,
+				       data, NULL, dir);
+		if (index < p->copy_size)
+			p->copy_list[index].skip = p->copy_count;
+	} else {
+		pipeline_for_each_comp(current, &pipeline_comp_copy_list,
+				       data, NULL, dir);
+		pipeline_copy_list_add(p, current);
 	}
 
-	err = pipeline_for_each_comp(current, &pipeline_comp_copy,
-				     data, NULL, dir);
-	if (err < 0)
-		return err;
+	return 0;
+}
+
+/* checks if component has process operation and single source and sink */
+static bool pipeline_comp_is_simple(struct comp_dev *comp)
+{
+	struct list_item *sources = &comp->bsource_list;
+	struct list_item *sinks = &comp->bsink_list;
+
+	return comp->drv->ops.process &&
+		!list_is_empty(sources) &&
+		list_item_is_last(sources->next, sources) &&
+		!list_is_empty(sinks) &&
+		list_item_is_last(sinks->next, sinks);
+}
 
-	if (dir == PPL_DIR_UPSTREAM)
-		err = comp_copy(current);
+/* checks if next component can be fused with current one */
+static bool pipeline_comp_can_fuse(struct comp_dev *current,
+				   struct comp_dev *next)
+{
+	struct comp_buffer *buffer;
 
-	return err;
+	if (!pipeline_comp_is_simple(next))
+		return false;
+
+	buffer = list_first_item(&current->bsink_list, struct comp_buffer,
+				 source_list);
+
+	/* intermediate buffer is bypassed, so it can't be used by anybody
+	 * else and samples must keep their size for in place processing
+	 */
+	return buffer->sink == next && !buffer->cb &&
+		!buffer_is_planar(buffer) &&
+		current->params.frame_fmt == next->params.frame_fmt &&
+		current->params.channels == next->params.channels;
+}
+
+/* mark chains of adjacent simple components in the copy list */
+static void pipeline_copy_list_fuse(struct pipeline *p)
+{
+	struct pipeline_copy_entry *entry;
+	uint32_t i;
+	uint32_t j;
+
+	for (i = 0; i < p->copy_count; i = j) {
+		entry = &p->copy_list[i];
+		j = i + 1;
+
+		if (!pipeline_comp_is_simple(entry->comp))
+			continue;
+
+		while (j < p->copy_count &&
+		       pipeline_comp_can_fuse(p->copy_list[j - 1].comp,
+					      p->copy_list[j].comp))
+			j++;
+
+		/* nothing to fuse with */
+		if (j - i < 2)
+			continue;
+
+		if (!p->fused_block)
+			p->fused_block = rzalloc(RZONE_RUNTIME,
+						 SOF_MEM_CAPS_RAM,
+						 PPL_FUSED_BLOCK_BYTES);
+		if (!p->fused_block) {
+			trace_pipe_error("pipeline_copy_list_fuse() error: "
+					 "Out of Memory");
+			return;
+		}
+
+		entry->fused = j - i;
+	}
 }
 
-/* Copy data across all pipeline components.
+/* Walk the graph once and store the copy order of active components.
  * For capture pipelines it always starts from source component
  * and continues downstream. For playback pipelines there are two
  * possibilities: for preload it starts from sink component and
  * continues upstream and if not preload, then it first copies
  * sink component itself and then goes upstream.
  */
-static int pipeline_copy(struct pipeline *p)
+static int pipeline_copy_list_build(struct pipeline *p)
 {
 	struct pipeline_data data;
 	struct comp_dev *start;
 	uint32_t dir;
-	int ret = 0;
+	uint32_t size;
 
-	if (p->source_comp->params.direction == SOF_IPC_STREAM_PLAYBACK) {
-		dir = PPL_DIR_UPSTREAM;
-		start = p->sink_comp;
+	do {
+		p->copy_count = 0;
+		p->copy_xcore = false;
 
-		/* if not pipeline preload then copy sink comp first */
-		if (!p->preload) {
-			ret = comp_copy(start);
-			if (ret < 0) {
-				trace_pipe_error("pipeline_copy() error: "
-						 "ret = %d", ret);
-				return ret;
+		if (p->source_comp->params.direction ==
+		    SOF_IPC_STREAM_PLAYBACK) {
+			dir = PPL_DIR_UPSTREAM;
+			start = p->sink_comp;
+
+			/* if not pipeline preload then copy sink comp first */
+			if (!p->preload) {
+				pipeline_copy_list_add(p, start);
+				start = comp_get_previous(start, dir);
 			}
+		} else {
+			dir = PPL_DIR_DOWNSTREAM;
+			start = p->source_comp;
+		}
+
+		if (start) {
+			data.start = start;
+			data.p = p;
+			pipeline_comp_copy_list(start, &data, dir);
+		}
+
+		/* all entries stored */
+		if (p->copy_count <= p->copy_size)
+			break;
+
+		/* grow the list and walk again */
+		size = p->copy_count;
+		rfree(p->copy_list);
+		p->copy_size = 0;
+		p->copy_list = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+				       size * sizeof(*p->copy_list));
+		if (!p->copy_list) {
+			trace_pipe_error_with_ids(p, "pipeline_copy_list_build"
+						  "() error: Out of Memory");
+			p->copy_count = 0;
+			return -ENOMEM;
+		}
+		p->copy_size = size;
+	} while (true);
+
+	pipeline_copy_list_fuse(p);
+
+	p->copy_list_valid = true;
+	p->copy_list_preload = p->preload;
+
+	return 0;
+}
 
-			start = comp_get_previous(start, dir);
-			if (!start)
-				/* nothing else to do */
+/* find index of the entry following comp after list rebuild */
+static uint32_t pipeline_copy_list_next(struct pipeline *p,
+					struct comp_dev *comp)
+{
+	uint32_t i;
+
+	for (i = 0; i < p->copy_count; i++) {
+		if (p->copy_list[i].comp == comp)
+			return i + 1;
+	}
+
+	/* current comp is not active anymore, nothing else to copy */
+	return p->copy_count;
+}
+
+/* copy fused components one by one */
+static int pipeline_fused_copy_each(struct pipeline_copy_entry *entry)
+{
+	uint32_t cycles;
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < entry->fused; i++) {
+		cycles = perf_cycles_get();
+		ret = entry[i].copy(entry[i].comp);
+		perf_cnt_update(&entry[i].comp->perf,
+				perf_cycles_get() - cycles);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/* Process chain of fused components block by block. The first component
+ * reads its source buffer into scratch block, the middle ones process
+ * the block in place and the last one writes its sink buffer. Only the
+ * chain source and sink buffers are updated.
+ */
+static int pipeline_fused_copy(struct pipeline *p,
+			       struct pipeline_copy_entry *entry)
+{
+	struct comp_dev *first = entry->comp;
+	struct comp_dev *last = entry[entry->fused - 1].comp;
+	struct comp_dev *comp;
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	struct comp_buffer *buffer;
+	struct comp_buffer source_pos;
+	struct comp_buffer sink_pos;
+	struct comp_buffer block;
+	uint32_t block_frames;
+	uint32_t frames;
+	uint32_t source_bytes;
+	uint32_t sink_bytes;
+	uint32_t cycles;
+	uint32_t now;
+	uint32_t n;
+	uint32_t i;
+	uint32_t j;
+	int ret;
+
+	source = list_first_item(&first->bsource_list, struct comp_buffer,
+				 sink_list);
+	sink = list_first_item(&last->bsink_list, struct comp_buffer,
+			       source_list);
+
+	/* data left in intermediate buffers, drain them first */
+	for (i = 0; i < entry->fused - 1; i++) {
+		buffer = list_first_item(&entry[i].comp->bsink_list,
+					 struct comp_buffer, source_list);
+		if (buffer->avail)
+			return pipeline_fused_copy_each(entry);
+	}
+
+	/* check for underrun */
+	if (source->avail == 0) {
+		trace_pipe_error("pipeline_fused_copy() error: source "
+				 "component buffer has not enough data "
+				 "available");
+		comp_underrun(first, source, 0, 0);
+		return -EIO;
+	}
+
+	/* check for overrun */
+	if (sink->free == 0) {
+		trace_pipe_error("pipeline_fused_copy() error: sink "
+				 "component buffer has not enough free "
+				 "bytes for copy");
+		comp_overrun(last, sink, 0, 0);
+		return -EIO;
+	}
+
+	frames = comp_avail_frames(source, sink);
+	source_bytes = comp_frame_bytes(source->source);
+	sink_bytes = comp_frame_bytes(sink->sink);
+
+	/* keep even number of frames for optimized processing functions */
+	block_frames = (PPL_FUSED_BLOCK_BYTES / comp_frame_bytes(first)) & ~1;
+
+	tracev_pipe("pipeline_fused_copy(), first->comp.id = %u, "
+		    "fused = %u, frames = %u", first->comp.id, entry->fused,
+		    frames);
+
+	/* local copies keep positions while processing blocks */
+	source_pos = *source;
+	sink_pos = *sink;
+
+	bzero(&block, sizeof(block));
+	block.addr = p->fused_block;
+	block.end_addr = p->fused_block + PPL_FUSED_BLOCK_BYTES;
+	block.size = PPL_FUSED_BLOCK_BYTES;
+
+	/* cycles of each component are accumulated over all blocks */
+	for (i = 0; i < frames; i += n) {
+		n = MIN(frames - i, block_frames);
+		block.r_ptr = block.addr;
+		block.w_ptr = block.addr;
+
+		cycles = perf_cycles_get();
+		ret = first->drv->ops.process(first, &source_pos, &block, n);
+		if (ret < 0)
+			return ret;
+
+		now = perf_cycles_get();
+		first->perf.acc += now - cycles;
+		cycles = now;
+
+		for (j = 1; j < entry->fused - 1; j++) {
+			comp = entry[j].comp;
+			ret = comp->drv->ops.process(comp, &block, &block, n);
+			if (ret < 0)
 				return ret;
+
+			now = perf_cycles_get();
+			comp->perf.acc += now - cycles;
+			cycles = now;
 		}
-	} else {
-		dir = PPL_DIR_DOWNSTREAM;
-		start = p->source_comp;
+
+		ret = last->drv->ops.process(last, &block, &sink_pos, n);
+		if (ret < 0)
+			return ret;
+
+		last->perf.acc += perf_cycles_get() - cycles;
+
+		source_pos.r_ptr = buffer_pos_add(source, source_pos.r_ptr,
+						  n * source_bytes);
+		sink_pos.w_ptr = buffer_pos_add(sink, sink_pos.w_ptr,
+						n * sink_bytes);
 	}
 
-	data.start = start;
-	data.p = p;
+	/* calculate new free and available */
+	comp_update_buffer_produce(sink, frames * sink_bytes);
+	comp_update_buffer_consume(source, frames * source_bytes);
 
-	ret = pipeline_comp_copy(start, &data, dir);
-	if (ret < 0)
-		trace_pipe_error("pipeline_copy() error: ret = %d, start"
-				 "->comp.id = %u, dir = %u", ret,
-				 start->comp.id, dir);
+	for (j = 0; j < entry->fused; j++)
+		perf_cnt_commit(&entry[j].comp->perf);
+
+	return 0;
+}
+
+/* conceal xruns recorded by DMA callbacks, the task owns the positions */
+static void pipeline_xrun_conceal_dma(struct pipeline *p)
+{
+	struct comp_buffer *buffer;
+	struct list_item *clist;
+	uint32_t bytes;
+	uint32_t flags;
+	uint32_t i;
+
+	spin_lock_irq(&p->lock, flags);
+	p->xrun_conceal_dma = false;
+	spin_unlock_irq(&p->lock, flags);
+
+	for (i = 0; i < p->copy_count; i++) {
+		list_for_item(clist, &p->copy_list[i].comp->bsink_list) {
+			buffer = container_of(clist, struct comp_buffer,
+					      source_list);
+
+			spin_lock_irq(&p->lock, flags);
+			bytes = buffer->conceal_bytes;
+			buffer->conceal_bytes = 0;
+			spin_unlock_irq(&p->lock, flags);
+
+			if (!bytes)
+				continue;
+
+			if (buffer->sink->is_dma_connected)
+				buffer_conceal_dma_underrun(buffer, bytes);
+			else
+				buffer_conceal_dma_overrun(buffer, bytes);
+		}
+	}
+}
+
+/* Copy data across all pipeline components using the precompiled copy
+ * list, so the graph is walked only after component state changes.
+ */
+static int pipeline_copy(struct pipeline *p)
+{
+	struct pipeline_copy_entry *entry;
+	struct comp_dev *comp;
+	uint32_t conceal_us;
+	uint32_t cycles;
+	uint32_t i = 0;
+	int ret = 0;
+
+	if (!p->copy_list_valid || p->copy_list_preload != p->preload) {
+		ret = pipeline_copy_list_build(p);
+		if (ret < 0)
+			return ret;
+	}
+
+	if (p->copy_xcore)
+		pipeline_xcore_sync(p);
+
+	if (p->xrun_conceal_dma)
+		pipeline_xrun_conceal_dma(p);
+
+	while (i < p->copy_count) {
+		entry = &p->copy_list[i];
+		conceal_us = p->xrun_conceal_us;
+
+		if (entry->fused) {
+			comp = entry[entry->fused - 1].comp;
+			ret = pipeline_fused_copy(p, entry);
+		} else {
+			comp = entry->comp;
+			cycles = perf_cycles_get();
+			ret = entry->copy(comp);
+			perf_cnt_update(&comp->perf,
+					perf_cycles_get() - cycles);
+		}
+		/* concealed xrun refilled the buffers, copy again */
+		if (ret < 0 && p->xrun_conceal_us != conceal_us)
+			continue;
+
+		if (ret < 0) {
+			trace_pipe_error("pipeline_copy() error: ret = %d, "
+					 "comp->comp.id = %u", ret,
+					 comp->comp.id);
+			break;
+		}
+
+		/* components changed state during copy e.g. on xrun */
+		if (!p->copy_list_valid) {
+			ret = pipeline_copy_list_build(p);
+			if (ret < 0)
+				break;
+			i = pipeline_copy_list_next(p, comp);
+			continue;
+		}
+
+		if (entry->fused)
+			i += entry->fused;
+		else if (ret == PPL_STATUS_PATH_STOP)
+			i = entry->skip;
+		else
+			i++;
+	}
 
 	p->preload = false;
 
@@ -773,6 +1343,85 @@ void pipeline_xrun(struct pipeline *p, struct comp_dev *dev,
 	pipeline_comp_xrun(dev, &data, dev->params.direction);
 }
 
+/* Xruns are concealed at the starving or blocked buffer while their
+ * length in a row stays within the xrun limit of the scheduling pipeline,
+ * so component state is kept. Longer xruns are reported to the host and
+ * recovered by a full prepare. Xruns of DMA callbacks are only recorded
+ * there and concealed by the next pipeline copy.
+ */
+bool pipeline_xrun_conceal(struct pipeline *p, struct comp_buffer *buffer,
+			   uint32_t bytes, bool underrun)
+{
+	struct comp_dev *dev = underrun ? buffer->source : buffer->sink;
+	struct comp_dev *dma = underrun ? buffer->sink : buffer->source;
+	uint32_t frame_bytes;
+	uint32_t flags;
+	uint32_t us;
+
+	if (!p || !p->sched_comp || buffer->xcore)
+		return false;
+
+	p = p->sched_comp->pipeline;
+	if (!p->ipc_pipe.xrun_limit_usecs || !buffer->source ||
+	    !buffer->sink)
+		return false;
+
+	/* the pointer to move must not be owned by a DMA, otherwise the
+	 * buffer and the DMA positions would never meet again
+	 */
+	if (dev->is_dma_connected)
+		return false;
+
+	frame_bytes = comp_frame_bytes(buffer->source);
+	if (!frame_bytes || !buffer->source->params.rate)
+		return false;
+
+	/* one period of the starving or blocked component if size unknown */
+	if (!bytes)
+		bytes = dev->frames * frame_bytes;
+
+	bytes = MIN(bytes, underrun ? buffer->free : buffer->avail);
+	bytes -= bytes % frame_bytes;
+	if (!bytes)
+		return false;
+
+	us = (uint64_t)(bytes / frame_bytes) * 1000000 /
+		buffer->source->params.rate;
+
+	/* called from DAI DMA callbacks too */
+	spin_lock_irq(&p->lock, flags);
+
+	if (p->xrun_conceal_us + us > p->ipc_pipe.xrun_limit_usecs ||
+	    buffer->conceal_bytes + bytes > buffer->size) {
+		spin_unlock_irq(&p->lock, flags);
+		return false;
+	}
+
+	p->xrun_conceal_us += us;
+	p->xrun_concealed = true;
+
+	/* the other position may be moved by the task right now */
+	if (dma->is_dma_connected) {
+		buffer->conceal_bytes += bytes;
+		p->xrun_conceal_dma = true;
+	}
+
+	spin_unlock_irq(&p->lock, flags);
+
+	trace_pipe_with_ids(p, "pipeline_xrun_conceal(), buffer %u us %u",
+			    buffer->ipc_buffer.comp.id, us);
+
+	if (dma->is_dma_connected)
+		return true;
+
+	if (underrun)
+		buffer_conceal_underrun(buffer, bytes);
+	else
+		buffer_conceal_overrun(buffer, bytes);
+
+	return true;
+}
+
 #if NO_XRUN_RECOVERY
 /* recover the pipeline from a XRUN condition */
 static int pipeline_xrun_recover(struct pipeline *p)
@@ -813,11 +1462,89 @@ static int pipeline_xrun_recover(struct pipeline *p)
 }
 #endif
 
+/* apply the control updates of one bulk and free it */
+static int pipeline_ctrl_bulk_run(struct pipeline_ctrl_bulk *bulk)
+{
+	struct pipeline_ctrl_update *update;
+	struct sof_ipc_ctrl_data *data;
+	int ret = 0;
+	int err;
+	int i;
+
+	for (i = 0; i < bulk->count; i++) {
+		update = &bulk->update[i];
+		data = (struct sof_ipc_ctrl_data *)((char *)bulk +
+						    update->offset);
+
+		err = comp_cmd(update->dev, update->cmd, data,
+			       data->rhdr.hdr.size);
+		if (err < 0) {
+			trace_pipe_error("pipeline_ctrl_bulk_run() error: "
+					 "comp %u cmd %d failed %d",
+					 update->dev->comp.id, update->cmd,
+					 err);
+			if (!ret)
+				ret = err;
+		}
+	}
+
+	rfree(bulk);
+	return ret;
+}
+
+int pipeline_ctrl_bulk_queue(struct pipeline *p,
+			     struct pipeline_ctrl_bulk *bulk)
+{
+	struct pipeline_ctrl_bulk **tail;
+	uint32_t flags;
+
+	tracev_pipe_with_ids(p, "pipeline_ctrl_bulk_queue(), count = %u",
+			     bulk->count);
+
+	bulk->next = NULL;
+
+	spin_lock_irq(&p->lock, flags);
+
+	/* updates of an active pipeline wait for the next period */
+	if (p->status == COMP_STATE_ACTIVE) {
+		for (tail = &p->ctrl_bulk; *tail; tail = &(*tail)->next)
+			;
+		*tail = bulk;
+		spin_unlock_irq(&p->lock, flags);
+		return 0;
+	}
+
+	spin_unlock_irq(&p->lock, flags);
+
+	return pipeline_ctrl_bulk_run(bulk);
+}
+
+void pipeline_ctrl_bulk_apply(struct pipeline *p)
+{
+	struct pipeline_ctrl_bulk *bulk;
+	struct pipeline_ctrl_bulk *next;
+	uint32_t flags;
+
+	if (!p->ctrl_bulk)
+		return;
+
+	spin_lock_irq(&p->lock, flags);
+	bulk = p->ctrl_bulk;
+	p->ctrl_bulk = NULL;
+	spin_unlock_irq(&p->lock, flags);
+
+	/* errors are traced, the host was already answered */
+	for (; bulk; bulk = next) {
+		next = bulk->next;
+		pipeline_ctrl_bulk_run(bulk);
+	}
+}
+
 /* notify pipeline that this component requires buffers emptied/filled */
 void pipeline_schedule_copy(struct pipeline *p, uint64_t start)
 {
 	if (p->sched_comp->state == COMP_STATE_ACTIVE)
-		schedule_task(&p->pipe_task, start, p->ipc_pipe.period, 0);
+		schedule_task(&p->pipe_task, start, pipeline_period(p), 0);
 }
 
 /* notify pipeline that this component requires buffers emptied/filled
@@ -826,7 +1553,7 @@ void pipeline_schedule_copy(struct pipeline *p, uint64_t start)
  */
 void pipeline_schedule_copy_idle(struct pipeline *p)
 {
-	schedule_task(&p->pipe_task, 0, p->ipc_pipe.period,
+	schedule_task(&p->pipe_task, 0, pipeline_period(p),
 		      SOF_SCHEDULE_FLAG_IDLE);
 }
 
@@ -842,13 +1569,178 @@ void pipeline_schedule_cancel(struct pipeline *p)
 					  "failed, err = %d", err);
 }
 
+uint64_t pipeline_wallclock_hz(void)
+{
+#if CONFIG_HOST
+	return 1000000;
+#else
+	return clock_ms_to_ticks(PLATFORM_DEFAULT_CLOCK, 1) * 1000;
+#endif
+}
+
+/* testbench has no wallclock, its time advances one period per task run */
+static uint64_t pipeline_wallclock(struct pipeline *p)
+{
+#if CONFIG_HOST
+	return p->telemetry.count * pipeline_period(p);
+#else
+	return platform_timer_get(platform_timer);
+#endif
+}
+
+bool pipeline_is_stream_buffer(struct pipeline *p,
+			       struct comp_buffer *buffer)
+{
+	return buffer->source && buffer->source->pipeline &&
+		pipeline_is_same_sched_comp(buffer->source->pipeline, p);
+}
+
+uint32_t pipeline_buffer_latency(struct comp_buffer *buffer)
+{
+	uint32_t frame_bytes;
+
+	if (!buffer->sink)
+		return 0;
+
+	frame_bytes = comp_frame_bytes(buffer->sink);
+	if (!frame_bytes || !buffer->sink->params.rate)
+		return 0;
+
+	return (uint64_t)(buffer->avail / frame_bytes) * 1000000 /
+		buffer->sink->params.rate;
+}
+
+/* account fill level of all buffers written by the pipeline task */
+static uint32_t pipeline_telemetry_buffers(struct pipeline *p, bool remote)
+{
+	struct pipeline_telemetry *t = &p->telemetry;
+	struct list_item *clist;
+	struct comp_buffer *buffer;
+	uint32_t latency = 0;
+	uint32_t i;
+
+	for (i = 0; i < p->copy_count; i++) {
+		list_for_item(clist, &p->copy_list[i].comp->bsink_list) {
+			buffer = container_of(clist, struct comp_buffer,
+					      source_list);
+
+			/* fill levels restart with the telemetry */
+			if (!t->count || buffer->avail < buffer->avail_min)
+				buffer->avail_min = buffer->avail;
+			if (!t->count || buffer->avail > buffer->avail_max)
+				buffer->avail_max = buffer->avail;
+
+			/* IPC on the master core reads the fill levels, only
+			 * the source writes them in cross-core buffers
+			 */
+			if (remote && !buffer->xcore)
+				dcache_writeback_region(buffer,
+							sizeof(*buffer));
+			else if (remote)
+				dcache_writeback_region(&buffer->avail_min,
+							2 * sizeof(uint32_t));
+
+			latency += pipeline_buffer_latency(buffer);
+		}
+	}
+
+	return latency;
+}
+
+/* estimate how much faster the DAI clock runs than the wallclock */
+static void pipeline_telemetry_drift(struct pipeline *p, struct comp_dev *dai)
+{
+	struct pipeline_telemetry *t = &p->telemetry;
+	uint32_t frame_bytes = comp_frame_bytes(dai);
+	uint64_t frames;
+	int64_t ticks;
+	int32_t drift;
+
+	if (!frame_bytes || !dai->params.rate || !t->wallclock)
+		return;
+
+	/* wallclock ticks the DAI needed for its frames by its own clock */
+	frames = (t->dai_posn - t->dai_posn_start) / frame_bytes;
+	ticks = frames * pipeline_wallclock_hz() / dai->params.rate;
+
+	drift = (ticks - (int64_t)t->wallclock) * 1000000 /
+		(int64_t)t->wallclock;
+
+	if (t->count == PPL_TELEMETRY_DRIFT_PERIODS)
+		t->drift = drift;
+	else
+		t->drift += (drift - t->drift) /
+			(1 << PPL_TELEMETRY_DRIFT_SHIFT);
+}
+
+/* update stream telemetry after a pipeline period */
+static void pipeline_telemetry_update(struct pipeline *p)
+{
+	struct pipeline_telemetry *t = &p->telemetry;
+	uint64_t now = pipeline_wallclock(p);
+	struct comp_dev *host = p->source_comp;
+	struct comp_dev *dai = p->sink_comp;
+	bool remote = p->ipc_pipe.core != PLATFORM_MASTER_CORE_ID;
+	uint32_t latency;
+
+	/* IPC on the master core reads and resets telemetry in memory */
+	if (remote)
+		dcache_invalidate_region(t, sizeof(*t));
+
+	latency = pipeline_telemetry_buffers(p, remote);
+
+	if (p->source_comp->params.direction == SOF_IPC_STREAM_CAPTURE) {
+		host = p->sink_comp;
+		dai = p->source_comp;
+	}
+
+	/* positions restart on xrun recovery, so does the drift baseline */
+	if (!t->count || dai->position < t->dai_posn) {
+		t->wallclock_start = now;
+		t->dai_posn_start = dai->position;
+		t->drift_count = 0;
+	}
+
+	/* DAI clock is measured from the last period before it started */
+	if (!t->drift_count && dai->position == t->dai_posn_start)
+		t->wallclock_start = now;
+
+	if (!t->count)
+		t->latency_min = latency;
+
+	t->host_posn = host->position;
+	t->dai_posn = dai->position;
+
+	t->wallclock = now - t->wallclock_start;
+	t->latency = latency;
+	if (latency < t->latency_min)
+		t->latency_min = latency;
+	if (latency > t->latency_max)
+		t->latency_max = latency;
+
+	t->count++;
+	if (t->drift_count || dai->position != t->dai_posn_start)
+		t->drift_count++;
+
+	if (t->drift_count >= PPL_TELEMETRY_DRIFT_PERIODS)
+		pipeline_telemetry_drift(p, dai);
+
+	if (remote)
+		dcache_writeback_region(t, sizeof(*t));
+}
+
 static uint64_t pipeline_task(void *arg)
 {
 	struct pipeline *p = arg;
+	uint32_t cycles = perf_cycles_get();
+	uint32_t flags;
 	int err;
 
 	tracev_pipe_with_ids(p, "pipeline_task()");
 
+	/* apply bulk control updates at the period boundary */
+	pipeline_ctrl_bulk_apply(p);
+
 	/* are we in xrun ? */
 	if (p->xrun_bytes) {
 		/* try to recover */
@@ -867,7 +1759,19 @@ static uint64_t pipeline_task(void *arg)
 		}
 	}
 
+	/* xruns are concealed in a row until a period runs without one */
+	spin_lock_irq(&p->lock, flags);
+	if (!p->xrun_concealed)
+		p->xrun_conceal_us = 0;
+	p->xrun_concealed = false;
+
+	/* telemetry may be read and reset by IPC */
+	pipeline_telemetry_update(p);
+
+	spin_unlock_irq(&p->lock, flags);
+
 sched:
+	perf_cnt_update(&p->perf, perf_cycles_get() - cycles);
 	tracev_pipe("pipeline_task() sched");
-	return p->ipc_pipe.period;
+	return pipeline_period(p);
 }
@@ -150,6 +150,82 @@ static struct comp_dev *selector_new(struct sof_ipc_comp *comp)
 	return dev;
 }
 
+/**
+ * \brief Checks if sink buffer can alias source buffer memory.
+ * \param[in] cd Selector component private data.
+ * \param[in] sink Sink buffer.
+ * \return True if passthrough data can be forwarded without copy.
+ *
+ * Sink read by DMA has to stay in the memory DMA was configured with.
+ */
+static bool sel_can_alias(struct comp_data *cd, struct comp_buffer *sink)
+{
+	return cd->config.in_channels_count ==
+		cd->config.out_channels_count &&
+		cd->source_format == cd->sink_format &&
+		!sink->sink->is_dma_connected && !sink->cb;
+}
+
+/**
+ * \brief Aliases sink buffer to source buffer memory.
+ * \param[in,out] cd Selector component private data.
+ * \param[in,out] source Source buffer.
+ * \param[in,out] sink Sink buffer.
+ *
+ * Sink write pointer follows source read pointer plus forwarded bytes,
+ * so source data becomes sink data without a copy.
+ */
+static void sel_alias_sink(struct comp_data *cd, struct comp_buffer *source,
+			   struct comp_buffer *sink)
+{
+	uint32_t flags;
+
+	trace_selector("sel_alias_sink()");
+
+	/* keep the original memory for unalias */
+	if (cd->alias_sink != sink) {
+		cd->alias_sink = sink;
+		cd->alias_sink_addr = sink->addr;
+		cd->alias_sink_size = sink->size;
+	}
+
+	spin_lock_irq(&sink->lock, flags);
+
+	sink->addr = source->addr;
+	sink->end_addr = source->end_addr;
+	sink->size = source->size;
+	sink->r_ptr = source->r_ptr;
+	sink->w_ptr = source->r_ptr;
+	sink->avail = 0;
+	sink->free = sink->size;
+
+	spin_unlock_irq(&sink->lock, flags);
+
+	cd->alias_bytes = 0;
+}
+
+/**
+ * \brief Restores sink buffer memory.
+ * \param[in,out] cd Selector component private data.
+ */
+static void sel_unalias_sink(struct comp_data *cd)
+{
+	struct comp_buffer *sink = cd->alias_sink;
+
+	if (!sink)
+		return;
+
+	trace_selector("sel_unalias_sink()");
+
+	sink->addr = cd->alias_sink_addr;
+	sink->end_addr = sink->addr + cd->alias_sink_size;
+	sink->size = cd->alias_sink_size;
+	buffer_reset_pos(sink);
+
+	cd->alias_sink = NULL;
+	cd->alias_bytes = 0;
+}
+
 /**
  * \brief Frees selector component.
  * \param[in,out] dev Selector base component device.
@@ -160,6 +236,8 @@ static void selector_free(struct comp_dev *dev)
 
 	trace_selector("selector_free()");
 
+	sel_unalias_sink(cd);
+
 	rfree(cd);
 	rfree(dev);
 }
@@ -208,6 +286,11 @@ static int selector_ctrl_set_data(struct comp_dev *dev,
 		/* Just copy the configuration & verify input params.*/
 		ret = sel_set_channel_values(cd, cfg->in_channels_count,
 				  cfg->out_channels_count, cfg->sel_channel);
+		if (ret < 0)
+			break;
+
+		/* running copy picks up the new channel selection */
+		sel_set_channel_map(cd);
 		break;
 	default:
 		trace_selector_error("selector_ctrl_set_cmd() error: "
@@ -309,6 +392,69 @@ static int selector_trigger(struct comp_dev *dev, int cmd)
 }
 
 
+/**
+ * \brief Forwards passthrough data through aliased sink buffer.
+ * \param[in,out] dev Selector base component device.
+ * \param[in,out] source Source buffer.
+ * \param[in,out] sink Sink buffer.
+ * \return Error code.
+ *
+ * Source data is consumed only after sink reader consumed it, so the
+ * source writer can't overwrite data still used by the sink reader.
+ */
+static int selector_copy_alias(struct comp_dev *dev,
+			       struct comp_buffer *source,
+			       struct comp_buffer *sink)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	uint32_t bytes;
+	void *w_ptr;
+
+	/* expected sink write position */
+	w_ptr = source->r_ptr + cd->alias_bytes;
+	if (w_ptr >= source->end_addr)
+		w_ptr = source->addr + (w_ptr - source->end_addr);
+
+	/* alias again if buffers were reset e.g. on xrun recovery */
+	if (cd->alias_sink != sink || sink->addr != source->addr ||
+	    sink->w_ptr != w_ptr || sink->avail > cd->alias_bytes)
+		sel_alias_sink(cd, source, sink);
+
+	/* release source data already consumed by sink reader */
+	bytes = cd->alias_bytes - sink->avail;
+	if (bytes) {
+		comp_update_buffer_consume(source, bytes);
+		cd->alias_bytes -= bytes;
+	}
+
+	/* check for overrun */
+	if (sink->free == 0) {
+		trace_selector_error("selector_copy_alias() error: "
+				     "sink component buffer has not enough "
+				     "free bytes for copy");
+		comp_overrun(dev, sink, 0, 0);
+		return -EIO;
+	}
+
+	/* check for underrun */
+	bytes = source->avail - cd->alias_bytes;
+	if (bytes == 0) {
+		trace_selector_error("selector_copy_alias() error: "
+				     "source component buffer has not enough "
+				     "data available");
+		comp_underrun(dev, source, 0, 0);
+		return -EIO;
+	}
+
+	tracev_selector("selector_copy_alias(), bytes = 0x%x", bytes);
+
+	/* forward new source data */
+	comp_update_buffer_produce(sink, bytes);
+	cd->alias_bytes += bytes;
+
+	return 0;
+}
+
 /**
  * \brief Copies and processes stream data.
  * \param[in,out] dev Selector base component device.
@@ -331,6 +477,13 @@ static int selector_copy(struct comp_dev *dev)
 	sink = list_first_item(&dev->bsink_list, struct comp_buffer,
 			       source_list);
 
+	/* passthrough without copy */
+	if (cd->alias)
+		return selector_copy_alias(dev, source, sink);
+
+	/* sink must not point into source memory when data is copied */
+	sel_unalias_sink(cd);
+
 	/* check for underrun */
 	if (source->avail == 0) {
 		trace_selector_error("selector_copy() error: "
@@ -454,6 +607,11 @@ static int selector_prepare(struct comp_dev *dev)
 		goto err;
 	}
 
+	/* forwarding mode is kept until the next prepare */
+	cd->alias = sel_can_alias(cd, sinkb);
+	if (!cd->alias)
+		sel_unalias_sink(cd);
+
 	return 0;
 
 err:
@@ -468,8 +626,13 @@ err:
  */
 static int selector_reset(struct comp_dev *dev)
 {
+	struct comp_data *cd = comp_get_drvdata(dev);
+
 	trace_selector("selector_reset()");
 
+	sel_unalias_sink(cd);
+	cd->alias = false;
+
 	return comp_set_state(dev, COMP_TRIGGER_RESET);
 }
 
@@ -82,6 +82,14 @@ struct comp_data {
 	enum sof_ipc_frame source_format;	/**< source frame format */
 	enum sof_ipc_frame sink_format;		/**< sink frame format */
 	struct sof_sel_config config;	/**< component configuration data */
+	uint32_t ch_map[SEL_SINK_4CH];	/**< source channel of sink channel */
+
+	/* passthrough sink buffer aliased to source buffer memory */
+	bool alias;			/**< forward by alias, set at prepare */
+	struct comp_buffer *alias_sink;	/**< aliased sink buffer */
+	void *alias_sink_addr;		/**< original sink buffer address */
+	uint32_t alias_sink_size;	/**< original sink buffer size */
+	uint32_t alias_bytes;		/**< source bytes forwarded to sink */
 	/**< channel selector processing function */
 	void (*sel_func)(struct comp_dev *dev, struct comp_buffer *sink,
 		struct comp_buffer *source, uint32_t frames);
@@ -108,4 +116,10 @@ typedef void (*sel_func)(struct comp_dev *, struct comp_buffer *,
  */
 sel_func sel_get_processing_function(struct comp_dev *dev);
 
+/**
+ * \brief Sets source channel for each sink channel.
+ * \param[in,out] cd Selector component private data.
+ */
+void sel_set_channel_map(struct comp_data *cd);
+
 #endif /* SELECTOR_H */
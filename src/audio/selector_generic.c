@@ -36,83 +36,174 @@
 
 #include "selector.h"
 
-/** 
- * \brief Channel selection for 16 bit, 1 channel data format.
+/**
+ * \brief Limits number of frames to the ones stored before buffer wrap.
+ * \param[in] buffer Buffer to process.
+ * \param[in] ptr Current position in the buffer.
+ * \param[in] frame_bytes Size of a frame in the buffer.
+ * \param[in] frames Number of frames to process.
+ * \return Number of frames which can be accessed linearly.
+ */
+static inline uint32_t sel_block_frames(struct comp_buffer *buffer, void *ptr,
+					uint32_t frame_bytes, uint32_t frames)
+{
+	uint32_t block = (uint32_t)(buffer->end_addr - ptr) / frame_bytes;
+
+	return MIN(block, frames);
+}
+
+/**
+ * \brief Wraps buffer position.
+ * \param[in] buffer Processed buffer.
+ * \param[in] ptr Position after processed block.
+ * \return Position inside the buffer.
+ */
+static inline void *sel_block_wrap(struct comp_buffer *buffer, void *ptr)
+{
+	if (ptr >= buffer->end_addr)
+		ptr = buffer->addr + (ptr - buffer->end_addr);
+
+	return ptr;
+}
+
+void sel_set_channel_map(struct comp_data *cd)
+{
+	uint32_t ch;
+
+	if (cd->config.out_channels_count == SEL_SINK_1CH) {
+		cd->ch_map[0] = cd->config.sel_channel;
+		return;
+	}
+
+	for (ch = 0; ch < cd->config.out_channels_count; ch++)
+		cd->ch_map[ch] = ch;
+}
+
+/**
+ * \brief Channel map for 16 bit data format.
  * \param[in,out] dev Selector base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
  * \param[in] frames Number of frames to process.
+ *
+ * Deinterleaves source frames block by block, where every block ends at
+ * the source or sink buffer wrap.
  */
-static void sel_s16le_1ch(struct comp_dev *dev, struct comp_buffer *sink,
+static void sel_s16le_map(struct comp_dev *dev, struct comp_buffer *sink,
 			  struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
-	int16_t *dest;
+	uint32_t in_nch = cd->config.in_channels_count;
+	uint32_t out_nch = cd->config.out_channels_count;
+	int16_t *src = source->r_ptr;
+	int16_t *dest = sink->w_ptr;
+	uint32_t ch;
 	uint32_t i;
-	uint32_t j = 0;
-	uint32_t nch = cd->config.in_channels_count;
+	uint32_t n;
 
-	for (i = cd->config.sel_channel; i < frames * nch; i += nch) {
-		src = buffer_read_frag_s16(source, i);
-		dest = buffer_write_frag_s16(sink, j++);
-		*dest = *src;
+	while (frames) {
+		n = sel_block_frames(source, src, in_nch * sizeof(int16_t),
+				     frames);
+		n = sel_block_frames(sink, dest, out_nch * sizeof(int16_t), n);
+
+		for (i = 0; i < n; i++) {
+			for (ch = 0; ch < out_nch; ch++)
+				dest[ch] = src[cd->ch_map[ch]];
+			src += in_nch;
+			dest += out_nch;
+		}
+
+		src = sel_block_wrap(source, src);
+		dest = sel_block_wrap(sink, dest);
+		frames -= n;
 	}
 }
 
-/** 
- * \brief Channel selection for 32 bit, 1 channel data format.
+/**
+ * \brief Channel map for 32 bit data format.
  * \param[in,out] dev Selector base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
  * \param[in] frames Number of frames to process.
+ *
+ * Deinterleaves source frames block by block, where every block ends at
+ * the source or sink buffer wrap.
  */
-static void sel_s32le_1ch(struct comp_dev *dev, struct comp_buffer *sink,
+static void sel_s32le_map(struct comp_dev *dev, struct comp_buffer *sink,
 			  struct comp_buffer *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
+	uint32_t in_nch = cd->config.in_channels_count;
+	uint32_t out_nch = cd->config.out_channels_count;
+	int32_t *src = source->r_ptr;
+	int32_t *dest = sink->w_ptr;
+	uint32_t ch;
 	uint32_t i;
-	uint32_t j = 0;
-	uint32_t nch = cd->config.in_channels_count;
+	uint32_t n;
+
+	while (frames) {
+		n = sel_block_frames(source, src, in_nch * sizeof(int32_t),
+				     frames);
+		n = sel_block_frames(sink, dest, out_nch * sizeof(int32_t), n);
 
-	for (i = cd->config.sel_channel; i < frames * nch; i += nch) {
-		src = buffer_read_frag_s32(source, i);
-		dest = buffer_write_frag_s32(sink, j++);
-		*dest = *src;
+		for (i = 0; i < n; i++) {
+			for (ch = 0; ch < out_nch; ch++)
+				dest[ch] = src[cd->ch_map[ch]];
+			src += in_nch;
+			dest += out_nch;
+		}
+
+		src = sel_block_wrap(source, src);
+		dest = sel_block_wrap(sink, dest);
+		frames -= n;
 	}
 }
 
-/** 
- * \brief Channel selection for 16 bit, at least 2 channels data format.
+/**
+ * \brief Passthrough copy of all channels.
  * \param[in,out] dev Selector base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
  * \param[in] frames Number of frames to process.
+ * \param[in] sample_bytes Size of a sample.
  */
-static void sel_s16le_nch(struct comp_dev *dev, struct comp_buffer *sink,
-			  struct comp_buffer *source, uint32_t frames)
+static void sel_nch_copy(struct comp_dev *dev, struct comp_buffer *sink,
+			 struct comp_buffer *source, uint32_t frames,
+			 uint32_t sample_bytes)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
-	int16_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
-	uint32_t channel;
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < cd->config.in_channels_count; channel++) {
-			src = buffer_read_frag_s16(source, j);
-			dest = buffer_write_frag_s16(sink, j);
-			*dest = *src;
-			j++;
-		}
+	uint32_t frame_bytes = cd->config.in_channels_count * sample_bytes;
+	void *src = source->r_ptr;
+	void *dest = sink->w_ptr;
+	uint32_t n;
+
+	while (frames) {
+		n = sel_block_frames(source, src, frame_bytes, frames);
+		n = sel_block_frames(sink, dest, frame_bytes, n);
+
+		memcpy(dest, src, n * frame_bytes);
+
+		src = sel_block_wrap(source, src + n * frame_bytes);
+		dest = sel_block_wrap(sink, dest + n * frame_bytes);
+		frames -= n;
 	}
 }
 
-/** 
- * \brief Channel selection for 32 bit, at least 2 channels data format.
+/**
+ * \brief Passthrough for 16 bit, at least 2 channels data format.
+ * \param[in,out] dev Selector base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void sel_s16le_nch(struct comp_dev *dev, struct comp_buffer *sink,
+			  struct comp_buffer *source, uint32_t frames)
+{
+	sel_nch_copy(dev, sink, source, frames, sizeof(int16_t));
+}
+
+/**
+ * \brief Passthrough for 32 bit, at least 2 channels data format.
  * \param[in,out] dev Selector base component device.
  * \param[in,out] sink Destination buffer.
  * \param[in,out] source Source buffer.
@@ -121,27 +212,13 @@ static void sel_s16le_nch(struct comp_dev *dev, struct comp_buffer *sink,
 static void sel_s32le_nch(struct comp_dev *dev, struct comp_buffer *sink,
 			  struct comp_buffer *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
-	uint32_t channel;
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < cd->config.in_channels_count; channel++) {
-			src = buffer_read_frag_s32(source, j);
-			dest = buffer_write_frag_s32(sink, j);
-			*dest = *src;
-			j++;
-		}
-	}
+	sel_nch_copy(dev, sink, source, frames, sizeof(int32_t));
 }
 
 const struct comp_func_map func_table[] = {
-	{SOF_IPC_FRAME_S16_LE, 1, sel_s16le_1ch},
-	{SOF_IPC_FRAME_S24_4LE, 1, sel_s32le_1ch},
-	{SOF_IPC_FRAME_S32_LE, 1, sel_s32le_1ch},
+	{SOF_IPC_FRAME_S16_LE, 1, sel_s16le_map},
+	{SOF_IPC_FRAME_S24_4LE, 1, sel_s32le_map},
+	{SOF_IPC_FRAME_S32_LE, 1, sel_s32le_map},
 	{SOF_IPC_FRAME_S16_LE, 2, sel_s16le_nch},
 	{SOF_IPC_FRAME_S24_4LE, 2, sel_s32le_nch},
 	{SOF_IPC_FRAME_S32_LE, 2, sel_s32le_nch},
@@ -155,6 +232,8 @@ sel_func sel_get_processing_function(struct comp_dev *dev)
 	struct comp_data *cd = comp_get_drvdata(dev);
 	int i;
 
+	sel_set_channel_map(cd);
+
 	/* map the channel selection function for source and sink buffers */
 	for (i = 0; i < ARRAY_SIZE(func_table); i++) {
 		if (cd->source_format != func_table[i].source)
@@ -843,7 +843,9 @@ static int src_prepare(struct comp_dev *dev)
 	if (ret == COMP_STATUS_STATE_ALREADY_SET)
 		return PPL_STATUS_PATH_STOP;
 
-	/* SRC supports S16_LE, S24_4LE and S32_LE formats */
+	/* SRC supports S16_LE, S24_4LE and S32_LE formats, and FLOAT when
+	 * SRC_FLOAT is set
+	 */
 	switch (dev->params.frame_fmt) {
 	case SOF_IPC_FRAME_S16_LE:
 		cd->data_shift = 0;
@@ -864,6 +866,12 @@ static int src_prepare(struct comp_dev *dev)
 		cd->data_shift = 0;
 		cd->polyphase_func = src_polyphase_stage_cir;
 		break;
+#if SRC_FLOAT
+	case SOF_IPC_FRAME_FLOAT:
+		cd->data_shift = 0;
+		cd->polyphase_func = src_polyphase_stage_cir_float;
+		break;
+#endif
 	default:
 		trace_src_error("src_prepare() error: invalid dev->frame_fmt");
 		return -EINVAL;
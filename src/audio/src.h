@@ -118,6 +118,14 @@ static inline void src_dec_wrap_s16(int16_t **ptr, int16_t *addr, size_t size)
 		*ptr = (int16_t *)((size_t)*ptr + size);
 }
 
+#if SRC_FLOAT
+static inline void src_inc_wrap_float(float **ptr, float *end, size_t size)
+{
+	if (*ptr >= end)
+		*ptr = (float *)((size_t)*ptr - size);
+}
+#endif
+
 void src_polyphase_reset(struct polyphase_src *src);
 
 int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
@@ -130,6 +138,10 @@ void src_polyphase_stage_cir(struct src_stage_prm *s);
 
 void src_polyphase_stage_cir_s16(struct src_stage_prm *s);
 
+#if SRC_FLOAT
+void src_polyphase_stage_cir_float(struct src_stage_prm *s);
+#endif
+
 int src_buffer_lengths(struct src_param *p, int fs_in, int fs_out, int nch,
 		       int source_frames);
 
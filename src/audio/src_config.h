@@ -47,6 +47,7 @@
 #define SRC_GENERIC	1
 #define SRC_HIFIEP	0
 #define SRC_HIFI3	0
+#define SRC_X86		0
 #endif
 
 /* Select optimized code variant when xt-xcc compiler is used */
@@ -54,6 +55,7 @@
 #if defined __XCC__
 #include <xtensa/config/core-isa.h>
 #define SRC_GENERIC	0
+#define SRC_X86		0
 #if XCHAL_HAVE_HIFI2EP == 1
 #define SRC_SHORT	1  /* Select 16 bit coefficients to save RAM */
 #define SRC_HIFIEP	1
@@ -71,10 +73,26 @@
 #else
 #define SRC_SHORT	1  /* Use 16 bit filter coefficients for speed */
 #endif
+/* Use SSE4.2 and AVX2 code in x86 host builds */
+#if defined(__SSE4_2__)
+#define SRC_GENERIC	0
+#define SRC_X86		1
+#else
 #define SRC_GENERIC	1
+#define SRC_X86		0
+#endif
 #define SRC_HIFIEP	0
 #define SRC_HIFI3	0
 #endif
 #endif
 
+/* Float samples are converted to Q1.31 at stage input and output. The
+ * conversion is plain C so it is available in the generic and x86 builds.
+ */
+#if CONFIG_FORMAT_FLOAT && (SRC_GENERIC || SRC_X86)
+#define SRC_FLOAT	1
+#else
+#define SRC_FLOAT	0
+#endif
+
 #endif
@@ -446,4 +446,105 @@ void src_polyphase_stage_cir_s16(struct src_stage_prm *s)
 	s->y_wptr = y_wptr;
 }
 
+#if SRC_FLOAT
+void src_polyphase_stage_cir_float(struct src_stage_prm *s)
+{
+	int i;
+	int n;
+	int m;
+	int n_wrap_buf;
+	int n_wrap_fir;
+	int n_min;
+	int32_t *rp;
+	int32_t *wp;
+
+	struct src_state *fir = s->state;
+	struct src_stage *cfg = s->stage;
+	int32_t *fir_delay = fir->fir_delay;
+	int32_t *fir_end = &fir->fir_delay[fir->fir_delay_size];
+	int32_t *out_delay_end = &fir->out_delay[fir->out_delay_size];
+	const void *cp; /* Can be int32_t or int16_t */
+	const size_t out_size = fir->out_delay_size * sizeof(int32_t);
+	const int nch = s->nch;
+	const int nch_x_odm = cfg->odm * nch;
+	const int blk_in_words = nch * cfg->blk_in;
+	const int blk_out_words = nch * cfg->num_of_subfilters;
+	const int fir_length = fir->fir_delay_size;
+	const int rewind = nch * (cfg->blk_in
+		+ (cfg->num_of_subfilters - 1) * cfg->idm) - nch;
+	const int nch_x_idm = nch * cfg->idm;
+	const size_t fir_size = fir->fir_delay_size * sizeof(int32_t);
+	const int taps_x_nch = cfg->subfilter_length * nch;
+	float *x_rptr = (float *)s->x_rptr;
+	float *y_wptr = (float *)s->y_wptr;
+	float *x_end_addr = (float *)s->x_end_addr;
+	float *y_end_addr = (float *)s->y_end_addr;
+
+#if SRC_SHORT
+	const size_t subfilter_size = cfg->subfilter_length * sizeof(int16_t);
+#else
+	const size_t subfilter_size = cfg->subfilter_length * sizeof(int32_t);
+#endif
+
+	for (n = 0; n < s->times; n++) {
+		/* Input data, convert to Q1.31 */
+		m = blk_in_words;
+		while (m > 0) {
+			/* Number of words without circular wrap */
+			n_wrap_buf = x_end_addr - x_rptr;
+			n_wrap_fir = fir->fir_wp - fir->fir_delay + 1;
+			n_min = (n_wrap_fir < n_wrap_buf)
+				? n_wrap_fir : n_wrap_buf;
+			n_min = (m < n_min) ? m : n_min;
+			m -= n_min;
+			for (i = 0; i < n_min; i++) {
+				*fir->fir_wp = float_to_s32(*x_rptr);
+				fir->fir_wp--;
+				x_rptr++;
+			}
+			/* Check for wrap */
+			src_dec_wrap(&fir->fir_wp, fir_delay, fir_size);
+			src_inc_wrap_float(&x_rptr, x_end_addr, s->x_size);
+		}
+
+		/* Filter */
+		cp = cfg->coefs; /* Reset to 1st coefficient */
+		rp = fir->fir_wp + rewind;
+		src_inc_wrap(&rp, fir_end, fir_size);
+		wp = fir->out_rp;
+		for (i = 0; i < cfg->num_of_subfilters; i++) {
+			fir_filter_generic(rp, cp, wp,
+					   fir_delay, fir_end, fir_length,
+					   taps_x_nch, cfg->shift, nch);
+			wp += nch_x_odm;
+			cp += subfilter_size;
+			src_inc_wrap(&wp, out_delay_end, out_size);
+			rp -= nch_x_idm; /* Next sub-filter start */
+			src_dec_wrap(&rp, fir_delay, fir_size);
+		}
+
+		/* Output, convert back to float */
+		m = blk_out_words;
+		while (m > 0) {
+			n_wrap_fir = out_delay_end - fir->out_rp;
+			n_wrap_buf = y_end_addr - y_wptr;
+			n_min = (n_wrap_fir < n_wrap_buf)
+				? n_wrap_fir : n_wrap_buf;
+			n_min = (m < n_min) ? m : n_min;
+			m -= n_min;
+			for (i = 0; i < n_min; i++) {
+				*y_wptr = s32_to_float(*fir->out_rp);
+				y_wptr++;
+				fir->out_rp++;
+			}
+			/* Check wrap */
+			src_inc_wrap_float(&y_wptr, y_end_addr, s->y_size);
+			src_inc_wrap(&fir->out_rp, out_delay_end, out_size);
+		}
+	}
+	s->x_rptr = x_rptr;
+	s->y_wptr = y_wptr;
+}
+#endif
+
 #endif
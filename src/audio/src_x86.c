@@ -0,0 +1,571 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* SSE4.2 and AVX2 optimized code parts for SRC in x86 host builds */
+
+#include <stdint.h>
+#include <sof/alloc.h>
+#include <sof/audio/format.h>
+#include <sof/math/numbers.h>
+
+#include "src_config.h"
+#include "src.h"
+
+#if SRC_X86
+
+#include <sof/audio/format_x86.h>
+
+#if SRC_SHORT /* 16 bit coefficients version */
+
+#define src_coef		int16_t
+
+#define SRC_X86_QSHIFT		15	/* Q2.46 -> Q2.31 */
+
+/* Q1.15 coefficients are used as such */
+static inline int32_t src_x86_coef(const src_coef *c)
+{
+	return *c;
+}
+
+static inline q_vec src_x86_load_coef(const src_coef *c)
+{
+	return q_vec_load_s16(c);
+}
+
+#if defined(__AVX2__)
+static inline __m128i src_x86_load_coef4(const src_coef *c)
+{
+	return _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)c));
+}
+#endif
+
+#else /* 32bit coefficients version */
+
+#define src_coef		int32_t
+
+#define SRC_X86_QSHIFT		23	/* Qx.54 -> Qx.31 */
+
+/* Q1.31 coefficients are used as Q1.23 */
+static inline int32_t src_x86_coef(const src_coef *c)
+{
+	return *c >> 8;
+}
+
+static inline q_vec src_x86_load_coef(const src_coef *c)
+{
+	return q_vec_srai32(q_vec_load_s32(c), 8);
+}
+
+#if defined(__AVX2__)
+static inline __m128i src_x86_load_coef4(const src_coef *c)
+{
+	return _mm_srai_epi32(_mm_loadu_si128((const __m128i *)c), 8);
+}
+#endif
+
+#endif /* 32bit coefficients version */
+
+/* Q_VEC_LANES / 2 coefficients, each duplicated to adjacent lanes */
+static inline q_vec src_x86_load_coef_x2(const src_coef *c)
+{
+#if defined(__AVX2__)
+	return _mm256_permutevar8x32_epi32
+		(_mm256_castsi128_si256(src_x86_load_coef4(c)),
+		 _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3));
+#else
+	return _mm_setr_epi32(src_x86_coef(c), src_x86_coef(c),
+			      src_x86_coef(c + 1), src_x86_coef(c + 1));
+#endif
+}
+
+/* Mono FIR part without circular wrap */
+static inline int64_t src_x86_dot(const int32_t *data, const src_coef *coef,
+				  int taps)
+{
+	q_vec even = q_vec_zero();
+	q_vec odd = q_vec_zero();
+	int64_t y;
+	int i;
+
+	for (i = 0; i + Q_VEC_LANES <= taps; i += Q_VEC_LANES)
+		q_vec_mac_32x32(&even, &odd, src_x86_load_coef(&coef[i]),
+				q_vec_load_s32(&data[i]));
+
+	y = q_vec_hsum64(q_vec_add64(even, odd));
+	for (; i < taps; i++)
+		y += (int64_t)src_x86_coef(&coef[i]) * data[i];
+
+	return y;
+}
+
+/* Stereo FIR part without circular wrap, the even data words are summed
+ * to y0 and the odd words to y1.
+ */
+static inline void src_x86_dot_2ch(const int32_t *data,
+				   const src_coef *coef, int taps,
+				   int64_t *y0, int64_t *y1)
+{
+	q_vec even = q_vec_zero();
+	q_vec odd = q_vec_zero();
+	int32_t c;
+	int i;
+
+	for (i = 0; i + Q_VEC_LANES / 2 <= taps; i += Q_VEC_LANES / 2)
+		q_vec_mac_32x32(&even, &odd, src_x86_load_coef_x2(&coef[i]),
+				q_vec_load_s32(&data[2 * i]));
+
+	*y0 += q_vec_hsum64(even);
+	*y1 += q_vec_hsum64(odd);
+	for (; i < taps; i++) {
+		c = src_x86_coef(&coef[i]);
+		*y0 += (int64_t)c * data[2 * i];
+		*y1 += (int64_t)c * data[2 * i + 1];
+	}
+}
+
+/* Four adjacent channels FIR part without circular wrap, lane k of the
+ * accumulators is for data word k of every frame.
+ */
+static inline void src_x86_dot_4ch(const int32_t *data,
+				   const src_coef *coef, int taps, int nch,
+				   __m128i *even, __m128i *odd)
+{
+	__m128i c;
+	__m128i d;
+	int i;
+
+	for (i = 0; i < taps; i++) {
+		c = _mm_set1_epi32(src_x86_coef(&coef[i]));
+		d = _mm_loadu_si128((const __m128i *)&data[i * nch]);
+		*even = _mm_add_epi64(*even, _mm_mul_epi32(c, d));
+		*odd = _mm_add_epi64(*odd,
+				     _mm_mul_epi32(c, _mm_srli_epi64(d, 32)));
+	}
+}
+
+static inline void fir_filter_x86(int32_t *rp, const void *cp, int32_t *wp0,
+				  int32_t *fir_start, int32_t *fir_end,
+				  const int fir_delay_length,
+				  const int taps_x_nch, const int shift,
+				  const int nch)
+{
+	const src_coef *coef = cp;
+	__m128i even;
+	__m128i odd;
+	int64_t y0;
+	int64_t y1;
+	int32_t *data;
+	int i;
+	int j;
+	int n1;
+	int n2;
+	int frames;
+	const int qshift = SRC_X86_QSHIFT + shift;
+	const int32_t rnd = 1 << (qshift - 1); /* Half LSB */
+	const int taps = taps_x_nch / nch;
+	int32_t *d = rp;
+	int32_t *wp = wp0;
+
+	/* Note that initialization code ensures that circular wrap does not
+	 * happen mid-frame. The number of taps before the wrap is the same
+	 * for all channels.
+	 */
+	if (nch == 1) {
+		frames = fir_end - d; /* Frames until wrap */
+		n1 = (taps < frames) ? taps : frames;
+		n2 = taps - n1;
+		y0 = rnd + src_x86_dot(d, coef, n1);
+		y0 += src_x86_dot(fir_start, &coef[n1], n2);
+		*wp = sat_int32(y0 >> qshift);
+		return;
+	}
+
+	if (nch == 2) {
+		data = d - 1;
+		y0 = rnd;
+		y1 = rnd;
+		frames = fir_end - data; /* Frames until wrap */
+		n1 = ((taps_x_nch < frames) ? taps_x_nch : frames) >> 1;
+		n2 = taps - n1;
+		src_x86_dot_2ch(data, coef, n1, &y0, &y1);
+		data += 2 * n1;
+		if (data == fir_end)
+			data = fir_start;
+
+		src_x86_dot_2ch(data, &coef[n1], n2, &y0, &y1);
+		*wp = sat_int32(y1 >> qshift);
+		*(wp + 1) = sat_int32(y0 >> qshift);
+		return;
+	}
+
+	frames = fir_end - d + nch - 1; /* Frames until wrap */
+	n1 = (taps_x_nch < frames) ? taps_x_nch : frames;
+	n1 = (n1 + nch - 1) / nch; /* Taps until wrap */
+	n2 = taps - n1;
+
+	if (!(nch & 3)) {
+		/* Channels j ... j + 3 are in data words in reverse order */
+		for (j = 0; j < nch; j += 4) {
+			even = _mm_set1_epi64x(rnd);
+			odd = even;
+			data = d - j - 3;
+			src_x86_dot_4ch(data, coef, n1, nch, &even, &odd);
+			data += n1 * nch;
+			if (data >= fir_end)
+				data -= fir_delay_length;
+
+			src_x86_dot_4ch(data, &coef[n1], n2, nch, &even, &odd);
+			wp[j] = sat_int32(_mm_extract_epi64(odd, 1) >> qshift);
+			wp[j + 1] = sat_int32(_mm_extract_epi64(even, 1) >>
+					      qshift);
+			wp[j + 2] = sat_int32(_mm_cvtsi128_si64(odd) >> qshift);
+			wp[j + 3] = sat_int32(_mm_cvtsi128_si64(even) >>
+					      qshift);
+		}
+		return;
+	}
+
+	for (j = 0; j < nch; j++) {
+		data = d--;
+		y0 = rnd;
+		for (i = 0; i < n1; i++) {
+			y0 += (int64_t)src_x86_coef(&coef[i]) * (*data);
+			data += nch;
+		}
+		if (data >= fir_end)
+			data -= fir_delay_length;
+
+		for (i = n1; i < taps; i++) {
+			y0 += (int64_t)src_x86_coef(&coef[i]) * (*data);
+			data += nch;
+		}
+		*wp = sat_int32(y0 >> qshift);
+		wp++;
+	}
+}
+
+void src_polyphase_stage_cir(struct src_stage_prm *s)
+{
+	int i;
+	int n;
+	int m;
+	int n_wrap_buf;
+	int n_wrap_fir;
+	int n_min;
+	int32_t *rp;
+	int32_t *wp;
+
+	struct src_state *fir = s->state;
+	struct src_stage *cfg = s->stage;
+	int32_t *fir_delay = fir->fir_delay;
+	int32_t *fir_end = &fir->fir_delay[fir->fir_delay_size];
+	int32_t *out_delay_end = &fir->out_delay[fir->out_delay_size];
+	const void *cp; /* Can be int32_t or int16_t */
+	const size_t out_size = fir->out_delay_size * sizeof(int32_t);
+	const int nch = s->nch;
+	const int nch_x_odm = cfg->odm * nch;
+	const int blk_in_words = nch * cfg->blk_in;
+	const int blk_out_words = nch * cfg->num_of_subfilters;
+	const int fir_length = fir->fir_delay_size;
+	const int rewind = nch * (cfg->blk_in
+		+ (cfg->num_of_subfilters - 1) * cfg->idm) - nch;
+	const int nch_x_idm = nch * cfg->idm;
+	const size_t fir_size = fir->fir_delay_size * sizeof(int32_t);
+	const int taps_x_nch = cfg->subfilter_length * nch;
+	int32_t *x_rptr = (int32_t *)s->x_rptr;
+	int32_t *y_wptr = (int32_t *)s->y_wptr;
+	int32_t *x_end_addr = (int32_t *)s->x_end_addr;
+	int32_t *y_end_addr = (int32_t *)s->y_end_addr;
+
+#if SRC_SHORT
+	const size_t subfilter_size = cfg->subfilter_length * sizeof(int16_t);
+#else
+	const size_t subfilter_size = cfg->subfilter_length * sizeof(int32_t);
+#endif
+
+	for (n = 0; n < s->times; n++) {
+		/* Input data, for s24 format s->shift is 8 */
+		m = blk_in_words;
+		while (m > 0) {
+			/* Number of words without circular wrap */
+			n_wrap_buf = x_end_addr - x_rptr;
+			n_wrap_fir = fir->fir_wp - fir->fir_delay + 1;
+			n_min = (n_wrap_fir < n_wrap_buf)
+				? n_wrap_fir : n_wrap_buf;
+			n_min = (m < n_min) ? m : n_min;
+			m -= n_min;
+			for (i = 0; i < n_min; i++) {
+				*fir->fir_wp = *x_rptr << s->shift;
+				fir->fir_wp--;
+				x_rptr++;
+			}
+			/* Check for wrap */
+			src_dec_wrap(&fir->fir_wp, fir_delay, fir_size);
+			src_inc_wrap(&x_rptr, x_end_addr, s->x_size);
+		}
+
+		/* Filter */
+		cp = cfg->coefs; /* Reset to 1st coefficient */
+		rp = fir->fir_wp + rewind;
+		src_inc_wrap(&rp, fir_end, fir_size);
+		wp = fir->out_rp;
+		for (i = 0; i < cfg->num_of_subfilters; i++) {
+			fir_filter_x86(rp, cp, wp, fir_delay, fir_end,
+				       fir_length, taps_x_nch, cfg->shift,
+				       nch);
+			wp += nch_x_odm;
+			cp += subfilter_size;
+			src_inc_wrap(&wp, out_delay_end, out_size);
+			rp -= nch_x_idm; /* Next sub-filter start */
+			src_dec_wrap(&rp, fir_delay, fir_size);
+		}
+
+		/* Output, for s24 format s->shift is 8 */
+		m = blk_out_words;
+		while (m > 0) {
+			n_wrap_fir = out_delay_end - fir->out_rp;
+			n_wrap_buf = y_end_addr - y_wptr;
+			n_min = (n_wrap_fir < n_wrap_buf)
+				? n_wrap_fir : n_wrap_buf;
+			n_min = (m < n_min) ? m : n_min;
+			m -= n_min;
+			for (i = 0; i < n_min; i++) {
+				*y_wptr = *fir->out_rp >> s->shift;
+				y_wptr++;
+				fir->out_rp++;
+			}
+			/* Check wrap */
+			src_inc_wrap(&y_wptr, y_end_addr, s->y_size);
+			src_inc_wrap(&fir->out_rp, out_delay_end, out_size);
+		}
+	}
+	s->x_rptr = x_rptr;
+	s->y_wptr = y_wptr;
+}
+
+void src_polyphase_stage_cir_s16(struct src_stage_prm *s)
+{
+	int i;
+	int n;
+	int m;
+	int n_wrap_buf;
+	int n_wrap_fir;
+	int n_min;
+	int32_t *rp;
+	int32_t *wp;
+
+	struct src_state *fir = s->state;
+	struct src_stage *cfg = s->stage;
+	int32_t *fir_delay = fir->fir_delay;
+	int32_t *fir_end = &fir->fir_delay[fir->fir_delay_size];
+	int32_t *out_delay_end = &fir->out_delay[fir->out_delay_size];
+	const void *cp; /* Can be int32_t or int16_t */
+	const size_t out_size = fir->out_delay_size * sizeof(int32_t);
+	const int nch = s->nch;
+	const int nch_x_odm = cfg->odm * nch;
+	const int blk_in_words = nch * cfg->blk_in;
+	const int blk_out_words = nch * cfg->num_of_subfilters;
+	const int fir_length = fir->fir_delay_size;
+	const int rewind = nch * (cfg->blk_in
+		+ (cfg->num_of_subfilters - 1) * cfg->idm) - nch;
+	const int nch_x_idm = nch * cfg->idm;
+	const size_t fir_size = fir->fir_delay_size * sizeof(int32_t);
+	const int taps_x_nch = cfg->subfilter_length * nch;
+	int16_t *x_rptr = (int16_t *)s->x_rptr;
+	int16_t *y_wptr = (int16_t *)s->y_wptr;
+	int16_t *x_end_addr = (int16_t *)s->x_end_addr;
+	int16_t *y_end_addr = (int16_t *)s->y_end_addr;
+
+#if SRC_SHORT
+	const size_t subfilter_size = cfg->subfilter_length * sizeof(int16_t);
+#else
+	const size_t subfilter_size = cfg->subfilter_length * sizeof(int32_t);
+#endif
+
+	for (n = 0; n < s->times; n++) {
+		/* Input data, used fixed shift by 16 */
+		m = blk_in_words;
+		while (m > 0) {
+			/* Number of words without circular wrap */
+			n_wrap_buf = x_end_addr - x_rptr;
+			n_wrap_fir = fir->fir_wp - fir->fir_delay + 1;
+			n_min = (n_wrap_fir < n_wrap_buf)
+				? n_wrap_fir : n_wrap_buf;
+			n_min = (m < n_min) ? m : n_min;
+			m -= n_min;
+			for (i = 0; i < n_min; i++) {
+				*fir->fir_wp = Q_SHIFT_LEFT(*x_rptr, 15, 31);
+				fir->fir_wp--;
+				x_rptr++;
+			}
+			/* Check for wrap */
+			src_dec_wrap(&fir->fir_wp, fir_delay, fir_size);
+			src_inc_wrap_s16(&x_rptr, x_end_addr, s->x_size);
+		}
+
+		/* Filter */
+		cp = cfg->coefs; /* Reset to 1st coefficient */
+		rp = fir->fir_wp + rewind;
+		src_inc_wrap(&rp, fir_end, fir_size);
+		wp = fir->out_rp;
+		for (i = 0; i < cfg->num_of_subfilters; i++) {
+			fir_filter_x86(rp, cp, wp, fir_delay, fir_end,
+				       fir_length, taps_x_nch, cfg->shift,
+				       nch);
+			wp += nch_x_odm;
+			cp += subfilter_size;
+			src_inc_wrap(&wp, out_delay_end, out_size);
+			rp -= nch_x_idm; /* Next sub-filter start */
+			src_dec_wrap(&rp, fir_delay, fir_size);
+		}
+
+		/* Output, use fixed shift by 16 */
+		m = blk_out_words;
+		while (m > 0) {
+			n_wrap_fir = out_delay_end - fir->out_rp;
+			n_wrap_buf = y_end_addr - y_wptr;
+			n_min = (n_wrap_fir < n_wrap_buf)
+				? n_wrap_fir : n_wrap_buf;
+			n_min = (m < n_min) ? m : n_min;
+			m -= n_min;
+			for (i = 0; i < n_min; i++) {
+				*y_wptr = Q_SHIFT_RND(*fir->out_rp, 31, 15);
+				y_wptr++;
+				fir->out_rp++;
+			}
+			/* Check wrap */
+			src_inc_wrap_s16(&y_wptr, y_end_addr, s->y_size);
+			src_inc_wrap(&fir->out_rp, out_delay_end, out_size);
+		}
+	}
+	s->x_rptr = x_rptr;
+	s->y_wptr = y_wptr;
+}
+
+#if SRC_FLOAT
+void src_polyphase_stage_cir_float(struct src_stage_prm *s)
+{
+	int i;
+	int n;
+	int m;
+	int n_wrap_buf;
+	int n_wrap_fir;
+	int n_min;
+	int32_t *rp;
+	int32_t *wp;
+
+	struct src_state *fir = s->state;
+	struct src_stage *cfg = s->stage;
+	int32_t *fir_delay = fir->fir_delay;
+	int32_t *fir_end = &fir->fir_delay[fir->fir_delay_size];
+	int32_t *out_delay_end = &fir->out_delay[fir->out_delay_size];
+	const void *cp; /* Can be int32_t or int16_t */
+	const size_t out_size = fir->out_delay_size * sizeof(int32_t);
+	const int nch = s->nch;
+	const int nch_x_odm = cfg->odm * nch;
+	const int blk_in_words = nch * cfg->blk_in;
+	const int blk_out_words = nch * cfg->num_of_subfilters;
+	const int fir_length = fir->fir_delay_size;
+	const int rewind = nch * (cfg->blk_in
+		+ (cfg->num_of_subfilters - 1) * cfg->idm) - nch;
+	const int nch_x_idm = nch * cfg->idm;
+	const size_t fir_size = fir->fir_delay_size * sizeof(int32_t);
+	const int taps_x_nch = cfg->subfilter_length * nch;
+	float *x_rptr = (float *)s->x_rptr;
+	float *y_wptr = (float *)s->y_wptr;
+	float *x_end_addr = (float *)s->x_end_addr;
+	float *y_end_addr = (float *)s->y_end_addr;
+
+#if SRC_SHORT
+	const size_t subfilter_size = cfg->subfilter_length * sizeof(int16_t);
+#else
+	const size_t subfilter_size = cfg->subfilter_length * sizeof(int32_t);
+#endif
+
+	for (n = 0; n < s->times; n++) {
+		/* Input data, convert to Q1.31 */
+		m = blk_in_words;
+		while (m > 0) {
+			/* Number of words without circular wrap */
+			n_wrap_buf = x_end_addr - x_rptr;
+			n_wrap_fir = fir->fir_wp - fir->fir_delay + 1;
+			n_min = (n_wrap_fir < n_wrap_buf)
+				? n_wrap_fir : n_wrap_buf;
+			n_min = (m < n_min) ? m : n_min;
+			m -= n_min;
+			for (i = 0; i < n_min; i++) {
+				*fir->fir_wp = float_to_s32(*x_rptr);
+				fir->fir_wp--;
+				x_rptr++;
+			}
+			/* Check for wrap */
+			src_dec_wrap(&fir->fir_wp, fir_delay, fir_size);
+			src_inc_wrap_float(&x_rptr, x_end_addr, s->x_size);
+		}
+
+		/* Filter */
+		cp = cfg->coefs; /* Reset to 1st coefficient */
+		rp = fir->fir_wp + rewind;
+		src_inc_wrap(&rp, fir_end, fir_size);
+		wp = fir->out_rp;
+		for (i = 0; i < cfg->num_of_subfilters; i++) {
+			fir_filter_x86(rp, cp, wp, fir_delay, fir_end,
+				       fir_length, taps_x_nch, cfg->shift,
+				       nch);
+			wp += nch_x_odm;
+			cp += subfilter_size;
+			src_inc_wrap(&wp, out_delay_end, out_size);
+			rp -= nch_x_idm; /* Next sub-filter start */
+			src_dec_wrap(&rp, fir_delay, fir_size);
+		}
+
+		/* Output, convert back to float */
+		m = blk_out_words;
+		while (m > 0) {
+			n_wrap_fir = out_delay_end - fir->out_rp;
+			n_wrap_buf = y_end_addr - y_wptr;
+			n_min = (n_wrap_fir < n_wrap_buf)
+				? n_wrap_fir : n_wrap_buf;
+			n_min = (m < n_min) ? m : n_min;
+			m -= n_min;
+			for (i = 0; i < n_min; i++) {
+				*y_wptr = s32_to_float(*fir->out_rp);
+				y_wptr++;
+				fir->out_rp++;
+			}
+			/* Check wrap */
+			src_inc_wrap_float(&y_wptr, y_end_addr, s->y_size);
+			src_inc_wrap(&fir->out_rp, out_delay_end, out_size);
+		}
+	}
+	s->x_rptr = x_rptr;
+	s->y_wptr = y_wptr;
+}
+#endif
+
+#endif
@@ -436,6 +436,27 @@ static int volume_trigger(struct comp_dev *dev, int cmd)
 	return comp_set_state(dev, cmd);
 }
 
+/**
+ * \brief Processes stream data without buffer updates.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] source Source buffer.
+ * \param[in,out] sink Destination buffer, can be the same as source.
+ * \param[in] frames Number of frames to process.
+ * \return Error code.
+ */
+static int volume_process(struct comp_dev *dev, struct comp_buffer *source,
+			  struct comp_buffer *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	tracev_volume("volume_process()");
+
+	/* copy and scale volume */
+	cd->scale_vol(dev, sink, source, frames);
+
+	return 0;
+}
+
 /**
  * \brief Copies and processes stream data.
  * \param[in,out] dev Volume base component device.
@@ -443,7 +464,6 @@ static int volume_trigger(struct comp_dev *dev, int cmd)
  */
 static int volume_copy(struct comp_dev *dev)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
 	struct comp_buffer *sink;
 	struct comp_buffer *source;
 	uint32_t frames;
@@ -483,8 +503,7 @@ static int volume_copy(struct comp_dev *dev)
 	tracev_volume("volume_copy(), source_bytes = 0x%x, sink_bytes = 0x%x",
 		      source_bytes, sink_bytes);
 
-	/* copy and scale volume */
-	cd->scale_vol(dev, sink, source, frames);
+	volume_process(dev, source, sink, frames);
 
 	/* calculate new free and available */
 	comp_update_buffer_produce(sink, sink_bytes);
@@ -644,6 +663,7 @@ struct comp_driver comp_volume = {
 		.cmd		= volume_cmd,
 		.trigger	= volume_trigger,
 		.copy		= volume_copy,
+		.process	= volume_process,
 		.prepare	= volume_prepare,
 		.reset		= volume_reset,
 		.cache		= volume_cache,
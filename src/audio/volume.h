@@ -55,6 +55,11 @@
 
 #endif
 
+/* x86 host builds with SSE4.2 or AVX2 enabled use volume_x86.c */
+#if defined(__SSE4_2__)
+#undef CONFIG_GENERIC
+#endif
+
 /** \brief Volume trace function. */
 #define trace_volume(__e, ...)	trace_event(TRACE_CLASS_VOLUME, __e, ##__VA_ARGS__)
 
@@ -132,6 +137,14 @@ extern const struct comp_func_map func_map[];
 /** \brief Number of processing functions. */
 extern const size_t func_count;
 
+#if CONFIG_FORMAT_FLOAT
+/** \brief Map of float processing and conversion functions. */
+extern const struct comp_func_map float_func_map[];
+
+/** \brief Number of float processing functions. */
+extern const size_t float_func_count;
+#endif
+
 typedef void (*scale_vol)(struct comp_dev *, struct comp_buffer *,
 			  struct comp_buffer *, uint32_t);
 
@@ -154,6 +167,17 @@ inline static scale_vol vol_get_processing_function(struct comp_dev *dev)
 		return func_map[i].func;
 	}
 
+#if CONFIG_FORMAT_FLOAT
+	for (i = 0; i < float_func_count; i++) {
+		if (cd->source_format != float_func_map[i].source)
+			continue;
+		if (cd->sink_format != float_func_map[i].sink)
+			continue;
+
+		return float_func_map[i].func;
+	}
+#endif
+
 	return NULL;
 }
 
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file audio/volume_float.c
+ * \brief Volume float processing implementation
+ */
+
+#include "volume.h"
+
+#if CONFIG_FORMAT_FLOAT
+
+/**
+ * \brief Reads one sample as float.
+ * \param[in] source Source buffer.
+ * \param[in] idx Sample index.
+ * \param[in] fmt Source frame format.
+ * \return Sample scaled to +-1.0 full scale.
+ */
+static inline float vol_float_read(struct comp_buffer *source, uint32_t idx,
+				   const enum sof_ipc_frame fmt)
+{
+	int16_t *x16;
+	int32_t *x32;
+	float *x;
+
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		x16 = buffer_read_frag_s16(source, idx);
+		return s16_to_float(*x16);
+	case SOF_IPC_FRAME_S24_4LE:
+		x32 = buffer_read_frag_s32(source, idx);
+		return s24_to_float(*x32);
+	case SOF_IPC_FRAME_S32_LE:
+		x32 = buffer_read_frag_s32(source, idx);
+		return s32_to_float(*x32);
+	default:
+		x = buffer_read_frag_float(source, idx);
+		return *x;
+	}
+}
+
+/**
+ * \brief Writes one float sample in sink format.
+ * \param[in,out] sink Destination buffer.
+ * \param[in] idx Sample index.
+ * \param[in] y Sample scaled to +-1.0 full scale.
+ * \param[in] fmt Sink frame format.
+ */
+static inline void vol_float_write(struct comp_buffer *sink, uint32_t idx,
+				   float y, const enum sof_ipc_frame fmt)
+{
+	int16_t *y16;
+	int32_t *y32;
+	float *yf;
+
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		y16 = buffer_write_frag_s16(sink, idx);
+		*y16 = float_to_s16(y);
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		y32 = buffer_write_frag_s32(sink, idx);
+		*y32 = float_to_s24(y);
+		break;
+	case SOF_IPC_FRAME_S32_LE:
+		y32 = buffer_write_frag_s32(sink, idx);
+		*y32 = float_to_s32(y);
+		break;
+	default:
+		yf = buffer_write_frag_float(sink, idx);
+		*yf = y;
+		break;
+	}
+}
+
+/**
+ * \brief Volume processing with float gain.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ * \param[in] in_fmt Source frame format.
+ * \param[in] out_fmt Sink frame format.
+ *
+ * Fixed point samples are converted on the way in or out so a float
+ * pipeline is requantized only at its boundaries.
+ */
+static inline void vol_float(struct comp_dev *dev, struct comp_buffer *sink,
+			     struct comp_buffer *source, uint32_t frames,
+			     const enum sof_ipc_frame in_fmt,
+			     const enum sof_ipc_frame out_fmt)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	float gain[SOF_IPC_MAX_CHANNELS];
+	float x;
+	uint32_t channel;
+	uint32_t buff_frag = 0;
+	uint32_t i;
+
+	/* volume is Q8.16 */
+	for (channel = 0; channel < dev->params.channels; channel++)
+		gain[channel] = cd->volume[channel] * (1.0f / VOL_ZERO_DB);
+
+	for (i = 0; i < frames; i++) {
+		for (channel = 0; channel < dev->params.channels; channel++) {
+			x = vol_float_read(source, buff_frag, in_fmt);
+			vol_float_write(sink, buff_frag, x * gain[channel],
+					out_fmt);
+			buff_frag++;
+		}
+	}
+}
+
+static void vol_float_to_float(struct comp_dev *dev, struct comp_buffer *sink,
+			       struct comp_buffer *source, uint32_t frames)
+{
+	vol_float(dev, sink, source, frames, SOF_IPC_FRAME_FLOAT,
+		  SOF_IPC_FRAME_FLOAT);
+}
+
+static void vol_s16_to_float(struct comp_dev *dev, struct comp_buffer *sink,
+			     struct comp_buffer *source, uint32_t frames)
+{
+	vol_float(dev, sink, source, frames, SOF_IPC_FRAME_S16_LE,
+		  SOF_IPC_FRAME_FLOAT);
+}
+
+static void vol_s24_to_float(struct comp_dev *dev, struct comp_buffer *sink,
+			     struct comp_buffer *source, uint32_t frames)
+{
+	vol_float(dev, sink, source, frames, SOF_IPC_FRAME_S24_4LE,
+		  SOF_IPC_FRAME_FLOAT);
+}
+
+static void vol_s32_to_float(struct comp_dev *dev, struct comp_buffer *sink,
+			     struct comp_buffer *source, uint32_t frames)
+{
+	vol_float(dev, sink, source, frames, SOF_IPC_FRAME_S32_LE,
+		  SOF_IPC_FRAME_FLOAT);
+}
+
+static void vol_float_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
+			     struct comp_buffer *source, uint32_t frames)
+{
+	vol_float(dev, sink, source, frames, SOF_IPC_FRAME_FLOAT,
+		  SOF_IPC_FRAME_S16_LE);
+}
+
+static void vol_float_to_s24(struct comp_dev *dev, struct comp_buffer *sink,
+			     struct comp_buffer *source, uint32_t frames)
+{
+	vol_float(dev, sink, source, frames, SOF_IPC_FRAME_FLOAT,
+		  SOF_IPC_FRAME_S24_4LE);
+}
+
+static void vol_float_to_s32(struct comp_dev *dev, struct comp_buffer *sink,
+			     struct comp_buffer *source, uint32_t frames)
+{
+	vol_float(dev, sink, source, frames, SOF_IPC_FRAME_FLOAT,
+		  SOF_IPC_FRAME_S32_LE);
+}
+
+const struct comp_func_map float_func_map[] = {
+	{SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_FLOAT, vol_float_to_float},
+	{SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_FLOAT, vol_s16_to_float},
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_FLOAT, vol_s24_to_float},
+	{SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_FLOAT, vol_s32_to_float},
+	{SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_S16_LE, vol_float_to_s16},
+	{SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_S24_4LE, vol_float_to_s24},
+	{SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_S32_LE, vol_float_to_s32},
+};
+
+const size_t float_func_count = ARRAY_SIZE(float_func_map);
+
+#endif
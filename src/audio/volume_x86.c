@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file audio/volume_x86.c
+ * \brief Volume SSE4.2 and AVX2 processing implementation
+ */
+
+#include "volume.h"
+
+#if defined(__SSE4_2__)
+
+#include <sof/audio/format_x86.h>
+
+/** \brief Sample containers of the processing functions. */
+enum vol_x86_fmt {
+	VOL_X86_S16,
+	VOL_X86_S24,
+	VOL_X86_S32,
+};
+
+/**
+ * \brief Scalar volume multiply, same as in the generic implementation.
+ * \param[in] x Input sample converted to 32 bits.
+ * \param[in] vol Gain.
+ * \param[in] out Output sample format.
+ * \param[in] shift Product right shift.
+ * \return Output sample.
+ */
+static inline int32_t vol_x86_mult(int32_t x, int32_t vol,
+				   const enum vol_x86_fmt out, const int shift)
+{
+	switch (out) {
+	case VOL_X86_S16:
+		return q_multsr_sat_32x32_16(x, vol, shift);
+	case VOL_X86_S24:
+		return q_multsr_sat_32x32_24(x, vol, shift);
+	default:
+		return q_multsr_sat_32x32(x, vol, shift);
+	}
+}
+
+/**
+ * \brief Vector volume multiply for Q_VEC_LANES samples.
+ * \param[in] x Input samples converted to 32 bits.
+ * \param[in] vol Gains.
+ * \param[in] out Output sample format.
+ * \param[in] shift Product right shift.
+ * \return Output samples, 16 bit output is saturated by the store.
+ */
+static inline q_vec vol_x86_vec_mult(q_vec x, q_vec vol,
+				     const enum vol_x86_fmt out,
+				     const int shift)
+{
+	switch (out) {
+	case VOL_X86_S16:
+		return q_vec_multsr_32x32(x, vol, shift);
+	case VOL_X86_S24:
+		return q_vec_sat24(q_vec_multsr_32x32(x, vol, shift));
+	default:
+		return q_vec_multsr_sat_32x32(x, vol, shift);
+	}
+}
+
+static inline int32_t vol_x86_load(const void *p, const enum vol_x86_fmt in,
+				   const int in_shift)
+{
+	switch (in) {
+	case VOL_X86_S16:
+		return *(const int16_t *)p << in_shift;
+	case VOL_X86_S24:
+		return sign_extend_s24(*(const int32_t *)p);
+	default:
+		return *(const int32_t *)p;
+	}
+}
+
+static inline void vol_x86_store(void *p, int32_t x,
+				 const enum vol_x86_fmt out)
+{
+	if (out == VOL_X86_S16)
+		*(int16_t *)p = x;
+	else
+		*(int32_t *)p = x;
+}
+
+static inline q_vec vol_x86_vec_load(const void *p, const enum vol_x86_fmt in,
+				     const int in_shift)
+{
+	switch (in) {
+	case VOL_X86_S16:
+		return q_vec_slli32(q_vec_load_s16(p), in_shift);
+	case VOL_X86_S24:
+		return q_vec_sign_extend_s24(q_vec_load_s32(p));
+	default:
+		return q_vec_load_s32(p);
+	}
+}
+
+static inline void vol_x86_vec_store(void *p, q_vec x,
+				     const enum vol_x86_fmt out)
+{
+	if (out == VOL_X86_S16)
+		q_vec_store_s16(p, x);
+	else
+		q_vec_store_s32(p, x);
+}
+
+/**
+ * \brief Common volume processing loop.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ * \param[in] in Input sample format.
+ * \param[in] out Output sample format.
+ * \param[in] in_shift Left shift of 16 bit input samples.
+ * \param[in] shift Product right shift.
+ *
+ * Samples are processed in runs up to the next source or sink buffer wrap.
+ * Whole frames are processed with vectors when the number of channels
+ * divides the vector length so the gains vector is the same for every
+ * step, the remaining samples are processed one by one.
+ */
+static inline void vol_x86_process(struct comp_dev *dev,
+				   struct comp_buffer *sink,
+				   struct comp_buffer *source,
+				   uint32_t frames,
+				   const enum vol_x86_fmt in,
+				   const enum vol_x86_fmt out,
+				   const int in_shift, const int shift)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	const int in_size = in == VOL_X86_S16 ? 2 : 4;
+	const int out_size = out == VOL_X86_S16 ? 2 : 4;
+	const int nch = dev->params.channels;
+	const int vec = nch <= Q_VEC_LANES && !(Q_VEC_LANES % nch);
+	int32_t gain[Q_VEC_LANES];
+	uint8_t *src = source->r_ptr;
+	uint8_t *dst = sink->w_ptr;
+	uint32_t samples = frames * nch;
+	uint32_t n;
+	uint32_t i;
+	q_vec vol = q_vec_zero();
+	int ch = 0;
+
+	if (vec) {
+		for (i = 0; i < Q_VEC_LANES; i++)
+			gain[i] = cd->volume[i % nch];
+		vol = q_vec_load_s32(gain);
+	}
+
+	while (samples) {
+		n = MIN(samples, MIN(((uint8_t *)source->end_addr - src) /
+				     in_size,
+				     ((uint8_t *)sink->end_addr - dst) /
+				     out_size));
+
+		/* single samples until start of a frame */
+		for (i = 0; i < n && (!vec || ch); i++) {
+			vol_x86_store(dst, vol_x86_mult(vol_x86_load(src, in,
+								     in_shift),
+							cd->volume[ch], out,
+							shift), out);
+			src += in_size;
+			dst += out_size;
+			ch = ch + 1 < nch ? ch + 1 : 0;
+		}
+
+		/* whole vectors, ch stays zero */
+		for (; vec && i + Q_VEC_LANES <= n; i += Q_VEC_LANES) {
+			vol_x86_vec_store(dst, vol_x86_vec_mult
+					  (vol_x86_vec_load(src, in, in_shift),
+					   vol, out, shift), out);
+			src += Q_VEC_LANES * in_size;
+			dst += Q_VEC_LANES * out_size;
+		}
+
+		/* remaining samples before buffer wrap */
+		for (; i < n; i++) {
+			vol_x86_store(dst, vol_x86_mult(vol_x86_load(src, in,
+								     in_shift),
+							cd->volume[ch], out,
+							shift), out);
+			src += in_size;
+			dst += out_size;
+			ch = ch + 1 < nch ? ch + 1 : 0;
+		}
+
+		samples -= n;
+		if (src >= (uint8_t *)source->end_addr)
+			src = source->addr;
+		if (dst >= (uint8_t *)sink->end_addr)
+			dst = sink->addr;
+	}
+}
+
+/**
+ * \brief Volume processing from 16 bit to 16 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s16_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
+			   struct comp_buffer *source, uint32_t frames)
+{
+	vol_x86_process(dev, sink, source, frames, VOL_X86_S16, VOL_X86_S16,
+			0, Q_SHIFT_BITS_32(15, 16, 15));
+}
+
+/**
+ * \brief Volume processing from 16 bit to 24 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s16_to_s24(struct comp_dev *dev, struct comp_buffer *sink,
+			   struct comp_buffer *source, uint32_t frames)
+{
+	vol_x86_process(dev, sink, source, frames, VOL_X86_S16, VOL_X86_S24,
+			0, Q_SHIFT_BITS_64(15, 16, 23));
+}
+
+/**
+ * \brief Volume processing from 16 bit to 32 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s16_to_s32(struct comp_dev *dev, struct comp_buffer *sink,
+			   struct comp_buffer *source, uint32_t frames)
+{
+	vol_x86_process(dev, sink, source, frames, VOL_X86_S16, VOL_X86_S32,
+			8, Q_SHIFT_BITS_64(23, 16, 31));
+}
+
+/**
+ * \brief Volume processing from 24 bit to 16 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s24_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
+			   struct comp_buffer *source, uint32_t frames)
+{
+	vol_x86_process(dev, sink, source, frames, VOL_X86_S24, VOL_X86_S16,
+			0, Q_SHIFT_BITS_64(23, 16, 15));
+}
+
+/**
+ * \brief Volume processing from 24 bit to 24 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s24_to_s24(struct comp_dev *dev, struct comp_buffer *sink,
+			   struct comp_buffer *source, uint32_t frames)
+{
+	vol_x86_process(dev, sink, source, frames, VOL_X86_S24, VOL_X86_S24,
+			0, Q_SHIFT_BITS_64(23, 16, 23));
+}
+
+/**
+ * \brief Volume processing from 24 bit to 32 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s24_to_s32(struct comp_dev *dev, struct comp_buffer *sink,
+			   struct comp_buffer *source, uint32_t frames)
+{
+	vol_x86_process(dev, sink, source, frames, VOL_X86_S24, VOL_X86_S32,
+			0, Q_SHIFT_BITS_64(23, 16, 31));
+}
+
+/**
+ * \brief Volume processing from 32 bit to 16 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s32_to_s16(struct comp_dev *dev, struct comp_buffer *sink,
+			   struct comp_buffer *source, uint32_t frames)
+{
+	vol_x86_process(dev, sink, source, frames, VOL_X86_S32, VOL_X86_S16,
+			0, Q_SHIFT_BITS_64(31, 16, 15));
+}
+
+/**
+ * \brief Volume processing from 32 bit to 24 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s32_to_s24(struct comp_dev *dev, struct comp_buffer *sink,
+			   struct comp_buffer *source, uint32_t frames)
+{
+	vol_x86_process(dev, sink, source, frames, VOL_X86_S32, VOL_X86_S24,
+			0, Q_SHIFT_BITS_64(31, 16, 23));
+}
+
+/**
+ * \brief Volume processing from 32 bit to 32 bit.
+ * \param[in,out] dev Volume base component device.
+ * \param[in,out] sink Destination buffer.
+ * \param[in,out] source Source buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s32_to_s32(struct comp_dev *dev, struct comp_buffer *sink,
+			   struct comp_buffer *source, uint32_t frames)
+{
+	vol_x86_process(dev, sink, source, frames, VOL_X86_S32, VOL_X86_S32,
+			0, Q_SHIFT_BITS_64(31, 16, 31));
+}
+
+const struct comp_func_map func_map[] = {
+	{SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE, vol_s16_to_s16},
+	{SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S24_4LE, vol_s16_to_s24},
+	{SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, vol_s16_to_s32},
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S16_LE, vol_s24_to_s16},
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, vol_s24_to_s24},
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE, vol_s24_to_s32},
+	{SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S16_LE, vol_s32_to_s16},
+	{SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE, vol_s32_to_s24},
+	{SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, vol_s32_to_s32},
+};
+
+const size_t func_count = ARRAY_SIZE(func_map);
+
+#endif
@@ -36,10 +36,28 @@
 #include <stdio.h>
 #include <malloc.h>
 #include <sof/alloc.h>
+#include <sof/list.h>
 #include "host/common_test.h"
+#include "host/dma.h"
 
 /* testbench mem alloc definition */
 
+/*
+ * Audio buffers are DMA memory and SG elements carry 32 bit addresses, so
+ * buffers are mapped with tb_dma_map(). The mappings are tracked to tell
+ * them apart from heap memory in rfree().
+ */
+struct buffer_map {
+	struct list_item list;
+	void *ptr;
+	size_t bytes;
+};
+
+static struct list_item buffer_maps = {
+	.next = &buffer_maps,
+	.prev = &buffer_maps,
+};
+
 void *rmalloc(int zone, uint32_t caps, size_t bytes)
 {
 	return malloc(bytes);
@@ -52,12 +70,40 @@ void *rzalloc(int zone, uint32_t caps, size_t bytes)
 
 void rfree(void *ptr)
 {
+	struct list_item *item;
+	struct buffer_map *map;
+
+	list_for_item(item, &buffer_maps) {
+		map = container_of(item, struct buffer_map, list);
+		if (map->ptr == ptr) {
+			tb_dma_unmap(map->ptr, map->bytes);
+			list_item_del(&map->list);
+			free(map);
+			return;
+		}
+	}
+
 	free(ptr);
 }
 
 void *rballoc(int zone, uint32_t caps, size_t bytes)
 {
-	return malloc(bytes);
+	struct buffer_map *map = malloc(sizeof(*map));
+
+	if (!map)
+		return NULL;
+
+	/* without 32 bit memory buffers can only be used by file I/O */
+	map->ptr = tb_dma_map(-1, bytes);
+	if (!map->ptr) {
+		free(map);
+		return malloc(bytes);
+	}
+
+	map->bytes = bytes;
+	list_item_append(&map->list, &buffer_maps);
+
+	return map->ptr;
 }
 
 void heap_trace(struct mm_heap *heap, int size)
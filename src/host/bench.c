@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Kernel benchmark for the host audio modules.
+ *
+ * Every CPU variant of the audio modules is loaded and its processing
+ * kernels are called directly on synthetic buffers for a range of
+ * formats, channel counts, period sizes and buffer wrap positions. Each
+ * case is calibrated to run long enough for the clock resolution, warmed
+ * up and then timed over a number of repetitions. The minimum and median
+ * time per sample and the median CPU cycles per sample are reported, and
+ * can be written as CSV for tracking kernels across commits.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <dlfcn.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <sof/sof.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <uapi/ipc/stream.h>
+#include "host/common_test.h"
+#include "host/trace.h"
+#include "host/bench.h"
+
+/* shortest timed repetition, shorter ones are dominated by clock jitter */
+#define BENCH_REP_NS		200000
+
+/* limit for calls per repetition of very fast kernels */
+#define BENCH_MAX_CALLS		(1 << 20)
+
+static const struct bench_module bench_modules[] = {
+	{"volume", bench_volume},
+	{"selector", bench_selector},
+	{"eq_fir", bench_eq_fir},
+	{"eq_iir", bench_eq_iir},
+	{"src", bench_src},
+	{"mixer", bench_mixer},
+};
+
+static uint64_t bench_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* CPU time stamp counter, not available on all hosts */
+static uint64_t bench_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static int bench_cmp_u64(const void *a, const void *b)
+{
+	const uint64_t *x = a;
+	const uint64_t *y = b;
+
+	return *x < *y ? -1 : *x > *y;
+}
+
+uint32_t bench_sample_bytes(uint32_t frame_fmt)
+{
+	return frame_fmt == SOF_IPC_FRAME_S16_LE ? 2 : 4;
+}
+
+const char *bench_format_name(uint32_t frame_fmt)
+{
+	switch (frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return "s16";
+	case SOF_IPC_FRAME_S24_4LE:
+		return "s24";
+	case SOF_IPC_FRAME_S32_LE:
+		return "s32";
+	case SOF_IPC_FRAME_FLOAT:
+		return "float";
+	default:
+		return "unknown";
+	}
+}
+
+int bench_kernel_enabled(struct bench_cfg *cfg, const char *kernel)
+{
+	return !cfg->kernel || strstr(kernel, cfg->kernel);
+}
+
+int bench_buffer_init(struct comp_buffer *buf, uint32_t frames,
+		      uint32_t frame_bytes, int wrap, uint32_t frame_fmt)
+{
+	uint32_t bytes = 2 * frames * frame_bytes;
+	uint32_t seed = bytes;
+	uint32_t i;
+
+	memset(buf, 0, sizeof(*buf));
+	buf->addr = aligned_alloc(64, ALIGN_UP(bytes, 64));
+	if (!buf->addr)
+		return -ENOMEM;
+
+	buf->size = bytes;
+	buf->alloc_size = bytes;
+	buf->end_addr = (char *)buf->addr + bytes;
+	buf->layout = SOF_IPC_BUFFER_INTERLEAVED;
+	buf->planes = 1;
+	buf->plane_size = bytes;
+	buf->avail = bytes;
+	buf->free = bytes;
+
+	/* period starts half a period before the wrap */
+	buf->r_ptr = buf->addr;
+	if (wrap)
+		buf->r_ptr = (char *)buf->end_addr - frames / 2 * frame_bytes;
+	buf->w_ptr = buf->r_ptr;
+
+	/* pseudo random full scale samples */
+	for (i = 0; i < bytes / bench_sample_bytes(frame_fmt); i++) {
+		seed = seed * 1664525 + 1013904223;
+		switch (frame_fmt) {
+		case SOF_IPC_FRAME_S16_LE:
+			((int16_t *)buf->addr)[i] = seed >> 16;
+			break;
+		case SOF_IPC_FRAME_S24_4LE:
+			((int32_t *)buf->addr)[i] = (int32_t)seed >> 8;
+			break;
+		case SOF_IPC_FRAME_FLOAT:
+			((float *)buf->addr)[i] = (int32_t)seed / 2147483648.0f;
+			break;
+		default:
+			((int32_t *)buf->addr)[i] = seed;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+void bench_buffer_free(struct comp_buffer *buf)
+{
+	free(buf->addr);
+	buf->addr = NULL;
+}
+
+/* time calls of the kernel, returns ns */
+static uint64_t bench_time(struct bench_case *bc, uint32_t calls,
+			   uint64_t *cycles)
+{
+	uint64_t ns = bench_ns();
+	uint64_t cyc = bench_cycles();
+	uint32_t i;
+
+	for (i = 0; i < calls; i++)
+		bc->run(bc);
+
+	*cycles = bench_cycles() - cyc;
+	return bench_ns() - ns;
+}
+
+void bench_run(struct bench_cfg *cfg, struct bench_case *bc)
+{
+	uint64_t ns[cfg->reps];
+	uint64_t cyc[cfg->reps];
+	uint64_t cycles;
+	uint32_t calls = 1;
+	uint32_t i;
+	double samples;
+	double ns_min;
+	double ns_med;
+	double cyc_med;
+
+	/* calibrate calls per repetition */
+	while (bench_time(bc, calls, &cycles) < BENCH_REP_NS &&
+	       calls < BENCH_MAX_CALLS)
+		calls *= 2;
+
+	for (i = 0; i < cfg->warmup; i++)
+		bench_time(bc, calls, &cycles);
+
+	for (i = 0; i < cfg->reps; i++)
+		ns[i] = bench_time(bc, calls, &cyc[i]);
+
+	qsort(ns, cfg->reps, sizeof(ns[0]), bench_cmp_u64);
+	qsort(cyc, cfg->reps, sizeof(cyc[0]), bench_cmp_u64);
+
+	samples = (double)calls * bc->samples;
+	ns_min = ns[0] / samples;
+	ns_med = ns[cfg->reps / 2] / samples;
+	cyc_med = cyc[cfg->reps / 2] / samples;
+
+	printf("%-8s %-28s %-20s %2u ch %5u frames %-6s %9.3f ns %9.3f ns "
+	       "%8.2f cycles\n", cfg->variant, bc->kernel, bc->format,
+	       bc->channels, bc->frames, bc->wrap ? "wrap" : "linear",
+	       ns_med, ns_min, cyc_med);
+
+	if (cfg->csv)
+		fprintf(cfg->csv, "%s,%s,%s,%u,%u,%d,%u,%u,%.4f,%.4f,%.4f\n",
+			cfg->variant, bc->kernel, bc->format, bc->channels,
+			bc->frames, bc->wrap, calls, cfg->reps, ns_min, ns_med,
+			cyc_med);
+}
+
+/* parse comma separated list of numbers */
+static uint32_t parse_list(char *arg, uint32_t *list)
+{
+	char *tok = strtok(arg, ",");
+	uint32_t n = 0;
+
+	while (tok && n < BENCH_MAX_LIST) {
+		list[n] = atoi(tok);
+		if (list[n])
+			n++;
+		tok = strtok(NULL, ",");
+	}
+
+	return n;
+}
+
+/* true if name is in comma separated list, or there is no list */
+static int in_list(const char *list, const char *name)
+{
+	size_t len = strlen(name);
+	const char *p = list;
+
+	if (!list)
+		return 1;
+
+	while ((p = strstr(p, name))) {
+		if ((p == list || p[-1] == ',') &&
+		    (p[len] == ',' || p[len] == '\0'))
+			return 1;
+		p += len;
+	}
+
+	return 0;
+}
+
+static void print_usage(char *executable)
+{
+	printf("Usage: %s [-m modules] [-k kernel] [-v variants] ", executable);
+	printf("[-c channels] [-p frames] [-w warmup] [-r repetitions] ");
+	printf("[-F fir_taps] [-B iir_biquads] [-o csv_file]\n");
+	printf("modules, variants, channels and frames are comma separated ");
+	printf("lists, kernel selects kernels with names containing it\n");
+	printf("modules: volume, selector, eq_fir, eq_iir, src, mixer\n");
+	printf("Example Usage:\n");
+	printf("%s -m volume,src -v generic,avx2 -c 2 -p 48 -o bench.csv\n",
+	       executable);
+}
+
+int main(int argc, char **argv)
+{
+	struct bench_cfg cfg = {
+		.channels = {1, 2, 4, 8},
+		.num_channels = 4,
+		.frames = {48, 1024},
+		.num_frames = 2,
+		.warmup = 3,
+		.reps = 15,
+		.fir_taps = 64,
+		.iir_biquads = 2,
+	};
+	struct shared_lib_table lib;
+	char variants[DEBUG_MSG_LEN];
+	char *modules = NULL;
+	char *vlist = NULL;
+	char *variant;
+	char *saveptr;
+	void *handle;
+	int option;
+	int i;
+
+	while ((option = getopt(argc, argv, "hm:k:v:c:p:w:r:F:B:o:")) != -1) {
+		switch (option) {
+		case 'm':
+			modules = optarg;
+			break;
+		case 'k':
+			cfg.kernel = optarg;
+			break;
+		case 'v':
+			vlist = optarg;
+			break;
+		case 'c':
+			cfg.num_channels = parse_list(optarg, cfg.channels);
+			break;
+		case 'p':
+			cfg.num_frames = parse_list(optarg, cfg.frames);
+			break;
+		case 'w':
+			cfg.warmup = atoi(optarg);
+			break;
+		case 'r':
+			cfg.reps = atoi(optarg);
+			break;
+		case 'F':
+			cfg.fir_taps = atoi(optarg);
+			break;
+		case 'B':
+			cfg.iir_biquads = atoi(optarg);
+			break;
+		case 'o':
+			cfg.csv = fopen(optarg, "w");
+			if (!cfg.csv) {
+				fprintf(stderr, "error: opening file %s\n",
+					optarg);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'h':
+		default:
+			print_usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (!cfg.num_channels || !cfg.num_frames || !cfg.reps) {
+		print_usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	/* kernels don't trace in the data path, keep setup quiet */
+	tb_enable_trace(false);
+
+	/* module libraries register their drivers when loaded */
+	sys_comp_init();
+
+	if (cfg.csv)
+		fprintf(cfg.csv, "variant,kernel,format,channels,frames,wrap,"
+			"calls,reps,ns_per_sample_min,ns_per_sample_median,"
+			"cycles_per_sample_median\n");
+
+	printf("%-8s %-28s %-20s %5s %12s %-6s %12s %12s %15s\n", "variant",
+	       "kernel", "format", "", "", "buffer", "ns med/smpl",
+	       "ns min/smpl", "cyc med/smpl");
+
+	/* all variants supported by this CPU */
+	strcpy(variants, tb_get_cpu_features());
+	for (variant = strtok_r(variants, " ", &saveptr); variant;
+	     variant = strtok_r(NULL, " ", &saveptr)) {
+		if (!in_list(vlist, variant))
+			continue;
+
+		tb_set_cpu_variant(variant);
+		cfg.variant = variant;
+
+		for (i = 0; i < ARRAY_SIZE(bench_modules); i++) {
+			if (!in_list(modules, bench_modules[i].name))
+				continue;
+
+			memset(&lib, 0, sizeof(lib));
+			snprintf(lib.library_name, sizeof(lib.library_name),
+				 "libsof_%s.so", bench_modules[i].name);
+
+			handle = tb_open_library(&lib);
+			if (!handle)
+				continue;
+
+			bench_modules[i].run(handle, &cfg);
+		}
+	}
+
+	if (cfg.csv)
+		fclose(cfg.csv);
+
+	return 0;
+}
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * FIR and IIR equalizer kernel benchmark. The FIR kernels are called
+ * directly, the IIR kernels through the configured processing function
+ * map of the EQ IIR component. Both use a flat response so long runs
+ * don't saturate.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <sof/audio/component.h>
+#include <uapi/user/eq.h>
+#include "fir_config.h"
+#include "fir.h"
+#include "eq_iir.h"
+#include "iir.h"
+#include "host/bench.h"
+
+/* processing function map of EQ IIR covers all source x sink formats */
+#define BENCH_IIR_FUNC_MAP	9
+
+typedef void (*bench_fir_func)(struct fir_state_32x16 fir[],
+			       struct comp_buffer *source,
+			       struct comp_buffer *sink, int frames, int nch);
+
+/*
+ * Only the filter states at the start of the EQ IIR component data are
+ * used by the processing functions.
+ */
+struct bench_iir_data {
+	struct iir_state_df2t iir[PLATFORM_MAX_CHANNELS];
+};
+
+struct bench_eq_prm {
+	struct comp_dev dev;
+	struct comp_buffer source;
+	struct comp_buffer sink;
+	struct fir_state_32x16 fir[PLATFORM_MAX_CHANNELS];
+	struct bench_iir_data iir;
+	bench_fir_func fir_func;
+	eq_iir_func iir_func;
+	void *delay;
+};
+
+static int bench_eq_buffers(struct bench_eq_prm *prm, uint32_t source_fmt,
+			    uint32_t sink_fmt, uint32_t channels,
+			    uint32_t frames, int wrap)
+{
+	if (bench_buffer_init(&prm->source, frames,
+			      channels * bench_sample_bytes(source_fmt),
+			      wrap, source_fmt) < 0 ||
+	    bench_buffer_init(&prm->sink, frames,
+			      channels * bench_sample_bytes(sink_fmt),
+			      wrap, sink_fmt) < 0) {
+		fprintf(stderr, "error: eq buffer allocation\n");
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static void bench_eq_free(struct bench_eq_prm *prm)
+{
+	bench_buffer_free(&prm->source);
+	bench_buffer_free(&prm->sink);
+	free(prm->delay);
+}
+
+static void bench_fir_run(struct bench_case *bc)
+{
+	struct bench_eq_prm *prm = bc->priv;
+
+	prm->fir_func(prm->fir, &prm->source, &prm->sink, bc->frames,
+		      bc->channels);
+}
+
+static void bench_fir_case(struct bench_cfg *cfg, void *handle,
+			   struct sof_eq_fir_coef_data *coef,
+			   bench_fir_func func, uint32_t frame_fmt,
+			   uint32_t channels, uint32_t frames, int wrap)
+{
+	size_t (*init_coef)(struct fir_state_32x16 *fir,
+			    struct sof_eq_fir_coef_data *config);
+	void (*init_delay)(struct fir_state_32x16 *fir, int32_t **data);
+	struct bench_eq_prm prm;
+	struct bench_case bc = {
+		.kernel = "eq_fir",
+		.channels = channels,
+		.frames = frames,
+		.wrap = wrap,
+		.samples = channels * frames,
+		.run = bench_fir_run,
+		.priv = &prm,
+	};
+	int32_t *delay;
+	int size = 0;
+	uint32_t ch;
+
+	init_coef = dlsym(handle, "fir_init_coef");
+	init_delay = dlsym(handle, "fir_init_delay");
+	if (!init_coef || !init_delay) {
+		fprintf(stderr, "error: no FIR init functions\n");
+		return;
+	}
+
+	memset(&prm, 0, sizeof(prm));
+	prm.fir_func = func;
+
+	for (ch = 0; ch < channels; ch++) {
+		size = init_coef(&prm.fir[ch], coef);
+		if (size < 0) {
+			fprintf(stderr, "error: FIR length %d\n",
+				coef->length);
+			return;
+		}
+	}
+
+	prm.delay = calloc(channels, size);
+	if (!prm.delay)
+		return;
+
+	delay = prm.delay;
+	for (ch = 0; ch < channels; ch++)
+		init_delay(&prm.fir[ch], &delay);
+
+	snprintf(bc.format, sizeof(bc.format), "%s %d taps",
+		 bench_format_name(frame_fmt), coef->length);
+
+	if (!bench_eq_buffers(&prm, frame_fmt, frame_fmt, channels, frames,
+			      wrap))
+		bench_run(cfg, &bc);
+
+	bench_eq_free(&prm);
+}
+
+void bench_eq_fir(void *handle, struct bench_cfg *cfg)
+{
+	static const struct {
+		uint32_t frame_fmt;
+		const char *name_x86;	/* optimized kernel */
+		const char *name;	/* generic kernel */
+	} kernels[] = {
+		{SOF_IPC_FRAME_S16_LE, "eq_fir_s16_x86", "eq_fir_s16"},
+		{SOF_IPC_FRAME_S24_4LE, "eq_fir_s24_x86", "eq_fir_s24"},
+		{SOF_IPC_FRAME_S32_LE, "eq_fir_s32_x86", "eq_fir_s32"},
+	};
+	struct sof_eq_fir_coef_data *coef;
+	bench_fir_func func;
+	uint32_t c;
+	uint32_t f;
+	int i;
+	int n;
+	int wrap;
+
+	if (!bench_kernel_enabled(cfg, "eq_fir"))
+		return;
+
+	/* moving average filter */
+	coef = calloc(1, sizeof(*coef) + cfg->fir_taps * sizeof(int16_t));
+	if (!coef)
+		return;
+
+	coef->length = cfg->fir_taps;
+	for (n = 0; n < coef->length; n++)
+		coef->coef[n] = INT16_MAX / coef->length;
+
+	for (i = 0; i < ARRAY_SIZE(kernels); i++) {
+		func = dlsym(handle, kernels[i].name_x86);
+		if (!func)
+			func = dlsym(handle, kernels[i].name);
+		if (!func) {
+			fprintf(stderr, "error: no FIR function %s\n",
+				kernels[i].name);
+			continue;
+		}
+
+		for (c = 0; c < cfg->num_channels; c++) {
+			if (cfg->channels[c] > PLATFORM_MAX_CHANNELS)
+				continue;
+			for (f = 0; f < cfg->num_frames; f++)
+				for (wrap = 0; wrap < 2; wrap++)
+					bench_fir_case(cfg, handle, coef, func,
+						       kernels[i].frame_fmt,
+						       cfg->channels[c],
+						       cfg->frames[f], wrap);
+		}
+	}
+
+	free(coef);
+}
+
+static void bench_iir_run(struct bench_case *bc)
+{
+	struct bench_eq_prm *prm = bc->priv;
+
+	prm->iir_func(&prm->dev, &prm->source, &prm->sink, bc->frames);
+}
+
+static void bench_iir_case(struct bench_cfg *cfg, void *handle,
+			   struct sof_eq_iir_header_df2t *coef,
+			   const struct eq_iir_func_map *map,
+			   uint32_t channels, uint32_t frames, int wrap)
+{
+	size_t (*init_coef)(struct iir_state_df2t *iir,
+			    struct sof_eq_iir_header_df2t *config);
+	void (*init_delay)(struct iir_state_df2t *iir, int64_t **delay);
+	struct bench_eq_prm prm;
+	struct bench_case bc = {
+		.kernel = "eq_iir_func",
+		.channels = channels,
+		.frames = frames,
+		.wrap = wrap,
+		.samples = channels * frames,
+		.run = bench_iir_run,
+		.priv = &prm,
+	};
+	int64_t *delay;
+	int size = 0;
+	uint32_t ch;
+
+	init_coef = dlsym(handle, "iir_init_coef_df2t");
+	init_delay = dlsym(handle, "iir_init_delay_df2t");
+	if (!init_coef || !init_delay) {
+		fprintf(stderr, "error: no IIR init functions\n");
+		return;
+	}
+
+	memset(&prm, 0, sizeof(prm));
+	prm.iir_func = map->func;
+	prm.dev.params.channels = channels;
+	comp_set_drvdata((&prm.dev), &prm.iir);
+
+	for (ch = 0; ch < channels; ch++) {
+		size = init_coef(&prm.iir.iir[ch], coef);
+		if (size < 0) {
+			fprintf(stderr, "error: IIR biquads %u\n",
+				coef->num_sections);
+			return;
+		}
+	}
+
+	prm.delay = calloc(channels, size);
+	if (!prm.delay)
+		return;
+
+	delay = prm.delay;
+	for (ch = 0; ch < channels; ch++)
+		init_delay(&prm.iir.iir[ch], &delay);
+
+	snprintf(bc.format, sizeof(bc.format), "%s>%s %u bq",
+		 bench_format_name(map->source), bench_format_name(map->sink),
+		 coef->num_sections);
+
+	if (!bench_eq_buffers(&prm, map->source, map->sink, channels, frames,
+			      wrap))
+		bench_run(cfg, &bc);
+
+	bench_eq_free(&prm);
+}
+
+void bench_eq_iir(void *handle, struct bench_cfg *cfg)
+{
+	const struct eq_iir_func_map *map = dlsym(handle, "fm_configured");
+	struct sof_eq_iir_biquad_df2t *bq;
+	struct sof_eq_iir_header_df2t *coef;
+	uint32_t c;
+	uint32_t f;
+	uint32_t n;
+	int i;
+	int wrap;
+
+	if (!map) {
+		fprintf(stderr, "error: no IIR function map\n");
+		return;
+	}
+
+	if (!bench_kernel_enabled(cfg, "eq_iir_func"))
+		return;
+
+	coef = calloc(1, sizeof(*coef) + cfg->iir_biquads * sizeof(*bq));
+	if (!coef)
+		return;
+
+	/* unity gain biquads with stable poles */
+	coef->num_sections = cfg->iir_biquads;
+	coef->num_sections_in_series = cfg->iir_biquads;
+	bq = (struct sof_eq_iir_biquad_df2t *)coef->biquads;
+	for (n = 0; n < cfg->iir_biquads; n++) {
+		bq[n].a2 = -(1 << 28);
+		bq[n].a1 = 1 << 29;
+		bq[n].b2 = 1 << 27;
+		bq[n].b1 = 1 << 28;
+		bq[n].b0 = 1 << 29;
+		bq[n].output_shift = 0;
+		bq[n].output_gain = 1 << 14;
+	}
+
+	for (i = 0; i < BENCH_IIR_FUNC_MAP; i++) {
+		if (!map[i].func)
+			continue;
+
+		for (c = 0; c < cfg->num_channels; c++) {
+			if (cfg->channels[c] > PLATFORM_MAX_CHANNELS)
+				continue;
+			for (f = 0; f < cfg->num_frames; f++)
+				for (wrap = 0; wrap < 2; wrap++)
+					bench_iir_case(cfg, handle, coef,
+						       &map[i],
+						       cfg->channels[c],
+						       cfg->frames[f], wrap);
+		}
+	}
+
+	free(coef);
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Mixer kernel benchmark. The mix functions are private to the mixer, so
+ * the component is created and prepared through its driver and the mix
+ * function it selects is called directly. Cost is per sink sample.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <config.h>
+#include <sof/list.h>
+#include <sof/audio/component.h>
+#include <sof/audio/mixer.h>
+#include <uapi/ipc/topology.h>
+#include "host/bench.h"
+
+#define BENCH_MIXER_SOURCES	4
+
+struct bench_mixer_prm {
+	struct comp_dev *dev;
+	struct mixer_data *md;
+	struct comp_buffer source[BENCH_MIXER_SOURCES];
+	struct comp_buffer *sources[BENCH_MIXER_SOURCES];
+	struct comp_buffer sink;
+	uint32_t num_sources;
+};
+
+static void bench_mixer_run(struct bench_case *bc)
+{
+	struct bench_mixer_prm *prm = bc->priv;
+
+	prm->md->mix_func(prm->dev, &prm->sink, prm->sources,
+			  prm->num_sources, bc->frames);
+}
+
+static void bench_mixer_case(struct bench_cfg *cfg, struct comp_driver *drv,
+			     uint32_t frame_fmt, uint32_t num_sources,
+			     uint32_t channels, uint32_t frames, int wrap)
+{
+	struct sof_ipc_comp_mixer mixer;
+	struct bench_mixer_prm prm;
+	struct bench_case bc = {
+		.kernel = "mix_func",
+		.channels = channels,
+		.frames = frames,
+		.wrap = wrap,
+		.samples = channels * frames,
+		.run = bench_mixer_run,
+		.priv = &prm,
+	};
+	uint32_t frame_bytes = channels * bench_sample_bytes(frame_fmt);
+	uint32_t i;
+
+	memset(&prm, 0, sizeof(prm));
+	memset(&mixer, 0, sizeof(mixer));
+	mixer.comp.hdr.size = sizeof(mixer);
+	mixer.comp.type = SOF_COMP_MIXER;
+	mixer.config.hdr.size = sizeof(mixer.config);
+
+	prm.dev = drv->ops.new((struct sof_ipc_comp *)&mixer);
+	if (!prm.dev) {
+		fprintf(stderr, "error: mixer new\n");
+		return;
+	}
+
+	list_init(&prm.dev->bsource_list);
+	list_init(&prm.dev->bsink_list);
+	prm.dev->drv = drv;
+	prm.dev->params.channels = channels;
+	prm.dev->params.frame_fmt = frame_fmt;
+	prm.dev->frames = frames;
+
+	if (drv->ops.prepare(prm.dev) < 0) {
+		fprintf(stderr, "error: mixer prepare\n");
+		goto out;
+	}
+
+	prm.md = comp_get_drvdata(prm.dev);
+	prm.num_sources = num_sources;
+
+	snprintf(bc.format, sizeof(bc.format), "%s %u src",
+		 bench_format_name(frame_fmt), num_sources);
+
+	for (i = 0; i < num_sources; i++) {
+		prm.sources[i] = &prm.source[i];
+		if (bench_buffer_init(&prm.source[i], frames, frame_bytes, wrap,
+				      frame_fmt) < 0)
+			goto out;
+	}
+
+	if (bench_buffer_init(&prm.sink, frames, frame_bytes, wrap,
+			      frame_fmt) < 0)
+		goto out;
+
+	bench_run(cfg, &bc);
+
+out:
+	for (i = 0; i < num_sources; i++)
+		bench_buffer_free(&prm.source[i]);
+	bench_buffer_free(&prm.sink);
+	drv->ops.free(prm.dev);
+}
+
+void bench_mixer(void *handle, struct bench_cfg *cfg)
+{
+	static const uint32_t formats[] = {
+		SOF_IPC_FRAME_S16_LE,
+		SOF_IPC_FRAME_S32_LE,
+#if CONFIG_FORMAT_FLOAT
+		SOF_IPC_FRAME_FLOAT,
+#endif
+	};
+	struct comp_driver *drv = dlsym(handle, "comp_mixer");
+	uint32_t n;
+	uint32_t c;
+	uint32_t f;
+	int i;
+	int wrap;
+
+	if (!drv) {
+		fprintf(stderr, "error: no mixer driver\n");
+		return;
+	}
+
+	if (!bench_kernel_enabled(cfg, "mix_func"))
+		return;
+
+	for (i = 0; i < ARRAY_SIZE(formats); i++)
+		for (n = 2; n <= BENCH_MIXER_SOURCES; n *= 2)
+			for (c = 0; c < cfg->num_channels; c++)
+				for (f = 0; f < cfg->num_frames; f++)
+					for (wrap = 0; wrap < 2; wrap++)
+						bench_mixer_case
+							(cfg, drv, formats[i],
+							 n, cfg->channels[c],
+							 cfg->frames[f], wrap);
+}
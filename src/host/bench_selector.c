@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Channel selector kernel benchmark. The selector only supports two and
+ * four channel sources, so the channel list of the configuration is not
+ * used. Cost is per source sample.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <sof/audio/component.h>
+#include "selector.h"
+#include "host/bench.h"
+
+struct bench_selector_prm {
+	struct comp_dev dev;
+	struct comp_data cd;
+	struct comp_buffer source;
+	struct comp_buffer sink;
+	sel_func func;
+};
+
+static void bench_selector_run(struct bench_case *bc)
+{
+	struct bench_selector_prm *prm = bc->priv;
+
+	prm->func(&prm->dev, &prm->sink, &prm->source, bc->frames);
+}
+
+static void bench_selector_case(struct bench_cfg *cfg,
+				sel_func (*get_func)(struct comp_dev *dev),
+				uint32_t frame_fmt, uint32_t in_nch,
+				uint32_t out_nch, uint32_t frames, int wrap)
+{
+	struct bench_selector_prm prm;
+	struct bench_case bc = {
+		.kernel = "sel_func",
+		.channels = in_nch,
+		.frames = frames,
+		.wrap = wrap,
+		.samples = in_nch * frames,
+		.run = bench_selector_run,
+		.priv = &prm,
+	};
+	uint32_t sample_bytes = bench_sample_bytes(frame_fmt);
+
+	memset(&prm, 0, sizeof(prm));
+	prm.dev.params.channels = in_nch;
+	prm.cd.source_format = frame_fmt;
+	prm.cd.sink_format = frame_fmt;
+	prm.cd.config.in_channels_count = in_nch;
+	prm.cd.config.out_channels_count = out_nch;
+	prm.cd.config.sel_channel = in_nch - 1;
+	comp_set_drvdata((&prm.dev), &prm.cd);
+
+	prm.func = get_func(&prm.dev);
+	if (!prm.func)
+		return;
+
+	snprintf(bc.format, sizeof(bc.format), "%s %u>%u",
+		 bench_format_name(frame_fmt), in_nch, out_nch);
+
+	if (bench_buffer_init(&prm.source, frames, in_nch * sample_bytes,
+			      wrap, frame_fmt) < 0 ||
+	    bench_buffer_init(&prm.sink, frames, out_nch * sample_bytes,
+			      wrap, frame_fmt) < 0) {
+		fprintf(stderr, "error: selector buffer allocation\n");
+		goto out;
+	}
+
+	bench_run(cfg, &bc);
+
+out:
+	bench_buffer_free(&prm.source);
+	bench_buffer_free(&prm.sink);
+}
+
+void bench_selector(void *handle, struct bench_cfg *cfg)
+{
+	static const uint32_t formats[] = {
+		SOF_IPC_FRAME_S16_LE,
+		SOF_IPC_FRAME_S24_4LE,
+		SOF_IPC_FRAME_S32_LE,
+	};
+	static const uint32_t in_channels[] = {SEL_SOURCE_2CH, SEL_SOURCE_4CH};
+	sel_func (*get_func)(struct comp_dev *dev);
+	uint32_t in;
+	uint32_t out;
+	uint32_t f;
+	uint32_t i;
+	int wrap;
+
+	get_func = dlsym(handle, "sel_get_processing_function");
+	if (!get_func) {
+		fprintf(stderr, "error: no selector processing functions\n");
+		return;
+	}
+
+	if (!bench_kernel_enabled(cfg, "sel_func"))
+		return;
+
+	for (i = 0; i < ARRAY_SIZE(formats); i++)
+		for (in = 0; in < ARRAY_SIZE(in_channels); in++)
+			for (out = SEL_SINK_1CH; out <= in_channels[in];
+			     out = out == SEL_SINK_1CH ? in_channels[in] :
+			     out + 1)
+				for (f = 0; f < cfg->num_frames; f++)
+					for (wrap = 0; wrap < 2; wrap++)
+						bench_selector_case
+							(cfg, get_func,
+							 formats[i],
+							 in_channels[in], out,
+							 cfg->frames[f], wrap);
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Sample rate converter kernel benchmark. Each stage of a conversion is
+ * measured separately with the stage repeated to cover a period. Cost is
+ * per input sample of the stage.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <sof/audio/component.h>
+#include "src.h"
+#include "host/bench.h"
+
+typedef void (*bench_src_func)(struct src_stage_prm *s);
+
+struct bench_src_prm {
+	struct src_stage_prm s;
+	struct comp_buffer source;
+	struct comp_buffer sink;
+	bench_src_func func;
+};
+
+struct bench_src_lib {
+	int (*buffer_lengths)(struct src_param *p, int fs_in, int fs_out,
+			      int nch, int source_frames);
+	int (*polyphase_init)(struct polyphase_src *src, struct src_param *p,
+			      int32_t *delay_lines_start);
+	bench_src_func func[2];		/* s32 and s16 stage functions */
+};
+
+static void bench_src_run(struct bench_case *bc)
+{
+	struct bench_src_prm *prm = bc->priv;
+
+	prm->s.x_rptr = prm->source.r_ptr;
+	prm->s.y_wptr = prm->sink.w_ptr;
+	prm->func(&prm->s);
+}
+
+static void bench_src_stage(struct bench_cfg *cfg, struct bench_src_lib *lib,
+			    struct src_stage *stage, struct src_state *state,
+			    uint32_t frame_fmt, uint32_t channels,
+			    uint32_t frames, int wrap, const char *format)
+{
+	uint32_t sample_bytes = bench_sample_bytes(frame_fmt);
+	struct bench_src_prm prm;
+	struct bench_case bc = {
+		.channels = channels,
+		.wrap = wrap,
+		.run = bench_src_run,
+		.priv = &prm,
+	};
+	int times = MAX(frames / stage->blk_in, 1);
+
+	memset(&prm, 0, sizeof(prm));
+	if (frame_fmt == SOF_IPC_FRAME_S16_LE) {
+		prm.func = lib->func[1];
+		bc.kernel = "src_polyphase_stage_cir_s16";
+	} else {
+		prm.func = lib->func[0];
+		bc.kernel = "src_polyphase_stage_cir";
+	}
+
+	if (!prm.func || !bench_kernel_enabled(cfg, bc.kernel))
+		return;
+
+	bc.frames = times * stage->blk_in;
+	bc.samples = bc.frames * channels;
+	strncpy(bc.format, format, sizeof(bc.format) - 1);
+
+	if (bench_buffer_init(&prm.source, bc.frames, channels * sample_bytes,
+			      wrap, frame_fmt) < 0 ||
+	    bench_buffer_init(&prm.sink, times * stage->blk_out,
+			      channels * sample_bytes, wrap, frame_fmt) < 0) {
+		fprintf(stderr, "error: src buffer allocation\n");
+		goto out;
+	}
+
+	prm.s.nch = channels;
+	prm.s.times = times;
+	prm.s.x_end_addr = prm.source.end_addr;
+	prm.s.x_size = prm.source.size;
+	prm.s.y_addr = prm.sink.addr;
+	prm.s.y_end_addr = prm.sink.end_addr;
+	prm.s.y_size = prm.sink.size;
+	prm.s.shift = frame_fmt == SOF_IPC_FRAME_S24_4LE ? 8 : 0;
+	prm.s.state = state;
+	prm.s.stage = stage;
+
+	bench_run(cfg, &bc);
+
+out:
+	bench_buffer_free(&prm.source);
+	bench_buffer_free(&prm.sink);
+}
+
+static void bench_src_case(struct bench_cfg *cfg, struct bench_src_lib *lib,
+			   uint32_t frame_fmt, int fs_in, int fs_out,
+			   uint32_t channels, uint32_t frames, int wrap)
+{
+	struct polyphase_src src;
+	struct src_param p;
+	int32_t *delay;
+	char format[32];
+	int stages;
+
+	memset(&src, 0, sizeof(src));
+	memset(&p, 0, sizeof(p));
+
+	/* not all conversions are built in the coefficient tables */
+	if (lib->buffer_lengths(&p, fs_in, fs_out, channels, frames) < 0)
+		return;
+
+	delay = calloc(p.total, sizeof(int32_t));
+	if (!delay)
+		return;
+
+	stages = lib->polyphase_init(&src, &p, delay);
+	if (stages > 0) {
+		snprintf(format, sizeof(format), "%s %d>%d s1",
+			 bench_format_name(frame_fmt), fs_in, fs_out);
+		bench_src_stage(cfg, lib, src.stage1, &src.state1, frame_fmt,
+				channels, frames, wrap, format);
+	}
+
+	if (stages > 1) {
+		snprintf(format, sizeof(format), "%s %d>%d s2",
+			 bench_format_name(frame_fmt), fs_in, fs_out);
+		bench_src_stage(cfg, lib, src.stage2, &src.state2, frame_fmt,
+				channels, frames, wrap, format);
+	}
+
+	free(delay);
+}
+
+void bench_src(void *handle, struct bench_cfg *cfg)
+{
+	static const uint32_t formats[] = {
+		SOF_IPC_FRAME_S16_LE,
+		SOF_IPC_FRAME_S24_4LE,
+		SOF_IPC_FRAME_S32_LE,
+	};
+	static const int rates[][2] = {
+		{44100, 48000},
+		{48000, 44100},
+		{16000, 48000},
+		{48000, 16000},
+		{48000, 96000},
+		{96000, 48000},
+	};
+	struct bench_src_lib lib;
+	uint32_t c;
+	uint32_t f;
+	int i;
+	int r;
+	int wrap;
+
+	lib.buffer_lengths = dlsym(handle, "src_buffer_lengths");
+	lib.polyphase_init = dlsym(handle, "src_polyphase_init");
+	lib.func[0] = dlsym(handle, "src_polyphase_stage_cir");
+	lib.func[1] = dlsym(handle, "src_polyphase_stage_cir_s16");
+	if (!lib.buffer_lengths || !lib.polyphase_init) {
+		fprintf(stderr, "error: no SRC init functions\n");
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(formats); i++)
+		for (r = 0; r < ARRAY_SIZE(rates); r++)
+			for (c = 0; c < cfg->num_channels; c++)
+				for (f = 0; f < cfg->num_frames; f++)
+					for (wrap = 0; wrap < 2; wrap++)
+						bench_src_case
+							(cfg, &lib, formats[i],
+							 rates[r][0],
+							 rates[r][1],
+							 cfg->channels[c],
+							 cfg->frames[f], wrap);
+}
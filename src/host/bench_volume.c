@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Volume kernel benchmark, all source and sink format pairs. */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <dlfcn.h>
+#include <sof/audio/component.h>
+#include "volume.h"
+#include "host/bench.h"
+
+struct bench_volume_prm {
+	struct comp_dev dev;
+	struct comp_data cd;
+	struct comp_buffer source;
+	struct comp_buffer sink;
+	const struct comp_func_map *map;
+};
+
+static void bench_volume_run(struct bench_case *bc)
+{
+	struct bench_volume_prm *prm = bc->priv;
+	void *r_ptr = prm->source.r_ptr;
+	void *w_ptr = prm->sink.w_ptr;
+
+	prm->map->func(&prm->dev, &prm->sink, &prm->source, bc->frames);
+
+	/* kernels don't move pointers, keep the same period anyway */
+	prm->source.r_ptr = r_ptr;
+	prm->sink.w_ptr = w_ptr;
+}
+
+static void bench_volume_case(struct bench_cfg *cfg,
+			      const struct comp_func_map *map,
+			      uint32_t channels, uint32_t frames, int wrap)
+{
+	struct bench_volume_prm prm;
+	struct bench_case bc = {
+		.kernel = "scale_vol",
+		.channels = channels,
+		.frames = frames,
+		.wrap = wrap,
+		.samples = channels * frames,
+		.run = bench_volume_run,
+		.priv = &prm,
+	};
+	uint32_t i;
+
+	memset(&prm, 0, sizeof(prm));
+	prm.map = map;
+	prm.dev.params.channels = channels;
+	prm.cd.source_format = map->source;
+	prm.cd.sink_format = map->sink;
+	for (i = 0; i < SOF_IPC_MAX_CHANNELS; i++)
+		prm.cd.volume[i] = VOL_ZERO_DB / 2;
+	comp_set_drvdata((&prm.dev), &prm.cd);
+
+	snprintf(bc.format, sizeof(bc.format), "%s>%s",
+		 bench_format_name(map->source), bench_format_name(map->sink));
+
+	if (bench_buffer_init(&prm.source, frames,
+			      channels * bench_sample_bytes(map->source),
+			      wrap, map->source) < 0 ||
+	    bench_buffer_init(&prm.sink, frames,
+			      channels * bench_sample_bytes(map->sink),
+			      wrap, map->sink) < 0) {
+		fprintf(stderr, "error: volume buffer allocation\n");
+		goto out;
+	}
+
+	bench_run(cfg, &bc);
+
+out:
+	bench_buffer_free(&prm.source);
+	bench_buffer_free(&prm.sink);
+}
+
+static void bench_volume_map(struct bench_cfg *cfg,
+			     const struct comp_func_map *map, size_t count)
+{
+	uint32_t c;
+	uint32_t f;
+	size_t i;
+	int wrap;
+
+	for (i = 0; i < count; i++)
+		for (c = 0; c < cfg->num_channels; c++)
+			for (f = 0; f < cfg->num_frames; f++)
+				for (wrap = 0; wrap < 2; wrap++)
+					bench_volume_case(cfg, &map[i],
+							  cfg->channels[c],
+							  cfg->frames[f],
+							  wrap);
+}
+
+void bench_volume(void *handle, struct bench_cfg *cfg)
+{
+	const struct comp_func_map *map = dlsym(handle, "func_map");
+	const size_t *count = dlsym(handle, "func_count");
+
+	if (!map || !count) {
+		fprintf(stderr, "error: no volume function map\n");
+		return;
+	}
+
+	if (!bench_kernel_enabled(cfg, "scale_vol"))
+		return;
+
+	bench_volume_map(cfg, map, *count);
+
+	/* float kernels are optional */
+	map = dlsym(handle, "float_func_map");
+	count = dlsym(handle, "float_func_count");
+	if (map && count)
+		bench_volume_map(cfg, map, *count);
+}
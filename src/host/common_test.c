@@ -38,6 +38,7 @@
 #include <stdlib.h>
 #include <sof/string.h>
 #include <math.h>
+#include <dlfcn.h>
 #include <arch/sof.h>
 #include <sof/task.h>
 #include <sof/alloc.h>
@@ -46,11 +47,22 @@
 #include <sof/dma.h>
 #include <sof/schedule.h>
 #include <sof/wait.h>
+#include <sof/notifier.h>
 #include <sof/ipc.h>
 #include <sof/audio/pipeline.h>
+#include "host/dai.h"
+#include "host/dma.h"
 #include "host/common_test.h"
 #include "host/topology.h"
 
+/* testbench runs everything on a single core with one notifier list */
+static struct notify *host_notify;
+
+struct notify **arch_notify_get(void)
+{
+	return &host_notify;
+}
+
 /* testbench helper functions for pipeline setup and trigger */
 
 int tb_pipeline_setup(struct sof *sof)
@@ -58,6 +70,13 @@ int tb_pipeline_setup(struct sof *sof)
 	/* init components */
 	sys_comp_init();
 
+	/* init notifier used by kpb and keyword detect */
+	init_system_notify(sof);
+
+	/* install the software DMA engines and the DAIs they serve */
+	tb_dma_init();
+	tb_dai_init();
+
 	/* init IPC */
 	if (ipc_init(sof) < 0) {
 		fprintf(stderr, "error: IPC init\n");
@@ -111,6 +130,9 @@ int tb_pipeline_start(struct ipc *ipc, int nch,
 	if (ret < 0)
 		printf("Warning: Failed start pipeline command.\n");
 
+	/* DSP is idle after the trigger, run the pipeline preload */
+	schedule();
+
 	return ret;
 }
 
@@ -140,6 +162,7 @@ int tb_pipeline_params(struct ipc *ipc, int nch,
 	params.params.direction = SOF_IPC_STREAM_PLAYBACK;
 	params.params.rate = tp->fs_in;
 	params.params.channels = nch;
+	params.params.buffer.size = tp->host_bytes;
 	switch (params.params.frame_fmt) {
 	case(SOF_IPC_FRAME_S16_LE):
 		params.params.sample_container_bytes = 2;
@@ -159,6 +182,12 @@ int tb_pipeline_params(struct ipc *ipc, int nch,
 		params.params.host_period_bytes = fs_period * nch *
 			params.params.sample_container_bytes;
 		break;
+	case(SOF_IPC_FRAME_FLOAT):
+		params.params.sample_container_bytes = 4;
+		params.params.sample_valid_bytes = 4;
+		params.params.host_period_bytes = fs_period * nch *
+			params.params.sample_container_bytes;
+		break;
 	default:
 		fprintf(stderr, "error: invalid frame format\n");
 		return -EINVAL;
@@ -217,37 +246,147 @@ int get_index_by_type(uint32_t comp_type,
 
 /* The following definitions are to satisfy libsof linker errors */
 
-struct dai *dai_get(uint32_t type, uint32_t index, uint32_t flags)
+void pipeline_xrun(struct pipeline *p, struct comp_dev *dev, int32_t bytes)
 {
-	return NULL;
 }
 
-void dai_put(struct dai *dai)
-{
-}
+/*
+ * CPU optimized module variants built by src/audio/CMakeLists.txt, in
+ * order of preference. Module libraries are named lib<module>_<variant>.so
+ * and the generic build is lib<module>.so.
+ */
+static const char * const cpu_variants[] = {
+	"avx2", "fma", "avx", "sse42",
+};
+
+#define CPU_VARIANT_GENERIC	"generic"
 
-struct dma *dma_get(uint32_t dir, uint32_t caps, uint32_t dev, uint32_t flags)
+/* variant forced by user, NULL picks best supported variant */
+static const char *cpu_variant_override;
+
+/* check CPU support for variant with cpuid */
+static int cpu_variant_supported(const char *variant)
 {
-	return NULL;
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+
+	if (!strcmp(variant, "avx2"))
+		return __builtin_cpu_supports("avx2");
+	if (!strcmp(variant, "fma"))
+		return __builtin_cpu_supports("fma");
+	if (!strcmp(variant, "avx"))
+		return __builtin_cpu_supports("avx");
+	if (!strcmp(variant, "sse42"))
+		return __builtin_cpu_supports("sse4.2");
+#endif
+	return 0;
 }
 
-void dma_put(struct dma *dma)
+/* force CPU variant for all modules, "generic" disables optimizations */
+int tb_set_cpu_variant(const char *variant)
 {
+	int i;
+
+	if (!strcmp(variant, CPU_VARIANT_GENERIC)) {
+		cpu_variant_override = CPU_VARIANT_GENERIC;
+		return 0;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(cpu_variants); i++) {
+		if (!strcmp(variant, cpu_variants[i])) {
+			cpu_variant_override = cpu_variants[i];
+			return 0;
+		}
+	}
+
+	return -EINVAL;
 }
 
-int dma_sg_alloc(struct dma_sg_elem_array *elem_array,
-		 int zone,
-		 uint32_t direction,
-		 uint32_t buffer_count, uint32_t buffer_bytes,
-		 uintptr_t dma_buffer_addr, uintptr_t external_addr)
+/* get space separated list of supported variants for report */
+const char *tb_get_cpu_features(void)
 {
-	return 0;
+	static char features[DEBUG_MSG_LEN];
+	int i;
+
+	strcpy(features, CPU_VARIANT_GENERIC);
+	for (i = 0; i < ARRAY_SIZE(cpu_variants); i++) {
+		if (cpu_variant_supported(cpu_variants[i])) {
+			strcat(features, " ");
+			strcat(features, cpu_variants[i]);
+		}
+	}
+
+	return features;
 }
 
-void dma_sg_free(struct dma_sg_elem_array *elem_array)
+/* open library of variant, library_name is the generic library */
+static void *open_variant(struct shared_lib_table *lib, const char *variant)
 {
+	char name[MAX_LIB_NAME_LEN];
+	char message[DEBUG_MSG_LEN + MAX_LIB_NAME_LEN];
+	const char *ext = strstr(lib->library_name, ".so");
+	void *handle;
+	int len;
+
+	if (!ext)
+		return NULL;
+
+	len = ext - lib->library_name;
+	snprintf(name, sizeof(name), "%.*s_%s%s", len, lib->library_name,
+		 variant, ext);
+
+	handle = dlopen(name, RTLD_LAZY);
+	if (!handle) {
+		sprintf(message, "no %s variant %s\n", variant, name);
+		debug_print(message);
+		return NULL;
+	}
+
+	strcpy(lib->library_name, name);
+	lib->variant = variant;
+
+	return handle;
 }
 
-void pipeline_xrun(struct pipeline *p, struct comp_dev *dev, int32_t bytes)
+/*
+ * Open module shared library, the best variant supported by CPU is
+ * used unless library was set by user or variant is forced.
+ */
+void *tb_open_library(struct shared_lib_table *lib)
 {
+	const char *variant = cpu_variant_override;
+	void *handle;
+	int i;
+
+	/* forced variant must exist */
+	if (!lib->user_library && variant &&
+	    strcmp(variant, CPU_VARIANT_GENERIC)) {
+		handle = open_variant(lib, variant);
+		if (!handle)
+			fprintf(stderr, "error: no %s variant of %s\n",
+				variant, lib->library_name);
+		return handle;
+	}
+
+	/* pick best supported variant, fall back to generic library */
+	if (!lib->user_library && !variant) {
+		for (i = 0; i < ARRAY_SIZE(cpu_variants); i++) {
+			if (!cpu_variant_supported(cpu_variants[i]))
+				continue;
+
+			handle = open_variant(lib, cpu_variants[i]);
+			if (handle)
+				return handle;
+		}
+	}
+
+	handle = dlopen(lib->library_name, RTLD_LAZY);
+	if (!handle) {
+		fprintf(stderr, "error: %s\n", dlerror());
+		return NULL;
+	}
+
+	lib->variant = lib->user_library ? "user" : CPU_VARIANT_GENERIC;
+
+	return handle;
 }
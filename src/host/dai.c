@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Testbench DAI driver. The DAIs have no registers to program, their FIFO
+ * addresses point to the codec streams of the software DMA engine.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <sof/sof.h>
+#include <sof/dai.h>
+#include "host/dai.h"
+#include "host/dma.h"
+
+static int tb_dai_set_config(struct dai *dai,
+			     struct sof_ipc_dai_config *config)
+{
+	return 0;
+}
+
+static int tb_dai_trigger(struct dai *dai, int cmd, int direction)
+{
+	return 0;
+}
+
+static int tb_dai_dummy(struct dai *dai)
+{
+	return 0;
+}
+
+static const struct dai_ops tb_dai_ops = {
+	.set_config		= tb_dai_set_config,
+	.trigger		= tb_dai_trigger,
+	.pm_context_restore	= tb_dai_dummy,
+	.pm_context_store	= tb_dai_dummy,
+	.probe			= tb_dai_dummy,
+	.remove			= tb_dai_dummy,
+};
+
+static struct dai tb_ssp[TB_DAI_COUNT];
+static struct dai tb_dmic[TB_DAI_COUNT];
+static struct dai tb_hda[TB_DAI_COUNT];
+
+static struct dai_type_info tb_dai_types[] = {
+	{
+		.type		= SOF_DAI_INTEL_SSP,
+		.dai_array	= tb_ssp,
+		.num_dais	= ARRAY_SIZE(tb_ssp),
+	},
+	{
+		.type		= SOF_DAI_INTEL_DMIC,
+		.dai_array	= tb_dmic,
+		.num_dais	= ARRAY_SIZE(tb_dmic),
+	},
+	{
+		.type		= SOF_DAI_INTEL_HDA,
+		.dai_array	= tb_hda,
+		.num_dais	= ARRAY_SIZE(tb_hda),
+	},
+};
+
+void tb_dai_init(void)
+{
+	struct dai_type_info *dti;
+	struct dai *d;
+
+	for (dti = tb_dai_types;
+	     dti < tb_dai_types + ARRAY_SIZE(tb_dai_types); dti++) {
+		for (d = dti->dai_array; d < dti->dai_array + dti->num_dais;
+		     d++) {
+			d->type = dti->type;
+			d->index = d - dti->dai_array;
+			d->ops = &tb_dai_ops;
+			spinlock_init(&d->lock);
+		}
+	}
+
+	dai_install(tb_dai_types, ARRAY_SIZE(tb_dai_types));
+}
+
+int tb_dai_set_fifo(uint32_t type, uint32_t index, int direction,
+		    struct tb_dma_fifo *fifo)
+{
+	struct dai_type_info *dti;
+
+	for (dti = tb_dai_types;
+	     dti < tb_dai_types + ARRAY_SIZE(tb_dai_types); dti++) {
+		if (dti->type != type)
+			continue;
+
+		if (index >= dti->num_dais)
+			return -EINVAL;
+
+		/* SG elements carry the 32 bit FIFO address */
+		dti->dai_array[index].plat_data.fifo[direction].offset =
+			(uint32_t)(uintptr_t)fifo;
+		return 0;
+	}
+
+	return -EINVAL;
+}
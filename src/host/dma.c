@@ -0,0 +1,815 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Software DMA engine for the testbench.
+ *
+ * Each DMAC runs a worker thread that moves the SG elements of its active
+ * channels at the configured bandwidth. Channels with IRQs enabled behave
+ * like DW-DMA: every element is a block that raises a DMA_CB_TYPE_IRQ
+ * callback, which can reload the next element or stop the channel. Channels
+ * with IRQs disabled behave like HDA-DMA: the elements form a ring, the
+ * engine fills or drains it as space and data allow and dma_copy() is used
+ * to acknowledge the bytes consumed or produced by the firmware.
+ *
+ * Completed blocks are handled in emulated interrupt context: one lock is
+ * held while data lands and callbacks run, the testbench takes the same
+ * lock with tb_dma_irq_lock() when it calls into the pipeline. The device
+ * side of DAI channels is a struct tb_dma_fifo codec stream.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <sof/atomic.h>
+#include <sof/dma.h>
+#include <sof/trace.h>
+#include <sof/audio/component.h>
+#include <sof/math/numbers.h>
+#include <platform/dma.h>
+#include "host/dma.h"
+
+#define trace_swdma(__e, ...) \
+	trace_event(TRACE_CLASS_DMA, __e, ##__VA_ARGS__)
+#define trace_swdma_error(__e, ...) \
+	trace_error(TRACE_CLASS_DMA, __e, ##__VA_ARGS__)
+
+#define SW_DMA_NS_PER_SEC	1000000000ULL
+
+/* link DMAC runs at the rate of a 48kHz stereo 32 bit codec by default */
+#define SW_DMA_LINK_BANDWIDTH	(48000 * 2 * 4)
+
+struct sw_dma_chan {
+	uint32_t status;		/* COMP_STATE_ */
+	uint32_t direction;
+	uint32_t cyclic;
+	bool irq_disabled;		/* HDA mode */
+	struct dma_sg_elem *elems;
+	uint32_t elem_count;
+	uint32_t elem;			/* index of current element */
+	struct dma_sg_elem cur;		/* current transfer */
+	uint32_t offset;		/* bytes of current transfer done */
+	uint32_t buffer_bytes;		/* size of all elements */
+	uint32_t level;			/* bytes pending in ring */
+	uint32_t chunk;			/* bytes in flight */
+	uint64_t due;			/* ns when chunk lands, 0 if idle */
+	uint64_t timestamp;		/* ns of last completed block */
+	void (*cb)(void *data, uint32_t type, struct dma_sg_elem *next);
+	void *cb_data;
+	int cb_type;
+};
+
+struct sw_dma_pdata {
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	bool run;
+	uint32_t bandwidth;		/* bytes per second, 0 is immediate */
+	uint32_t jitter;		/* max extra us per block */
+	unsigned int seed;
+	struct sw_dma_chan chan[TB_DMA_CHANNELS];
+};
+
+static const struct dma_ops sw_dma_ops;
+
+/* emulated interrupt context, taken before any DMAC mutex */
+static pthread_mutex_t sw_dma_irq = PTHREAD_MUTEX_INITIALIZER;
+
+static struct sw_dma_pdata sw_dma_pdata[2] = {
+	{ .bandwidth = 0, },
+	{ .bandwidth = SW_DMA_LINK_BANDWIDTH, },
+};
+
+static struct dma sw_dma[] = {
+{
+	.plat_data = {
+		.id		= DMA_ID_DMAC0,
+		.dir		= DMA_DIR_HMEM_TO_LMEM | DMA_DIR_LMEM_TO_HMEM |
+				  DMA_DIR_MEM_TO_MEM,
+		.caps		= DMA_CAP_HDA | DMA_CAP_GP_LP | DMA_CAP_GP_HP,
+		.devs		= DMA_DEV_HOST,
+		.channels	= TB_DMA_CHANNELS,
+	},
+	.ops		= &sw_dma_ops,
+	.private	= &sw_dma_pdata[0],
+},
+{
+	.plat_data = {
+		.id		= DMA_ID_DMAC1,
+		.dir		= DMA_DIR_MEM_TO_DEV | DMA_DIR_DEV_TO_MEM,
+		.caps		= DMA_CAP_HDA | DMA_CAP_GP_LP | DMA_CAP_GP_HP,
+		.devs		= DMA_DEV_HDA | DMA_DEV_SSP | DMA_DEV_DMIC |
+				  DMA_DEV_SSI | DMA_DEV_SOUNDWIRE,
+		.channels	= TB_DMA_CHANNELS,
+	},
+	.ops		= &sw_dma_ops,
+	.private	= &sw_dma_pdata[1],
+},
+};
+
+static uint64_t sw_dma_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * SW_DMA_NS_PER_SEC + ts.tv_nsec;
+}
+
+/* HDA mode channels that fill the ring in local memory */
+static bool sw_dma_to_local(struct sw_dma_chan *chan)
+{
+	return chan->direction & (DMA_DIR_HMEM_TO_LMEM | DMA_DIR_DEV_TO_MEM |
+				  DMA_DIR_MEM_TO_MEM);
+}
+
+/* bytes the channel can move in its next block */
+static uint32_t sw_dma_block_bytes(struct sw_dma_chan *chan)
+{
+	uint32_t bytes = chan->cur.size - chan->offset;
+
+	/* DW mode moves whole elements */
+	if (!chan->irq_disabled)
+		return bytes;
+
+	/* HDA mode is limited by the free space or data in the ring */
+	if (sw_dma_to_local(chan))
+		return MIN(bytes, chan->buffer_bytes - chan->level);
+
+	return MIN(bytes, chan->level);
+}
+
+/* time it takes to move bytes including random jitter */
+static uint64_t sw_dma_block_ns(struct sw_dma_pdata *p, uint32_t bytes)
+{
+	uint64_t ns = 0;
+
+	if (p->bandwidth)
+		ns = bytes * SW_DMA_NS_PER_SEC / p->bandwidth;
+
+	if (p->jitter)
+		ns += (rand_r(&p->seed) % (p->jitter + 1)) * 1000ULL;
+
+	return ns;
+}
+
+/* advance to the next element of the SG list */
+static void sw_dma_next_elem(struct sw_dma_chan *chan)
+{
+	chan->offset = 0;
+
+	if (++chan->elem >= chan->elem_count) {
+		chan->elem = 0;
+
+		/* DW mode stops at the end of a non cyclic list */
+		if (!chan->cyclic && !chan->irq_disabled)
+			chan->status = COMP_STATE_PREPARE;
+	}
+
+	chan->cur = chan->elems[chan->elem];
+}
+
+/* move bytes of the current block, device side is a codec stream FIFO */
+static void sw_dma_move(struct sw_dma_chan *chan, uint32_t bytes)
+{
+	struct tb_dma_fifo *fifo;
+	uint8_t *mem;
+	uint32_t n = 0;
+
+	switch (chan->direction) {
+	case DMA_DIR_MEM_TO_DEV:
+		fifo = (struct tb_dma_fifo *)(uintptr_t)chan->cur.dest;
+		mem = (uint8_t *)(uintptr_t)(chan->cur.src + chan->offset);
+
+		/* playback past the end of the stream is dropped */
+		if (fifo->pos < fifo->size)
+			n = MIN(bytes, fifo->size - fifo->pos);
+		memcpy(fifo->data + fifo->pos, mem, n);
+		break;
+	case DMA_DIR_DEV_TO_MEM:
+		fifo = (struct tb_dma_fifo *)(uintptr_t)chan->cur.src;
+		mem = (uint8_t *)(uintptr_t)(chan->cur.dest + chan->offset);
+
+		/* capture past the end of the stream reads silence */
+		if (fifo->pos < fifo->size)
+			n = MIN(bytes, fifo->size - fifo->pos);
+		memcpy(mem, fifo->data + fifo->pos, n);
+		memset(mem + n, 0, bytes - n);
+		break;
+	default:
+		memcpy((void *)(uintptr_t)(chan->cur.dest + chan->offset),
+		       (void *)(uintptr_t)(chan->cur.src + chan->offset),
+		       bytes);
+		return;
+	}
+
+	fifo->pos += bytes;
+}
+
+/*
+ * Block has landed, copy its data and run the DW mode callback. Called in
+ * interrupt context with the DMAC lock held.
+ */
+static void sw_dma_block_irq(struct sw_dma_pdata *p, struct sw_dma_chan *chan,
+			     uint64_t now)
+{
+	struct dma_sg_elem next = {
+		.src = DMA_RELOAD_LLI,
+		.dest = DMA_RELOAD_LLI,
+		.size = DMA_RELOAD_LLI
+	};
+	void (*cb)(void *data, uint32_t type, struct dma_sg_elem *next);
+	uint32_t bytes;
+
+	bytes = chan->chunk;
+	sw_dma_move(chan, bytes);
+
+	chan->offset += bytes;
+	chan->chunk = 0;
+	chan->due = 0;
+	chan->timestamp = now;
+
+	/* data level between the DMA and firmware pointers */
+	if (sw_dma_to_local(chan))
+		chan->level = MIN(chan->level + bytes, chan->buffer_bytes);
+	else
+		chan->level -= MIN(bytes, chan->level);
+
+	if (chan->irq_disabled) {
+		if (chan->offset == chan->cur.size)
+			sw_dma_next_elem(chan);
+		return;
+	}
+
+	/* callback runs without the DMAC lock as it may call the DMA API */
+	cb = chan->cb_type & DMA_CB_TYPE_IRQ ? chan->cb : NULL;
+	if (cb) {
+		pthread_mutex_unlock(&p->mutex);
+		cb(chan->cb_data, DMA_CB_TYPE_IRQ, &next);
+		pthread_mutex_lock(&p->mutex);
+	}
+
+	/* channel may have been stopped or paused by the callback */
+	if (chan->status != COMP_STATE_ACTIVE)
+		return;
+
+	switch (next.size) {
+	case DMA_RELOAD_END:
+		chan->status = COMP_STATE_PREPARE;
+		break;
+	case DMA_RELOAD_LLI:
+	case DMA_RELOAD_IGNORE:
+		sw_dma_next_elem(chan);
+		break;
+	default:
+		/* reload with the element given by the callback */
+		chan->cur = next;
+		chan->offset = 0;
+		break;
+	}
+}
+
+/* worker side of a landed block, enters interrupt context first */
+static void sw_dma_block_done(struct sw_dma_pdata *p,
+			      struct sw_dma_chan *chan, uint64_t now)
+{
+	/* interrupt context is always locked before the DMAC */
+	pthread_mutex_unlock(&p->mutex);
+	pthread_mutex_lock(&sw_dma_irq);
+	pthread_mutex_lock(&p->mutex);
+
+	/* block was dropped by a stop while waiting */
+	if (chan->status == COMP_STATE_ACTIVE && chan->due)
+		sw_dma_block_irq(p, chan, now);
+
+	pthread_mutex_unlock(&sw_dma_irq);
+}
+
+/*
+ * One shot DW transfers of an immediate DMAC complete in the context that
+ * starts them, which already holds the interrupt lock. This is how fast
+ * host memory copies look to the firmware, e.g. the host period is there
+ * before the pipeline preload runs.
+ */
+static void sw_dma_run_now(struct sw_dma_pdata *p, struct sw_dma_chan *chan)
+{
+	uint64_t now = sw_dma_now();
+
+	while (chan->status == COMP_STATE_ACTIVE) {
+		chan->chunk = sw_dma_block_bytes(chan);
+		if (!chan->chunk)
+			break;
+
+		chan->due = now;
+		sw_dma_block_irq(p, chan, now);
+	}
+}
+
+static void *sw_dma_thread(void *data)
+{
+	struct sw_dma_pdata *p = data;
+	struct sw_dma_chan *chan;
+	struct timespec ts;
+	uint64_t now;
+	uint64_t wake;
+	uint32_t bytes;
+	int i;
+
+	pthread_mutex_lock(&p->mutex);
+
+	while (p->run) {
+		now = sw_dma_now();
+		wake = UINT64_MAX;
+
+		for (i = 0; i < TB_DMA_CHANNELS; i++) {
+			chan = &p->chan[i];
+			if (chan->status != COMP_STATE_ACTIVE)
+				continue;
+
+			/* start the next block if there is work to do */
+			if (!chan->due) {
+				bytes = sw_dma_block_bytes(chan);
+				if (!bytes)
+					continue;
+
+				chan->chunk = bytes;
+				chan->due = now + sw_dma_block_ns(p, bytes);
+			}
+
+			if (chan->due <= now) {
+				sw_dma_block_done(p, chan, now);
+
+				/* rescan as the callback may change channels */
+				wake = 0;
+				break;
+			}
+
+			wake = MIN(wake, chan->due);
+		}
+
+		if (!wake)
+			continue;
+
+		if (wake == UINT64_MAX) {
+			pthread_cond_wait(&p->cond, &p->mutex);
+		} else {
+			ts.tv_sec = wake / SW_DMA_NS_PER_SEC;
+			ts.tv_nsec = wake % SW_DMA_NS_PER_SEC;
+			pthread_cond_timedwait(&p->cond, &p->mutex, &ts);
+		}
+	}
+
+	pthread_mutex_unlock(&p->mutex);
+	return NULL;
+}
+
+static int sw_dma_channel_get(struct dma *dma, int req_chan)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	int i;
+
+	pthread_mutex_lock(&p->mutex);
+
+	/* find first free channel */
+	for (i = 0; i < TB_DMA_CHANNELS; i++) {
+		if (p->chan[i].status != COMP_STATE_INIT)
+			continue;
+
+		p->chan[i].status = COMP_STATE_READY;
+		atomic_add(&dma->num_channels_busy, 1);
+
+		pthread_mutex_unlock(&p->mutex);
+		return i;
+	}
+
+	pthread_mutex_unlock(&p->mutex);
+	trace_swdma_error("sw_dma_channel_get() error: dma %d no free "
+			  "channels", dma->plat_data.id);
+	return -ENODEV;
+}
+
+static void sw_dma_channel_put(struct dma *dma, int channel)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	struct sw_dma_chan *chan = &p->chan[channel];
+
+	pthread_mutex_lock(&p->mutex);
+
+	free(chan->elems);
+	memset(chan, 0, sizeof(*chan));
+	chan->status = COMP_STATE_INIT;
+	atomic_sub(&dma->num_channels_busy, 1);
+
+	pthread_mutex_unlock(&p->mutex);
+}
+
+static int sw_dma_start(struct dma *dma, int channel)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	struct sw_dma_chan *chan = &p->chan[channel];
+	int ret = 0;
+
+	pthread_mutex_lock(&p->mutex);
+
+	if (chan->status != COMP_STATE_PREPARE || !chan->elem_count) {
+		trace_swdma_error("sw_dma_start() error: dma %d channel %d "
+				  "not ready", dma->plat_data.id, channel);
+		ret = -EBUSY;
+		goto out;
+	}
+
+	chan->elem = 0;
+	chan->cur = chan->elems[0];
+	chan->offset = 0;
+	chan->due = 0;
+	chan->status = COMP_STATE_ACTIVE;
+
+	/* DW mode firmware pointer starts at the DMA pointer, a full ring */
+	if (chan->irq_disabled || sw_dma_to_local(chan))
+		chan->level = 0;
+	else
+		chan->level = chan->buffer_bytes;
+
+	if (!chan->irq_disabled && !chan->cyclic && !p->bandwidth &&
+	    !p->jitter)
+		sw_dma_run_now(p, chan);
+	else
+		pthread_cond_signal(&p->cond);
+
+out:
+	pthread_mutex_unlock(&p->mutex);
+	return ret;
+}
+
+static int sw_dma_stop(struct dma *dma, int channel)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	struct sw_dma_chan *chan = &p->chan[channel];
+
+	pthread_mutex_lock(&p->mutex);
+
+	/* block in flight is dropped */
+	if (chan->status == COMP_STATE_ACTIVE ||
+	    chan->status == COMP_STATE_PAUSED)
+		chan->status = COMP_STATE_PREPARE;
+	chan->chunk = 0;
+	chan->due = 0;
+
+	pthread_mutex_unlock(&p->mutex);
+	return 0;
+}
+
+static int sw_dma_pause(struct dma *dma, int channel)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	struct sw_dma_chan *chan = &p->chan[channel];
+
+	pthread_mutex_lock(&p->mutex);
+
+	/* block in flight is restarted on release */
+	if (chan->status == COMP_STATE_ACTIVE) {
+		chan->status = COMP_STATE_PAUSED;
+		chan->chunk = 0;
+		chan->due = 0;
+	}
+
+	pthread_mutex_unlock(&p->mutex);
+	return 0;
+}
+
+static int sw_dma_release(struct dma *dma, int channel)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	struct sw_dma_chan *chan = &p->chan[channel];
+
+	pthread_mutex_lock(&p->mutex);
+
+	if (chan->status == COMP_STATE_PAUSED) {
+		chan->status = COMP_STATE_ACTIVE;
+		pthread_cond_signal(&p->cond);
+	}
+
+	pthread_mutex_unlock(&p->mutex);
+	return 0;
+}
+
+static int sw_dma_copy(struct dma *dma, int channel, int bytes,
+		       uint32_t flags)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	struct sw_dma_chan *chan = &p->chan[channel];
+	struct dma_sg_elem next = {
+		.src = DMA_RELOAD_LLI,
+		.dest = DMA_RELOAD_LLI,
+		.size = bytes
+	};
+
+	pthread_mutex_lock(&p->mutex);
+
+	/* firmware consumed or produced bytes in the ring */
+	if (!(flags & DMA_COPY_PRELOAD)) {
+		if (sw_dma_to_local(chan))
+			chan->level -= MIN((uint32_t)bytes, chan->level);
+		else
+			chan->level = MIN(chan->level + bytes,
+					  chan->buffer_bytes);
+		pthread_cond_signal(&p->cond);
+	}
+
+	pthread_mutex_unlock(&p->mutex);
+
+	if (chan->cb && chan->cb_type & DMA_CB_TYPE_COPY) {
+		chan->cb(chan->cb_data, DMA_CB_TYPE_COPY, &next);
+		if (next.size == DMA_RELOAD_END)
+			sw_dma_stop(dma, channel);
+	}
+
+	return 0;
+}
+
+static int sw_dma_status(struct dma *dma, int channel,
+			 struct dma_chan_status *status, uint8_t direction)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	struct sw_dma_chan *chan = &p->chan[channel];
+
+	pthread_mutex_lock(&p->mutex);
+
+	status->state = chan->status;
+	status->flags = 0;
+	status->r_pos = chan->cur.src + chan->offset;
+	status->w_pos = chan->cur.dest + chan->offset;
+	status->timestamp = chan->timestamp / 1000;
+
+	pthread_mutex_unlock(&p->mutex);
+	return 0;
+}
+
+static int sw_dma_set_config(struct dma *dma, int channel,
+			     struct dma_sg_config *config)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	struct sw_dma_chan *chan = &p->chan[channel];
+	struct dma_sg_elem *elems;
+	uint32_t count = config->elem_array.count;
+	uint32_t buffer_bytes = 0;
+	int i;
+
+	if (!count) {
+		trace_swdma_error("sw_dma_set_config() error: dma %d channel "
+				  "%d no elems", dma->plat_data.id, channel);
+		return -EINVAL;
+	}
+
+	elems = malloc(sizeof(*elems) * count);
+	if (!elems)
+		return -ENOMEM;
+
+	/* SG addresses must come from tb_dma_map() or 32 bit memory */
+	for (i = 0; i < count; i++) {
+		elems[i] = config->elem_array.elems[i];
+		if (!elems[i].src || !elems[i].dest || !elems[i].size) {
+			trace_swdma_error("sw_dma_set_config() error: dma %d "
+					  "channel %d invalid elem %d",
+					  dma->plat_data.id, channel, i);
+			free(elems);
+			return -EINVAL;
+		}
+		buffer_bytes += elems[i].size;
+	}
+
+	pthread_mutex_lock(&p->mutex);
+
+	if (chan->status == COMP_STATE_ACTIVE) {
+		pthread_mutex_unlock(&p->mutex);
+		free(elems);
+		return -EBUSY;
+	}
+
+	free(chan->elems);
+	chan->elems = elems;
+	chan->elem_count = count;
+	chan->buffer_bytes = buffer_bytes;
+	chan->direction = config->direction;
+	chan->cyclic = config->cyclic;
+	chan->irq_disabled = config->irq_disabled;
+	chan->status = COMP_STATE_PREPARE;
+
+	pthread_mutex_unlock(&p->mutex);
+	return 0;
+}
+
+static int sw_dma_set_cb(struct dma *dma, int channel, int type,
+			 void (*cb)(void *data, uint32_t type,
+				    struct dma_sg_elem *next),
+			 void *data)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	struct sw_dma_chan *chan = &p->chan[channel];
+
+	pthread_mutex_lock(&p->mutex);
+	chan->cb = cb;
+	chan->cb_data = data;
+	chan->cb_type = type;
+	pthread_mutex_unlock(&p->mutex);
+
+	return 0;
+}
+
+static int sw_dma_pm_context_restore(struct dma *dma)
+{
+	return 0;
+}
+
+static int sw_dma_pm_context_store(struct dma *dma)
+{
+	return 0;
+}
+
+static int sw_dma_probe(struct dma *dma)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	pthread_condattr_t attr;
+	int ret;
+
+	pthread_mutex_init(&p->mutex, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&p->cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	memset(p->chan, 0, sizeof(p->chan));
+	atomic_init(&dma->num_channels_busy, 0);
+	p->seed = dma->plat_data.id;
+	p->run = true;
+
+	ret = pthread_create(&p->thread, NULL, sw_dma_thread, p);
+	if (ret) {
+		trace_swdma_error("sw_dma_probe() error: dma %d thread %d",
+				  dma->plat_data.id, ret);
+		p->run = false;
+		return -ret;
+	}
+
+	return 0;
+}
+
+static int sw_dma_remove(struct dma *dma)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	int i;
+
+	pthread_mutex_lock(&p->mutex);
+	p->run = false;
+	pthread_cond_signal(&p->cond);
+	pthread_mutex_unlock(&p->mutex);
+
+	pthread_join(p->thread, NULL);
+
+	for (i = 0; i < TB_DMA_CHANNELS; i++) {
+		free(p->chan[i].elems);
+		p->chan[i].elems = NULL;
+	}
+
+	pthread_cond_destroy(&p->cond);
+	pthread_mutex_destroy(&p->mutex);
+	return 0;
+}
+
+static int sw_dma_get_data_size(struct dma *dma, int channel,
+				uint32_t *avail, uint32_t *free)
+{
+	struct sw_dma_pdata *p = dma_get_drvdata(dma);
+	struct sw_dma_chan *chan = &p->chan[channel];
+
+	pthread_mutex_lock(&p->mutex);
+	*avail = chan->level;
+	*free = chan->buffer_bytes - chan->level;
+	pthread_mutex_unlock(&p->mutex);
+
+	return 0;
+}
+
+static const struct dma_ops sw_dma_ops = {
+	.channel_get		= sw_dma_channel_get,
+	.channel_put		= sw_dma_channel_put,
+	.start			= sw_dma_start,
+	.stop			= sw_dma_stop,
+	.copy			= sw_dma_copy,
+	.pause			= sw_dma_pause,
+	.release		= sw_dma_release,
+	.status			= sw_dma_status,
+	.set_config		= sw_dma_set_config,
+	.set_cb			= sw_dma_set_cb,
+	.pm_context_restore	= sw_dma_pm_context_restore,
+	.pm_context_store	= sw_dma_pm_context_store,
+	.probe			= sw_dma_probe,
+	.remove			= sw_dma_remove,
+	.get_data_size		= sw_dma_get_data_size,
+};
+
+void tb_dma_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sw_dma); i++)
+		spinlock_init(&sw_dma[i].lock);
+
+	dma_install(sw_dma, ARRAY_SIZE(sw_dma));
+}
+
+int tb_dma_set_timing(uint32_t dma_id, uint32_t bandwidth, uint32_t jitter)
+{
+	struct sw_dma_pdata *p;
+
+	if (dma_id >= ARRAY_SIZE(sw_dma))
+		return -EINVAL;
+
+	p = dma_get_drvdata((&sw_dma[dma_id]));
+
+	/* the worker is not running before the first dma_get() */
+	if (sw_dma[dma_id].sref)
+		pthread_mutex_lock(&p->mutex);
+
+	p->bandwidth = bandwidth;
+	p->jitter = jitter;
+
+	if (sw_dma[dma_id].sref) {
+		pthread_cond_signal(&p->cond);
+		pthread_mutex_unlock(&p->mutex);
+	}
+
+	return 0;
+}
+
+void tb_dma_irq_lock(void)
+{
+	pthread_mutex_lock(&sw_dma_irq);
+}
+
+void tb_dma_irq_unlock(void)
+{
+	pthread_mutex_unlock(&sw_dma_irq);
+}
+
+void *tb_dma_map(int fd, size_t bytes)
+{
+	int flags = MAP_SHARED;
+	void *ptr;
+
+	/* anonymous memory, read only files are mapped copy on write */
+	if (fd < 0)
+		flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	else if ((fcntl(fd, F_GETFL) & O_ACCMODE) == O_RDONLY)
+		flags = MAP_PRIVATE;
+
+#ifdef MAP_32BIT
+	/* SG element addresses are 32 bit */
+	flags |= MAP_32BIT;
+#endif
+
+	ptr = mmap(NULL, bytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+	if (ptr == MAP_FAILED)
+		return NULL;
+
+	if ((uintptr_t)ptr + bytes > UINT32_MAX) {
+		munmap(ptr, bytes);
+		return NULL;
+	}
+
+	return ptr;
+}
+
+void tb_dma_unmap(void *ptr, size_t bytes)
+{
+	munmap(ptr, bytes);
+}
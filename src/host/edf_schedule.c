@@ -60,14 +60,22 @@ static void schedule_edf_task_complete(struct task *task)
 	task->state = SOF_TASK_STATE_COMPLETED;
 }
 
-/* schedule task */
+/* schedule task, idle tasks wait for the next scheduler run */
 static void schedule_edf_task(struct task *task, uint64_t start,
 			      uint64_t deadline, uint32_t flags)
 {
 	(void)deadline;
+
+	/* a deferred task runs now instead */
+	if (task->state == SOF_TASK_STATE_QUEUED)
+		list_item_del(&task->list);
+
 	list_item_prepend(&task->list, &sch->list);
 	task->state = SOF_TASK_STATE_QUEUED;
 
+	if (flags & SOF_SCHEDULE_FLAG_IDLE)
+		return;
+
 	if (task->func)
 		task->func(task->data);
 
@@ -101,11 +109,25 @@ static void edf_scheduler_free(void)
 	free(sch);
 }
 
-/* The following definitions are to satisfy libsof linker errors */
+/* run the tasks deferred until the DSP is idle */
 static void schedule_edf(void)
 {
+	struct list_item *tlist;
+	struct list_item *tmp;
+	struct task *task;
+
+	list_for_item_safe(tlist, tmp, &sch->list) {
+		task = container_of(tlist, struct task, list);
+
+		if (task->func)
+			task->func(task->data);
+
+		schedule_edf_task_complete(task);
+	}
 }
 
+/* The following definitions are to satisfy libsof linker errors */
+
 static int schedule_edf_task_cancel(struct task *task)
 {
 	if (task->state == SOF_TASK_STATE_QUEUED) {
@@ -34,8 +34,12 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sof/sof.h>
 #include <sof/lock.h>
 #include <sof/list.h>
@@ -45,6 +49,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/audio/pipeline.h>
+#include <sof/math/numbers.h>
 #include <uapi/ipc/stream.h>
 #include "host/common_test.h"
 #include "host/file.h"
@@ -64,8 +69,7 @@ static inline void buffer_check_wrap_16(int16_t **ptr, int16_t *end,
 }
 
 /*
- * Read 32-bit samples from file
- * currently only supports txt files
+ * Read 32-bit samples from text file
  */
 static int read_samples_32(struct comp_dev *dev, struct comp_buffer *sink,
 			   int n, int fmt, int nch)
@@ -87,47 +91,19 @@ static int read_samples_32(struct comp_dev *dev, struct comp_buffer *sink,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				/* read sample from file */
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fscanf(cd->fs.rfh, "%d",
-							     dest);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fscanf(cd->fs.rfh, "%d",
-							     &sample);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* raw input file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fread(dest,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fread(&sample,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
+				/* read sample from text file */
+				if (fmt == SOF_IPC_FRAME_S32_LE)
+					ret = fscanf(cd->fs.rfh, "%d", dest);
+
+				/* mask bits if 24-bit samples */
+				if (fmt == SOF_IPC_FRAME_S24_4LE) {
+					ret = fscanf(cd->fs.rfh, "%d", &sample);
+					*dest = sample & 0x00ffffff;
+				}
+				/* quit if eof is reached */
+				if (ret == EOF) {
+					cd->fs.reached_eof = 1;
+					goto quit;
 				}
 				dest++;
 				n_samples++;
@@ -142,8 +118,7 @@ quit:
 }
 
 /*
- * Read 16-bit samples from file
- * currently only supports txt files
+ * Read 16-bit samples from text file
  */
 static int read_samples_16(struct comp_dev *dev, struct comp_buffer *sink,
 			   int n, int nch)
@@ -165,27 +140,11 @@ static int read_samples_16(struct comp_dev *dev, struct comp_buffer *sink,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					ret = fscanf(cd->fs.rfh, "%hd", dest);
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* rw pcm input file */
-				default:
-					ret = fread(dest, sizeof(int16_t), 1,
-						    cd->fs.rfh);
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
+				ret = fscanf(cd->fs.rfh, "%hd", dest);
+				if (ret == EOF) {
+					cd->fs.reached_eof = 1;
+					goto quit;
 				}
-
 				dest++;
 				n_samples++;
 			}
@@ -200,8 +159,7 @@ quit:
 }
 
 /*
- * Write 16-bit samples from file
- * currently only supports txt files
+ * Write 16-bit samples to text file
  */
 static int write_samples_16(struct comp_dev *dev, struct comp_buffer *source,
 			    int n, int nch)
@@ -223,25 +181,9 @@ static int write_samples_16(struct comp_dev *dev, struct comp_buffer *source,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					ret = fprintf(cd->fs.wfh,
-						      "%d\n", *src);
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					ret = fwrite(src,
-						     sizeof(int16_t),
-						     1, cd->fs.wfh);
-					if (ret != 1)
-						goto quit;
-					break;
-				}
-
+				ret = fprintf(cd->fs.wfh, "%d\n", *src);
+				if (ret < 0)
+					goto quit;
 				src++;
 				n_samples++;
 			}
@@ -255,8 +197,7 @@ quit:
 }
 
 /*
- * Write 32-bit samples from file
- * currently only supports txt files
+ * Write 32-bit samples to text file
  */
 static int write_samples_32(struct comp_dev *dev, struct comp_buffer *source,
 			    int n, int fmt, int nch)
@@ -279,39 +220,15 @@ static int write_samples_32(struct comp_dev *dev, struct comp_buffer *source,
 
 			/* copy sample per channel */
 			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n", *src);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n",
-							      sample >> 8);
-					}
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fwrite(src,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						sample >>= 8;
-						ret = fwrite(&sample,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					}
-					if (ret != 1)
-						goto quit;
-					break;
+				if (fmt == SOF_IPC_FRAME_S32_LE)
+					ret = fprintf(cd->fs.wfh, "%d\n", *src);
+				if (fmt == SOF_IPC_FRAME_S24_4LE) {
+					sample = *src << 8;
+					ret = fprintf(cd->fs.wfh, "%d\n",
+						      sample >> 8);
 				}
+				if (ret < 0)
+					goto quit;
 
 				/* increment read pointer */
 				src++;
@@ -328,6 +245,127 @@ quit:
 	return n_samples;
 }
 
+/* mask sign extension bits of 24-bit samples read from file */
+static void samples_mask_24(int32_t *ptr, size_t samples)
+{
+	size_t i;
+
+	for (i = 0; i < samples; i++)
+		ptr[i] &= 0x00ffffff;
+}
+
+/* sign extend 24-bit samples written to file */
+static void samples_sign_extend_24(int32_t *ptr, size_t samples)
+{
+	size_t i;
+
+	for (i = 0; i < samples; i++)
+		ptr[i] = (ptr[i] << 8) >> 8;
+}
+
+/*
+ * Read samples from raw or WAV file in blocks
+ * copies straight from the mapped file or streams with fread()
+ */
+static int read_samples_block(struct comp_dev *dev, struct comp_buffer *sink,
+			      int n, int fmt, int sample_bytes)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	uint8_t *dest = sink->w_ptr;
+	size_t bytes = n * sample_bytes;
+	size_t avail = cd->fs.rend - cd->fs.rpos;
+	size_t copied = 0;
+	size_t seg, ret;
+
+	/* last block of sample data */
+	if (avail < bytes) {
+		bytes = avail - avail % sample_bytes;
+		cd->fs.reached_eof = 1;
+	}
+
+	while (copied < bytes) {
+		/* check for buffer wrap and copy to the end of the buffer */
+		seg = MIN(bytes - copied, (uint8_t *)sink->end_addr - dest);
+
+		if (cd->fs.map) {
+			memcpy(dest, cd->fs.map + cd->fs.rpos, seg);
+		} else {
+			ret = fread(dest, 1, seg, cd->fs.rfh);
+			if (ret < seg) {
+				cd->fs.reached_eof = 1;
+				seg = ret - ret % sample_bytes;
+				bytes = copied + seg;
+			}
+		}
+
+		if (fmt == SOF_IPC_FRAME_S24_4LE)
+			samples_mask_24((int32_t *)dest, seg / sizeof(int32_t));
+
+		cd->fs.rpos += seg;
+		copied += seg;
+		dest += seg;
+		if (dest >= (uint8_t *)sink->end_addr)
+			dest = sink->addr;
+	}
+
+	return copied / sample_bytes;
+}
+
+/* write block buffer to output file */
+static int file_flush(struct file_comp_data *cd)
+{
+	if (!cd->fs.wfill)
+		return 0;
+
+	if (fwrite(cd->fs.wbuf, 1, cd->fs.wfill, cd->fs.wfh) != cd->fs.wfill) {
+		fprintf(stderr, "error: writing file %s\n", cd->fs.fn);
+		return -EIO;
+	}
+
+	cd->fs.wbytes += cd->fs.wfill;
+	cd->fs.wfill = 0;
+	return 0;
+}
+
+/*
+ * Write samples to raw or WAV file in blocks
+ * samples are gathered in a large buffer that is flushed when full
+ */
+static int write_samples_block(struct comp_dev *dev,
+			       struct comp_buffer *source,
+			       int n, int fmt, int sample_bytes)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	uint8_t *src = source->r_ptr;
+	uint8_t *wptr;
+	size_t bytes = n * sample_bytes;
+	size_t copied = 0;
+	size_t seg;
+
+	while (copied < bytes) {
+		/* check for source and block buffer wrap */
+		seg = MIN(bytes - copied, (uint8_t *)source->end_addr - src);
+		seg = MIN(seg, FILE_WBUF_SIZE - cd->fs.wfill);
+
+		wptr = cd->fs.wbuf + cd->fs.wfill;
+		memcpy(wptr, src, seg);
+		if (fmt == SOF_IPC_FRAME_S24_4LE)
+			samples_sign_extend_24((int32_t *)wptr,
+					       seg / sizeof(int32_t));
+
+		cd->fs.wfill += seg;
+		copied += seg;
+		src += seg;
+		if (src >= (uint8_t *)source->end_addr)
+			src = source->addr;
+
+		if (cd->fs.wfill == FILE_WBUF_SIZE && file_flush(cd) < 0)
+			break;
+	}
+
+	return copied / sample_bytes;
+}
+
 /* function for processing 32-bit samples */
 static int file_s32_default(struct comp_dev *dev, struct comp_buffer *sink,
 			    struct comp_buffer *source, uint32_t frames)
@@ -410,16 +448,354 @@ static int file_s24(struct comp_dev *dev, struct comp_buffer *sink,
 	return n_samples;
 }
 
+/* function for processing raw and WAV files in blocks */
+static int file_block(struct comp_dev *dev, struct comp_buffer *sink,
+		      struct comp_buffer *source, uint32_t frames)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	int fmt = dev->params.frame_fmt;
+	int bytes = dev->params.sample_container_bytes;
+	int n = frames * dev->params.channels;
+	int n_samples = 0;
+
+	switch (cd->fs.mode) {
+	case FILE_READ:
+		n_samples = read_samples_block(dev, sink, n, fmt, bytes);
+		break;
+	case FILE_WRITE:
+		n_samples = write_samples_block(dev, source, n, fmt, bytes);
+		break;
+	default:
+		/* TODO: duplex mode */
+		break;
+	}
+
+	cd->fs.n += n_samples;
+	return n_samples;
+}
+
 static enum file_format get_file_format(char *filename)
 {
 	char *ext = strrchr(filename, '.');
 
+	if (!ext)
+		return FILE_RAW;
+
 	if (!strcmp(ext, ".txt"))
 		return FILE_TEXT;
 
+	if (!strcmp(ext, ".wav"))
+		return FILE_WAV;
+
 	return FILE_RAW;
 }
 
+/* WAV file headers, little endian and naturally aligned */
+#define WAV_FORMAT_PCM		0x0001
+#define WAV_FORMAT_FLOAT	0x0003
+#define WAV_FORMAT_EXTENSIBLE	0xfffe
+
+struct wav_riff_hdr {
+	char riff[4];
+	uint32_t size;
+	char wave[4];
+};
+
+struct wav_chunk_hdr {
+	char id[4];
+	uint32_t size;
+};
+
+struct wav_fmt {
+	uint16_t format;
+	uint16_t channels;
+	uint32_t rate;
+	uint32_t byte_rate;
+	uint16_t block_align;
+	uint16_t bits;
+	/* WAVE_FORMAT_EXTENSIBLE only */
+	uint16_t ext_size;
+	uint16_t valid_bits;
+	uint32_t channel_mask;
+	uint8_t subformat[16];
+};
+
+/* KSDATAFORMAT_SUBTYPE GUID tail, first two bytes are the format */
+static const uint8_t wav_guid[14] = {
+	0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00,
+	0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71,
+};
+
+const char *file_wav_format_name(uint32_t frame_fmt)
+{
+	switch (frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return "S16_LE";
+	case SOF_IPC_FRAME_S24_4LE:
+		return "S24_LE";
+	case SOF_IPC_FRAME_S32_LE:
+		return "S32_LE";
+	case SOF_IPC_FRAME_FLOAT:
+		return "FLOAT_LE";
+	default:
+		return NULL;
+	}
+}
+
+/* get SOF frame format from WAV fmt chunk */
+static int file_wav_frame_fmt(struct wav_fmt *fmt, uint32_t fmt_size)
+{
+	uint16_t format = fmt->format;
+	uint16_t valid_bits = fmt->bits;
+
+	if (format == WAV_FORMAT_EXTENSIBLE) {
+		if (fmt_size < sizeof(*fmt))
+			return -EINVAL;
+		format = fmt->subformat[0] | (fmt->subformat[1] << 8);
+		if (fmt->valid_bits)
+			valid_bits = fmt->valid_bits;
+	}
+
+	if (!fmt->channels || !fmt->rate ||
+	    fmt->block_align != fmt->channels * fmt->bits / 8)
+		return -EINVAL;
+
+	if (format == WAV_FORMAT_FLOAT && fmt->bits == 32)
+		return SOF_IPC_FRAME_FLOAT;
+
+	if (format != WAV_FORMAT_PCM)
+		return -EINVAL;
+
+	if (fmt->bits == 16 && valid_bits == 16)
+		return SOF_IPC_FRAME_S16_LE;
+	if (fmt->bits == 32 && valid_bits == 24)
+		return SOF_IPC_FRAME_S24_4LE;
+	if (fmt->bits == 32 && valid_bits == 32)
+		return SOF_IPC_FRAME_S32_LE;
+
+	return -EINVAL;
+}
+
+/*
+ * Parse WAV file header
+ * leaves the file positioned at the start of the sample data
+ */
+int file_wav_read_header(FILE *fh, struct file_wav_info *wav)
+{
+	struct wav_riff_hdr riff;
+	struct wav_chunk_hdr chunk;
+	struct wav_fmt fmt;
+	uint32_t fmt_size = 0;
+	uint32_t size;
+	int ret;
+
+	if (fread(&riff, sizeof(riff), 1, fh) != 1 ||
+	    memcmp(riff.riff, "RIFF", 4) || memcmp(riff.wave, "WAVE", 4)) {
+		fprintf(stderr, "error: not a WAV file\n");
+		return -EINVAL;
+	}
+
+	while (fread(&chunk, sizeof(chunk), 1, fh) == 1) {
+		/* chunks are padded to even size */
+		size = chunk.size + (chunk.size & 1);
+
+		if (!memcmp(chunk.id, "fmt ", 4)) {
+			if (chunk.size < offsetof(struct wav_fmt, ext_size))
+				break;
+			memset(&fmt, 0, sizeof(fmt));
+			fmt_size = MIN(chunk.size, sizeof(fmt));
+			if (fread(&fmt, fmt_size, 1, fh) != 1)
+				break;
+			size -= fmt_size;
+		} else if (!memcmp(chunk.id, "data", 4)) {
+			if (!fmt_size)
+				break;
+
+			ret = file_wav_frame_fmt(&fmt, fmt_size);
+			if (ret < 0) {
+				fprintf(stderr, "error: unsupported WAV format "
+					"%u with %u bits\n", fmt.format,
+					fmt.bits);
+				return ret;
+			}
+
+			wav->frame_fmt = ret;
+			wav->rate = fmt.rate;
+			wav->channels = fmt.channels;
+			wav->data_offset = ftell(fh);
+			wav->data_bytes = chunk.size;
+			return 0;
+		}
+
+		if (fseek(fh, size, SEEK_CUR) < 0)
+			break;
+	}
+
+	fprintf(stderr, "error: no WAV fmt and data chunks\n");
+	return -EINVAL;
+}
+
+/* fmt chunk size, extensible format describes the 24 bits valid in 32 */
+static size_t file_wav_fmt_size(uint32_t frame_fmt)
+{
+	if (frame_fmt == SOF_IPC_FRAME_S24_4LE)
+		return sizeof(struct wav_fmt);
+
+	return offsetof(struct wav_fmt, ext_size);
+}
+
+static size_t file_wav_header_size(uint32_t frame_fmt)
+{
+	return sizeof(struct wav_riff_hdr) + 2 * sizeof(struct wav_chunk_hdr) +
+		file_wav_fmt_size(frame_fmt);
+}
+
+/* write WAV header for the sample data written so far */
+static int file_wav_write_header(struct file_comp_data *cd)
+{
+	struct file_wav_info *wav = &cd->fs.wav;
+	struct wav_riff_hdr riff;
+	struct wav_chunk_hdr fmt_hdr;
+	struct wav_chunk_hdr data_hdr;
+	struct wav_fmt fmt;
+	size_t fmt_size = file_wav_fmt_size(wav->frame_fmt);
+	uint16_t bits = wav->frame_fmt == SOF_IPC_FRAME_S16_LE ? 16 : 32;
+
+	memcpy(riff.riff, "RIFF", 4);
+	riff.size = file_wav_header_size(wav->frame_fmt) -
+		sizeof(struct wav_chunk_hdr) + cd->fs.wbytes;
+	memcpy(riff.wave, "WAVE", 4);
+
+	memcpy(fmt_hdr.id, "fmt ", 4);
+	fmt_hdr.size = fmt_size;
+
+	memset(&fmt, 0, sizeof(fmt));
+	fmt.format = wav->frame_fmt == SOF_IPC_FRAME_FLOAT ?
+		WAV_FORMAT_FLOAT : WAV_FORMAT_PCM;
+	fmt.channels = wav->channels;
+	fmt.rate = wav->rate;
+	fmt.block_align = wav->channels * bits / 8;
+	fmt.byte_rate = wav->rate * fmt.block_align;
+	fmt.bits = bits;
+
+	if (fmt_size == sizeof(fmt)) {
+		fmt.ext_size = sizeof(fmt) - offsetof(struct wav_fmt,
+						      valid_bits);
+		fmt.valid_bits = 24;
+		fmt.subformat[0] = fmt.format & 0xff;
+		fmt.subformat[1] = fmt.format >> 8;
+		memcpy(&fmt.subformat[2], wav_guid, sizeof(wav_guid));
+		fmt.format = WAV_FORMAT_EXTENSIBLE;
+	}
+
+	memcpy(data_hdr.id, "data", 4);
+	data_hdr.size = cd->fs.wbytes;
+
+	if (fseek(cd->fs.wfh, 0, SEEK_SET) < 0 ||
+	    fwrite(&riff, sizeof(riff), 1, cd->fs.wfh) != 1 ||
+	    fwrite(&fmt_hdr, sizeof(fmt_hdr), 1, cd->fs.wfh) != 1 ||
+	    fwrite(&fmt, fmt_size, 1, cd->fs.wfh) != 1 ||
+	    fwrite(&data_hdr, sizeof(data_hdr), 1, cd->fs.wfh) != 1) {
+		fprintf(stderr, "error: writing WAV header %s\n", cd->fs.fn);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* map raw or WAV input, falls back to streaming when it can't be mapped */
+static void file_map_input(struct file_comp_data *cd)
+{
+	struct stat st;
+	void *map;
+
+	if (fstat(fileno(cd->fs.rfh), &st) < 0 || !S_ISREG(st.st_mode) ||
+	    !st.st_size)
+		return;
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+		   fileno(cd->fs.rfh), 0);
+	if (map == MAP_FAILED)
+		return;
+
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+	cd->fs.map = map;
+	cd->fs.map_size = st.st_size;
+	cd->fs.rend = MIN(cd->fs.rend, cd->fs.map_size);
+}
+
+/* open file handle(s) depending on mode */
+static int file_open(struct file_comp_data *cd)
+{
+	size_t hdr_size;
+
+	switch (cd->fs.mode) {
+	case FILE_READ:
+		cd->fs.rfh = fopen(cd->fs.fn, "r");
+		if (!cd->fs.rfh)
+			return -ENOENT;
+
+		cd->fs.rpos = 0;
+		cd->fs.rend = SIZE_MAX;
+		if (cd->fs.f_format == FILE_WAV) {
+			if (file_wav_read_header(cd->fs.rfh, &cd->fs.wav) < 0)
+				return -EINVAL;
+			cd->fs.rpos = cd->fs.wav.data_offset;
+			cd->fs.rend = cd->fs.rpos + cd->fs.wav.data_bytes;
+		}
+
+		if (cd->fs.f_format != FILE_TEXT)
+			file_map_input(cd);
+		break;
+	case FILE_WRITE:
+		cd->fs.wfh = fopen(cd->fs.fn, "w");
+		if (!cd->fs.wfh)
+			return -ENOENT;
+
+		if (cd->fs.f_format == FILE_TEXT) {
+			setvbuf(cd->fs.wfh, NULL, _IOFBF, FILE_WBUF_SIZE);
+			break;
+		}
+
+		cd->fs.wbuf = malloc(FILE_WBUF_SIZE);
+		if (!cd->fs.wbuf)
+			return -ENOMEM;
+
+		/* header is written with the final sizes on free */
+		if (cd->fs.f_format == FILE_WAV) {
+			hdr_size = file_wav_header_size(cd->fs.wav.frame_fmt);
+			if (fseek(cd->fs.wfh, hdr_size, SEEK_SET) < 0)
+				return -EIO;
+		}
+		break;
+	default:
+		/* TODO: duplex mode */
+		break;
+	}
+
+	return 0;
+}
+
+/* flush output and close file handle(s) */
+static void file_close(struct file_comp_data *cd)
+{
+	if (cd->fs.wfh && cd->fs.wbuf) {
+		file_flush(cd);
+		if (cd->fs.f_format == FILE_WAV)
+			file_wav_write_header(cd);
+	}
+
+	if (cd->fs.map)
+		munmap(cd->fs.map, cd->fs.map_size);
+	if (cd->fs.rfh)
+		fclose(cd->fs.rfh);
+	if (cd->fs.wfh)
+		fclose(cd->fs.wfh);
+
+	free(cd->fs.wbuf);
+}
+
 static struct comp_dev *file_new(struct sof_ipc_comp *comp)
 {
 	struct comp_dev *dev;
@@ -469,29 +845,17 @@ static struct comp_dev *file_new(struct sof_ipc_comp *comp)
 	/* set file comp mode */
 	cd->fs.mode = ipc_file->mode;
 
+	/* output format is known from topology, input from WAV header */
+	cd->fs.wav.frame_fmt = ipc_file->config.frame_fmt;
+
 	/* open file handle(s) depending on mode */
-	switch (cd->fs.mode) {
-	case FILE_READ:
-		cd->fs.rfh = fopen(cd->fs.fn, "r");
-		if (!cd->fs.rfh) {
-			fprintf(stderr, "error: opening file %s\n", cd->fs.fn);
-			free(cd);
-			free(dev);
-			return NULL;
-		}
-		break;
-	case FILE_WRITE:
-		cd->fs.wfh = fopen(cd->fs.fn, "w");
-		if (!cd->fs.wfh) {
-			fprintf(stderr, "error: opening file %s\n", cd->fs.fn);
-			free(cd);
-			free(dev);
-			return NULL;
-		}
-		break;
-	default:
-		/* TODO: duplex mode */
-		break;
+	if (file_open(cd) < 0) {
+		fprintf(stderr, "error: opening file %s\n", cd->fs.fn);
+		file_close(cd);
+		free(cd->fs.fn);
+		free(cd);
+		free(dev);
+		return NULL;
 	}
 
 	cd->fs.reached_eof = 0;
@@ -506,10 +870,7 @@ static void file_free(struct comp_dev *dev)
 {
 	struct file_comp_data *cd = comp_get_drvdata(dev);
 
-	if (cd->fs.mode == FILE_READ)
-		fclose(cd->fs.rfh);
-	else
-		fclose(cd->fs.wfh);
+	file_close(cd);
 
 	free(cd->fs.fn);
 	free(cd);
@@ -531,6 +892,20 @@ static int file_params(struct comp_dev *dev)
 			dev->params.sample_container_bytes = 2;
 		else
 			dev->params.sample_container_bytes = 4;
+
+		/* WAV output header parameters */
+		cd->fs.wav.frame_fmt = config->frame_fmt;
+		cd->fs.wav.rate = dev->params.rate;
+		cd->fs.wav.channels = dev->params.channels;
+	}
+
+	/* WAV input must match the stream */
+	if (cd->fs.mode == FILE_READ && cd->fs.f_format == FILE_WAV &&
+	    (cd->fs.wav.channels != dev->params.channels ||
+	     cd->fs.wav.frame_fmt != dev->params.frame_fmt)) {
+		fprintf(stderr, "error: WAV file %s format mismatch\n",
+			cd->fs.fn);
+		return -EINVAL;
 	}
 
 	/* Need to compute this in non-host endpoint */
@@ -540,10 +915,11 @@ static int file_params(struct comp_dev *dev)
 	/* calculate period size based on config */
 	cd->period_bytes = dev->frames * dev->frame_bytes;
 
-	/* File to sink supports only S32_LE/S16_LE/S24_4LE PCM formats */
+	/* File to sink supports S32_LE/S16_LE/S24_4LE PCM and FLOAT */
 	if (config->frame_fmt != SOF_IPC_FRAME_S32_LE &&
 	    config->frame_fmt != SOF_IPC_FRAME_S24_4LE &&
-	    config->frame_fmt != SOF_IPC_FRAME_S16_LE)
+	    config->frame_fmt != SOF_IPC_FRAME_S16_LE &&
+	    config->frame_fmt != SOF_IPC_FRAME_FLOAT)
 		return -EINVAL;
 
 	return 0;
@@ -600,9 +976,11 @@ static int file_copy(struct comp_dev *dev)
 
 			/* update sink buffer pointers */
 			bytes = dev->params.sample_container_bytes;
-			if (ret > 0)
+			if (ret > 0) {
 				comp_update_buffer_produce(buffer,
 							   ret * bytes);
+				dev->position += ret * bytes;
+			}
 		}
 		break;
 	case FILE_WRITE:
@@ -617,9 +995,11 @@ static int file_copy(struct comp_dev *dev)
 
 			/* update source buffer pointers */
 			bytes = dev->params.sample_container_bytes;
-			if (ret > 0)
+			if (ret > 0) {
 				comp_update_buffer_consume(buffer,
 							   ret * bytes);
+				dev->position += ret * bytes;
+			}
 		}
 		break;
 	default:
@@ -694,10 +1074,29 @@ static int file_prepare(struct comp_dev *dev)
 		}
 		buffer_reset_pos(buffer);
 		break;
+	case(SOF_IPC_FRAME_FLOAT):
+		/* float samples are only copied in blocks */
+		if (cd->fs.f_format == FILE_TEXT) {
+			fprintf(stderr, "error: no text file float support\n");
+			return -EINVAL;
+		}
+		ret = buffer_set_size(buffer, dev->frames * 4 *
+			periods * dev->params.channels);
+		if (ret < 0) {
+			fprintf(stderr, "error: file buffer size set\n");
+			return ret;
+		}
+		buffer_reset_pos(buffer);
+		break;
 	default:
 		return -EINVAL;
 	}
 
+	/* raw and WAV files are copied in blocks */
+	if (cd->fs.f_format != FILE_TEXT)
+		cd->file_func = file_block;
+
+	dev->position = 0;
 	dev->state = COMP_STATE_PREPARE;
 
 	return ret;
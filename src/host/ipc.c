@@ -70,3 +70,9 @@ int ipc_stream_send_xrun(struct comp_dev *cdev,
 {
 	return 0;
 }
+
+int ipc_send_comp_notification(struct comp_dev *cdev,
+			       struct sof_ipc_comp_event *event)
+{
+	return 0;
+}
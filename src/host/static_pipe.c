@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Static pipeline blob writer. Topology records are appended in creation
+ * order and written as a C header included by the firmware static
+ * pipeline loader.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sof/audio/format.h>
+#include <uapi/abi.h>
+#include <uapi/user/static_pipe.h>
+#include "host/static_pipe.h"
+
+/* words written per line of the generated header */
+#define STATIC_PIPE_LINE_WORDS	6
+
+static struct sof_static_pipe_hdr *blob;
+static size_t blob_alloc;
+
+int static_pipe_init(void)
+{
+	blob_alloc = 4096;
+	blob = calloc(1, blob_alloc);
+	if (!blob)
+		return -ENOMEM;
+
+	blob->magic = SOF_STATIC_PIPE_MAGIC;
+	blob->abi = SOF_ABI_VERSION;
+	return 0;
+}
+
+/* append a record, data is padded to a multiple of 4 bytes */
+int static_pipe_add(uint32_t type, const void *data, uint32_t size)
+{
+	struct sof_static_pipe_rec *rec;
+	uint32_t padded = ALIGN_UP(size, sizeof(uint32_t));
+	size_t used = sizeof(*blob) + blob->size;
+	size_t need = used + sizeof(*rec) + padded;
+	void *grow;
+
+	if (need > blob_alloc) {
+		grow = realloc(blob, need * 2);
+		if (!grow)
+			return -ENOMEM;
+		blob = grow;
+		blob_alloc = need * 2;
+	}
+
+	rec = (struct sof_static_pipe_rec *)((char *)blob + used);
+	rec->type = type;
+	rec->size = padded;
+	memcpy(rec->data, data, size);
+	memset((char *)rec->data + size, 0, padded - size);
+
+	blob->size += sizeof(*rec) + padded;
+	blob->num_records++;
+	return 0;
+}
+
+/* append a buffer with its offset in the audio pool of all buffers */
+int static_pipe_add_buffer(const struct sof_ipc_buffer *desc)
+{
+	struct sof_static_pipe_buffer sbuf;
+
+	sbuf.offset = blob->pool_size;
+	sbuf.buffer = *desc;
+
+	blob->pool_size += ALIGN_UP(desc->size, SOF_STATIC_PIPE_ALIGN);
+	blob->pool_caps |= desc->caps;
+
+	return static_pipe_add(SOF_STATIC_PIPE_BUFFER, &sbuf, sizeof(sbuf));
+}
+
+/* write the blob as a constant array of a C header */
+int static_pipe_write(const char *name, const char *tplg_name)
+{
+	const uint32_t *words = (const uint32_t *)blob;
+	size_t count = (sizeof(*blob) + blob->size) / sizeof(uint32_t);
+	size_t i;
+	FILE *fp;
+
+	fp = fopen(name, "w");
+	if (!fp) {
+		fprintf(stderr, "error: opening file %s\n", name);
+		return -EINVAL;
+	}
+
+	fprintf(fp, "/* generated by testbench -g from %s, do not edit */\n",
+		tplg_name);
+	fprintf(fp, "/* %u records, %u bytes of buffer pool */\n\n",
+		blob->num_records, blob->pool_size);
+	fprintf(fp, "static const uint32_t static_pipe_blob[] = {");
+
+	for (i = 0; i < count; i++) {
+		if (i % STATIC_PIPE_LINE_WORDS == 0)
+			fprintf(fp, "\n\t");
+		else
+			fprintf(fp, " ");
+		fprintf(fp, "0x%08x,", words[i]);
+	}
+
+	fprintf(fp, "\n};\n");
+
+	if (fclose(fp)) {
+		fprintf(stderr, "error: writing file %s\n", name);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+void static_pipe_free(void)
+{
+	free(blob);
+	blob = NULL;
+	blob_alloc = 0;
+}
@@ -31,12 +31,20 @@
 
 #include <sof/ipc.h>
 #include <sof/list.h>
+#include <sof/math/numbers.h>
+#include <platform/dma.h>
 #include <getopt.h>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "host/common_test.h"
 #include "host/topology.h"
 #include "host/trace.h"
 #include "host/file.h"
+#include "host/dai.h"
+#include "host/dma.h"
 
 #define TESTBENCH_NCH 2 /* Stereo */
 
@@ -45,6 +53,35 @@ struct shared_lib_table lib_table[NUM_WIDGETS_SUPPORTED] = {
 	{"file", "", SND_SOC_TPLG_DAPM_AIF_IN, 0, NULL},
 	{"vol", "libsof_volume.so", SND_SOC_TPLG_DAPM_PGA, 0, NULL},
 	{"src", "libsof_src.so", SND_SOC_TPLG_DAPM_SRC, 0, NULL},
+	{"mixer", "libsof_mixer.so", SND_SOC_TPLG_DAPM_MIXER, 0, NULL},
+	{"mux", "libsof_mux.so", SND_SOC_TPLG_DAPM_MUX, 0, NULL},
+	{"tone", "libsof_tone.so", SND_SOC_TPLG_DAPM_SIGGEN, 0, NULL},
+	{"eq_fir", "libsof_eq_fir.so", SND_SOC_TPLG_DAPM_EFFECT, 0, NULL},
+	{"eq_iir", "libsof_eq_iir.so", SND_SOC_TPLG_DAPM_EFFECT, 0, NULL},
+	{"kpb", "libsof_kpb.so", SND_SOC_TPLG_DAPM_EFFECT, 0, NULL},
+	{"selector", "libsof_selector.so", SND_SOC_TPLG_DAPM_EFFECT, 0, NULL},
+	{"detect", "libsof_detect_test.so", SND_SOC_TPLG_DAPM_EFFECT, 0,
+		NULL},
+	{"host", "libsof_host.so", SND_SOC_TPLG_DAPM_AIF_IN, 0, NULL},
+	{"dai", "libsof_dai.so", SND_SOC_TPLG_DAPM_DAI_IN, 0, NULL},
+};
+
+/*
+ * Playback stream of the DMA mode. The host buffer is the sample data of
+ * the mapped input file and the codec stream behind the DAI FIFO is the
+ * mapped output file.
+ */
+struct dma_stream {
+	FILE *in;
+	uint8_t *in_map;
+	size_t in_map_bytes;
+	uint32_t in_offset;	/* sample data offset in input file */
+	uint32_t in_bytes;	/* sample data bytes */
+	int out_fd;
+	uint32_t out_sample_bytes;
+	struct tb_dma_fifo *fifo;
+	int n_in;		/* samples in host buffer */
+	int n_out;		/* samples played */
 };
 
 /* main firmware context */
@@ -59,6 +96,7 @@ intptr_t _comp_init_start, _comp_init_end;
 /*
  * Parse shared library from user input
  * Currently only handles volume and src comp
+ * Libraries set here are loaded as is, without CPU variant dispatch
  * This function takes in the libraries to be used as an input in the format:
  * "vol=libsof_volume.so,src=libsof_src.so,..."
  * The function parses the above string to identify the following:
@@ -93,6 +131,7 @@ static void parse_libraries(char *libs)
 		/* set to new name that may be used while loading */
 		strncpy(lib_table[index].library_name, token1,
 			MAX_LIB_NAME_LEN - 1);
+		lib_table[index].user_library = 1;
 
 		/* next library */
 		token = strtok_r(NULL, ",", &lib_token);
@@ -104,14 +143,56 @@ static void print_usage(char *executable)
 {
 	printf("Usage: %s -i <input_file> -o <output_file> ", executable);
 	printf("-t <tplg_file> -b <input_format> ");
-	printf("-a <comp1=comp1_library,comp2=comp2_library>\n");
+	printf("-a <comp1=comp1_library,comp2=comp2_library> ");
+	printf("-c <cpu_variant>\n");
+	printf("       %s -t <tplg_file> -g <static_blob.h>\n", executable);
 	printf("input_format should be S16_LE, S32_LE, S24_LE or FLOAT_LE\n");
+	printf("format, rate and channels of .wav input are taken from the ");
+	printf("file header\n");
+	printf("cpu_variant forces module variant, generic, sse42, avx, ");
+	printf("avx2 or fma, by default the best supported one is used\n");
+	printf("-g writes the pipelines of the topology as a static ");
+	printf("pipeline blob header for CONFIG_STATIC_PIPELINE firmware\n");
+	printf("-D <speed> runs the host and dai components of a playback ");
+	printf("topology on the software DMA,\n");
+	printf("speed is the dai link rate relative to real time\n");
+	printf("-j <us> delays each DMA block by a random time of up to us\n");
 	printf("Example Usage:\n");
 	printf("%s -i in.txt -o out.txt -t test.tplg ", executable);
 	printf("-r 48000 -R 96000 ");
 	printf("-b S16_LE -a vol=libsof_volume.so\n");
 }
 
+/* take stream format, rate and channels from WAV input file header */
+static int parse_wav_input(struct testbench_prm *tp)
+{
+	struct file_wav_info wav;
+	char *ext = strrchr(tp->input_file, '.');
+	FILE *fh;
+	int ret;
+
+	if (!ext || strcmp(ext, ".wav"))
+		return 0;
+
+	fh = fopen(tp->input_file, "r");
+	if (!fh) {
+		fprintf(stderr, "error: opening file %s\n", tp->input_file);
+		return -ENOENT;
+	}
+
+	ret = file_wav_read_header(fh, &wav);
+	fclose(fh);
+	if (ret < 0)
+		return ret;
+
+	free(tp->bits_in);
+	tp->bits_in = strdup(file_wav_format_name(wav.frame_fmt));
+	tp->fs_in = wav.rate;
+	tp->channels = wav.channels;
+
+	return 0;
+}
+
 /* free components */
 static void free_comps(void)
 {
@@ -142,11 +223,306 @@ static void free_comps(void)
 	}
 }
 
+/* print cycles spent per period, host counts nanoseconds */
+static void print_perf_cnt(const char *name, uint32_t id,
+			   struct perf_cnt *pc, uint64_t period_ns)
+{
+	printf("%-10s %5u %8u %10u %10u %10u %7.2f%%\n", name, id,
+	       pc->count, pc->min, perf_cnt_avg(pc), pc->max,
+	       100.0 * perf_cnt_avg(pc) / period_ns);
+}
+
+static void print_perf(struct pipeline *p)
+{
+	struct list_item *clist;
+	struct ipc_comp_dev *icd;
+	uint64_t period_ns = pipeline_period(p) * 1000;
+	uint32_t bin_ns = 1 << PERF_HIST_SHIFT;
+	int i;
+
+	printf("Load per period of %u us (ns):\n",
+	       (uint32_t)(period_ns / 1000));
+	printf("%-10s %5s %8s %10s %10s %10s %8s\n", "", "id", "periods",
+	       "min", "avg", "max", "load");
+
+	list_for_item(clist, &sof.ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_COMPONENT)
+			print_perf_cnt("component", icd->cd->comp.id,
+				       &icd->cd->perf, period_ns);
+	}
+
+	print_perf_cnt("pipeline", p->ipc_pipe.comp_id, &p->perf, period_ns);
+
+	printf("Pipeline period histogram:\n");
+	for (i = 0; i < PERF_HIST_BINS - 1; i++) {
+		if (p->perf.hist[i])
+			printf("  < %10u ns: %u\n", bin_ns, p->perf.hist[i]);
+		bin_ns <<= 1;
+	}
+	if (p->perf.hist[i])
+		printf(" >= %10u ns: %u\n", bin_ns >> 1, p->perf.hist[i]);
+}
+
+static void print_telemetry(struct pipeline *p)
+{
+	struct pipeline_telemetry *t = &p->telemetry;
+	struct list_item *clist;
+	struct ipc_comp_dev *icd;
+	struct comp_buffer *buffer;
+
+	printf("Stream telemetry after %u periods:\n", t->count);
+	printf("  host position %llu bytes, dai position %llu bytes\n",
+	       (unsigned long long)t->host_posn,
+	       (unsigned long long)t->dai_posn);
+	printf("  latency %u us, min %u us, max %u us, drift %d ppm\n",
+	       t->latency, t->latency_min, t->latency_max, t->drift);
+
+	list_for_item(clist, &sof.ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_BUFFER)
+			continue;
+
+		buffer = icd->cb;
+		if (pipeline_is_stream_buffer(p, buffer))
+			printf("  buffer %u: size %u avail %u min %u max %u\n",
+			       buffer->ipc_buffer.comp.id, buffer->size,
+			       buffer->avail, buffer->avail_min,
+			       buffer->avail_max);
+	}
+}
+
+/* map the sample data of the input file as host buffer of the DMA mode */
+static int dma_input_map(struct testbench_prm *tp, struct dma_stream *ds)
+{
+	struct file_wav_info wav;
+	char *ext = strrchr(tp->input_file, '.');
+	struct stat st;
+
+	ds->in = fopen(tp->input_file, "r");
+	if (!ds->in || fstat(fileno(ds->in), &st) < 0) {
+		fprintf(stderr, "error: opening file %s\n", tp->input_file);
+		return -ENOENT;
+	}
+
+	ds->in_offset = 0;
+	ds->in_bytes = st.st_size;
+	if (ext && !strcmp(ext, ".wav")) {
+		if (file_wav_read_header(ds->in, &wav) < 0 ||
+		    wav.data_offset > st.st_size)
+			return -EINVAL;
+
+		ds->in_offset = wav.data_offset;
+		ds->in_bytes = MIN(wav.data_bytes,
+				   st.st_size - wav.data_offset);
+	}
+
+	if (!ds->in_bytes) {
+		fprintf(stderr, "error: no samples in %s\n", tp->input_file);
+		return -EINVAL;
+	}
+
+	ds->in_map_bytes = ds->in_offset + ds->in_bytes;
+	ds->in_map = tb_dma_map(fileno(ds->in), ds->in_map_bytes);
+	if (!ds->in_map) {
+		fprintf(stderr, "error: mapping file %s\n", tp->input_file);
+		return -ENOMEM;
+	}
+
+	tp->host_bytes = ds->in_bytes;
+	return 0;
+}
+
+/* pass the host buffer pages and the dai config, as the driver would */
+static int dma_endpoints_config(struct testbench_prm *tp,
+				struct dma_stream *ds, struct comp_dev *host,
+				struct comp_dev *dai)
+{
+	struct sof_ipc_comp_dai *ipc_dai = COMP_GET_IPC(dai, sof_ipc_comp_dai);
+	struct sof_ipc_comp_config *dconfig = COMP_GET_CONFIG(dai);
+	struct sof_ipc_dai_config config = {0};
+	struct dma_sg_elem_array elem_array;
+	uint32_t i;
+
+	/* host buffer pages, the last one is partial */
+	elem_array.count = ceil_divide(ds->in_bytes, HOST_PAGE_SIZE);
+	elem_array.elems = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+				   sizeof(struct dma_sg_elem) *
+				   elem_array.count);
+	if (!elem_array.elems)
+		return -ENOMEM;
+
+	for (i = 0; i < elem_array.count; i++) {
+		elem_array.elems[i].src = (uintptr_t)ds->in_map +
+			ds->in_offset + i * HOST_PAGE_SIZE;
+		elem_array.elems[i].size = MIN(HOST_PAGE_SIZE,
+					       ds->in_bytes -
+					       i * HOST_PAGE_SIZE);
+	}
+
+	if (comp_host_buffer(host, &elem_array, ds->in_bytes) < 0) {
+		rfree(elem_array.elems);
+		return -EINVAL;
+	}
+
+	/* codec stream is mapped once the dai frame size is known */
+	ds->fifo = tb_dma_map(-1, sizeof(*ds->fifo));
+	if (!ds->fifo)
+		return -ENOMEM;
+
+	if (tb_dai_set_fifo(ipc_dai->type, ipc_dai->dai_index,
+			    SOF_IPC_STREAM_PLAYBACK, ds->fifo) < 0) {
+		fprintf(stderr, "error: no dai type %u index %u\n",
+			ipc_dai->type, ipc_dai->dai_index);
+		return -EINVAL;
+	}
+
+	config.type = ipc_dai->type;
+	config.dai_index = ipc_dai->dai_index;
+	switch (ipc_dai->type) {
+	case SOF_DAI_INTEL_SSP:
+		config.ssp.tdm_slots = tp->channels;
+		config.ssp.sample_valid_bits =
+			dconfig->frame_fmt == SOF_IPC_FRAME_S16_LE ? 16 : 32;
+		break;
+	case SOF_DAI_INTEL_HDA:
+		config.hda.link_dma_ch = ipc_dai->dai_index;
+		break;
+	default:
+		fprintf(stderr, "error: dai type %u has no playback DMA\n",
+			ipc_dai->type);
+		return -EINVAL;
+	}
+
+	return comp_dai_config(dai, &config);
+}
+
+/*
+ * Start the pipeline on the software DMA. Completed DMA blocks wait for
+ * the interrupt lock until the codec stream is mapped and timed.
+ */
+static int dma_stream_start(struct sof *sof, struct testbench_prm *tp,
+			    struct dma_stream *ds,
+			    struct sof_ipc_pipe_new *ipc_pipe)
+{
+	struct comp_dev *host = ipc_get_comp(sof->ipc, fr_id)->cd;
+	struct comp_dev *dai = ipc_get_comp(sof->ipc, fw_id)->cd;
+	uint64_t frames;
+	uint64_t bytes;
+	int ret;
+
+	if (dma_endpoints_config(tp, ds, host, dai) < 0) {
+		fprintf(stderr, "error: dma endpoints config\n");
+		return -EINVAL;
+	}
+
+	tb_dma_irq_lock();
+
+	ret = tb_pipeline_start(sof->ipc, tp->channels, ipc_pipe, tp);
+	if (ret < 0)
+		goto out;
+
+	/* codec stream holds the input resampled to the dai format */
+	frames = ds->in_bytes / comp_frame_bytes(host);
+	bytes = frames * tp->fs_out / tp->fs_in * dai->frame_bytes;
+	ds->n_in = ds->in_bytes / comp_sample_bytes(host);
+	ds->out_sample_bytes = comp_sample_bytes(dai);
+
+	ds->out_fd = open(tp->output_file, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (ds->out_fd < 0 || !bytes || bytes > UINT32_MAX ||
+	    ftruncate(ds->out_fd, bytes) < 0) {
+		fprintf(stderr, "error: opening file %s\n", tp->output_file);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	ds->fifo->data = tb_dma_map(ds->out_fd, bytes);
+	if (!ds->fifo->data) {
+		fprintf(stderr, "error: mapping file %s\n", tp->output_file);
+		ret = -ENOMEM;
+		goto out;
+	}
+	ds->fifo->size = bytes;
+
+	/* host DMA is immediate, the link runs at the codec rate */
+	tb_dma_set_timing(DMA_ID_DMAC0, 0, tp->dma_jitter);
+	tb_dma_set_timing(DMA_ID_DMAC1, tp->dma_speed * tp->fs_out *
+			  dai->frame_bytes, tp->dma_jitter);
+
+out:
+	tb_dma_irq_unlock();
+	return ret;
+}
+
+/* wait until the codec stream is played, no progress for 1s is an xrun */
+static void dma_stream_run(struct testbench_prm *tp, struct pipeline *p,
+			   struct dma_stream *ds)
+{
+	useconds_t poll_us = MAX(pipeline_period(p) / tp->dma_speed, 100);
+	useconds_t idle_us = 0;
+	uint64_t last = 0;
+	uint64_t pos;
+
+	for (;;) {
+		usleep(poll_us);
+
+		tb_dma_irq_lock();
+		pos = ds->fifo->pos;
+		tb_dma_irq_unlock();
+
+		if (pos >= ds->fifo->size)
+			return;
+
+		if (pos != last) {
+			last = pos;
+			idle_us = 0;
+		} else {
+			idle_us += poll_us;
+			if (idle_us >= 1000000) {
+				printf("warning: possible pipeline xrun\n");
+				return;
+			}
+		}
+	}
+}
+
+/* stop and reset the pipeline in emulated interrupt context */
+static int dma_stream_stop(struct pipeline *p, struct comp_dev *cd)
+{
+	int ret;
+
+	tb_dma_irq_lock();
+	ret = pipeline_trigger(p, cd, COMP_TRIGGER_STOP);
+	if (ret >= 0)
+		ret = pipeline_reset(p, cd);
+	tb_dma_irq_unlock();
+
+	return ret;
+}
+
+/* trim the output file to the bytes played and unmap the stream */
+static void dma_stream_close(struct dma_stream *ds)
+{
+	uint32_t bytes = MIN(ds->fifo->pos, ds->fifo->size);
+
+	ds->n_out = bytes / ds->out_sample_bytes;
+
+	tb_dma_unmap(ds->fifo->data, ds->fifo->size);
+	if (ftruncate(ds->out_fd, bytes) < 0)
+		fprintf(stderr, "warning: output file not trimmed\n");
+	close(ds->out_fd);
+
+	tb_dma_unmap(ds->fifo, sizeof(*ds->fifo));
+	tb_dma_unmap(ds->in_map, ds->in_map_bytes);
+	fclose(ds->in);
+}
+
 static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 {
+	const char *optstring = "hdi:o:t:b:a:c:r:R:g:D:j:";
 	int option = 0;
 
-	while ((option = getopt(argc, argv, "hdi:o:t:b:a:r:R:")) != -1) {
+	while ((option = getopt(argc, argv, optstring)) != -1) {
 		switch (option) {
 		/* input sample file */
 		case 'i':
@@ -163,6 +539,11 @@ static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 			tp->tplg_file = strdup(optarg);
 			break;
 
+		/* static pipeline blob output */
+		case 'g':
+			tp->static_file = strdup(optarg);
+			break;
+
 		/* input samples bit format */
 		case 'b':
 			tp->bits_in = strdup(optarg);
@@ -173,6 +554,15 @@ static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 			parse_libraries(optarg);
 			break;
 
+		/* force CPU optimized variant of modules */
+		case 'c':
+			if (tb_set_cpu_variant(optarg) < 0) {
+				fprintf(stderr, "error: unknown cpu variant "
+					"%s\n", optarg);
+				exit(EXIT_FAILURE);
+			}
+			break;
+
 		/* input sample rate */
 		case 'r':
 			tp->fs_in = atoi(optarg);
@@ -183,6 +573,22 @@ static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 			tp->fs_out = atoi(optarg);
 			break;
 
+		/* run host and dai on the software DMA */
+		case 'D':
+			tp->dma = 1;
+			tp->dma_speed = atof(optarg);
+			if (tp->dma_speed <= 0) {
+				fprintf(stderr, "error: invalid DMA speed "
+					"%s\n", optarg);
+				exit(EXIT_FAILURE);
+			}
+			break;
+
+		/* DMA block jitter */
+		case 'j':
+			tp->dma_jitter = atoi(optarg);
+			break;
+
 		/* enable debug prints */
 		case 'd':
 			debug = 1;
@@ -204,26 +610,56 @@ int main(int argc, char **argv)
 	struct pipeline *p;
 	struct sof_ipc_pipe_new *ipc_pipe;
 	struct comp_dev *cd;
-	struct file_comp_data *frcd, *fwcd;
+	struct file_comp_data *frcd = NULL, *fwcd = NULL;
+	struct dma_stream ds = {0};
 	char pipeline[DEBUG_MSG_LEN];
+	struct timespec tplg_start, tplg_end;
 	clock_t tic, toc;
-	double c_realtime, t_exec;
+	double c_realtime, t_exec, t_tplg;
 	int n_in, n_out, ret;
 	int i;
 
 	/* initialize input and output sample rates */
 	tp.fs_in = 0;
 	tp.fs_out = 0;
+	tp.channels = TESTBENCH_NCH;
+	tp.static_file = NULL;
+	tp.dma = 0;
+	tp.dma_jitter = 0;
+	tp.host_bytes = 0;
 
 	/* command line arguments*/
 	parse_input_args(argc, argv, &tp);
 
+	/* record static pipeline blob, nothing is created or run */
+	if (tp.tplg_file && tp.static_file) {
+		ret = parse_topology(&sof, lib_table, &tp, &fr_id, &fw_id,
+				     &sched_id, pipeline);
+		if (ret < 0)
+			fprintf(stderr, "error: static pipeline %s\n",
+				tp.static_file);
+		else
+			printf("Static pipeline written to file: \"%s\"\n",
+			       tp.static_file);
+		free(tp.tplg_file);
+		free(tp.static_file);
+		exit(ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+	}
+
+	/* WAV input overrides format, rate and channels */
+	if (tp.input_file && parse_wav_input(&tp) < 0)
+		exit(EXIT_FAILURE);
+
 	/* check args */
 	if (!tp.tplg_file || !tp.input_file || !tp.output_file || !tp.bits_in) {
 		print_usage(argv[0]);
 		exit(EXIT_FAILURE);
 	}
 
+	/* host buffer of the DMA mode */
+	if (tp.dma && dma_input_map(&tp, &ds) < 0)
+		exit(EXIT_FAILURE);
+
 	/* initialize ipc and scheduler */
 	if (tb_pipeline_setup(&sof) < 0) {
 		fprintf(stderr, "error: pipeline init\n");
@@ -231,19 +667,25 @@ int main(int argc, char **argv)
 	}
 
 	/* parse topology file and create pipeline */
+	clock_gettime(CLOCK_MONOTONIC, &tplg_start);
 	if (parse_topology(&sof, lib_table, &tp, &fr_id, &fw_id, &sched_id,
 			   pipeline) < 0) {
 		fprintf(stderr, "error: parsing topology\n");
 		exit(EXIT_FAILURE);
 	}
+	clock_gettime(CLOCK_MONOTONIC, &tplg_end);
+	t_tplg = (tplg_end.tv_sec - tplg_start.tv_sec) * 1e6 +
+		 (tplg_end.tv_nsec - tplg_start.tv_nsec) / 1e3;
 
 	/* Get pointers to fileread and filewrite */
-	pcm_dev = ipc_get_comp(sof.ipc, fw_id);
-	fwcd = comp_get_drvdata(pcm_dev->cd);
-	pcm_dev = ipc_get_comp(sof.ipc, fr_id);
-	frcd = comp_get_drvdata(pcm_dev->cd);
+	if (!tp.dma) {
+		pcm_dev = ipc_get_comp(sof.ipc, fw_id);
+		fwcd = comp_get_drvdata(pcm_dev->cd);
+		pcm_dev = ipc_get_comp(sof.ipc, fr_id);
+		frcd = comp_get_drvdata(pcm_dev->cd);
+	}
 
-	/* Run pipeline until EOF from fileread */
+	/* Run pipeline until EOF from fileread or end of codec stream */
 	pcm_dev = ipc_get_comp(sof.ipc, sched_id);
 	p = pcm_dev->cd->pipeline;
 	ipc_pipe = &p->ipc_pipe;
@@ -256,7 +698,11 @@ int main(int argc, char **argv)
 		tp.fs_out = ipc_pipe->period * ipc_pipe->frames_per_sched;
 
 	/* set pipeline params and trigger start */
-	if (tb_pipeline_start(sof.ipc, TESTBENCH_NCH, ipc_pipe, &tp) < 0) {
+	if (tp.dma)
+		ret = dma_stream_start(&sof, &tp, &ds, ipc_pipe);
+	else
+		ret = tb_pipeline_start(sof.ipc, tp.channels, ipc_pipe, &tp);
+	if (ret < 0) {
 		fprintf(stderr, "error: pipeline params\n");
 		exit(EXIT_FAILURE);
 	}
@@ -265,28 +711,38 @@ int main(int argc, char **argv)
 	tb_enable_trace(false); /* reduce trace output */
 	tic = clock();
 
-	while (frcd->fs.reached_eof == 0)
-		pipeline_schedule_copy(p, 0);
+	if (tp.dma) {
+		dma_stream_run(&tp, p, &ds);
+	} else {
+		while (frcd->fs.reached_eof == 0)
+			pipeline_schedule_copy(p, 0);
 
-	if (!frcd->fs.reached_eof)
-		printf("warning: possible pipeline xrun\n");
+		if (!frcd->fs.reached_eof)
+			printf("warning: possible pipeline xrun\n");
+	}
 
 	/* reset and free pipeline */
 	toc = clock();
 	tb_enable_trace(true);
-	ret = pipeline_reset(p, cd);
+	if (tp.dma)
+		ret = dma_stream_stop(p, cd);
+	else
+		ret = pipeline_reset(p, cd);
 	if (ret < 0) {
 		fprintf(stderr, "error: pipeline reset\n");
 		exit(EXIT_FAILURE);
 	}
 
-	n_in = frcd->fs.n;
-	n_out = fwcd->fs.n;
+	if (tp.dma) {
+		dma_stream_close(&ds);
+		n_in = ds.n_in;
+		n_out = ds.n_out;
+	} else {
+		n_in = frcd->fs.n;
+		n_out = fwcd->fs.n;
+	}
 	t_exec = (double)(toc - tic) / CLOCKS_PER_SEC;
-	c_realtime = (double)n_out / TESTBENCH_NCH / tp.fs_out / t_exec;
-
-	/* free all components/buffers in pipeline */
-	free_comps();
+	c_realtime = (double)n_out / tp.channels / tp.fs_out / t_exec;
 
 	/* print test summary */
 	printf("==========================================================\n");
@@ -296,12 +752,25 @@ int main(int argc, char **argv)
 	printf("%s\n", pipeline);
 	printf("Input bit format: %s\n", tp.bits_in);
 	printf("Input sample rate: %d\n", tp.fs_in);
+	printf("Channels: %d\n", tp.channels);
 	printf("Output sample rate: %d\n", tp.fs_out);
 	printf("Output written to file: \"%s\"\n", tp.output_file);
 	printf("Input sample count: %d\n", n_in);
 	printf("Output sample count: %d\n", n_out);
 	printf("Total execution time: %.2f us, %.2f x realtime\n",
 	       1e3 * t_exec, c_realtime);
+	printf("Topology load time: %.2f us\n", t_tplg);
+	printf("CPU variants supported: %s\n", tb_get_cpu_features());
+	for (i = 1; i < NUM_WIDGETS_SUPPORTED; i++) {
+		if (lib_table[i].handle)
+			printf("Module %s: %s (%s)\n", lib_table[i].comp_name,
+			       lib_table[i].library_name, lib_table[i].variant);
+	}
+	print_perf(p);
+	print_telemetry(p);
+
+	/* free all components/buffers in pipeline */
+	free_comps();
 
 	/* free all other data */
 	free(tp.bits_in);
@@ -38,14 +38,232 @@
 #include <stdio.h>
 #include <sof/string.h>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sof/audio/component.h>
+#include <uapi/user/header.h>
+#include <uapi/user/static_pipe.h>
 #include "host/topology.h"
 #include "host/file.h"
+#include "host/static_pipe.h"
+
+/* smallest widget name hash table, it is kept at most half full */
+#define TPLG_HASH_MIN		64
 
-FILE *file;
 char pipeline_string[DEBUG_MSG_LEN];
 struct shared_lib_table *lib_table;
 
+/* topology file is mapped and parsed in place */
+static const uint8_t *tplg_data;
+static size_t tplg_size;
+static size_t tplg_pos;
+
+/* loaded widgets, the hash table has indexes to comp_list by name */
+static struct comp_info *comp_list;
+static int num_comps;
+static int *comp_hash;
+static int comp_hash_size;
+
+/* testbench streams from one fileread to one filewrite, -1 if none */
+static int fileread_pipeline;
+static int filewrite_pipeline;
+
+static size_t pipeline_len;
+
+/* record a static pipeline blob instead of creating the pipelines */
+static int static_pipe;
+
+/* run the real host and dai endpoints on the software DMA */
+static int dma_endpoints;
+
+/* create a component, or record it in the static pipeline blob */
+static int tplg_comp_new(struct sof *sof, struct sof_ipc_comp *comp)
+{
+	if (static_pipe)
+		return static_pipe_add(SOF_STATIC_PIPE_COMP, comp,
+				       comp->hdr.size);
+
+	return ipc_comp_new(sof->ipc, comp);
+}
+
+static int tplg_buffer_new(struct sof *sof, struct sof_ipc_buffer *buffer)
+{
+	if (static_pipe)
+		return static_pipe_add_buffer(buffer);
+
+	return ipc_buffer_new(sof->ipc, buffer);
+}
+
+static int tplg_pipeline_new(struct sof *sof,
+			     struct sof_ipc_pipe_new *pipeline)
+{
+	if (static_pipe)
+		return static_pipe_add(SOF_STATIC_PIPE_PIPELINE, pipeline,
+				       sizeof(*pipeline));
+
+	return ipc_pipeline_new(sof->ipc, pipeline);
+}
+
+static int tplg_comp_connect(struct sof *sof,
+			     struct sof_ipc_pipe_comp_connect *connect)
+{
+	if (static_pipe)
+		return static_pipe_add(SOF_STATIC_PIPE_CONNECT, connect,
+				       sizeof(*connect));
+
+	return ipc_comp_connect(sof->ipc, connect);
+}
+
+static int tplg_pipeline_complete(struct sof *sof, uint32_t comp_id)
+{
+	if (static_pipe)
+		return static_pipe_add(SOF_STATIC_PIPE_COMPLETE, &comp_id,
+				       sizeof(comp_id));
+
+	return ipc_pipeline_complete(sof->ipc, comp_id);
+}
+
+/* next object in topology or NULL if the file is truncated */
+static const void *tplg_peek(size_t size)
+{
+	if (size > tplg_size - tplg_pos)
+		return NULL;
+
+	return tplg_data + tplg_pos;
+}
+
+static const void *tplg_get(size_t size)
+{
+	const void *obj = tplg_peek(size);
+
+	if (obj)
+		tplg_pos += size;
+
+	return obj;
+}
+
+/* FNV-1a hash of a topology object name */
+static uint32_t tplg_name_hash(const char *name)
+{
+	uint32_t hash = 2166136261u;
+	int i;
+
+	for (i = 0; i < SNDRV_CTL_ELEM_ID_NAME_MAXLEN && name[i]; i++)
+		hash = (hash ^ (uint8_t)name[i]) * 16777619;
+
+	return hash;
+}
+
+static void comp_hash_insert(int index)
+{
+	uint32_t slot = tplg_name_hash(comp_list[index].name);
+
+	/* linear probing, the table always has free slots */
+	slot &= comp_hash_size - 1;
+	while (comp_hash[slot] >= 0)
+		slot = (slot + 1) & (comp_hash_size - 1);
+
+	comp_hash[slot] = index;
+}
+
+/* make room for widgets, rehash when the table gets half full */
+static int comp_list_reserve(int count)
+{
+	struct comp_info *list;
+	int size = comp_hash_size ? comp_hash_size : TPLG_HASH_MIN;
+	int i;
+
+	list = realloc(comp_list, (num_comps + count) * sizeof(*list));
+	if (!list)
+		return -ENOMEM;
+	comp_list = list;
+
+	while (size < 2 * (num_comps + count))
+		size *= 2;
+
+	if (size == comp_hash_size)
+		return 0;
+
+	free(comp_hash);
+	comp_hash = malloc(size * sizeof(*comp_hash));
+	if (!comp_hash)
+		return -ENOMEM;
+
+	comp_hash_size = size;
+	for (i = 0; i < size; i++)
+		comp_hash[i] = -1;
+	for (i = 0; i < num_comps; i++)
+		comp_hash_insert(i);
+
+	return 0;
+}
+
+/* look up loaded widget by name */
+static struct comp_info *find_comp(const char *name)
+{
+	struct comp_info *info;
+	uint32_t slot;
+
+	/* graph before any widget section */
+	if (!comp_hash_size)
+		return NULL;
+
+	slot = tplg_name_hash(name) & (comp_hash_size - 1);
+	while (comp_hash[slot] >= 0) {
+		info = &comp_list[comp_hash[slot]];
+		if (!strncmp(info->name, name, SNDRV_CTL_ELEM_ID_NAME_MAXLEN))
+			return info;
+		slot = (slot + 1) & (comp_hash_size - 1);
+	}
+
+	return NULL;
+}
+
+/* append to pipeline description, long pipelines end with ... */
+static void pipeline_string_add(const char *str, int len)
+{
+	size_t max = sizeof(pipeline_string) - 1;
+	int n;
+
+	if (pipeline_len >= max)
+		return;
+
+	n = snprintf(pipeline_string + pipeline_len, max + 1 - pipeline_len,
+		     "%.*s", len, str);
+	pipeline_len += n;
+	if (pipeline_len >= max) {
+		pipeline_len = max;
+		strcpy(pipeline_string + max - 3, "...");
+	}
+}
+
+/* open the shared library of a comp driver if not already registered */
+static void register_comp_index(int index)
+{
+	char message[DEBUG_MSG_LEN + MAX_LIB_NAME_LEN];
+
+	if (lib_table[index].register_drv)
+		return;
+
+	sprintf(message, "registered comp driver for %s\n",
+		lib_table[index].comp_name);
+	debug_print(message);
+
+	/* open shared library object */
+	sprintf(message, "opening shared lib %s\n",
+		lib_table[index].library_name);
+	debug_print(message);
+
+	lib_table[index].handle = tb_open_library(&lib_table[index]);
+	if (!lib_table[index].handle)
+		exit(EXIT_FAILURE);
+
+	/* comp init is executed on lib load */
+	lib_table[index].register_drv = 1;
+}
+
 /*
  * Register component driver
  * Only needed once per component type
@@ -53,11 +271,32 @@ struct shared_lib_table *lib_table;
 static void register_comp(int comp_type)
 {
 	int index;
-	char message[DEBUG_MSG_LEN + MAX_LIB_NAME_LEN];
+
+	/* register host and dai comp drivers of dma endpoints */
+	if (dma_endpoints) {
+		switch (comp_type) {
+		case SND_SOC_TPLG_DAPM_AIF_IN:
+		case SND_SOC_TPLG_DAPM_AIF_OUT:
+			index = get_index_by_name("host", lib_table);
+			if (index >= 0)
+				register_comp_index(index);
+			return;
+		case SND_SOC_TPLG_DAPM_DAI_IN:
+		case SND_SOC_TPLG_DAPM_DAI_OUT:
+			index = get_index_by_name("dai", lib_table);
+			if (index >= 0)
+				register_comp_index(index);
+			return;
+		default:
+			break;
+		}
+	}
 
 	/* register file comp driver (no shared library needed) */
 	if (comp_type == SND_SOC_TPLG_DAPM_DAI_IN ||
-	    comp_type == SND_SOC_TPLG_DAPM_AIF_IN) {
+	    comp_type == SND_SOC_TPLG_DAPM_DAI_OUT ||
+	    comp_type == SND_SOC_TPLG_DAPM_AIF_IN ||
+	    comp_type == SND_SOC_TPLG_DAPM_AIF_OUT) {
 		if (!lib_table[0].register_drv) {
 			sys_comp_file_init();
 			lib_table[0].register_drv = 1;
@@ -71,214 +310,143 @@ static void register_comp(int comp_type)
 	if (index < 0)
 		return;
 
-	/* register comp driver if not already registered */
-	if (!lib_table[index].register_drv) {
-		sprintf(message, "registered comp driver for %s\n",
-			lib_table[index].comp_name);
-		debug_print(message);
-
-		/* open shared library object */
-		sprintf(message, "opening shared lib %s\n",
-			lib_table[index].library_name);
-		debug_print(message);
-
-		lib_table[index].handle = dlopen(lib_table[index].library_name,
-						 RTLD_LAZY);
-		if (!lib_table[index].handle) {
-			fprintf(stderr, "error: %s\n", dlerror());
-			exit(EXIT_FAILURE);
-		}
-
-		/* comp init is executed on lib load */
-		lib_table[index].register_drv = 1;
-	}
+	register_comp_index(index);
+}
 
+/* widget vendor arrays follow the widget in the mapped topology */
+static struct snd_soc_tplg_vendor_array *
+widget_array(const struct snd_soc_tplg_dapm_widget *widget)
+{
+	return (struct snd_soc_tplg_vendor_array *)widget->priv.array;
 }
 
-/* read vendor tuples array from topology */
-static int read_array(struct snd_soc_tplg_vendor_array *array)
+/* parse comp tokens and component specific tokens of a widget */
+static int load_comp_tokens(struct sof_ipc_comp_config *config, void *object,
+			    const struct sof_topology_token *tokens, int count,
+			    const struct snd_soc_tplg_dapm_widget *widget)
 {
-	struct snd_soc_tplg_vendor_uuid_elem uuid;
-	struct snd_soc_tplg_vendor_string_elem string;
-	struct snd_soc_tplg_vendor_value_elem value;
-	int j, ret = 0;
-	size_t size;
-
-	switch (array->type) {
-	case SND_SOC_TPLG_TUPLE_TYPE_UUID:
-
-		/* copy uuid elems into array */
-		for (j = 0; j < array->num_elems; j++) {
-			size = sizeof(struct snd_soc_tplg_vendor_uuid_elem);
-			ret = fread(&uuid, size, 1, file);
-			if (ret != 1)
-				return -EINVAL;
-			memcpy(&array->uuid[j], &uuid, size);
-		}
-		break;
-	case SND_SOC_TPLG_TUPLE_TYPE_STRING:
+	struct snd_soc_tplg_vendor_array *array = widget_array(widget);
+	int size = widget->priv.size;
 
-		/* copy string elems into array */
-		for (j = 0; j < array->num_elems; j++) {
-			size = sizeof(struct snd_soc_tplg_vendor_string_elem);
-			ret = fread(&string, size, 1, file);
-			if (ret != 1)
-				return -EINVAL;
-			memcpy(&array->string[j], &string, size);
-		}
-		break;
-	case SND_SOC_TPLG_TUPLE_TYPE_BOOL:
-	case SND_SOC_TPLG_TUPLE_TYPE_BYTE:
-	case SND_SOC_TPLG_TUPLE_TYPE_WORD:
-	case SND_SOC_TPLG_TUPLE_TYPE_SHORT:
-		/* copy value elems into array */
-		for (j = 0; j < array->num_elems; j++) {
-			size = sizeof(struct snd_soc_tplg_vendor_value_elem);
-			ret = fread(&value, size, 1, file);
-			if (ret != 1)
-				return -EINVAL;
-			memcpy(&array->value[j], &value, size);
-		}
-		break;
-	default:
-		fprintf(stderr, "error: unknown token type %d\n", array->type);
+	if (config && sof_parse_tokens(config, comp_tokens,
+				       ARRAY_SIZE(comp_tokens), array,
+				       size) != 0) {
+		fprintf(stderr, "error: parse %.*s comp_tokens %d\n",
+			SNDRV_CTL_ELEM_ID_NAME_MAXLEN, widget->name, size);
 		return -EINVAL;
 	}
+
+	if (count && sof_parse_tokens(object, tokens, count, array,
+				      size) != 0) {
+		fprintf(stderr, "error: parse %.*s tokens %d\n",
+			SNDRV_CTL_ELEM_ID_NAME_MAXLEN, widget->name, size);
+		return -EINVAL;
+	}
+
 	return 0;
 }
 
 /* load pipeline graph DAPM widget*/
-static int load_graph(struct sof *sof, struct comp_info *temp_comp_list,
-		      int count, int num_comps, int pipeline_id)
+static int load_graph(struct sof *sof, int count, int pipeline_id)
 {
-	struct sof_ipc_pipe_comp_connect connection;
-	struct snd_soc_tplg_dapm_graph_elem *graph_elem;
-	size_t size;
-	int i, j, ret = 0;
-
-	/* allocate memory for graph elem */
-	size = sizeof(struct snd_soc_tplg_dapm_graph_elem);
-	graph_elem = (struct snd_soc_tplg_dapm_graph_elem *)malloc(size);
-	if (!graph_elem) {
-		fprintf(stderr, "error: mem alloc\n");
+	const struct snd_soc_tplg_dapm_graph_elem *graph;
+	struct sof_ipc_pipe_comp_connect connection = {0};
+	struct comp_info *source;
+	struct comp_info *sink;
+	int i;
+
+	graph = tplg_get(count * sizeof(*graph));
+	if (!graph) {
+		fprintf(stderr, "error: topology graph truncated\n");
 		return -EINVAL;
 	}
 
 	/* set up component connections */
-	connection.source_id = -1;
-	connection.sink_id = -1;
+	connection.hdr.size = sizeof(connection);
 	for (i = 0; i < count; i++) {
-		size = sizeof(struct snd_soc_tplg_dapm_graph_elem);
-		ret = fread(graph_elem, size, 1, file);
-		if (ret != 1)
-			return -EINVAL;
-
-		/* look up component id from the component list */
-		for (j = 0; j < num_comps; j++) {
-			if (strcmp(temp_comp_list[j].name,
-				   graph_elem->source) == 0)
-				connection.source_id = temp_comp_list[j].id;
-
-			if (strcmp(temp_comp_list[j].name,
-				   graph_elem->sink) == 0)
-				connection.sink_id = temp_comp_list[j].id;
-		}
-
-		strcat(pipeline_string, graph_elem->source);
-		strcat(pipeline_string, "->");
+		pipeline_string_add(graph[i].source,
+				    SNDRV_CTL_ELEM_ID_NAME_MAXLEN);
+		pipeline_string_add("->", 2);
 
 		if (i == (count - 1))
-			strcat(pipeline_string, graph_elem->sink);
-
-		/* connect source and sink */
-		if (connection.source_id != -1 && connection.sink_id != -1)
-			if (ipc_comp_connect(sof->ipc, &connection) < 0) {
-				fprintf(stderr, "error: comp connect\n");
+			pipeline_string_add(graph[i].sink,
+					    SNDRV_CTL_ELEM_ID_NAME_MAXLEN);
+
+		/*
+		 * Routes to widgets not loaded in testbench are skipped but
+		 * the pipelines of the stream must be complete.
+		 */
+		source = find_comp(graph[i].source);
+		sink = find_comp(graph[i].sink);
+		if (!source || !sink) {
+			if (pipeline_id == fileread_pipeline ||
+			    pipeline_id == filewrite_pipeline) {
+				fprintf(stderr, "error: route %.*s -> %.*s\n",
+					SNDRV_CTL_ELEM_ID_NAME_MAXLEN,
+					graph[i].source,
+					SNDRV_CTL_ELEM_ID_NAME_MAXLEN,
+					graph[i].sink);
 				return -EINVAL;
 			}
+			continue;
+		}
+
+		/* connect source and sink */
+		connection.source_id = source->id;
+		connection.sink_id = sink->id;
+		if (tplg_comp_connect(sof, &connection) < 0) {
+			fprintf(stderr, "error: comp connect\n");
+			return -EINVAL;
+		}
 	}
 
 	/* pipeline complete after pipeline connections are established */
 	for (i = 0; i < num_comps; i++) {
-		if (temp_comp_list[i].pipeline_id == pipeline_id &&
-		    temp_comp_list[i].type == SND_SOC_TPLG_DAPM_SCHEDULER)
-			ipc_pipeline_complete(sof->ipc, temp_comp_list[i].id);
+		if (comp_list[i].pipeline_id == pipeline_id &&
+		    comp_list[i].type == SND_SOC_TPLG_DAPM_SCHEDULER)
+			tplg_pipeline_complete(sof, comp_list[i].id);
 	}
 
-	free(graph_elem);
 	return 0;
 }
 
 /* load buffer DAPM widget */
-static int load_buffer(struct sof *sof, int comp_id, int pipeline_id, int size)
+static int load_buffer(struct sof *sof, int comp_id, int pipeline_id,
+		       const struct snd_soc_tplg_dapm_widget *widget)
 {
-	struct sof_ipc_buffer buffer;
-	struct snd_soc_tplg_vendor_array *array = NULL;
-	int ret = 0;
+	struct sof_ipc_buffer buffer = {0};
 
 	/* configure buffer */
 	buffer.comp.id = comp_id;
 	buffer.comp.pipeline_id = pipeline_id;
 
-	/* allocate memory for vendor tuple array */
-	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
-	ret = fread(array, sizeof(struct snd_soc_tplg_vendor_array), 1, file);
-	if (ret != 1)
-		return -EINVAL;
-
-	read_array(array);
 	/* parse buffer tokens */
-	ret = sof_parse_tokens(&buffer, buffer_tokens,
-			       ARRAY_SIZE(buffer_tokens), array,
-			       size);
+	if (load_comp_tokens(NULL, &buffer, buffer_tokens,
+			     ARRAY_SIZE(buffer_tokens), widget) < 0)
+		return -EINVAL;
 
 	/* create buffer component */
-	if (ipc_buffer_new(sof->ipc, &buffer) < 0) {
+	if (tplg_buffer_new(sof, &buffer) < 0) {
 		fprintf(stderr, "error: buffer new\n");
 		return -EINVAL;
 	}
-	free(array);
+
 	return 0;
 }
 
-/* load fileread component */
+/* load fileread component, stream source of playback or capture */
 static int load_fileread(struct sof *sof, int comp_id, int pipeline_id,
-			 int size, int *fr_id, int *sched_id,
-			 struct testbench_prm *tp)
+			 const struct snd_soc_tplg_dapm_widget *widget,
+			 int *fr_id, int *sched_id, struct testbench_prm *tp)
 {
-	struct sof_ipc_comp_file fileread;
-	struct snd_soc_tplg_vendor_array *array = NULL;
-	size_t total_array_size = 0, read_size;
-	int ret = 0;
+	struct sof_ipc_comp_file fileread = {0};
+	int ret;
 
 	fileread.config.frame_fmt = find_format(tp->bits_in);
 
-	/* allocate memory for vendor tuple array */
-	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
-	if (!array) {
-		fprintf(stderr, "error: mem alloc\n");
+	/* parse comp tokens */
+	if (load_comp_tokens(&fileread.config, NULL, NULL, 0, widget) < 0)
 		return -EINVAL;
-	}
-
-	/* read vendor tokens */
-	while (total_array_size < size) {
-		read_size = sizeof(struct snd_soc_tplg_vendor_array);
-		ret = fread(array, read_size, 1, file);
-		if (ret != 1)
-			return -EINVAL;
-		read_array(array);
-
-		/* parse comp tokens */
-		ret = sof_parse_tokens(&fileread.config, comp_tokens,
-				       ARRAY_SIZE(comp_tokens), array,
-				       array->size);
-		if (ret != 0) {
-			fprintf(stderr, "error: parse fileread tokens %d\n",
-				size);
-			return -EINVAL;
-		}
-		total_array_size += array->size;
-	}
 
 	/* configure fileread */
 	fileread.fn = strdup(tp->input_file);
@@ -293,52 +461,25 @@ static int load_fileread(struct sof *sof, int comp_id, int pipeline_id,
 	fileread.config.hdr.size = sizeof(struct sof_ipc_comp_config);
 
 	/* create fileread component */
-	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)&fileread) < 0) {
+	ret = tplg_comp_new(sof, (struct sof_ipc_comp *)&fileread);
+	if (ret < 0)
 		fprintf(stderr, "error: comp register\n");
-		return -EINVAL;
-	}
 
-	free(array);
 	free(fileread.fn);
-	return 0;
+	return ret < 0 ? -EINVAL : 0;
 }
 
-/* load filewrite component */
+/* load filewrite component, stream sink of playback or capture */
 static int load_filewrite(struct sof *sof, int comp_id, int pipeline_id,
-			  int size, int *fw_id, struct testbench_prm *tp)
+			  const struct snd_soc_tplg_dapm_widget *widget,
+			  int *fw_id, struct testbench_prm *tp)
 {
-	struct sof_ipc_comp_file filewrite;
-	struct snd_soc_tplg_vendor_array *array = NULL;
-	size_t total_array_size = 0, read_size;
-	int ret = 0;
+	struct sof_ipc_comp_file filewrite = {0};
+	int ret;
 
-	/* allocate memory for vendor tuple array */
-	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
-	if (!array) {
-		fprintf(stderr, "error: mem alloc\n");
+	/* parse comp tokens */
+	if (load_comp_tokens(&filewrite.config, NULL, NULL, 0, widget) < 0)
 		return -EINVAL;
-	}
-
-	/* read vendor tokens */
-	while (total_array_size < size) {
-		read_size = sizeof(struct snd_soc_tplg_vendor_array);
-		ret = fread(array, read_size, 1, file);
-		if (ret != 1)
-			return -EINVAL;
-
-		read_array(array);
-
-		/* parse comp tokens */
-		ret = sof_parse_tokens(&filewrite.config, comp_tokens,
-				       ARRAY_SIZE(comp_tokens), array,
-				       array->size);
-		if (ret != 0) {
-			fprintf(stderr, "error: parse filewrite tokens %d\n",
-				size);
-			return -EINVAL;
-		}
-		total_array_size += array->size;
-	}
 
 	/* configure filewrite */
 	filewrite.fn = strdup(tp->output_file);
@@ -351,50 +492,106 @@ static int load_filewrite(struct sof *sof, int comp_id, int pipeline_id,
 	filewrite.config.hdr.size = sizeof(struct sof_ipc_comp_config);
 
 	/* create filewrite component */
-	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)&filewrite) < 0) {
+	ret = tplg_comp_new(sof, (struct sof_ipc_comp *)&filewrite);
+	if (ret < 0)
+		fprintf(stderr, "error: comp register\n");
+
+	free(filewrite.fn);
+	return ret < 0 ? -EINVAL : 0;
+}
+
+/* load host component of a static pipeline, pcm playback is scheduling */
+static int load_host(struct sof *sof, int comp_id, int pipeline_id,
+		     const struct snd_soc_tplg_dapm_widget *widget,
+		     int *sched_id)
+{
+	struct sof_ipc_comp_host host = {0};
+
+	/* parse comp tokens */
+	if (load_comp_tokens(&host.config, NULL, NULL, 0, widget) < 0)
+		return -EINVAL;
+
+	/* configure host */
+	host.comp.id = comp_id;
+	host.comp.hdr.size = sizeof(struct sof_ipc_comp_host);
+	host.comp.type = SOF_COMP_HOST;
+	host.comp.pipeline_id = pipeline_id;
+	host.config.hdr.size = sizeof(struct sof_ipc_comp_config);
+
+	if (widget->id == SND_SOC_TPLG_DAPM_AIF_IN) {
+		host.direction = SOF_IPC_STREAM_PLAYBACK;
+		*sched_id = comp_id;
+	} else {
+		host.direction = SOF_IPC_STREAM_CAPTURE;
+	}
+
+	/* create host component */
+	if (tplg_comp_new(sof, (struct sof_ipc_comp *)&host) < 0) {
 		fprintf(stderr, "error: comp register\n");
 		return -EINVAL;
 	}
 
-	free(array);
-	free(filewrite.fn);
 	return 0;
 }
 
-/* load pda dapm widget */
-static int load_pga(struct sof *sof, int comp_id, int pipeline_id,
-		    int size)
+/* load dai component of a static pipeline, dai capture is scheduling */
+static int load_dai(struct sof *sof, int comp_id, int pipeline_id,
+		    const struct snd_soc_tplg_dapm_widget *widget,
+		    int *sched_id)
 {
-	struct sof_ipc_comp_volume volume;
-	struct snd_soc_tplg_vendor_array *array = NULL;
-	size_t total_array_size = 0, read_size;
-	int ret = 0;
+	struct sof_ipc_comp_dai dai = {0};
 
-	/* allocate memory for vendor tuple array */
-	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
-	if (!array) {
-		fprintf(stderr, "error: mem alloc\n");
+	/* parse dai tokens */
+	if (load_comp_tokens(&dai.config, &dai, dai_tokens,
+			     ARRAY_SIZE(dai_tokens), widget) < 0)
 		return -EINVAL;
+
+	/* configure dai */
+	dai.comp.id = comp_id;
+	dai.comp.hdr.size = sizeof(struct sof_ipc_comp_dai);
+	dai.comp.type = SOF_COMP_DAI;
+	dai.comp.pipeline_id = pipeline_id;
+	dai.config.hdr.size = sizeof(struct sof_ipc_comp_config);
+
+	if (widget->id == SND_SOC_TPLG_DAPM_DAI_OUT) {
+		dai.direction = SOF_IPC_STREAM_CAPTURE;
+		*sched_id = comp_id;
+	} else {
+		dai.direction = SOF_IPC_STREAM_PLAYBACK;
 	}
 
-	/* read vendor tokens */
-	while (total_array_size < size) {
-		read_size = sizeof(struct snd_soc_tplg_vendor_array);
-		ret = fread(array, read_size, 1, file);
-		if (ret != 1)
-			return -EINVAL;
-		read_array(array);
+	/* create dai component */
+	if (tplg_comp_new(sof, (struct sof_ipc_comp *)&dai) < 0) {
+		fprintf(stderr, "error: comp register\n");
+		return -EINVAL;
+	}
 
-		/* parse volume tokens */
-		ret = sof_parse_tokens(&volume.config, comp_tokens,
-				       ARRAY_SIZE(comp_tokens), array,
-				       array->size);
-		if (ret != 0) {
-			fprintf(stderr, "error: parse pga tokens %d\n", size);
-			return -EINVAL;
-		}
-		total_array_size += array->size;
+	return 0;
+}
+
+/* load pcm or dai endpoint of a static pipeline */
+static int load_endpoint(struct sof *sof, int comp_id, int pipeline_id,
+			 const struct snd_soc_tplg_dapm_widget *widget,
+			 int *sched_id)
+{
+	switch (widget->id) {
+	case SND_SOC_TPLG_DAPM_AIF_IN:
+	case SND_SOC_TPLG_DAPM_AIF_OUT:
+		return load_host(sof, comp_id, pipeline_id, widget, sched_id);
+	default:
+		return load_dai(sof, comp_id, pipeline_id, widget, sched_id);
 	}
+}
+
+/* load pda dapm widget */
+static int load_pga(struct sof *sof, int comp_id, int pipeline_id,
+		    const struct snd_soc_tplg_dapm_widget *widget)
+{
+	struct sof_ipc_comp_volume volume = {0};
+
+	/* parse volume tokens */
+	if (load_comp_tokens(&volume.config, NULL, NULL, 0, widget) < 0)
+		return -EINVAL;
 
 	/* configure volume */
 	volume.comp.id = comp_id;
@@ -404,118 +601,63 @@ static int load_pga(struct sof *sof, int comp_id, int pipeline_id,
 	volume.config.hdr.size = sizeof(struct sof_ipc_comp_config);
 
 	/* load volume component */
-	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)&volume) < 0) {
+	if (tplg_comp_new(sof, (struct sof_ipc_comp *)&volume) < 0) {
 		fprintf(stderr, "error: comp register\n");
 		return -EINVAL;
 	}
 
-	free(array);
 	return 0;
 }
 
 /* load scheduler dapm widget */
 static int load_pipeline(struct sof *sof, struct sof_ipc_pipe_new *pipeline,
-			 int comp_id, int pipeline_id, int size, int *sched_id)
+			 int comp_id, int pipeline_id,
+			 const struct snd_soc_tplg_dapm_widget *widget,
+			 int *sched_id)
 {
-	struct snd_soc_tplg_vendor_array *array = NULL;
-	size_t total_array_size = 0, read_size;
-	int ret = 0;
-
 	/* configure pipeline */
 	pipeline->sched_id = *sched_id;
 	pipeline->comp_id = comp_id;
 	pipeline->pipeline_id = pipeline_id;
 
-	/* allocate memory for vendor tuple array */
-	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
-	if (!array) {
-		fprintf(stderr, "error: mem alloc\n");
+	/* parse scheduler tokens */
+	if (load_comp_tokens(NULL, pipeline, sched_tokens,
+			     ARRAY_SIZE(sched_tokens), widget) < 0)
 		return -EINVAL;
-	}
-
-	/* read vendor arrays */
-	while (total_array_size < size) {
-		read_size = sizeof(struct snd_soc_tplg_vendor_array);
-		ret = fread(array, read_size, 1, file);
-		if (ret != 1)
-			return -EINVAL;
-
-		ret = read_array(array);
-		if (ret < 0)
-			return -EINVAL;
-
-		/* parse scheduler tokens */
-		ret = sof_parse_tokens(pipeline, sched_tokens,
-				       ARRAY_SIZE(sched_tokens), array,
-				       array->size);
-		if (ret != 0) {
-			fprintf(stderr, "error: parse pipeline tokens %d\n",
-				size);
-			return -EINVAL;
-		}
-		total_array_size += array->size;
-	}
 
 	/* Create pipeline */
-	if (ipc_pipeline_new(sof->ipc, pipeline) < 0) {
+	if (tplg_pipeline_new(sof, pipeline) < 0) {
 		fprintf(stderr, "error: pipeline new\n");
 		return -EINVAL;
 	}
 
-	free(array);
 	return 0;
 }
 
 /* load dapm widget kcontrols
  * we don't use controls in the testbench atm.
- * so just skip to the next dapm widget
+ * so just skip to the next dapm widget. The private data of the first
+ * bytes control is returned in priv_data if requested, processing
+ * components use it as their initial configuration blob. It points to
+ * the mapped topology and is valid until parsing ends.
  */
-static int load_controls(struct sof *sof, int num_kcontrols)
+static int load_controls(int num_kcontrols, const void **priv_data,
+			 size_t *priv_size)
 {
-	struct snd_soc_tplg_ctl_hdr *ctl_hdr;
-	struct snd_soc_tplg_mixer_control *mixer_ctl;
-	struct snd_soc_tplg_enum_control *enum_ctl;
-	struct snd_soc_tplg_bytes_control *bytes_ctl;
-	size_t read_size, size;
-	int j, ret = 0;
-
-	/* allocate memory */
-	size = sizeof(struct snd_soc_tplg_ctl_hdr);
-	ctl_hdr = (struct snd_soc_tplg_ctl_hdr *)malloc(size);
-	if (!ctl_hdr) {
-		fprintf(stderr, "error: mem alloc\n");
-		return -EINVAL;
-	}
-
-	size = sizeof(struct snd_soc_tplg_mixer_control);
-	mixer_ctl = (struct snd_soc_tplg_mixer_control *)malloc(size);
-	if (!mixer_ctl) {
-		fprintf(stderr, "error: mem alloc\n");
-		return -EINVAL;
-	}
-
-	size = sizeof(struct snd_soc_tplg_enum_control);
-	enum_ctl = (struct snd_soc_tplg_enum_control *)malloc(size);
-	if (!enum_ctl) {
-		fprintf(stderr, "error: mem alloc\n");
-		return -EINVAL;
-	}
-
-	size = sizeof(struct snd_soc_tplg_bytes_control);
-	bytes_ctl = (struct snd_soc_tplg_bytes_control *)malloc(size);
-	if (!bytes_ctl) {
-		fprintf(stderr, "error: mem alloc\n");
-		return -EINVAL;
-	}
+	const struct snd_soc_tplg_ctl_hdr *ctl_hdr;
+	const struct snd_soc_tplg_mixer_control *mixer_ctl;
+	const struct snd_soc_tplg_enum_control *enum_ctl;
+	const struct snd_soc_tplg_bytes_control *bytes_ctl;
+	const void *priv;
+	int j;
 
 	for (j = 0; j < num_kcontrols; j++) {
-		/* read control header */
-		read_size = sizeof(struct snd_soc_tplg_ctl_hdr);
-		ret = fread(ctl_hdr, read_size, 1, file);
-		if (ret != 1)
-			return -EINVAL;
+		/* control header starts every control type */
+		ctl_hdr = tplg_peek(sizeof(*ctl_hdr));
+		if (!ctl_hdr)
+			goto truncated;
 
-		/* load control based on type */
+		/* skip control based on type */
 		switch (ctl_hdr->ops.info) {
 		case SND_SOC_TPLG_CTL_VOLSW:
 		case SND_SOC_TPLG_CTL_STROBE:
@@ -523,47 +665,33 @@ static int load_controls(struct sof *sof, int num_kcontrols)
 		case SND_SOC_TPLG_CTL_VOLSW_XR_SX:
 		case SND_SOC_TPLG_CTL_RANGE:
 		case SND_SOC_TPLG_DAPM_CTL_VOLSW:
-
-			/* load mixer type control */
-			read_size = sizeof(struct snd_soc_tplg_ctl_hdr);
-			fseek(file, read_size * -1, SEEK_CUR);
-			read_size = sizeof(struct snd_soc_tplg_mixer_control);
-			ret = fread(mixer_ctl, read_size, 1, file);
-			if (ret != 1)
-				return -EINVAL;
-
-			/* skip mixer private data */
-			fseek(file, mixer_ctl->priv.size, SEEK_CUR);
+			mixer_ctl = tplg_get(sizeof(*mixer_ctl));
+			if (!mixer_ctl || !tplg_get(mixer_ctl->priv.size))
+				goto truncated;
 			break;
 		case SND_SOC_TPLG_CTL_ENUM:
 		case SND_SOC_TPLG_CTL_ENUM_VALUE:
 		case SND_SOC_TPLG_DAPM_CTL_ENUM_DOUBLE:
 		case SND_SOC_TPLG_DAPM_CTL_ENUM_VIRT:
 		case SND_SOC_TPLG_DAPM_CTL_ENUM_VALUE:
-
-			/* load enum type control */
-			read_size = sizeof(struct snd_soc_tplg_ctl_hdr);
-			fseek(file, read_size * -1, SEEK_CUR);
-			read_size = sizeof(struct snd_soc_tplg_enum_control);
-			ret = fread(enum_ctl, read_size, 1, file);
-			if (ret != 1)
-				return -EINVAL;
-
-			/* skip enum private data */
-			fseek(file, enum_ctl->priv.size, SEEK_CUR);
+			enum_ctl = tplg_get(sizeof(*enum_ctl));
+			if (!enum_ctl || !tplg_get(enum_ctl->priv.size))
+				goto truncated;
 			break;
 		case SND_SOC_TPLG_CTL_BYTES:
-
-			/* load bytes type controls */
-			read_size = sizeof(struct snd_soc_tplg_ctl_hdr);
-			fseek(file, read_size * -1, SEEK_CUR);
-			read_size = sizeof(struct snd_soc_tplg_bytes_control);
-			ret = fread(bytes_ctl, read_size, 1, file);
-			if (ret != 1)
-				return -EINVAL;
-
-			/* skip bytes private data */
-			fseek(file, bytes_ctl->priv.size, SEEK_CUR);
+			bytes_ctl = tplg_get(sizeof(*bytes_ctl));
+			if (!bytes_ctl)
+				goto truncated;
+
+			priv = tplg_get(bytes_ctl->priv.size);
+			if (!priv)
+				goto truncated;
+
+			/* return first bytes private data if requested */
+			if (priv_data && !*priv_data && bytes_ctl->priv.size) {
+				*priv_data = priv;
+				*priv_size = bytes_ctl->priv.size;
+			}
 			break;
 		default:
 			printf("info: control type not supported\n");
@@ -571,64 +699,23 @@ static int load_controls(struct sof *sof, int num_kcontrols)
 		}
 	}
 
-	/* free all data */
-	free(mixer_ctl);
-	free(enum_ctl);
-	free(bytes_ctl);
-	free(ctl_hdr);
 	return 0;
+
+truncated:
+	fprintf(stderr, "error: topology kcontrols truncated\n");
+	return -EINVAL;
 }
 
 /* load src dapm widget */
 static int load_src(struct sof *sof, int comp_id, int pipeline_id,
-		    int size, struct testbench_prm *tp)
+		    const struct snd_soc_tplg_dapm_widget *widget,
+		    struct testbench_prm *tp)
 {
 	struct sof_ipc_comp_src src = {0};
-	struct snd_soc_tplg_vendor_array *array = NULL;
-	size_t total_array_size = 0, read_size;
-	int ret = 0;
 
-	/* allocate memory for vendor tuple array */
-	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
-	if (!array) {
-		fprintf(stderr, "error: mem alloc for src vendor array\n");
+	if (load_comp_tokens(&src.config, &src, src_tokens,
+			     ARRAY_SIZE(src_tokens), widget) < 0)
 		return -EINVAL;
-	}
-
-	/* read vendor tokens */
-	while (total_array_size < size) {
-		read_size = sizeof(struct snd_soc_tplg_vendor_array);
-		ret = fread(array, read_size, 1, file);
-		if (ret != 1)
-			return -EINVAL;
-		read_array(array);
-
-		/* parse comp tokens */
-		ret = sof_parse_tokens(&src.config, comp_tokens,
-				       ARRAY_SIZE(comp_tokens), array,
-				       array->size);
-		if (ret != 0) {
-			fprintf(stderr, "error: parse src comp_tokens %d\n",
-				size);
-			return -EINVAL;
-		}
-
-		/* parse src tokens */
-		ret = sof_parse_tokens(&src, src_tokens,
-				       ARRAY_SIZE(src_tokens), array,
-				       array->size);
-		if (ret != 0) {
-			fprintf(stderr, "error: parse src tokens %d\n", size);
-			return -EINVAL;
-		}
-
-		total_array_size += array->size;
-
-		/* read next array */
-		array = (void *)array + array->size;
-	}
-
-	array = (void *)array - size;
 
 	/* set testbench input and output sample rate from topology */
 	if (!tp->fs_out) {
@@ -650,94 +737,292 @@ static int load_src(struct sof *sof, int comp_id, int pipeline_id,
 	src.config.hdr.size = sizeof(struct sof_ipc_comp_config);
 
 	/* load src component */
-	if (ipc_comp_new(sof->ipc, (struct sof_ipc_comp *)&src) < 0) {
+	if (tplg_comp_new(sof, (struct sof_ipc_comp *)&src) < 0) {
 		fprintf(stderr, "error: new src comp\n");
 		return -EINVAL;
 	}
 
-	free(array);
 	return 0;
 }
 
-/* load dapm widget */
-static int load_widget(struct sof *sof, int *fr_id, int *fw_id, int *sched_id,
-		       struct comp_info *temp_comp_list,
-		       struct sof_ipc_pipe_new *pipeline, int comp_id,
-		       int comp_index, int pipeline_id,
-		       struct testbench_prm *tp)
+/* load mixer dapm widget */
+static int load_mixer(struct sof *sof, int comp_id, int pipeline_id,
+		      const struct snd_soc_tplg_dapm_widget *widget)
 {
-	struct snd_soc_tplg_dapm_widget *widget;
-	char message[DEBUG_MSG_LEN];
-	size_t read_size, size;
-	int ret = 0;
+	struct sof_ipc_comp_mixer mixer = {0};
+
+	if (load_comp_tokens(&mixer.config, NULL, NULL, 0, widget) < 0)
+		return -EINVAL;
+
+	/* configure mixer */
+	mixer.comp.id = comp_id;
+	mixer.comp.hdr.size = sizeof(struct sof_ipc_comp_mixer);
+	mixer.comp.type = SOF_COMP_MIXER;
+	mixer.comp.pipeline_id = pipeline_id;
+	mixer.config.hdr.size = sizeof(struct sof_ipc_comp_config);
+
+	/* load mixer component */
+	if (tplg_comp_new(sof, (struct sof_ipc_comp *)&mixer) < 0) {
+		fprintf(stderr, "error: new mixer comp\n");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* load mux dapm widget */
+static int load_mux(struct sof *sof, int comp_id, int pipeline_id,
+		    const struct snd_soc_tplg_dapm_widget *widget)
+{
+	struct sof_ipc_comp_mux mux = {0};
+
+	if (load_comp_tokens(&mux.config, NULL, NULL, 0, widget) < 0)
+		return -EINVAL;
+
+	/* configure mux */
+	mux.comp.id = comp_id;
+	mux.comp.hdr.size = sizeof(struct sof_ipc_comp_mux);
+	mux.comp.type = SOF_COMP_MUX;
+	mux.comp.pipeline_id = pipeline_id;
+	mux.config.hdr.size = sizeof(struct sof_ipc_comp_config);
+
+	/* load mux component */
+	if (tplg_comp_new(sof, (struct sof_ipc_comp *)&mux) < 0) {
+		fprintf(stderr, "error: new mux comp\n");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* load siggen dapm widget as tone generator */
+static int load_tone(struct sof *sof, int comp_id, int pipeline_id,
+		     const struct snd_soc_tplg_dapm_widget *widget)
+{
+	struct sof_ipc_comp_tone tone = {0};
+
+	if (load_comp_tokens(&tone.config, &tone, tone_tokens,
+			     ARRAY_SIZE(tone_tokens), widget) < 0)
+		return -EINVAL;
+
+	/* configure tone */
+	tone.comp.id = comp_id;
+	tone.comp.hdr.size = sizeof(struct sof_ipc_comp_tone);
+	tone.comp.type = SOF_COMP_TONE;
+	tone.comp.pipeline_id = pipeline_id;
+	tone.config.hdr.size = sizeof(struct sof_ipc_comp_config);
+
+	/* load tone component */
+	if (tplg_comp_new(sof, (struct sof_ipc_comp *)&tone) < 0) {
+		fprintf(stderr, "error: new tone comp\n");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * load effect dapm widget
+ * The process type token selects the component driver and the first bytes
+ * kcontrol carries its configuration blob, so kcontrols are consumed here.
+ */
+static int load_process(struct sof *sof, int comp_id, int pipeline_id,
+			const struct snd_soc_tplg_dapm_widget *widget)
+{
+	struct sof_ipc_comp_process process = {0};
+	struct sof_ipc_comp_process *ipc_process;
+	const struct process_types *ptype;
+	const struct sof_abi_hdr *blob = NULL;
+	size_t priv_size = 0, blob_size = 0;
+	int index, ret;
+
+	if (load_comp_tokens(&process.config, &process, process_tokens,
+			     ARRAY_SIZE(process_tokens), widget) < 0)
+		return -EINVAL;
 
-	/* allocate memory for widget */
-	size = sizeof(struct snd_soc_tplg_dapm_widget);
-	widget = (struct snd_soc_tplg_dapm_widget *)malloc(size);
-	if (!widget) {
+	ret = load_controls(widget->num_kcontrols, (const void **)&blob,
+			    &priv_size);
+	if (ret < 0)
+		return -EINVAL;
+
+	ptype = find_process(process.comp.type);
+	if (!ptype) {
+		printf("info: process type not supported %.*s\n",
+		       SNDRV_CTL_ELEM_ID_NAME_MAXLEN, widget->name);
+		return 0;
+	}
+
+	/* register comp driver for the process type */
+	if (!static_pipe) {
+		index = get_index_by_name(ptype->comp_name, lib_table);
+		if (index < 0) {
+			printf("info: no library for %s\n", ptype->comp_name);
+			return 0;
+		}
+		register_comp_index(index);
+	}
+
+	/* validate configuration blob */
+	if (blob) {
+		if (priv_size < sizeof(*blob) ||
+		    blob->size > priv_size - sizeof(*blob)) {
+			fprintf(stderr, "error: invalid %.*s blob size %zu\n",
+				SNDRV_CTL_ELEM_ID_NAME_MAXLEN, widget->name,
+				priv_size);
+			return -EINVAL;
+		}
+		blob_size = blob->size;
+	}
+
+	/* allocate process ipc with trailing configuration data */
+	ipc_process = calloc(1, sizeof(*ipc_process) + blob_size);
+	if (!ipc_process) {
 		fprintf(stderr, "error: mem alloc\n");
 		return -EINVAL;
 	}
 
-	/* read widget data */
-	read_size = sizeof(struct snd_soc_tplg_dapm_widget);
-	ret = fread(widget, read_size, 1, file);
-	if (ret != 1)
+	*ipc_process = process;
+	if (blob_size)
+		memcpy(ipc_process->data, blob->data, blob_size);
+
+	/* configure process */
+	ipc_process->comp.id = comp_id;
+	ipc_process->comp.hdr.size = sizeof(*ipc_process) + blob_size;
+	ipc_process->comp.pipeline_id = pipeline_id;
+	ipc_process->config.hdr.size = sizeof(struct sof_ipc_comp_config);
+	ipc_process->size = blob_size;
+	ipc_process->type = ptype->process;
+
+	/* load process component */
+	ret = tplg_comp_new(sof, (struct sof_ipc_comp *)ipc_process);
+	if (ret < 0)
+		fprintf(stderr, "error: new %s comp\n", ptype->comp_name);
+
+	free(ipc_process);
+	return ret < 0 ? -EINVAL : 1;
+}
+
+/*
+ * load dapm widget
+ * Returns 1 if a component was created for the widget, 0 if the widget
+ * has no testbench component and routes to it are ignored.
+ */
+static int load_widget(struct sof *sof, int *fr_id, int *fw_id, int *sched_id,
+		       struct sof_ipc_pipe_new *pipeline, int comp_id,
+		       int pipeline_id, struct testbench_prm *tp)
+{
+	const struct snd_soc_tplg_dapm_widget *widget;
+	char message[DEBUG_MSG_LEN];
+	int ret = 1;
+
+	/* widget and its vendor arrays */
+	widget = tplg_get(sizeof(*widget));
+	if (!widget || !tplg_get(widget->priv.size)) {
+		fprintf(stderr, "error: topology widget truncated\n");
 		return -EINVAL;
+	}
 
-	/*
-	 * create a list with all widget info
-	 * containing mapping between component names and ids
-	 * which will be used for setting up component connections
-	 */
-	temp_comp_list[comp_index].id = comp_id;
-	temp_comp_list[comp_index].name = strdup(widget->name);
-	temp_comp_list[comp_index].type = widget->id;
-	temp_comp_list[comp_index].pipeline_id = pipeline_id;
-
-	sprintf(message, "loading widget %s id %d\n",
-		temp_comp_list[comp_index].name,
-		temp_comp_list[comp_index].id);
+	sprintf(message, "loading widget %.*s id %d\n",
+		SNDRV_CTL_ELEM_ID_NAME_MAXLEN, widget->name, comp_id);
 	debug_print(message);
 
-	/* register comp driver */
-	register_comp(temp_comp_list[comp_index].type);
+	/* register comp driver, effects are registered by process type */
+	if (!static_pipe && widget->id != SND_SOC_TPLG_DAPM_EFFECT)
+		register_comp(widget->id);
 
 	/* load widget based on type */
-	switch (temp_comp_list[comp_index].type) {
+	switch (widget->id) {
 	/* load pga widget */
 	case(SND_SOC_TPLG_DAPM_PGA):
-		if (load_pga(sof, temp_comp_list[comp_index].id,
-			     pipeline_id, widget->priv.size) < 0) {
+		if (load_pga(sof, comp_id, pipeline_id, widget) < 0) {
 			fprintf(stderr, "error: load pga\n");
 			return -EINVAL;
 		}
 		break;
 
-	/* replace pcm playback component with fileread in testbench */
+	/* replace pcm playback and dai capture with fileread or dma host */
 	case(SND_SOC_TPLG_DAPM_AIF_IN):
-		if (load_fileread(sof, temp_comp_list[comp_index].id,
-				  pipeline_id, widget->priv.size,
+	case(SND_SOC_TPLG_DAPM_DAI_OUT):
+		if (static_pipe) {
+			if (load_endpoint(sof, comp_id, pipeline_id, widget,
+					  sched_id) < 0) {
+				fprintf(stderr, "error: load endpoint\n");
+				return -EINVAL;
+			}
+			break;
+		}
+		if (fileread_pipeline >= 0) {
+			printf("info: only one stream input, skipping %.*s\n",
+			       SNDRV_CTL_ELEM_ID_NAME_MAXLEN, widget->name);
+			ret = 0;
+			break;
+		}
+		if (dma_endpoints) {
+			if (widget->id != SND_SOC_TPLG_DAPM_AIF_IN) {
+				fprintf(stderr, "error: only playback "
+					"endpoints run on DMA\n");
+				return -EINVAL;
+			}
+			if (load_endpoint(sof, comp_id, pipeline_id, widget,
+					  sched_id) < 0) {
+				fprintf(stderr, "error: load endpoint\n");
+				return -EINVAL;
+			}
+			*fr_id = comp_id;
+			fileread_pipeline = pipeline_id;
+			break;
+		}
+		if (load_fileread(sof, comp_id, pipeline_id, widget,
 				  fr_id, sched_id, tp) < 0) {
 			fprintf(stderr, "error: load fileread\n");
 			return -EINVAL;
 		}
+		fileread_pipeline = pipeline_id;
 		break;
 
-	/* replace dai in component with filewrite in testbench */
+	/* replace dai playback and pcm capture with filewrite or dma dai */
 	case(SND_SOC_TPLG_DAPM_DAI_IN):
-		if (load_filewrite(sof, temp_comp_list[comp_index].id,
-				   pipeline_id, widget->priv.size,
+	case(SND_SOC_TPLG_DAPM_AIF_OUT):
+		if (static_pipe) {
+			if (load_endpoint(sof, comp_id, pipeline_id, widget,
+					  sched_id) < 0) {
+				fprintf(stderr, "error: load endpoint\n");
+				return -EINVAL;
+			}
+			break;
+		}
+		if (filewrite_pipeline >= 0) {
+			printf("info: only one stream output, skipping %.*s\n",
+			       SNDRV_CTL_ELEM_ID_NAME_MAXLEN, widget->name);
+			ret = 0;
+			break;
+		}
+		if (dma_endpoints) {
+			if (widget->id != SND_SOC_TPLG_DAPM_DAI_IN) {
+				fprintf(stderr, "error: only playback "
+					"endpoints run on DMA\n");
+				return -EINVAL;
+			}
+			if (load_endpoint(sof, comp_id, pipeline_id, widget,
+					  sched_id) < 0) {
+				fprintf(stderr, "error: load endpoint\n");
+				return -EINVAL;
+			}
+			*fw_id = comp_id;
+			filewrite_pipeline = pipeline_id;
+			break;
+		}
+		if (load_filewrite(sof, comp_id, pipeline_id, widget,
 				   fw_id, tp) < 0) {
 			fprintf(stderr, "error: load filewrite\n");
 			return -EINVAL;
 		}
+		filewrite_pipeline = pipeline_id;
 		break;
 
 	/* load buffer */
 	case(SND_SOC_TPLG_DAPM_BUFFER):
-		if (load_buffer(sof, temp_comp_list[comp_index].id,
-				pipeline_id, widget->priv.size) < 0) {
+		if (load_buffer(sof, comp_id, pipeline_id, widget) < 0) {
 			fprintf(stderr, "error: load buffer\n");
 			return -EINVAL;
 		}
@@ -745,85 +1030,197 @@ static int load_widget(struct sof *sof, int *fr_id, int *fw_id, int *sched_id,
 
 	/* load pipeline */
 	case(SND_SOC_TPLG_DAPM_SCHEDULER):
-		if (load_pipeline(sof, pipeline,
-				  temp_comp_list[comp_index].id,
-				  pipeline_id,
-				  widget->priv.size,
+		if (load_pipeline(sof, pipeline, comp_id, pipeline_id, widget,
 				  sched_id) < 0) {
-			fprintf(stderr, "error: load buffer\n");
+			fprintf(stderr, "error: load pipeline\n");
 			return -EINVAL;
 		}
 		break;
 
 	/* load src widget */
 	case(SND_SOC_TPLG_DAPM_SRC):
-		if (load_src(sof, temp_comp_list[comp_index].id,
-			     pipeline_id, widget->priv.size, tp) < 0) {
+		if (load_src(sof, comp_id, pipeline_id, widget, tp) < 0) {
 			fprintf(stderr, "error: load src\n");
 			return -EINVAL;
 		}
 		break;
 
-	/* unsupported widgets */
+	/* load mixer widget */
+	case(SND_SOC_TPLG_DAPM_MIXER):
+		if (load_mixer(sof, comp_id, pipeline_id, widget) < 0) {
+			fprintf(stderr, "error: load mixer\n");
+			return -EINVAL;
+		}
+		break;
+
+	/* load mux widget */
+	case(SND_SOC_TPLG_DAPM_MUX):
+		if (load_mux(sof, comp_id, pipeline_id, widget) < 0) {
+			fprintf(stderr, "error: load mux\n");
+			return -EINVAL;
+		}
+		break;
+
+	/* load tone widget */
+	case(SND_SOC_TPLG_DAPM_SIGGEN):
+		if (load_tone(sof, comp_id, pipeline_id, widget) < 0) {
+			fprintf(stderr, "error: load tone\n");
+			return -EINVAL;
+		}
+		break;
+
+	/* load processing widget, this also loads its kcontrols */
+	case(SND_SOC_TPLG_DAPM_EFFECT):
+		ret = load_process(sof, comp_id, pipeline_id, widget);
+		if (ret < 0) {
+			fprintf(stderr, "error: load process\n");
+			return -EINVAL;
+		}
+		return ret;
+
+	/* widgets without a testbench component */
 	default:
 		printf("info: Widget type not supported %d\n",
 		       widget->id);
+		ret = 0;
 		break;
 	}
 
-	/* load widget kcontrols */
-	if (widget->num_kcontrols > 0)
-		if (load_controls(sof, widget->num_kcontrols) < 0) {
-			fprintf(stderr, "error: load buffer\n");
-			return -EINVAL;
+	/* skip widget kcontrols */
+	if (load_controls(widget->num_kcontrols, NULL, NULL) < 0) {
+		fprintf(stderr, "error: load controls\n");
+		return -EINVAL;
+	}
+
+	return ret;
+}
+
+/* load block of dapm widgets */
+static int load_widgets(struct sof *sof, int *fr_id, int *fw_id,
+			int *sched_id, struct sof_ipc_pipe_new *pipeline,
+			int *next_comp_id, int count, int pipeline_id,
+			struct testbench_prm *tp)
+{
+	const struct snd_soc_tplg_dapm_widget *widget;
+	struct comp_info *info;
+	int ret;
+	int i;
+
+	if (comp_list_reserve(count) < 0) {
+		fprintf(stderr, "error: mem alloc\n");
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < count; i++) {
+		widget = tplg_peek(sizeof(*widget));
+		ret = load_widget(sof, fr_id, fw_id, sched_id, pipeline,
+				  *next_comp_id, pipeline_id, tp);
+		if (ret < 0)
+			return ret;
+
+		/* add loaded widget to name lookup */
+		if (ret) {
+			info = &comp_list[num_comps];
+			info->id = *next_comp_id;
+			info->name = (char *)widget->name;
+			info->type = widget->id;
+			info->pipeline_id = pipeline_id;
+			comp_hash_insert(num_comps++);
 		}
 
-	free(widget);
+		(*next_comp_id)++;
+	}
+
 	return 0;
 }
 
+static int map_topology(const char *name)
+{
+	struct stat st;
+	void *map;
+	int fd;
+
+	fd = open(name, O_RDONLY);
+	if (fd < 0) {
+		fprintf(stderr, "error: opening file %s\n", name);
+		return -EINVAL;
+	}
+
+	if (fstat(fd, &st) < 0 || !st.st_size) {
+		fprintf(stderr, "error: empty topology %s\n", name);
+		close(fd);
+		return -EINVAL;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		fprintf(stderr, "error: mapping file %s\n", name);
+		return -EINVAL;
+	}
+
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+	tplg_data = map;
+	tplg_size = st.st_size;
+	tplg_pos = 0;
+	return 0;
+}
+
+static void parse_topology_free(void)
+{
+	munmap((void *)tplg_data, tplg_size);
+	tplg_data = NULL;
+
+	free(comp_list);
+	free(comp_hash);
+	comp_list = NULL;
+	comp_hash = NULL;
+	num_comps = 0;
+	comp_hash_size = 0;
+}
+
 /* parse topology file and set up pipeline */
 int parse_topology(struct sof *sof, struct shared_lib_table *library_table,
 		   struct testbench_prm *tp, int *fr_id, int *fw_id,
 		   int *sched_id, char *pipeline_msg)
 {
-	struct snd_soc_tplg_hdr *hdr;
-
-	struct comp_info *temp_comp_list = NULL;
-	struct sof_ipc_pipe_new pipeline;
+	const struct snd_soc_tplg_hdr *hdr;
+	struct sof_ipc_pipe_new pipeline = {0};
 	char message[DEBUG_MSG_LEN];
-	int next_comp_id = 0, num_comps = 0;
-	int i, ret = 0;
-	size_t file_size, size;
-
-	/* open topology file */
-	file = fopen(tp->tplg_file, "rb");
-	if (!file) {
-		fprintf(stderr, "error: opening file %s\n", tp->tplg_file);
+	int next_comp_id = 0, num_routes = 0;
+	int ret = 0;
+
+	/* map topology file */
+	if (map_topology(tp->tplg_file) < 0)
 		return -EINVAL;
-	}
 
 	lib_table = library_table;
-
-	/* file size */
-	fseek(file, 0, SEEK_END);
-	file_size = ftell(file);
-	fseek(file, 0, SEEK_SET);
-
-	/* allocate memory */
-	size = sizeof(struct snd_soc_tplg_hdr);
-	hdr = (struct snd_soc_tplg_hdr *)malloc(size);
-	if (!hdr) {
+	pipeline_len = 0;
+	pipeline_string[0] = '\0';
+	fileread_pipeline = -1;
+	filewrite_pipeline = -1;
+
+	/* record all pipelines of the topology for the static loader */
+	static_pipe = tp->static_file != NULL;
+	dma_endpoints = tp->dma && !static_pipe;
+	if (static_pipe && static_pipe_init() < 0) {
 		fprintf(stderr, "error: mem alloc\n");
-		return -EINVAL;
+		parse_topology_free();
+		return -ENOMEM;
 	}
 
 	debug_print("topology parsing start\n");
-	while (1) {
-		/* read topology header */
-		ret = fread(hdr, sizeof(struct snd_soc_tplg_hdr), 1, file);
-		if (ret != 1)
-			return -EINVAL;
+	while (tplg_pos < tplg_size) {
+		/* topology header, its size may grow with ABI */
+		hdr = tplg_peek(sizeof(*hdr));
+		if (!hdr || hdr->size < sizeof(*hdr) ||
+		    hdr->magic != SND_SOC_TPLG_MAGIC || !tplg_get(hdr->size) ||
+		    !tplg_peek(hdr->payload_size)) {
+			fprintf(stderr, "error: invalid topology header\n");
+			ret = -EINVAL;
+			break;
+		}
 
 		sprintf(message, "type: %x, size: 0x%x count: %d index: %d\n",
 			hdr->type, hdr->payload_size, hdr->count, hdr->index);
@@ -837,49 +1234,40 @@ int parse_topology(struct sof *sof, struct shared_lib_table *library_table,
 				hdr->count);
 			debug_print(message);
 
-			num_comps += hdr->count;
-			size = sizeof(struct comp_info) * num_comps;
-			temp_comp_list = (struct comp_info *)
-					 realloc(temp_comp_list, size);
-
-			for (i = (num_comps - hdr->count); i < num_comps; i++)
-				load_widget(sof, fr_id, fw_id, sched_id,
-					    temp_comp_list,
-					    &pipeline, next_comp_id++,
-					    i, hdr->index, tp);
+			ret = load_widgets(sof, fr_id, fw_id, sched_id,
+					   &pipeline, &next_comp_id,
+					   hdr->count, hdr->index, tp);
 			break;
 
 		/* set up component connections from pipeline graph */
 		case SND_SOC_TPLG_TYPE_DAPM_GRAPH:
-			if (load_graph(sof, temp_comp_list, hdr->count,
-				       num_comps, hdr->index) < 0) {
+			ret = load_graph(sof, hdr->count, hdr->index);
+			if (ret < 0)
 				fprintf(stderr, "error: pipeline graph\n");
-				return -EINVAL;
-			}
-
-			if (ftell(file) == file_size)
-				goto finish;
+			num_routes += hdr->count;
 			break;
 		default:
-			fseek(file, hdr->payload_size, SEEK_CUR);
-			if (ftell(file) == file_size)
-				goto finish;
+			tplg_get(hdr->payload_size);
 			break;
 		}
+
+		if (ret < 0)
+			break;
 	}
-finish:
-	debug_print("topology parsing end\n");
-	strcpy(pipeline_msg, pipeline_string);
 
-	/* free all data */
-	free(hdr);
+	sprintf(message, "topology parsing end, %d widgets %d routes\n",
+		next_comp_id, num_routes);
+	debug_print(message);
+	strcpy(pipeline_msg, pipeline_string);
 
-	for (i = 0; i < num_comps; i++)
-		free(temp_comp_list[i].name);
+	if (static_pipe) {
+		if (ret >= 0)
+			ret = static_pipe_write(tp->static_file, tp->tplg_file);
+		static_pipe_free();
+	}
 
-	free(temp_comp_list);
-	fclose(file);
-	return 0;
+	parse_topology_free();
+	return ret < 0 ? -EINVAL : 0;
 }
 
 /* parse vendor tokens in topology */
@@ -887,13 +1275,14 @@ int sof_parse_tokens(void *object, const struct sof_topology_token *tokens,
 		     int count, struct snd_soc_tplg_vendor_array *array,
 		     int priv_size)
 {
+	size_t elem_size;
 	int asize;
 
 	while (priv_size > 0) {
 		asize = array->size;
 
 		/* validate asize */
-		if (asize < 0) { /* FIXME: A zero-size array makes no sense */
+		if (asize < (int)sizeof(*array)) {
 			fprintf(stderr, "error: invalid array size 0x%x\n",
 				asize);
 			return -EINVAL;
@@ -908,6 +1297,25 @@ int sof_parse_tokens(void *object, const struct sof_topology_token *tokens,
 			return -EINVAL;
 		}
 
+		/* elements must be inside the array */
+		switch (array->type) {
+		case SND_SOC_TPLG_TUPLE_TYPE_UUID:
+			elem_size = sizeof(array->uuid[0]);
+			break;
+		case SND_SOC_TPLG_TUPLE_TYPE_STRING:
+			elem_size = sizeof(array->string[0]);
+			break;
+		default:
+			elem_size = sizeof(array->value[0]);
+			break;
+		}
+
+		if (array->num_elems > (asize - sizeof(*array)) / elem_size) {
+			fprintf(stderr, "error: invalid array elements %d\n",
+				array->num_elems);
+			return -EINVAL;
+		}
+
 		/* call correct parser depending on type */
 		switch (array->type) {
 		case SND_SOC_TPLG_TUPLE_TYPE_UUID:
@@ -930,6 +1338,9 @@ int sof_parse_tokens(void *object, const struct sof_topology_token *tokens,
 				array->type);
 			return -EINVAL;
 		}
+
+		/* next array */
+		array = (void *)array + asize;
 	}
 	return 0;
 }
@@ -1034,6 +1445,18 @@ enum sof_ipc_frame find_format(const char *name)
 	return SOF_IPC_FRAME_S32_LE;
 }
 
+const struct process_types *find_process(enum sof_comp_type type)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sof_process); i++) {
+		if (sof_process[i].type == type)
+			return &sof_process[i];
+	}
+
+	return NULL;
+}
+
 int get_token_uint32_t(void *elem, void *object, uint32_t offset,
 		       uint32_t size)
 {
@@ -1053,3 +1476,39 @@ int get_token_comp_format(void *elem, void *object, uint32_t offset,
 	*val = find_format(velem->string);
 	return 0;
 }
+
+int get_token_process_type(void *elem, void *object, uint32_t offset,
+			   uint32_t size)
+{
+	struct snd_soc_tplg_vendor_string_elem *velem = elem;
+	uint32_t *val = object + offset;
+	int i;
+
+	*val = SOF_COMP_NONE;
+	for (i = 0; i < ARRAY_SIZE(sof_process); i++) {
+		if (strcmp(velem->string, sof_process[i].name) == 0) {
+			*val = sof_process[i].type;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+int get_token_dai_type(void *elem, void *object, uint32_t offset,
+		       uint32_t size)
+{
+	struct snd_soc_tplg_vendor_string_elem *velem = elem;
+	uint32_t *val = object + offset;
+	int i;
+
+	*val = SOF_DAI_INTEL_NONE;
+	for (i = 0; i < ARRAY_SIZE(sof_dais); i++) {
+		if (strcmp(velem->string, sof_dais[i].name) == 0) {
+			*val = sof_dais[i].type;
+			break;
+		}
+	}
+
+	return 0;
+}
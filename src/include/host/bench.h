@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Kernel benchmark for the host audio modules. Processing kernels of
+ * every CPU variant of a module are run directly on synthetic buffers.
+ */
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sof/audio/buffer.h>
+
+#define BENCH_MAX_LIST		8
+
+/* benchmark configuration from command line */
+struct bench_cfg {
+	const char *variant;		/* CPU variant being measured */
+	const char *kernel;		/* only kernels matching this name */
+	uint32_t channels[BENCH_MAX_LIST];
+	uint32_t num_channels;
+	uint32_t frames[BENCH_MAX_LIST];
+	uint32_t num_frames;
+	uint32_t warmup;		/* untimed repetitions */
+	uint32_t reps;			/* timed repetitions */
+	uint32_t fir_taps;
+	uint32_t iir_biquads;
+	FILE *csv;			/* machine readable output */
+};
+
+/* one kernel run on one period of synthetic data */
+struct bench_case {
+	const char *kernel;		/* kernel function name */
+	char format[32];		/* stream format description */
+	uint32_t channels;
+	uint32_t frames;		/* frames per kernel call */
+	int wrap;			/* period crosses buffer wrap */
+	uint32_t samples;		/* samples processed per call */
+	void (*run)(struct bench_case *bc);
+	void *priv;			/* kernel specific data */
+};
+
+/* module whose kernels are benchmarked */
+struct bench_module {
+	const char *name;		/* audio module library name */
+	void (*run)(void *handle, struct bench_cfg *cfg);
+};
+
+void bench_volume(void *handle, struct bench_cfg *cfg);
+void bench_selector(void *handle, struct bench_cfg *cfg);
+void bench_eq_fir(void *handle, struct bench_cfg *cfg);
+void bench_eq_iir(void *handle, struct bench_cfg *cfg);
+void bench_src(void *handle, struct bench_cfg *cfg);
+void bench_mixer(void *handle, struct bench_cfg *cfg);
+
+/* measure case and report result */
+void bench_run(struct bench_cfg *cfg, struct bench_case *bc);
+
+/* true if kernel is selected by configuration */
+int bench_kernel_enabled(struct bench_cfg *cfg, const char *kernel);
+
+/*
+ * Buffer of two periods filled with synthetic samples. The read and write
+ * pointers are at the start, or in the middle of the second period when
+ * the processed period has to cross the buffer wrap.
+ */
+int bench_buffer_init(struct comp_buffer *buf, uint32_t frames,
+		      uint32_t frame_bytes, int wrap, uint32_t frame_fmt);
+void bench_buffer_free(struct comp_buffer *buf);
+
+uint32_t bench_sample_bytes(uint32_t frame_fmt);
+const char *bench_format_name(uint32_t frame_fmt);
+
+#endif
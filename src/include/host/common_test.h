@@ -45,13 +45,14 @@
 #define MAX_LIB_NAME_LEN	256
 
 /* number of widgets types supported in testbench */
-#define NUM_WIDGETS_SUPPORTED	3
+#define NUM_WIDGETS_SUPPORTED	13
 
 struct testbench_prm {
 	char *tplg_file; /* topology file to use */
 	char *input_file; /* input file name */
 	char *output_file; /* output file name */
 	char *bits_in; /* input bit format */
+	char *static_file; /* static pipeline blob to write instead of run */
 	/*
 	 * input and output sample rate parameters
 	 * By default, these are calculated from pipeline frames_per_sched
@@ -60,6 +61,16 @@ struct testbench_prm {
 	 */
 	uint32_t fs_in;
 	uint32_t fs_out;
+	uint32_t channels; /* stream channels, from WAV input if used */
+	/*
+	 * DMA mode runs the real host and DAI components on the software
+	 * DMA instead of file components. The host buffer is the mapped
+	 * input file and the DAI codec stream is the mapped output file.
+	 */
+	int dma;
+	double dma_speed; /* link DMA rate relative to real time */
+	uint32_t dma_jitter; /* max random DMA block delay in us */
+	uint32_t host_bytes; /* host buffer size for pcm params */
 };
 
 struct shared_lib_table {
@@ -68,6 +79,8 @@ struct shared_lib_table {
 	uint32_t widget_type;
 	int register_drv;
 	void *handle;
+	int user_library; /* library set by user, no CPU variant dispatch */
+	const char *variant; /* CPU optimized variant of loaded library */
 };
 
 extern int debug;
@@ -95,4 +108,10 @@ int get_index_by_name(char *comp_name,
 
 int get_index_by_type(uint32_t comp_type,
 		      struct shared_lib_table *lib_table);
+
+int tb_set_cpu_variant(const char *variant);
+
+const char *tb_get_cpu_features(void);
+
+void *tb_open_library(struct shared_lib_table *lib);
 #endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Software DMA engine for the testbench. Emulates the DW-DMA and HDA-DMA
+ * programming model on a worker thread so that components using the DMA
+ * API can be run on the host.
+ */
+
+#ifndef _TB_DMA_H
+#define _TB_DMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* number of channels per software DMAC */
+#define TB_DMA_CHANNELS		8
+
+/*
+ * Codec stream behind a DAI FIFO. SG elements of DAI channels use the
+ * address of this structure as FIFO address, so it must be allocated
+ * with tb_dma_map(). Playback past the end of the stream is dropped and
+ * capture past the end reads silence.
+ */
+struct tb_dma_fifo {
+	uint8_t *data;
+	uint32_t size;		/* stream size in bytes */
+	uint64_t pos;		/* bytes moved through the FIFO */
+};
+
+/* install the host and link software DMACs for dma_get() */
+void tb_dma_init(void);
+
+/*
+ * DMA completions and callbacks run in emulated interrupt context. The
+ * testbench holds this lock while it calls into the pipeline.
+ */
+void tb_dma_irq_lock(void);
+void tb_dma_irq_unlock(void);
+
+/*
+ * Set transfer timing of a DMAC. Bandwidth is in bytes per second, zero
+ * means transfers complete immediately. Each block is delayed by a
+ * random extra time of up to jitter microseconds.
+ */
+int tb_dma_set_timing(uint32_t dma_id, uint32_t bandwidth, uint32_t jitter);
+
+/*
+ * Map memory that can be described by the 32 bit addresses of DMA SG
+ * elements, e.g. the host memory or codec ring buffers. The memory is
+ * backed by the file when fd is valid or anonymous when fd is negative.
+ * Files opened read only are mapped copy on write.
+ */
+void *tb_dma_map(int fd, size_t bytes);
+void tb_dma_unmap(void *ptr, size_t bytes);
+
+#endif
@@ -43,6 +43,19 @@ enum file_mode {
 enum file_format {
 	FILE_TEXT = 0,
 	FILE_RAW,
+	FILE_WAV,
+};
+
+/* size of output block buffer */
+#define FILE_WBUF_SIZE	(64 * 1024)
+
+/* WAV stream parameters */
+struct file_wav_info {
+	uint32_t frame_fmt;	/* SOF_IPC_FRAME_ */
+	uint32_t rate;
+	uint32_t channels;
+	uint32_t data_offset;	/* file offset of sample data */
+	uint32_t data_bytes;	/* size of sample data */
 };
 
 /* file component state */
@@ -53,6 +66,14 @@ struct file_state {
 	int n;
 	enum file_mode mode;
 	enum file_format f_format;
+	uint8_t *map;		/* raw or WAV input mapped into memory */
+	size_t map_size;
+	size_t rpos;		/* input read position */
+	size_t rend;		/* end of input sample data */
+	uint8_t *wbuf;		/* raw or WAV output block buffer */
+	size_t wfill;
+	size_t wbytes;		/* sample bytes written */
+	struct file_wav_info wav;
 };
 
 /* file comp data */
@@ -74,4 +95,7 @@ struct sof_ipc_comp_file {
 	char *fn;
 	enum file_mode mode;
 };
+
+int file_wav_read_header(FILE *fh, struct file_wav_info *wav);
+const char *file_wav_format_name(uint32_t frame_fmt);
 #endif
@@ -50,6 +50,11 @@
 #define SOF_TKN_SCHED_CORE                      203
 #define SOF_TKN_SCHED_FRAMES                    204
 #define SOF_TKN_SCHED_TIME_DOMAIN               205
+#define SOF_TKN_SCHED_XRUN_LIMIT                206
+
+/* DAI */
+#define SOF_TKN_DAI_TYPE                        154
+#define SOF_TKN_DAI_INDEX                       155
 
 /* volume */
 #define SOF_TKN_VOLUME_RAMP_STEP_TYPE           250
@@ -67,6 +72,12 @@
  * #define SOF_TKN_COMP_PRELOAD_COUNT              403
  */
 
+/* tone */
+#define SOF_TKN_TONE_SAMPLE_RATE                800
+
+/* Processing Components */
+#define SOF_TKN_PROCESS_TYPE                    900
+
 struct comp_info {
 	char *name;
 	int id;
@@ -92,6 +103,34 @@ static const struct frame_types sof_frames[] = {
 	{"FLOAT_LE", SOF_IPC_FRAME_FLOAT},
 };
 
+struct process_types {
+	char *name;
+	char *comp_name;
+	enum sof_comp_type type;
+	enum sof_ipc_process_type process;
+};
+
+/* effect widgets are told apart by their SOF_TKN_PROCESS_TYPE string */
+static const struct process_types sof_process[] = {
+	{"EQFIR", "eq_fir", SOF_COMP_EQ_FIR, SOF_PROCESS_EQFIR},
+	{"EQIIR", "eq_iir", SOF_COMP_EQ_IIR, SOF_PROCESS_EQIIR},
+	{"KPB", "kpb", SOF_COMP_KPB, SOF_PROCESS_NONE},
+	{"CHAN_SELECTOR", "selector", SOF_COMP_SELECTOR, SOF_PROCESS_NONE},
+	{"KEYWORD_DETECT", "detect", SOF_COMP_KEYWORD_DETECT,
+		SOF_PROCESS_KEYWORD_DETECT},
+};
+
+struct dai_types {
+	char *name;
+	enum sof_ipc_dai_type type;
+};
+
+static const struct dai_types sof_dais[] = {
+	{"SSP", SOF_DAI_INTEL_SSP},
+	{"DMIC", SOF_DAI_INTEL_DMIC},
+	{"HDA", SOF_DAI_INTEL_HDA},
+};
+
 struct sof_topology_token {
 	uint32_t token;
 	uint32_t type;
@@ -109,6 +148,14 @@ int get_token_uint32_t(void *elem, void *object, uint32_t offset,
 int get_token_comp_format(void *elem, void *object, uint32_t offset,
 			  uint32_t size);
 
+const struct process_types *find_process(enum sof_comp_type type);
+
+int get_token_process_type(void *elem, void *object, uint32_t offset,
+			   uint32_t size);
+
+int get_token_dai_type(void *elem, void *object, uint32_t offset,
+		       uint32_t size);
+
 /* Buffers */
 static const struct sof_topology_token buffer_tokens[] = {
 	{SOF_TKN_BUF_SIZE, SND_SOC_TPLG_TUPLE_TYPE_WORD, get_token_uint32_t,
@@ -137,6 +184,17 @@ static const struct sof_topology_token sched_tokens[] = {
 	{SOF_TKN_SCHED_TIME_DOMAIN, SND_SOC_TPLG_TUPLE_TYPE_WORD,
 		get_token_uint32_t,
 		offsetof(struct sof_ipc_pipe_new, time_domain), 0},
+	{SOF_TKN_SCHED_XRUN_LIMIT, SND_SOC_TPLG_TUPLE_TYPE_WORD,
+		get_token_uint32_t,
+		offsetof(struct sof_ipc_pipe_new, xrun_limit_usecs), 0},
+};
+
+/* DAI */
+static const struct sof_topology_token dai_tokens[] = {
+	{SOF_TKN_DAI_TYPE, SND_SOC_TPLG_TUPLE_TYPE_STRING, get_token_dai_type,
+		offsetof(struct sof_ipc_comp_dai, type), 0},
+	{SOF_TKN_DAI_INDEX, SND_SOC_TPLG_TUPLE_TYPE_WORD, get_token_uint32_t,
+		offsetof(struct sof_ipc_comp_dai, dai_index), 0},
 };
 
 /* volume */
@@ -161,6 +219,15 @@ static const struct sof_topology_token src_tokens[] = {
 
 /* Tone */
 static const struct sof_topology_token tone_tokens[] = {
+	{SOF_TKN_TONE_SAMPLE_RATE, SND_SOC_TPLG_TUPLE_TYPE_WORD,
+		get_token_uint32_t,
+		offsetof(struct sof_ipc_comp_tone, sample_rate), 0},
+};
+
+static const struct sof_topology_token process_tokens[] = {
+	{SOF_TKN_PROCESS_TYPE, SND_SOC_TPLG_TUPLE_TYPE_STRING,
+		get_token_process_type,
+		offsetof(struct sof_ipc_comp_process, comp.type), 0},
 };
 
 /* Generic components */
@@ -31,6 +31,7 @@
 #ifndef __INCLUDE_AUDIO_BUFFER_H__
 #define __INCLUDE_AUDIO_BUFFER_H__
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 #include <sof/lock.h>
@@ -41,7 +42,10 @@
 #include <sof/trace.h>
 #include <sof/schedule.h>
 #include <sof/cache.h>
+#include <sof/platform.h>
+#include <sof/math/numbers.h>
 #include <uapi/ipc/topology.h>
+#include <uapi/ipc/stream.h>
 
 /* pipeline tracing */
 #define trace_buffer(__e, ...)	trace_event(TRACE_CLASS_BUFFER, __e, ##__VA_ARGS__)
@@ -55,15 +59,37 @@
 /* audio component buffer - connects 2 audio components together in pipeline */
 struct comp_buffer {
 
+	/* producer position, own cache line for cross-core buffers */
+	void *w_ptr		/* buffer write pointer */
+		__attribute__ ((__aligned__(PLATFORM_DCACHE_ALIGN)));
+	uint32_t free;		/* free bytes for writing */
+	uint32_t produced;	/* free running count of produced bytes */
+
+	/* consumer position, own cache line for cross-core buffers */
+	void *r_ptr		/* buffer read position */
+		__attribute__ ((__aligned__(PLATFORM_DCACHE_ALIGN)));
+	uint32_t avail;		/* available bytes for reading */
+	uint32_t consumed;	/* free running count of consumed bytes */
+
 	/* runtime data */
-	uint32_t size;		/* runtime buffer size in bytes (period multiple) */
+	uint32_t size		/* runtime buffer size in bytes */
+		__attribute__ ((__aligned__(PLATFORM_DCACHE_ALIGN)));
 	uint32_t alloc_size;	/* allocated size in bytes */
-	uint32_t avail;		/* available bytes for reading */
-	uint32_t free;		/* free bytes for writing */
-	void *w_ptr;		/* buffer write pointer */
-	void *r_ptr;		/* buffer read position */
+	bool xcore;		/* source and sink are run on different cores */
+	bool fade_in;		/* fade in audio after concealed underrun */
+	uint32_t conceal_bytes;	/* DMA xrun bytes left to the pipeline task */
+	bool pool;		/* audio memory is owned by a buffer pool */
+	uint32_t avail_min;	/* minimum avail seen by stream telemetry */
+	uint32_t avail_max;	/* maximum avail seen by stream telemetry */
 	void *addr;		/* buffer base address */
-	void *end_addr;		/* buffer end address */
+	void *end_addr;		/* buffer end address, plane end if planar */
+
+	/* planar layout keeps one ring per channel, positions are kept in
+	 * the ring of channel 0 and avail and free count all channels
+	 */
+	uint32_t layout;	/* SOF_IPC_BUFFER_ */
+	uint32_t planes;	/* channel rings, 1 if interleaved */
+	uint32_t plane_size;	/* ring size of each channel in bytes */
 
 	/* IPC configuration */
 	struct sof_ipc_buffer ipc_buffer;
@@ -121,6 +147,9 @@ struct comp_buffer {
 #define buffer_read_frag_s32(buffer, idx) \
 	buffer_get_frag(buffer, buffer->r_ptr, idx, sizeof(int32_t))
 
+#define buffer_read_frag_float(buffer, idx) \
+	buffer_get_frag(buffer, buffer->r_ptr, idx, sizeof(float))
+
 #define buffer_write_frag(buffer, idx, size) \
 	buffer_get_frag(buffer, buffer->w_ptr, idx, size)
 
@@ -130,10 +159,14 @@ struct comp_buffer {
 #define buffer_write_frag_s32(buffer, idx) \
 	buffer_get_frag(buffer, buffer->w_ptr, idx, sizeof(int32_t))
 
+#define buffer_write_frag_float(buffer, idx) \
+	buffer_get_frag(buffer, buffer->w_ptr, idx, sizeof(float))
+
 typedef void (*cache_buff_op)(struct comp_buffer *);
 
 /* pipeline buffer creation and destruction */
 struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc);
+struct comp_buffer *buffer_new_pool(struct sof_ipc_buffer *desc, void *addr);
 void buffer_free(struct comp_buffer *buffer);
 
 /* called by a component after producing data into this buffer */
@@ -142,6 +175,20 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes);
 /* called by a component after consuming data from this buffer */
 void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes);
 
+/* refresh positions of a cross-core buffer written by the other core */
+void buffer_xcore_producer_sync(struct comp_buffer *buffer);
+void buffer_xcore_consumer_sync(struct comp_buffer *buffer);
+
+/* fill an underrun with silence after fading out the queued audio */
+void buffer_conceal_underrun(struct comp_buffer *buffer, uint32_t bytes);
+
+/* drop the oldest audio of an overrun and fade in the rest */
+void buffer_conceal_overrun(struct comp_buffer *buffer, uint32_t bytes);
+
+/* catch up with a DMA that read or wrote bytes past the buffered audio */
+void buffer_conceal_dma_underrun(struct comp_buffer *buffer, uint32_t bytes);
+void buffer_conceal_dma_overrun(struct comp_buffer *buffer, uint32_t bytes);
+
 static inline void buffer_zero(struct comp_buffer *buffer)
 {
 	tracev_buffer("buffer_zero()");
@@ -212,6 +259,12 @@ static inline void buffer_reset_pos(struct comp_buffer *buffer)
 
 	/* there are no avail samples at reset */
 	buffer->avail = 0;
+	buffer->produced = 0;
+	buffer->consumed = 0;
+	buffer->avail_min = 0;
+	buffer->avail_max = 0;
+	buffer->fade_in = false;
+	buffer->conceal_bytes = 0;
 
 	/* clear buffer contents */
 	buffer_zero(buffer);
@@ -223,19 +276,73 @@ static inline int buffer_set_size(struct comp_buffer *buffer, uint32_t size)
 {
 	if (size > buffer->alloc_size)
 		return -ENOMEM;
-	if (size == 0)
+	if (size == 0 || size % buffer->planes)
 		return -EINVAL;
 
-	buffer->end_addr = buffer->addr + size;
+	buffer->plane_size = size / buffer->planes;
+	buffer->end_addr = buffer->addr + buffer->plane_size;
 	buffer->size = size;
 	return 0;
 }
 
+static inline int buffer_is_planar(struct comp_buffer *buffer)
+{
+	return buffer->layout == SOF_IPC_BUFFER_NONINTERLEAVED;
+}
+
+/* set layout of an idle buffer, the size is kept and split in planes */
+static inline void buffer_set_layout(struct comp_buffer *buffer,
+				    uint32_t layout, uint32_t channels)
+{
+	uint32_t planes = 1;
+
+	/* planes must split the buffer in whole samples */
+	if (layout == SOF_IPC_BUFFER_NONINTERLEAVED && channels > 1 &&
+	    !(buffer->size % (channels * sizeof(uint32_t))))
+		planes = channels;
+	else
+		layout = SOF_IPC_BUFFER_INTERLEAVED;
+
+	buffer->layout = layout;
+	buffer->planes = planes;
+	buffer->plane_size = buffer->size / planes;
+	buffer->end_addr = buffer->addr + buffer->plane_size;
+	buffer->w_ptr = buffer->addr;
+	buffer->r_ptr = buffer->addr;
+}
+
+/* advance a read or write position by bytes of all channels */
+static inline void *buffer_pos_add(struct comp_buffer *buffer, void *ptr,
+				   uint32_t bytes)
+{
+	ptr += bytes / buffer->planes;
+	if (ptr >= buffer->end_addr)
+		ptr = buffer->addr + (ptr - buffer->end_addr);
+
+	return ptr;
+}
+
+/* planar sample idx of interleaved sample index, slow path */
+static inline void *buffer_get_frag_planar(struct comp_buffer *buffer,
+					   void *ptr, uint32_t idx,
+					   uint32_t size)
+{
+	void *current = ptr + (idx / buffer->planes) * size;
+
+	if (current >= buffer->end_addr)
+		current = buffer->addr + (current - buffer->end_addr);
+
+	return current + (idx % buffer->planes) * buffer->plane_size;
+}
+
 static inline void *buffer_get_frag(struct comp_buffer *buffer, void *ptr,
 				    uint32_t idx, uint32_t size)
 {
 	void *current = ptr + (idx * size);
 
+	if (buffer_is_planar(buffer))
+		return buffer_get_frag_planar(buffer, ptr, idx, size);
+
 	/* check for pointer wrap */
 	if (current >= buffer->end_addr)
 		current = buffer->addr + (current - buffer->end_addr);
@@ -243,4 +350,59 @@ static inline void *buffer_get_frag(struct comp_buffer *buffer, void *ptr,
 	return current;
 }
 
+/* position of one channel for unit stride processing of planar buffers
+ * and channel strided processing of interleaved ones
+ */
+struct buffer_channel {
+	void *ptr;		/* current sample */
+	void *start;		/* channel ring start */
+	void *end;		/* channel ring end */
+	uint32_t stride;	/* bytes to next sample of the channel */
+};
+
+static inline void buffer_channel_init(struct comp_buffer *buffer, void *pos,
+				       uint32_t ch, uint32_t nch,
+				       uint32_t sample_bytes,
+				       struct buffer_channel *c)
+{
+	uint32_t offset;
+
+	if (buffer_is_planar(buffer)) {
+		offset = ch * buffer->plane_size;
+		c->stride = sample_bytes;
+	} else {
+		offset = ch * sample_bytes;
+		c->stride = nch * sample_bytes;
+	}
+
+	c->ptr = pos + offset;
+	c->start = buffer->addr + offset;
+	c->end = buffer->end_addr + offset;
+}
+
+/* samples of the channel before its ring wraps */
+static inline uint32_t buffer_channel_samples(struct buffer_channel *c)
+{
+	return (c->end - c->ptr + c->stride - 1) / c->stride;
+}
+
+/* samples to process from source and sink channels before either wraps */
+static inline uint32_t buffer_channel_run(struct buffer_channel *x,
+					  struct buffer_channel *y,
+					  uint32_t samples)
+{
+	uint32_t n = buffer_channel_samples(x);
+
+	n = MIN(n, buffer_channel_samples(y));
+	return MIN(n, samples);
+}
+
+static inline void buffer_channel_advance(struct buffer_channel *c,
+					  uint32_t samples)
+{
+	c->ptr += samples * c->stride;
+	if (c->ptr >= c->end)
+		c->ptr -= c->end - c->start;
+}
+
 #endif
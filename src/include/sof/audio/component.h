@@ -51,6 +51,7 @@
 #include <sof/audio/pipeline.h>
 #include <sof/cache.h>
 #include <sof/math/numbers.h>
+#include <sof/perf.h>
 #include <uapi/ipc/control.h>
 #include <uapi/ipc/stream.h>
 #include <uapi/ipc/topology.h>
@@ -201,6 +202,14 @@ struct comp_ops {
 	/** copy and process stream data from source to sink buffers */
 	int (*copy)(struct comp_dev *dev);
 
+	/**
+	 * process frames from source to sink without buffer checks and
+	 * updates, source and sink can be the same buffer for in place
+	 * processing - used by pipeline to fuse simple components together
+	 */
+	int (*process)(struct comp_dev *dev, struct comp_buffer *source,
+		       struct comp_buffer *sink, uint32_t frames);
+
 	/** host buffer config */
 	int (*host_buffer)(struct comp_dev *dev,
 			   struct dma_sg_elem_array *elem_array,
@@ -241,11 +250,13 @@ struct comp_dev {
 	/* runtime */
 	uint16_t state;		   /**< COMP_STATE_ */
 	uint16_t is_dma_connected; /**< component is connected to DMA */
+	uint32_t layout;	   /**< preferred buffer layout */
 	spinlock_t lock;	   /**< lock for this component */
 	uint64_t position;	   /**< component rendering position */
 	uint32_t frames;	   /**< number of frames we copy to sink */
 	uint32_t frame_bytes;	   /**< frames size copied to sink in bytes */
 	struct pipeline *pipeline; /**< pipeline we belong to */
+	struct perf_cnt perf;	   /**< copy cycles per period */
 
 	/** common runtime configuration for downstream/upstream */
 	struct sof_ipc_stream_params params;
@@ -699,6 +710,12 @@ static inline void comp_underrun(struct comp_dev *dev, struct comp_buffer *sourc
 		  (dev->comp.id << 16) | source->avail,
 		  (min_bytes << 16) | copy_bytes);
 
+	/* short underruns are concealed at the starving buffer */
+	if (pipeline_xrun_conceal(dev->pipeline, source,
+				  copy_bytes > source->avail ?
+				  copy_bytes - source->avail : 0, true))
+		return;
+
 	pipeline_xrun(dev->pipeline, dev, (int32_t)source->avail - copy_bytes);
 }
 
@@ -717,6 +734,12 @@ static inline void comp_overrun(struct comp_dev *dev, struct comp_buffer *sink,
 		  (dev->comp.id << 16) | sink->free,
 		  (min_bytes << 16) | copy_bytes);
 
+	/* short overruns are concealed at the blocked buffer */
+	if (pipeline_xrun_conceal(dev->pipeline, sink,
+				  copy_bytes > sink->free ?
+				  copy_bytes - sink->free : 0, false))
+		return;
+
 	pipeline_xrun(dev->pipeline, dev, (int32_t)copy_bytes - sink->free);
 }
 
@@ -33,6 +33,8 @@
 #ifndef AUDIO_FORMAT_H
 #define AUDIO_FORMAT_H
 
+#include <config.h>
+
 /* Maximum and minimum values for 24 bit */
 #define INT24_MAXVALUE  8388607
 #define INT24_MINVALUE -8388608
@@ -184,4 +186,54 @@ static inline int32_t sign_extend_s24(int32_t x)
 	return (x << 8) >> 8;
 }
 
+#if CONFIG_FORMAT_FLOAT
+
+/* Float samples are full scale at +-1.0 and have no saturation, only the
+ * conversions back to fixed point round and saturate.
+ */
+static inline float s16_to_float(int16_t x)
+{
+	return x * (1.0f / 32768.0f);
+}
+
+static inline float s24_to_float(int32_t x)
+{
+	return sign_extend_s24(x) * (1.0f / 8388608.0f);
+}
+
+static inline float s32_to_float(int32_t x)
+{
+	return x * (1.0f / 2147483648.0f);
+}
+
+static inline int32_t float_to_fixed(float x, float scale, int32_t min,
+				     int32_t max)
+{
+	float y = x * scale;
+
+	if (y >= (float)max)
+		return max;
+	if (y <= (float)min)
+		return min;
+
+	return y < 0.0f ? (int32_t)(y - 0.5f) : (int32_t)(y + 0.5f);
+}
+
+static inline int16_t float_to_s16(float x)
+{
+	return float_to_fixed(x, 32768.0f, INT16_MIN, INT16_MAX);
+}
+
+static inline int32_t float_to_s24(float x)
+{
+	return float_to_fixed(x, 8388608.0f, INT24_MINVALUE, INT24_MAXVALUE);
+}
+
+static inline int32_t float_to_s32(float x)
+{
+	return float_to_fixed(x, 2147483648.0f, INT32_MIN, INT32_MAX);
+}
+
+#endif
+
 #endif
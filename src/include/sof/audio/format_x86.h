@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Q-format arithmetic helpers for the x86 SSE4.2 and AVX2 host builds of
+ * the audio processing components. The helpers process Q_VEC_LANES 32 bit
+ * samples at a time and give the same results as the scalar functions in
+ * format.h, including rounding and saturation.
+ */
+
+#ifndef AUDIO_FORMAT_X86_H
+#define AUDIO_FORMAT_X86_H
+
+#if defined(__SSE4_2__)
+
+#include <sof/audio/format.h>
+#include <immintrin.h>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+
+#define Q_VEC_LANES	8
+
+#define q_vec		__m256i
+
+#define q_vec_zero()		_mm256_setzero_si256()
+#define q_vec_set1(x)		_mm256_set1_epi32(x)
+#define q_vec_set1_64(x)	_mm256_set1_epi64x(x)
+#define q_vec_add64(a, b)	_mm256_add_epi64(a, b)
+#define q_vec_xor(a, b)		_mm256_xor_si256(a, b)
+#define q_vec_mul(a, b)		_mm256_mul_epi32(a, b)
+#define q_vec_srli64(a, s)	_mm256_srli_epi64(a, s)
+#define q_vec_slli64(a, s)	_mm256_slli_epi64(a, s)
+#define q_vec_srl64(a, s)	_mm256_srl_epi64(a, _mm_cvtsi32_si128(s))
+#define q_vec_slli32(a, s)	_mm256_slli_epi32(a, s)
+#define q_vec_srai32(a, s)	_mm256_srai_epi32(a, s)
+#define q_vec_cmpgt64(a, b)	_mm256_cmpgt_epi64(a, b)
+#define q_vec_blendv(a, b, m)	_mm256_blendv_epi8(a, b, m)
+#define q_vec_blend16(a, b, m)	_mm256_blend_epi16(a, b, m)
+#define q_vec_min32(a, b)	_mm256_min_epi32(a, b)
+#define q_vec_max32(a, b)	_mm256_max_epi32(a, b)
+
+static inline q_vec q_vec_load_s32(const int32_t *p)
+{
+	return _mm256_loadu_si256((const __m256i *)p);
+}
+
+static inline void q_vec_store_s32(int32_t *p, q_vec v)
+{
+	_mm256_storeu_si256((__m256i *)p, v);
+}
+
+static inline q_vec q_vec_load_s16(const int16_t *p)
+{
+	return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)p));
+}
+
+static inline void q_vec_store_s16(int16_t *p, q_vec v)
+{
+	/* pack saturates within 128 bit halves, put the halves in order */
+	v = _mm256_permute4x64_epi64(_mm256_packs_epi32(v, v), 0xd8);
+	_mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(v));
+}
+
+static inline int64_t q_vec_hsum64(q_vec v)
+{
+	__m128i s = _mm_add_epi64(_mm256_castsi256_si128(v),
+				  _mm256_extracti128_si256(v, 1));
+
+	return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+}
+
+#else
+
+#define Q_VEC_LANES	4
+
+#define q_vec		__m128i
+
+#define q_vec_zero()		_mm_setzero_si128()
+#define q_vec_set1(x)		_mm_set1_epi32(x)
+#define q_vec_set1_64(x)	_mm_set1_epi64x(x)
+#define q_vec_add64(a, b)	_mm_add_epi64(a, b)
+#define q_vec_xor(a, b)		_mm_xor_si128(a, b)
+#define q_vec_mul(a, b)		_mm_mul_epi32(a, b)
+#define q_vec_srli64(a, s)	_mm_srli_epi64(a, s)
+#define q_vec_slli64(a, s)	_mm_slli_epi64(a, s)
+#define q_vec_srl64(a, s)	_mm_srl_epi64(a, _mm_cvtsi32_si128(s))
+#define q_vec_slli32(a, s)	_mm_slli_epi32(a, s)
+#define q_vec_srai32(a, s)	_mm_srai_epi32(a, s)
+#define q_vec_cmpgt64(a, b)	_mm_cmpgt_epi64(a, b)
+#define q_vec_blendv(a, b, m)	_mm_blendv_epi8(a, b, m)
+#define q_vec_blend16(a, b, m)	_mm_blend_epi16(a, b, m)
+#define q_vec_min32(a, b)	_mm_min_epi32(a, b)
+#define q_vec_max32(a, b)	_mm_max_epi32(a, b)
+
+static inline q_vec q_vec_load_s32(const int32_t *p)
+{
+	return _mm_loadu_si128((const __m128i *)p);
+}
+
+static inline void q_vec_store_s32(int32_t *p, q_vec v)
+{
+	_mm_storeu_si128((__m128i *)p, v);
+}
+
+static inline q_vec q_vec_load_s16(const int16_t *p)
+{
+	return _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)p));
+}
+
+static inline void q_vec_store_s16(int16_t *p, q_vec v)
+{
+	_mm_storel_epi64((__m128i *)p, _mm_packs_epi32(v, v));
+}
+
+static inline int64_t q_vec_hsum64(q_vec v)
+{
+	return _mm_cvtsi128_si64(v) + _mm_extract_epi64(v, 1);
+}
+
+#endif
+
+/* 64 bit products of the even and the odd 32 bit lanes */
+static inline void q_vec_mul_32x32(q_vec x, q_vec y, q_vec *even, q_vec *odd)
+{
+	*even = q_vec_mul(x, y);
+	*odd = q_vec_mul(q_vec_srli64(x, 32), q_vec_srli64(y, 32));
+}
+
+/* Multiply and accumulate to 64 bit even and odd lane accumulators */
+static inline void q_vec_mac_32x32(q_vec *even, q_vec *odd, q_vec x, q_vec y)
+{
+	q_vec pe;
+	q_vec po;
+
+	q_vec_mul_32x32(x, y, &pe, &po);
+	*even = q_vec_add64(*even, pe);
+	*odd = q_vec_add64(*odd, po);
+}
+
+/* Arithmetic right shift of 64 bit lanes */
+static inline q_vec q_vec_sra64(q_vec x, int shift)
+{
+	q_vec sign = q_vec_cmpgt64(q_vec_zero(), x);
+
+	return q_vec_xor(q_vec_srl64(q_vec_xor(x, sign), shift), sign);
+}
+
+/* Saturate 64 bit lanes to 32 bit range */
+static inline q_vec q_vec_sat32_64(q_vec x)
+{
+	const q_vec max = q_vec_set1_64(INT32_MAX);
+	const q_vec min = q_vec_set1_64(INT32_MIN);
+
+	x = q_vec_blendv(x, max, q_vec_cmpgt64(x, max));
+	return q_vec_blendv(x, min, q_vec_cmpgt64(min, x));
+}
+
+/* Merge low 32 bits of even and odd 64 bit lanes back to 32 bit lanes */
+static inline q_vec q_vec_merge64(q_vec even, q_vec odd)
+{
+	return q_vec_blend16(even, q_vec_slli64(odd, 32), 0xcc);
+}
+
+/* Same as q_multsr_sat_32x32() for every lane */
+static inline q_vec q_vec_multsr_sat_32x32(q_vec x, q_vec y, const int shift)
+{
+	const q_vec rnd = q_vec_set1_64((int64_t)1 << (shift - 1));
+	q_vec pe;
+	q_vec po;
+
+	q_vec_mul_32x32(x, y, &pe, &po);
+	pe = q_vec_sat32_64(q_vec_sra64(q_vec_add64(pe, rnd), shift));
+	po = q_vec_sat32_64(q_vec_sra64(q_vec_add64(po, rnd), shift));
+	return q_vec_merge64(pe, po);
+}
+
+/* Rounded product truncated to 32 bits like the argument of sat_int24()
+ * and sat_int16() in q_multsr_sat_32x32_24() and q_multsr_sat_32x32_16().
+ * The low 32 bits don't depend on the sign fill for shift <= 32.
+ */
+static inline q_vec q_vec_multsr_32x32(q_vec x, q_vec y, const int shift)
+{
+	const q_vec rnd = q_vec_set1_64((int64_t)1 << (shift - 1));
+	q_vec pe;
+	q_vec po;
+
+	q_vec_mul_32x32(x, y, &pe, &po);
+	pe = q_vec_srl64(q_vec_add64(pe, rnd), shift);
+	po = q_vec_srl64(q_vec_add64(po, rnd), shift);
+	return q_vec_merge64(pe, po);
+}
+
+/* Same as sat_int24() for every lane */
+static inline q_vec q_vec_sat24(q_vec x)
+{
+	x = q_vec_min32(x, q_vec_set1(INT24_MAXVALUE));
+	return q_vec_max32(x, q_vec_set1(INT24_MINVALUE));
+}
+
+/* Same as sign_extend_s24() for every lane */
+static inline q_vec q_vec_sign_extend_s24(q_vec x)
+{
+	return q_vec_srai32(q_vec_slli32(x, 8), 8);
+}
+
+#endif /* __SSE4_2__ */
+
+#endif
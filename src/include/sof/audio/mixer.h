@@ -31,6 +31,19 @@
 #ifndef __INCLUDE_AUDIO_MIXER_H__
 #define __INCLUDE_AUDIO_MIXER_H__
 
+#include <stdint.h>
+#include <sof/audio/component.h>
+
+/* mix count source streams to one sink stream */
+typedef void (*mixer_func)(struct comp_dev *dev, struct comp_buffer *sink,
+			   struct comp_buffer **sources, uint32_t count,
+			   uint32_t frames);
+
+/* mixer component private data */
+struct mixer_data {
+	mixer_func mix_func;	/* mix function for the stream format */
+};
+
 #ifdef UNIT_TEST
 void sys_comp_mixer_init(void);
 #endif
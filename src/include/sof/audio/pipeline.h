@@ -40,6 +40,7 @@
 #include <sof/audio/component.h>
 #include <sof/trace.h>
 #include <sof/schedule.h>
+#include <sof/perf.h>
 #include <uapi/ipc/topology.h>
 
 /*
@@ -88,6 +89,77 @@ struct ipc;
 #define PPL_DIR_DOWNSTREAM	0
 #define PPL_DIR_UPSTREAM	1
 
+/* share of core cycles pipelines can commit, the rest is left for IPC,
+ * low latency work and load estimate error
+ */
+#define PPL_LOAD_MAX_PERCENT	90
+
+/* periods a pipeline task must run before its load is calibrated */
+#define PPL_LOAD_CALIB_PERIODS	64
+
+/* scratch block size used by fused copy of simple components */
+#define PPL_FUSED_BLOCK_BYTES	2048
+
+/*
+ * Precompiled copy list entry. Entries are stored in the order the
+ * components must be copied, skip points to the first entry after the
+ * component's branch, so a path stop can leave the branch without a walk.
+ * Adjacent simple components are fused, the first entry of the chain keeps
+ * number of fused entries and the whole chain is processed block by block
+ * over a scratch buffer without updating the intermediate buffers.
+ */
+struct pipeline_copy_entry {
+	struct comp_dev *comp;			/* component to copy */
+	int (*copy)(struct comp_dev *dev);	/* component copy operation */
+	uint32_t skip;				/* next entry on path stop */
+	uint32_t fused;				/* entries in fused chain */
+};
+
+/* control update applied to a component of the pipeline */
+struct pipeline_ctrl_update {
+	struct comp_dev *dev;			/* component to update */
+	int cmd;				/* COMP_CMD_SET_VALUE or DATA */
+	uint32_t offset;			/* control data offset */
+};
+
+/*
+ * Bulk control update. The update array is followed by the control data in
+ * the same allocation. Queued bulks of an active pipeline are applied
+ * together by the pipeline task before the next period is copied.
+ */
+struct pipeline_ctrl_bulk {
+	struct pipeline_ctrl_bulk *next;	/* next queued bulk */
+	uint32_t size;				/* bulk size in bytes */
+	uint32_t count;				/* number of updates */
+	struct pipeline_ctrl_update update[];
+};
+
+/* periods run before DAI clock drift is estimated */
+#define PPL_TELEMETRY_DRIFT_PERIODS	16
+
+/* drift estimate smoothing factor is 1 / 2 ^ shift */
+#define PPL_TELEMETRY_DRIFT_SHIFT	3
+
+/*
+ * Stream telemetry updated every pipeline period. Latency is the audio
+ * queued in all buffers copied by the pipeline task and drift compares
+ * the DAI position advance with the wallclock since the drift baseline,
+ * which is taken again when xrun recovery restarts the positions.
+ */
+struct pipeline_telemetry {
+	uint32_t count;			/* periods since params */
+	uint32_t drift_count;		/* periods since DAI started moving */
+	uint64_t host_posn;		/* host position in bytes */
+	uint64_t dai_posn;		/* DAI position in bytes */
+	uint64_t wallclock;		/* wallclock ticks since baseline */
+	uint64_t wallclock_start;	/* wallclock at drift baseline */
+	uint64_t dai_posn_start;	/* DAI position at drift baseline */
+	uint32_t latency;		/* queued audio in us */
+	uint32_t latency_min;		/* minimum queued audio in us */
+	uint32_t latency_max;		/* maximum queued audio in us */
+	int32_t drift;			/* smoothed DAI clock drift in ppm */
+};
+
 /*
  * Audio pipeline.
  */
@@ -97,6 +169,9 @@ struct pipeline {
 
 	/* runtime status */
 	int32_t xrun_bytes;		/* last xrun length */
+	uint32_t xrun_conceal_us;	/* xruns concealed in a row in us */
+	bool xrun_concealed;		/* xrun concealed since last task */
+	bool xrun_conceal_dma;		/* DMA xrun left to the task */
 	uint32_t status;		/* pipeline status */
 	bool preload;			/* is pipeline preload needed */
 
@@ -105,6 +180,27 @@ struct pipeline {
 	struct comp_dev *sched_comp;	/* component that drives scheduling in this pipe */
 	struct comp_dev *source_comp;	/* source component for this pipe */
 	struct comp_dev *sink_comp;	/* sink component for this pipe */
+	uint32_t batch_periods;		/* periods per copy for deep buffer */
+
+	/* precompiled copy list, rebuilt on component state changes */
+	struct pipeline_copy_entry *copy_list;	/* copy list entries */
+	uint32_t copy_count;		/* number of used entries */
+	uint32_t copy_size;		/* number of allocated entries */
+	bool copy_list_valid;		/* copy list matches comps state */
+	bool copy_list_preload;		/* copy list built for preload */
+	bool copy_xcore;		/* copy list has cross-core buffers */
+	void *fused_block;		/* scratch block for fused copy */
+
+	/* load accounting */
+	struct perf_cnt perf;		/* pipeline task cycles per period */
+	uint32_t load;			/* committed task cycles per ms */
+	uint32_t load_calib;		/* measured task cycles per ms */
+
+	/* stream telemetry */
+	struct pipeline_telemetry telemetry;
+
+	/* bulk control updates for the next period */
+	struct pipeline_ctrl_bulk *ctrl_bulk;
 
 	/* position update */
 	uint32_t posn_offset;		/* position update array offset*/
@@ -126,6 +222,27 @@ static inline bool pipeline_is_preload(struct pipeline *p)
 	return p->preload;
 }
 
+/* marks precompiled copy list as outdated */
+static inline void pipeline_copy_list_invalidate(struct pipeline *p)
+{
+	p->copy_list_valid = false;
+}
+
+/* pipeline scheduling period in us, deep buffer batches several periods */
+static inline uint64_t pipeline_period(struct pipeline *p)
+{
+	return (uint64_t)p->ipc_pipe.period * p->batch_periods;
+}
+
+/* topology load estimate in cycles per ms, period_mips is per period */
+static inline uint32_t pipeline_load_estimate(struct pipeline *p)
+{
+	if (!p->ipc_pipe.period)
+		return 0;
+
+	return (uint64_t)p->ipc_pipe.period_mips * 1000 / p->ipc_pipe.period;
+}
+
 /* checks if pipeline is scheduled with timer */
 static inline bool pipeline_is_timer_driven(struct pipeline *p)
 {
@@ -165,6 +282,15 @@ void pipeline_cache(struct pipeline *p, struct comp_dev *dev, int cmd);
 /* trigger pipeline - atomic */
 int pipeline_trigger(struct pipeline *p, struct comp_dev *host_cd, int cmd);
 
+/* apply bulk control updates now or queue them for the next period,
+ * takes ownership of the bulk
+ */
+int pipeline_ctrl_bulk_queue(struct pipeline *p,
+			     struct pipeline_ctrl_bulk *bulk);
+
+/* apply and free queued bulk control updates */
+void pipeline_ctrl_bulk_apply(struct pipeline *p);
+
 /* static pipeline creation */
 int init_static_pipeline(struct ipc *ipc);
 
@@ -180,9 +306,28 @@ void pipeline_schedule_cancel(struct pipeline *p);
 void pipeline_get_timestamp(struct pipeline *p, struct comp_dev *host_dev,
 			    struct sof_ipc_stream_posn *posn);
 
+/* get stream telemetry wallclock rate in Hz */
+uint64_t pipeline_wallclock_hz(void);
+
+/* checks if buffer is copied by the pipeline task */
+bool pipeline_is_stream_buffer(struct pipeline *p,
+			       struct comp_buffer *buffer);
+
+/* get audio queued in buffer in us */
+uint32_t pipeline_buffer_latency(struct comp_buffer *buffer);
+
 void pipeline_schedule(void *arg);
 
+/* notify pipelines that component state was changed outside of
+ * pipeline trigger, prepare or reset
+ */
+void pipeline_comp_state_changed(struct comp_dev *dev);
+
 /* notify host that we have XRUN */
 void pipeline_xrun(struct pipeline *p, struct comp_dev *dev, int32_t bytes);
 
+/* conceal a short xrun of bytes at buffer, returns false if over limit */
+bool pipeline_xrun_conceal(struct pipeline *p, struct comp_buffer *buffer,
+			   uint32_t bytes, bool underrun);
+
 #endif
@@ -37,6 +37,10 @@
 #ifndef __INCLUDE_IDC_H__
 #define __INCLUDE_IDC_H__
 
+#include <stdint.h>
+#include <platform/platform.h>
+#include <sof/lock.h>
+#include <sof/platform.h>
 #include <sof/schedule.h>
 #include <sof/trace.h>
 
@@ -61,6 +65,12 @@
 /** \brief IDC task deadline. */
 #define IDC_DEADLINE	100
 
+/** \brief Number of queued messages per core pair, power of 2. */
+#define IDC_RING_SIZE	8
+
+/** \brief Max payload bytes copied with a queued message. */
+#define IDC_MSG_DATA_SIZE	48
+
 /** \brief ROM wake version parsed by ROM during core wake up. */
 #define IDC_ROM_WAKE_VERSION	0x2
 
@@ -98,6 +108,14 @@
 #define IDC_MSG_NOTIFY		IDC_TYPE(0x5)
 #define IDC_MSG_NOTIFY_EXT	IDC_EXTENSION(0x0)
 
+/** \brief IDC doorbell for messages queued in the core pair ring. */
+#define IDC_MSG_RING		IDC_TYPE(0x6)
+#define IDC_MSG_RING_EXT	IDC_EXTENSION(0x0)
+
+/** \brief IDC bulk control update message. */
+#define IDC_MSG_CTRL_BULK	IDC_TYPE(0x7)
+#define IDC_MSG_CTRL_BULK_EXT	IDC_EXTENSION(0x0)
+
 /** \brief Decodes IDC message type. */
 #define iTS(x)	(((x) >> IDC_TYPE_SHIFT) & IDC_TYPE_MASK)
 
@@ -106,6 +124,41 @@ struct idc_msg {
 	uint32_t header;	/**< header value */
 	uint32_t extension;	/**< extension value */
 	uint32_t core;		/**< core id */
+	void *data;		/**< payload copied with the message */
+	uint32_t data_size;	/**< payload size, up to IDC_MSG_DATA_SIZE */
+
+	/** completion callback of non-blocking message, run by the sender */
+	void (*cb)(void *cb_data, int ret);
+	void *cb_data;		/**< completion callback data */
+};
+
+/** \brief Queued IDC message, owned by the receiver until completed. */
+struct idc_ring_slot {
+	uint32_t header;			/**< header value */
+	uint32_t extension;			/**< extension value */
+	int32_t ret;				/**< result set by receiver */
+	uint32_t data_size;			/**< payload size */
+	uint8_t data[IDC_MSG_DATA_SIZE];	/**< payload */
+} __attribute__ ((__aligned__(PLATFORM_DCACHE_ALIGN)));
+
+/**
+ * \brief Single producer single consumer message ring of one core pair.
+ *
+ * Sender only writes head and receiver only writes tail, both free running
+ * and kept in separate cache lines, so no lock is shared between the cores.
+ */
+struct idc_ring {
+	uint32_t head	/**< next slot to be queued by the sender */
+		__attribute__ ((__aligned__(PLATFORM_DCACHE_ALIGN)));
+	uint32_t tail	/**< next slot to be completed by the receiver */
+		__attribute__ ((__aligned__(PLATFORM_DCACHE_ALIGN)));
+	struct idc_ring_slot slots[IDC_RING_SIZE];	/**< queued messages */
+};
+
+/** \brief Completion callback of a queued message. */
+struct idc_ring_cb {
+	void (*cb)(void *cb_data, int ret);	/**< callback */
+	void *cb_data;				/**< callback data */
 };
 
 /** \brief IDC data. */
@@ -115,6 +168,12 @@ struct idc {
 	uint32_t done_bit_mask;		/**< done interrupt mask */
 	struct idc_msg received_msg;	/**< received message */
 	struct task idc_task;		/**< IDC processing task */
+
+	/** completed messages sent to each core */
+	uint32_t ring_done[PLATFORM_CORE_COUNT];
+
+	/** completion callbacks of messages sent to each core */
+	struct idc_ring_cb ring_cb[PLATFORM_CORE_COUNT][IDC_RING_SIZE];
 };
 
 #endif
@@ -103,6 +103,12 @@ struct ipc_shared_context {
 	struct ipc_msg message[MSG_QUEUE_SIZE];
 
 	struct list_item comp_list;	/* list of component devices */
+
+	/* stream notification counts per posn_map slot, bumped lock-free by
+	 * the stream core and coalesced into one message by the master core
+	 */
+	uint32_t posn_seq[PLATFORM_MAX_STREAMS];
+	uint32_t xrun_seq[PLATFORM_MAX_STREAMS];
 };
 
 struct ipc {
@@ -119,9 +125,17 @@ struct ipc {
 	/* mmap for posn_offset */
 	struct pipeline *posn_map[PLATFORM_MAX_STREAMS];
 
+	/* stream notification counts already sent to host */
+	uint32_t posn_sent[PLATFORM_MAX_STREAMS];
+	uint32_t xrun_sent[PLATFORM_MAX_STREAMS];
+
 	/* context shared between cores */
 	struct ipc_shared_context *shared_ctx;
 
+	/* audio memory pool of static pipeline buffers */
+	void *buffer_pool;
+	uint32_t buffer_pool_users;
+
 	/* processing task */
 	struct task ipc_task;
 
@@ -162,6 +176,9 @@ int ipc_parse_page_descriptors(uint8_t *page_table,
 			       uint32_t direction);
 int ipc_get_page_descriptors(struct dma *dmac, uint8_t *page_table,
 			     struct sof_ipc_host_buffer *ring);
+int ipc_get_host_data(struct dma *dmac, uint8_t *page_table,
+		      struct sof_ipc_host_buffer *ring, void *data,
+		      uint32_t size);
 
 /*
  * IPC Component creation and destruction.
@@ -173,6 +190,8 @@ int ipc_comp_free(struct ipc *ipc, uint32_t comp_id);
  * IPC Buffer creation and destruction.
  */
 int ipc_buffer_new(struct ipc *ipc, struct sof_ipc_buffer *buffer);
+int ipc_buffer_new_pool(struct ipc *ipc, struct sof_ipc_buffer *buffer,
+			void *pool);
 int ipc_buffer_free(struct ipc *ipc, uint32_t buffer_id);
 
 /*
@@ -182,6 +201,12 @@ int ipc_pipeline_new(struct ipc *ipc, struct sof_ipc_pipe_new *pipeline);
 int ipc_pipeline_free(struct ipc *ipc, uint32_t comp_id);
 int ipc_pipeline_complete(struct ipc *ipc, uint32_t comp_id);
 
+/*
+ * Pipeline load admission, commit on stream open and release after reset.
+ */
+int ipc_pipeline_load_commit(struct ipc *ipc, struct pipeline *p);
+void ipc_pipeline_load_release(struct ipc *ipc);
+
 /*
  * Pipeline component and buffer connections.
  */
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __INCLUDE_LZ__
+#define __INCLUDE_LZ__
+
+#include <stdint.h>
+
+/*
+ * Streaming decoder for LZ compressed firmware segments.
+ *
+ * The stream is a sequence of LZ4 style blocks. Each block starts with a
+ * token whose high nibble is the literal count and low nibble the match
+ * length minus LZ_MIN_MATCH. A nibble of 15 is extended by following bytes
+ * that are added until one is not 255. The literals follow the literal
+ * count, then a 16 bit little endian match offset back into the already
+ * decoded data and the match length extension. The last block has
+ * literals only and ends exactly at the end of the decoded data.
+ *
+ * The decoded data is both the output and the match window, so the
+ * destination must be the whole segment. Input can be fed in any pieces
+ * and output is produced in chunks of at most max_out bytes per call.
+ */
+
+#define LZ_MIN_MATCH		4
+#define LZ_MAX_OFFSET		65535
+#define LZ_NIBBLE_MAX		15
+#define LZ_EXT_MAX		255
+
+/* decoder state */
+#define LZ_STATE_TOKEN		0
+#define LZ_STATE_LIT_EXT	1
+#define LZ_STATE_LITERAL	2
+#define LZ_STATE_OFFSET_LO	3
+#define LZ_STATE_OFFSET_HI	4
+#define LZ_STATE_MATCH_EXT	5
+#define LZ_STATE_MATCH		6
+#define LZ_STATE_DONE		7
+
+struct lz_dec {
+	uint8_t *out;		/* start of the decoded segment */
+	uint32_t out_size;	/* decoded segment size */
+	uint32_t out_pos;	/* bytes decoded so far */
+	uint32_t lit_len;	/* literals left in current block */
+	uint32_t match_len;	/* match bytes left in current block */
+	uint32_t offset;	/* current match offset */
+	uint32_t state;		/* LZ_STATE_ */
+	uint32_t ext;		/* current nibble needs extension bytes */
+};
+
+void lz_dec_init(struct lz_dec *dec, void *out, uint32_t out_size);
+
+/*
+ * Decode from in_size bytes of input, producing at most max_out bytes.
+ * The number of input bytes used is returned in in_used. Returns the
+ * number of bytes decoded or -EINVAL for a corrupt stream.
+ */
+int lz_dec_run(struct lz_dec *dec, const void *in, uint32_t in_size,
+	       uint32_t *in_used, uint32_t max_out);
+
+/* the whole segment has been decoded */
+static inline int lz_dec_done(struct lz_dec *dec)
+{
+	return dec->state == LZ_STATE_DONE;
+}
+
+#endif
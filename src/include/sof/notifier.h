@@ -72,7 +72,7 @@ struct notify **arch_notify_get(void);
 void notifier_register(struct notifier *notifier);
 void notifier_unregister(struct notifier *notifier);
 
-void notifier_notify(void);
+void notifier_notify(struct notify_data *notify_data);
 void notifier_event(struct notify_data *notify_data);
 
 void init_system_notify(struct sof *sof);
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Performance counters - cycles spent by components and pipelines in
+ * every scheduling period. Counters are read by host through the trace
+ * IPC and by testbench, and can be used to size the DSP clock.
+ */
+
+#ifndef __INCLUDE_SOF_PERF_H__
+#define __INCLUDE_SOF_PERF_H__
+
+#include <arch/timer.h>
+#include <stdint.h>
+
+/* histogram bin n counts periods taking < 2 ^ (n + PERF_HIST_SHIFT)
+ * cycles, the last bin counts all longer periods
+ */
+#define PERF_HIST_BINS		16
+#define PERF_HIST_SHIFT		10
+
+struct perf_cnt {
+	uint32_t count;		/* measured periods */
+	uint32_t last;		/* cycles in last period */
+	uint32_t min;		/* minimum cycles per period */
+	uint32_t max;		/* maximum cycles per period */
+	uint64_t total;		/* cycles in all periods */
+	uint32_t acc;		/* cycles accumulated in current period */
+	uint32_t hist[PERF_HIST_BINS];
+};
+
+/* free running cycle counter */
+static inline uint32_t perf_cycles_get(void)
+{
+	return arch_timer_get_ccount();
+}
+
+static inline void perf_cnt_reset(struct perf_cnt *pc)
+{
+	uint32_t i;
+
+	pc->count = 0;
+	pc->last = 0;
+	pc->min = 0;
+	pc->max = 0;
+	pc->total = 0;
+	pc->acc = 0;
+
+	for (i = 0; i < PERF_HIST_BINS; i++)
+		pc->hist[i] = 0;
+}
+
+/* account cycles of one period */
+static inline void perf_cnt_update(struct perf_cnt *pc, uint32_t cycles)
+{
+	uint32_t bin = 0;
+	uint32_t c = cycles >> PERF_HIST_SHIFT;
+
+	while (c && bin < PERF_HIST_BINS - 1) {
+		c >>= 1;
+		bin++;
+	}
+
+	if (!pc->count || cycles < pc->min)
+		pc->min = cycles;
+	if (cycles > pc->max)
+		pc->max = cycles;
+
+	pc->last = cycles;
+	pc->total += cycles;
+	pc->count++;
+	pc->hist[bin]++;
+}
+
+/* account cycles accumulated with several measurements in one period */
+static inline void perf_cnt_commit(struct perf_cnt *pc)
+{
+	perf_cnt_update(pc, pc->acc);
+	pc->acc = 0;
+}
+
+static inline uint32_t perf_cnt_avg(struct perf_cnt *pc)
+{
+	return pc->count ? pc->total / pc->count : 0;
+}
+
+#endif
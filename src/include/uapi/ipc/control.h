@@ -41,6 +41,7 @@
 
 #include <uapi/user/header.h>
 #include <uapi/ipc/header.h>
+#include <uapi/ipc/stream.h>
 
 /** \addtogroup sof_uapi_control uAPI Control
  *  SOF uAPI specification - component controls.
@@ -198,6 +199,27 @@ struct sof_ipc_comp_event {
 	};
 } __attribute__((packed));
 
+/**
+ * Bulk control update - SOF_IPC_COMP_SET_BULK.
+ *
+ * Carries set updates of many controls, each one a struct sof_ipc_ctrl_data
+ * of rhdr.hdr.size bytes padded to 4 bytes. The updates follow this header
+ * or are DMAed from the host buffer if buffer.pages is not zero, so large
+ * binary data needs no mailbox sized fragments. All updates of a pipeline
+ * are applied together at one period boundary.
+ */
+struct sof_ipc_ctrl_bulk {
+	struct sof_ipc_cmd_hdr hdr;
+	uint32_t num_ctrls;	/**< number of control updates */
+	uint32_t size;		/**< bytes of all control updates */
+
+	/* control updates DMAed from host if pages is not zero */
+	struct sof_ipc_host_buffer buffer;
+
+	/* reserved for future use */
+	uint32_t reserved[4];
+} __attribute__((packed));
+
 /** @}*/
 
 /** @}*/
@@ -134,6 +134,7 @@
 #define SOF_IPC_COMP_SET_DATA			SOF_CMD_TYPE(0x003)
 #define SOF_IPC_COMP_GET_DATA			SOF_CMD_TYPE(0x004)
 #define SOF_IPC_COMP_NOTIFICATION		SOF_CMD_TYPE(0x005)
+#define SOF_IPC_COMP_SET_BULK			SOF_CMD_TYPE(0x006)
 
 /** @} */
 
@@ -158,6 +159,7 @@
 #define SOF_IPC_STREAM_TRIG_DRAIN		SOF_CMD_TYPE(0x008)
 #define SOF_IPC_STREAM_TRIG_XRUN		SOF_CMD_TYPE(0x009)
 #define SOF_IPC_STREAM_POSITION			SOF_CMD_TYPE(0x00a)
+#define SOF_IPC_STREAM_POSITIONS		SOF_CMD_TYPE(0x00b)
 #define SOF_IPC_STREAM_VORBIS_PARAMS		SOF_CMD_TYPE(0x010)
 #define SOF_IPC_STREAM_VORBIS_FREE		SOF_CMD_TYPE(0x011)
 
@@ -169,6 +171,8 @@
 
 #define SOF_IPC_TRACE_DMA_PARAMS		SOF_CMD_TYPE(0x001)
 #define SOF_IPC_TRACE_DMA_POSITION		SOF_CMD_TYPE(0x002)
+#define SOF_IPC_TRACE_PERF_COUNTERS		SOF_CMD_TYPE(0x003)
+#define SOF_IPC_TRACE_STREAM_TELEMETRY		SOF_CMD_TYPE(0x004)
 
 /** @} */
 
@@ -175,4 +175,15 @@ struct sof_ipc_stream_posn {
 	int32_t xrun_size;	/**< XRUN size in bytes */
 } __attribute__((packed));
 
+/*
+ * Coalesced stream notification. Bit n is set for the stream using slot n
+ * of the stream mailbox region, at posn_offset / sizeof(struct
+ * sof_ipc_stream_posn). The slot holds the latest position or xrun.
+ */
+struct sof_ipc_stream_posn_batch {
+	struct sof_ipc_reply rhdr;
+	uint32_t posn_mask;	/**< streams with a new position */
+	uint32_t xrun_mask;	/**< streams with a new xrun */
+} __attribute__((packed));
+
 #endif
@@ -128,6 +128,7 @@ struct sof_ipc_comp_host {
 	uint32_t direction;	/**< SOF_IPC_STREAM_ */
 	uint32_t no_irq;	/**< don't send periodic IRQ to host/DSP */
 	uint32_t dmac_config; /**< DMA engine specific */
+	uint32_t deep_buffer;	/**< pipeline periods per copy, 0 is disabled */
 } __attribute__((packed));
 
 /* generic DAI component */
@@ -63,6 +63,74 @@ struct sof_ipc_dma_trace_posn {
 	uint32_t messages;	/* total trace messages */
 } __attribute__((packed));
 
+/*
+ * Performance counters
+ */
+
+#define SOF_IPC_PERF_HIST_BINS		16
+
+/* performance counters request - SOF_IPC_TRACE_PERF_COUNTERS */
+struct sof_ipc_perf_params {
+	struct sof_ipc_cmd_hdr hdr;
+	uint32_t comp_id;	/* component or pipeline id */
+	uint32_t reset;		/* clear counters after reading them */
+} __attribute__((packed));
+
+/* performance counters reply - SOF_IPC_TRACE_PERF_COUNTERS
+ * cycles are counted per pipeline period, histogram bin n counts periods
+ * taking less than 2 ^ (n + hist_shift) cycles
+ */
+struct sof_ipc_perf_counters {
+	struct sof_ipc_reply rhdr;
+	uint32_t comp_id;	/* component or pipeline id */
+	uint32_t core;		/* core running the pipeline */
+	uint32_t period;	/* pipeline period in us */
+	uint32_t ticks_per_msec; /* core clock ticks per ms */
+	uint32_t count;		/* measured periods */
+	uint32_t last;		/* cycles in last period */
+	uint32_t min;		/* minimum cycles per period */
+	uint32_t max;		/* maximum cycles per period */
+	uint32_t avg;		/* average cycles per period */
+	uint32_t hist_shift;	/* histogram first bin size shift */
+	uint32_t hist[SOF_IPC_PERF_HIST_BINS];
+} __attribute__((packed));
+
+/*
+ * Stream telemetry
+ */
+
+#define SOF_IPC_TELEMETRY_BUFFERS	8
+
+/* fill level of a buffer written by the pipeline, in bytes */
+struct sof_ipc_buffer_fill {
+	uint32_t comp_id;	/* buffer id */
+	uint32_t size;		/* buffer size */
+	uint32_t avail;		/* current fill level */
+	uint32_t min;		/* minimum fill level */
+	uint32_t max;		/* maximum fill level */
+} __attribute__((packed));
+
+/* stream telemetry reply - SOF_IPC_TRACE_STREAM_TELEMETRY
+ * request is struct sof_ipc_perf_params, drift is the DAI clock rate
+ * relative to the DSP wallclock in ppm. The drift baseline is taken when
+ * the DAI starts moving and again after xrun recovery.
+ */
+struct sof_ipc_stream_telemetry {
+	struct sof_ipc_reply rhdr;
+	uint32_t comp_id;	/* component or pipeline id */
+	uint32_t count;		/* measured periods */
+	uint64_t wallclock_hz;	/* wallclock rate */
+	uint64_t host_posn;	/* host position in bytes */
+	uint64_t dai_posn;	/* DAI position in bytes */
+	uint64_t wallclock;	/* wallclock ticks since drift baseline */
+	uint32_t latency;	/* audio queued in pipeline buffers in us */
+	uint32_t latency_min;	/* minimum latency in us */
+	uint32_t latency_max;	/* maximum latency in us */
+	int32_t drift_ppm;	/* DAI clock drift in ppm */
+	uint32_t num_buffers;	/* valid entries in buffers */
+	struct sof_ipc_buffer_fill buffers[SOF_IPC_TELEMETRY_BUFFERS];
+} __attribute__((packed));
+
 /*
  * Commom debug
  */
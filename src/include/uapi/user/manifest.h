@@ -73,13 +73,29 @@ union sof_man_segment_flags {
 		uint32_t readonly:1;
 		uint32_t code:1;
 		uint32_t data:1;
-		uint32_t _rsvd0:2;
+		uint32_t compressed:1;	/* file data is LZ compressed */
+		uint32_t _rsvd0:1;
 		uint32_t type:4;	/* MAN_SEGMENT_ */
 		uint32_t _rsvd1:4;
 		uint32_t length:16;	/* of segment in pages */
 	} r;
 } __attribute__((packed));
 
+/* compressed segment header magic "$LZ1" */
+#define SOF_MAN_LZ_MAGIC		0x315a4c24
+
+/*
+ * Header in front of the file data of a compressed segment. The decoded
+ * data fills the segment length in pages. Not used by ROM, so only
+ * segments of modules loaded by the boot loader can be compressed.
+ */
+struct sof_man_lz_header {
+	uint32_t magic;		/* SOF_MAN_LZ_MAGIC */
+	uint32_t size;		/* compressed bytes following the header */
+	uint32_t data_size;	/* decoded bytes */
+	uint32_t reserved;
+};
+
 /*
  * Module segment descriptor. Used by ROM - Immutable.
  */
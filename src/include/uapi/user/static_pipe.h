@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file include/uapi/user/static_pipe.h
+ * \brief Static pipeline blob generated from topology
+ */
+
+#ifndef __INCLUDE_UAPI_USER_STATIC_PIPE_H__
+#define __INCLUDE_UAPI_USER_STATIC_PIPE_H__
+
+#include <stdint.h>
+#include <uapi/ipc/topology.h>
+
+#define SOF_STATIC_PIPE_MAGIC	0x50495053	/**< 'S', 'P', 'I', 'P' */
+
+/** \brief Alignment of buffers in the audio pool, largest DSP cache line */
+#define SOF_STATIC_PIPE_ALIGN	64
+
+/* record types, records are created in blob order */
+#define SOF_STATIC_PIPE_COMP		0 /**< struct sof_ipc_comp_* */
+#define SOF_STATIC_PIPE_BUFFER		1 /**< struct sof_static_pipe_buffer */
+#define SOF_STATIC_PIPE_PIPELINE	2 /**< struct sof_ipc_pipe_new */
+#define SOF_STATIC_PIPE_CONNECT		3 /**< sof_ipc_pipe_comp_connect */
+#define SOF_STATIC_PIPE_COMPLETE	4 /**< uint32_t pipeline comp id */
+
+/**
+ * \brief Static pipeline blob header.
+ *
+ * Records follow the header. Buffer sizes and their offsets in one audio
+ * pool are computed by the generator so the firmware creates the
+ * pipelines with a single audio memory allocation and no IPC.
+ */
+struct sof_static_pipe_hdr {
+	uint32_t magic;		/**< SOF_STATIC_PIPE_MAGIC */
+	uint32_t abi;		/**< SOF ABI version of the records */
+	uint32_t size;		/**< size in bytes of records excl. header */
+	uint32_t num_records;	/**< number of records */
+	uint32_t pool_size;	/**< audio memory bytes of all buffers */
+	uint32_t pool_caps;	/**< SOF_MEM_CAPS_ of all buffers */
+	uint32_t reserved[2];	/**< reserved for future use */
+} __attribute__((packed));
+
+/** \brief Record header, data is padded to a multiple of 4 bytes */
+struct sof_static_pipe_rec {
+	uint32_t type;		/**< SOF_STATIC_PIPE_ */
+	uint32_t size;		/**< size in bytes of data excl. this struct */
+	uint32_t data[0];	/**< record data */
+} __attribute__((packed));
+
+/** \brief Buffer record with its offset in the audio pool */
+struct sof_static_pipe_buffer {
+	uint32_t offset;	/**< bytes from pool start */
+	struct sof_ipc_buffer buffer;
+} __attribute__((packed));
+
+#endif
@@ -69,6 +69,7 @@
 #define SOF_TKN_SCHED_CORE			203
 #define SOF_TKN_SCHED_FRAMES			204
 #define SOF_TKN_SCHED_TIMER			205
+#define SOF_TKN_SCHED_XRUN_LIMIT		206
 
 /* volume */
 #define SOF_TKN_VOLUME_RAMP_STEP_TYPE		250
@@ -80,6 +81,7 @@
 
 /* PCM */
 #define SOF_TKN_PCM_DMAC_CONFIG			353
+#define SOF_TKN_PCM_DEEP_BUFFER			354
 
 /* Generic components */
 #define SOF_TKN_COMP_PERIOD_SINK_COUNT		400
@@ -57,12 +57,16 @@
 #include <sof/audio/component.h>
 #include <sof/audio/pipeline.h>
 #include <sof/drivers/timer.h>
+#include <sof/clk.h>
+#include <sof/perf.h>
+#include <platform/clk.h>
 #include <uapi/ipc/header.h>
 #include <uapi/ipc/pm.h>
 #include <uapi/ipc/stream.h>
 #include <uapi/ipc/topology.h>
 #include <uapi/ipc/pm.h>
 #include <uapi/ipc/control.h>
+#include <uapi/ipc/trace.h>
 #include <sof/dma-trace.h>
 #include <sof/cpu.h>
 #include <sof/idc.h>
@@ -309,6 +313,15 @@ static int ipc_stream_pcm_params(uint32_t stream)
 pipe_params:
 #endif
 
+	/* commit pipeline load, fails if no core has the capacity */
+	err = ipc_pipeline_load_commit(_ipc, pcm_dev->cd->pipeline);
+	if (err < 0) {
+		trace_ipc_error("ipc: pipe %d comp %d load commit failed %d",
+				pcm_dev->cd->pipeline->ipc_pipe.pipeline_id,
+				pcm_params.comp_id, err);
+		goto error;
+	}
+
 	/* configure pipeline audio params */
 	err = pipeline_params(pcm_dev->cd->pipeline, pcm_dev->cd,
 			      (struct sof_ipc_pcm_params *)_ipc->comp_data);
@@ -354,6 +367,7 @@ error:
 		trace_ipc_error("ipc: pipe %d comp %d reset failed %d",
 				pcm_dev->cd->pipeline->ipc_pipe.pipeline_id,
 				pcm_params.comp_id, err);
+	ipc_pipeline_load_release(_ipc);
 	return -EINVAL;
 }
 
@@ -362,6 +376,7 @@ static int ipc_stream_pcm_free(uint32_t header)
 {
 	struct sof_ipc_stream free_req;
 	struct ipc_comp_dev *pcm_dev;
+	int ret;
 
 	/* copy message with ABI safe method */
 	IPC_COPY_CMD(free_req, _ipc->comp_data);
@@ -383,7 +398,12 @@ static int ipc_stream_pcm_free(uint32_t header)
 	}
 
 	/* reset the pipeline */
-	return pipeline_reset(pcm_dev->cd->pipeline, pcm_dev->cd);
+	ret = pipeline_reset(pcm_dev->cd->pipeline, pcm_dev->cd);
+
+	/* release load of tasks that no longer run */
+	ipc_pipeline_load_release(_ipc);
+
+	return ret;
 }
 
 /* get stream position */
@@ -423,6 +443,12 @@ static int ipc_stream_position(uint32_t header)
 	return 1;
 }
 
+/* stream mailbox slot of the pipeline */
+static inline uint32_t ipc_stream_posn_slot(struct pipeline *p)
+{
+	return p->posn_offset / sizeof(struct sof_ipc_stream_posn);
+}
+
 /* send stream position */
 int ipc_stream_send_position(struct comp_dev *cdev,
 	struct sof_ipc_stream_posn *posn)
@@ -433,8 +459,15 @@ int ipc_stream_send_position(struct comp_dev *cdev,
 	posn->comp_id = cdev->comp.id;
 
 	mailbox_stream_write(cdev->pipeline->posn_offset, posn, sizeof(*posn));
+
+#if CONFIG_IPC_POSITION_BATCH
+	/* host is told in the next coalesced message */
+	_ipc->shared_ctx->posn_seq[ipc_stream_posn_slot(cdev->pipeline)]++;
+	return 0;
+#else
 	return ipc_queue_host_message(_ipc, posn->rhdr.hdr.cmd, posn,
 				      sizeof(*posn), 0);
+#endif
 }
 
 /* send component notification */
@@ -462,8 +495,14 @@ int ipc_stream_send_xrun(struct comp_dev *cdev,
 	posn->comp_id = cdev->comp.id;
 
 	mailbox_stream_write(cdev->pipeline->posn_offset, posn, sizeof(*posn));
+
+#if CONFIG_IPC_POSITION_BATCH
+	_ipc->shared_ctx->xrun_seq[ipc_stream_posn_slot(cdev->pipeline)]++;
+	return 0;
+#else
 	return ipc_queue_host_message(_ipc, posn->rhdr.hdr.cmd, posn,
 				      sizeof(*posn), 0);
+#endif
 }
 
 static int ipc_stream_trigger(uint32_t header)
@@ -709,6 +748,193 @@ static int ipc_glb_pm_message(uint32_t header)
 	}
 }
 
+/*
+ * Performance counters IPC Operations.
+ */
+
+/* get component or pipeline cycles per period */
+static int ipc_perf_counters(uint32_t header)
+{
+	struct sof_ipc_perf_params params;
+	struct sof_ipc_perf_counters reply;
+	struct ipc_comp_dev *icd;
+	struct pipeline *p;
+	struct perf_cnt *pc;
+	uint32_t i;
+
+	STATIC_ASSERT(PERF_HIST_BINS == SOF_IPC_PERF_HIST_BINS,
+		      perf_hist_bins_mismatch);
+
+	/* copy message with ABI safe method */
+	IPC_COPY_CMD(params, _ipc->comp_data);
+
+	trace_ipc("ipc: comp %d -> perf counters", params.comp_id);
+
+	icd = ipc_get_comp(_ipc, params.comp_id);
+	if (!icd) {
+		trace_ipc_error("ipc: comp %d not found", params.comp_id);
+		return -ENODEV;
+	}
+
+	switch (icd->type) {
+	case COMP_TYPE_COMPONENT:
+		p = icd->cd->pipeline;
+		pc = &icd->cd->perf;
+		break;
+	case COMP_TYPE_PIPELINE:
+		p = icd->pipeline;
+		pc = &icd->pipeline->perf;
+		break;
+	default:
+		trace_ipc_error("ipc: comp %d has no perf counters",
+				params.comp_id);
+		return -EINVAL;
+	}
+
+	bzero(&reply, sizeof(reply));
+	reply.rhdr.hdr.cmd = header;
+	reply.rhdr.hdr.size = sizeof(reply);
+	reply.comp_id = params.comp_id;
+
+	/* components are not attached to pipeline until it is complete */
+	if (p) {
+		reply.core = p->ipc_pipe.core;
+		reply.period = pipeline_period(p);
+		reply.ticks_per_msec =
+			clock_ms_to_ticks(CLK_CPU(p->ipc_pipe.core), 1);
+	}
+
+	reply.count = pc->count;
+	reply.last = pc->last;
+	reply.min = pc->min;
+	reply.max = pc->max;
+	reply.avg = perf_cnt_avg(pc);
+	reply.hist_shift = PERF_HIST_SHIFT;
+	for (i = 0; i < PERF_HIST_BINS; i++)
+		reply.hist[i] = pc->hist[i];
+
+	if (params.reset)
+		perf_cnt_reset(pc);
+
+	mailbox_hostbox_write(0, &reply, sizeof(reply));
+
+	return 1;
+}
+
+/* get pipeline stream positions, latency and clock drift */
+static int ipc_stream_telemetry(uint32_t header)
+{
+	struct sof_ipc_perf_params params;
+	struct sof_ipc_stream_telemetry reply;
+	struct sof_ipc_buffer_fill *fill;
+	struct pipeline_telemetry *t;
+	struct ipc_comp_dev *icd;
+	struct comp_buffer *buffer;
+	struct list_item *clist;
+	struct pipeline *p;
+	bool remote;
+	uint32_t flags;
+
+	/* copy message with ABI safe method */
+	IPC_COPY_CMD(params, _ipc->comp_data);
+
+	trace_ipc("ipc: comp %d -> stream telemetry", params.comp_id);
+
+	icd = ipc_get_comp(_ipc, params.comp_id);
+	if (!icd) {
+		trace_ipc_error("ipc: comp %d not found", params.comp_id);
+		return -ENODEV;
+	}
+
+	switch (icd->type) {
+	case COMP_TYPE_COMPONENT:
+		p = icd->cd->pipeline;
+		break;
+	case COMP_TYPE_PIPELINE:
+		p = icd->pipeline;
+		break;
+	default:
+		p = NULL;
+		break;
+	}
+
+	/* telemetry is kept by the pipeline that runs the task */
+	if (p && p->sched_comp)
+		p = p->sched_comp->pipeline;
+
+	if (!p) {
+		trace_ipc_error("ipc: comp %d has no stream telemetry",
+				params.comp_id);
+		return -EINVAL;
+	}
+
+	t = &p->telemetry;
+	remote = p->ipc_pipe.core != cpu_get_id();
+
+	bzero(&reply, sizeof(reply));
+	reply.rhdr.hdr.cmd = header;
+	reply.rhdr.hdr.size = sizeof(reply);
+	reply.comp_id = params.comp_id;
+	reply.wallclock_hz = pipeline_wallclock_hz();
+
+	spin_lock_irq(&p->lock, flags);
+
+	/* pipeline task on other core writes telemetry in its cache */
+	if (remote)
+		dcache_invalidate_region(t, sizeof(*t));
+
+	reply.count = t->count;
+	reply.host_posn = t->host_posn;
+	reply.dai_posn = t->dai_posn;
+	reply.wallclock = t->wallclock;
+	reply.latency = t->latency;
+	reply.latency_min = t->latency_min;
+	reply.latency_max = t->latency_max;
+	reply.drift_ppm = t->drift;
+
+	/* measurement and buffer fill levels restart on the next period */
+	if (params.reset) {
+		bzero(t, sizeof(*t));
+		if (remote)
+			dcache_writeback_region(t, sizeof(*t));
+	}
+
+	spin_unlock_irq(&p->lock, flags);
+
+	/* report the buffers written by the pipeline task */
+	list_for_item(clist, &_ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_BUFFER)
+			continue;
+
+		buffer = icd->cb;
+		if (!pipeline_is_stream_buffer(p, buffer))
+			continue;
+
+		/* the pipeline task writes back the fill levels, cross-core
+		 * buffers keep their positions in sync
+		 */
+		if (remote && !buffer->xcore)
+			dcache_invalidate_region(buffer, sizeof(*buffer));
+		else if (remote)
+			dcache_invalidate_region(&buffer->avail_min,
+						 2 * sizeof(uint32_t));
+
+		if (reply.num_buffers < SOF_IPC_TELEMETRY_BUFFERS) {
+			fill = &reply.buffers[reply.num_buffers++];
+			fill->comp_id = buffer->ipc_buffer.comp.id;
+			fill->size = buffer->size;
+			fill->avail = buffer->avail;
+			fill->min = buffer->avail_min;
+			fill->max = buffer->avail_max;
+		}
+	}
+
+	mailbox_hostbox_write(0, &reply, sizeof(reply));
+
+	return 1;
+}
+
 #if CONFIG_TRACE
 /*
  * Debug IPC Operations.
@@ -808,6 +1034,10 @@ static int ipc_glb_debug_message(uint32_t header)
 	switch (cmd) {
 	case SOF_IPC_TRACE_DMA_PARAMS:
 		return ipc_dma_trace_config(header);
+	case SOF_IPC_TRACE_PERF_COUNTERS:
+		return ipc_perf_counters(header);
+	case SOF_IPC_TRACE_STREAM_TELEMETRY:
+		return ipc_stream_telemetry(header);
 	default:
 		trace_ipc_error("ipc: unknown debug cmd 0x%x", cmd);
 		return -EINVAL;
@@ -817,8 +1047,14 @@ static int ipc_glb_debug_message(uint32_t header)
 static int ipc_glb_debug_message(uint32_t header)
 {
 	/* traces are disabled - CONFIG_TRACE is not set */
-
-	return -EINVAL;
+	switch (iCS(header)) {
+	case SOF_IPC_TRACE_PERF_COUNTERS:
+		return ipc_perf_counters(header);
+	case SOF_IPC_TRACE_STREAM_TELEMETRY:
+		return ipc_stream_telemetry(header);
+	default:
+		return -EINVAL;
+	}
 }
 #endif
 
@@ -913,6 +1149,239 @@ static int ipc_comp_value(uint32_t header, uint32_t cmd)
 	return ret;
 }
 
+/* queue one pipeline bulk locally or on the core running the pipeline */
+static int ipc_comp_bulk_post(struct pipeline_ctrl_bulk *bulk)
+{
+	struct pipeline *p = bulk->update[0].dev->pipeline;
+	int core = p->ipc_pipe.core;
+	struct idc_msg bulk_msg = { IDC_MSG_CTRL_BULK, IDC_MSG_CTRL_BULK_EXT,
+				    core, &bulk, sizeof(bulk) };
+	int ret;
+
+	if (p->status != COMP_STATE_ACTIVE || cpu_get_id() == core)
+		return pipeline_ctrl_bulk_queue(p, bulk);
+
+	/* pipeline running on other core copies the bulk */
+	if (cpu_is_core_enabled(core)) {
+		dcache_writeback_region(bulk, bulk->size);
+		ret = idc_send_msg(&bulk_msg, IDC_BLOCKING);
+	} else {
+		ret = -EINVAL;
+	}
+
+	rfree(bulk);
+	return ret;
+}
+
+/* check a bulk control update and get its component and command */
+static int ipc_comp_bulk_update(struct sof_ipc_ctrl_data *data,
+				uint32_t size,
+				struct pipeline_ctrl_update *update)
+{
+	struct ipc_comp_dev *comp_dev;
+
+	if (size < sizeof(*data) || data->rhdr.hdr.size < sizeof(*data) ||
+	    data->rhdr.hdr.size > size) {
+		trace_ipc_error("ipc: bulk update size %u invalid",
+				data->rhdr.hdr.size);
+		return -EINVAL;
+	}
+
+	comp_dev = ipc_get_comp(_ipc, data->comp_id);
+	if (!comp_dev || comp_dev->type != COMP_TYPE_COMPONENT ||
+	    !comp_dev->cd->pipeline) {
+		trace_ipc_error("ipc: bulk comp %d not found", data->comp_id);
+		return -ENODEV;
+	}
+
+	switch (iCS(data->rhdr.hdr.cmd)) {
+	case SOF_IPC_COMP_SET_VALUE:
+		update->cmd = COMP_CMD_SET_VALUE;
+		break;
+	case SOF_IPC_COMP_SET_DATA:
+		update->cmd = COMP_CMD_SET_DATA;
+		break;
+	default:
+		trace_ipc_error("ipc: bulk comp %d cmd 0x%x not supported",
+				data->comp_id, data->rhdr.hdr.cmd);
+		return -EINVAL;
+	}
+
+	update->dev = comp_dev->cd;
+	return 0;
+}
+
+/* build the bulk of all updates of the pipeline of update */
+static struct pipeline_ctrl_bulk *
+ipc_comp_bulk_build(char *updates, struct pipeline_ctrl_update *update,
+		    uint32_t count)
+{
+	struct pipeline *p = update->dev->pipeline;
+	struct pipeline_ctrl_bulk *bulk;
+	struct sof_ipc_ctrl_data *data;
+	uint32_t bytes = 0;
+	uint32_t used = 0;
+	uint32_t offset;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (update[i].dev && update[i].dev->pipeline == p) {
+			data = (struct sof_ipc_ctrl_data *)(updates +
+							    update[i].offset);
+			bytes += ALIGN(data->rhdr.hdr.size, 4);
+			used++;
+		}
+	}
+
+	offset = sizeof(*bulk) + used * sizeof(*update);
+	bulk = rmalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM, offset + bytes);
+	if (!bulk)
+		return NULL;
+
+	bulk->next = NULL;
+	bulk->size = offset + bytes;
+	bulk->count = 0;
+
+	/* move the updates of this pipeline into the bulk */
+	for (i = 0; i < count; i++) {
+		if (!update[i].dev || update[i].dev->pipeline != p)
+			continue;
+
+		data = (struct sof_ipc_ctrl_data *)(updates +
+						    update[i].offset);
+		assert(!memcpy_s((char *)bulk + offset, bulk->size - offset,
+				 data, data->rhdr.hdr.size));
+
+		bulk->update[bulk->count].dev = update[i].dev;
+		bulk->update[bulk->count].cmd = update[i].cmd;
+		bulk->update[bulk->count].offset = offset;
+		bulk->count++;
+
+		offset += ALIGN(data->rhdr.hdr.size, 4);
+		update[i].dev = NULL;
+	}
+
+	return bulk;
+}
+
+/* set many component controls, applied per pipeline at one period */
+static int ipc_comp_bulk(uint32_t header)
+{
+#ifdef CONFIG_HOST_PTABLE
+	struct ipc_data *iipc = ipc_get_drvdata(_ipc);
+#endif
+	struct sof_ipc_ctrl_bulk bulk;
+	struct pipeline_ctrl_update *update = NULL;
+	struct pipeline_ctrl_bulk **blocks = NULL;
+	struct sof_ipc_ctrl_data *data;
+	char *host_data = NULL;
+	char *updates;
+	uint32_t offset = 0;
+	int num_blocks = 0;
+	int ret = 0;
+	int err;
+	int i;
+
+	/* copy message with ABI safe method */
+	IPC_COPY_CMD(bulk, _ipc->comp_data);
+
+	trace_ipc("ipc: bulk ctrls %u size %u", bulk.num_ctrls, bulk.size);
+
+	if (!bulk.num_ctrls ||
+	    bulk.num_ctrls > bulk.size / sizeof(struct sof_ipc_ctrl_data)) {
+		trace_ipc_error("ipc: bulk ctrls %u size %u invalid",
+				bulk.num_ctrls, bulk.size);
+		return -EINVAL;
+	}
+
+	if (bulk.buffer.pages) {
+#ifdef CONFIG_HOST_PTABLE
+		/* updates are in the host buffer */
+		host_data = rmalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+				    bulk.size);
+		if (!host_data)
+			return -ENOMEM;
+
+		ret = ipc_get_host_data(iipc->dmac, iipc->page_table,
+					&bulk.buffer, host_data, bulk.size);
+		if (ret < 0) {
+			trace_ipc_error("ipc: bulk host data failed %d", ret);
+			goto out;
+		}
+		updates = host_data;
+#else
+		trace_ipc_error("ipc: bulk host buffer not supported");
+		return -EINVAL;
+#endif
+	} else {
+		/* updates follow the header in the mailbox */
+		if (bulk.hdr.size < sizeof(bulk) ||
+		    bulk.hdr.size - sizeof(bulk) < bulk.size) {
+			trace_ipc_error("ipc: bulk size %u msg %u invalid",
+					bulk.size, bulk.hdr.size);
+			return -EINVAL;
+		}
+		updates = (char *)_ipc->comp_data + sizeof(bulk);
+	}
+
+	update = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+			 bulk.num_ctrls * sizeof(*update));
+	blocks = rzalloc(RZONE_RUNTIME, SOF_MEM_CAPS_RAM,
+			 bulk.num_ctrls * sizeof(*blocks));
+	if (!update || !blocks) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	/* validate all updates before any is applied */
+	for (i = 0; i < bulk.num_ctrls; i++) {
+		if (offset >= bulk.size) {
+			ret = -EINVAL;
+			goto out;
+		}
+
+		data = (struct sof_ipc_ctrl_data *)(updates + offset);
+		ret = ipc_comp_bulk_update(data, bulk.size - offset,
+					   &update[i]);
+		if (ret < 0)
+			goto out;
+
+		update[i].offset = offset;
+		offset += ALIGN(data->rhdr.hdr.size, 4);
+	}
+
+	/* one bulk per pipeline, all allocated before any is queued */
+	for (i = 0; i < bulk.num_ctrls; i++) {
+		if (!update[i].dev)
+			continue;
+
+		blocks[num_blocks] = ipc_comp_bulk_build(updates, &update[i],
+							 bulk.num_ctrls - i);
+		if (!blocks[num_blocks]) {
+			trace_ipc_error("ipc: bulk out of memory");
+			ret = -ENOMEM;
+			goto out;
+		}
+		num_blocks++;
+	}
+
+	/* queued bulks are owned by their pipelines */
+	for (i = 0; i < num_blocks; i++) {
+		err = ipc_comp_bulk_post(blocks[i]);
+		if (err < 0 && !ret)
+			ret = err;
+	}
+	num_blocks = 0;
+
+out:
+	for (i = 0; i < num_blocks; i++)
+		rfree(blocks[i]);
+	rfree(blocks);
+	rfree(update);
+	rfree(host_data);
+	return ret;
+}
+
 static int ipc_glb_comp_message(uint32_t header)
 {
 	uint32_t cmd = iCS(header);
@@ -926,6 +1395,8 @@ static int ipc_glb_comp_message(uint32_t header)
 		return ipc_comp_value(header, COMP_CMD_SET_DATA);
 	case SOF_IPC_COMP_GET_DATA:
 		return ipc_comp_value(header, COMP_CMD_GET_DATA);
+	case SOF_IPC_COMP_SET_BULK:
+		return ipc_comp_bulk(header);
 	default:
 		trace_ipc_error("ipc: unknown comp cmd 0x%x", cmd);
 		return -EINVAL;
@@ -1162,6 +1633,14 @@ static inline struct ipc_msg *ipc_glb_stream_message_find(struct ipc *ipc,
 	cmd = iCS(posn->rhdr.hdr.cmd);
 
 	switch (cmd) {
+	case SOF_IPC_STREAM_POSITIONS:
+		/* only one coalesced message is queued at a time */
+		list_for_item(plist, &ipc->shared_ctx->msg_list) {
+			msg = container_of(plist, struct ipc_msg, list);
+			if (msg->header == posn->rhdr.hdr.cmd)
+				return msg;
+		}
+		break;
 	case SOF_IPC_STREAM_TRIG_XRUN:
 	case SOF_IPC_STREAM_POSITION:
 
@@ -1276,9 +1755,68 @@ out:
 	return ret;
 }
 
+#if CONFIG_IPC_POSITION_BATCH
+/* tell host about all stream slots updated since the last pass, streams
+ * updated again before host took the message are merged into it
+ */
+static void ipc_stream_flush_positions(struct ipc *ipc)
+{
+	struct ipc_shared_context *ctx = ipc->shared_ctx;
+	struct sof_ipc_stream_posn_batch batch;
+	struct sof_ipc_stream_posn_batch *pending;
+	struct ipc_msg *msg;
+	uint32_t flags;
+	uint32_t seq;
+	int i;
+
+	batch.posn_mask = 0;
+	batch.xrun_mask = 0;
+
+	for (i = 0; i < PLATFORM_MAX_STREAMS; i++) {
+		seq = ctx->posn_seq[i];
+		if (seq != ipc->posn_sent[i]) {
+			ipc->posn_sent[i] = seq;
+			batch.posn_mask |= BIT(i);
+		}
+
+		seq = ctx->xrun_seq[i];
+		if (seq != ipc->xrun_sent[i]) {
+			ipc->xrun_sent[i] = seq;
+			batch.xrun_mask |= BIT(i);
+		}
+	}
+
+	if (!batch.posn_mask && !batch.xrun_mask)
+		return;
+
+	batch.rhdr.hdr.cmd = SOF_IPC_GLB_STREAM_MSG | SOF_IPC_STREAM_POSITIONS;
+	batch.rhdr.hdr.size = sizeof(batch);
+	batch.rhdr.error = 0;
+
+	spin_lock_irq(&ipc->lock, flags);
+
+	msg = msg_find(ipc, batch.rhdr.hdr.cmd, &batch);
+	if (msg) {
+		pending = (struct sof_ipc_stream_posn_batch *)msg->tx_data;
+		pending->posn_mask |= batch.posn_mask;
+		pending->xrun_mask |= batch.xrun_mask;
+	}
+
+	spin_unlock_irq(&ipc->lock, flags);
+
+	if (!msg)
+		ipc_queue_host_message(ipc, batch.rhdr.hdr.cmd, &batch,
+				       sizeof(batch), 0);
+}
+#endif
+
 /* process current message */
 int ipc_process_msg_queue(void)
 {
+#if CONFIG_IPC_POSITION_BATCH
+	ipc_stream_flush_positions(_ipc);
+#endif
+
 	if (_ipc->shared_ctx->dsp_pending)
 		ipc_platform_send_msg(_ipc);
 	return 0;
@@ -43,6 +43,13 @@
 #include <sof/audio/component.h>
 #include <sof/audio/pipeline.h>
 #include <sof/audio/buffer.h>
+#include <config.h>
+
+#if !CONFIG_HOST
+#include <sof/clk.h>
+#include <sof/cpu.h>
+#include <platform/clk.h>
+#endif
 
 /* Returns pipeline source component */
 #define ipc_get_ppl_src_comp(ipc, ppl_id) \
@@ -196,7 +203,9 @@ int ipc_comp_free(struct ipc *ipc, uint32_t comp_id)
 	return 0;
 }
 
-int ipc_buffer_new(struct ipc *ipc, struct sof_ipc_buffer *desc)
+/* create and register a buffer, pool is its audio memory if not NULL */
+static int ipc_buffer_add(struct ipc *ipc, struct sof_ipc_buffer *desc,
+			  void *pool)
 {
 	struct ipc_comp_dev *ibd;
 	struct comp_buffer *buffer;
@@ -212,7 +221,7 @@ int ipc_buffer_new(struct ipc *ipc, struct sof_ipc_buffer *desc)
 	}
 
 	/* register buffer with pipeline */
-	buffer = buffer_new(desc);
+	buffer = pool ? buffer_new_pool(desc, pool) : buffer_new(desc);
 	if (buffer == NULL) {
 		trace_ipc_error("ipc_buffer_new() error: buffer_new() failed");
 		rfree(ibd);
@@ -228,14 +237,30 @@ int ipc_buffer_new(struct ipc *ipc, struct sof_ipc_buffer *desc)
 	ibd->cb = buffer;
 	ibd->type = COMP_TYPE_BUFFER;
 
+	/* pool is freed with its last buffer */
+	if (pool)
+		ipc->buffer_pool_users++;
+
 	/* add new buffer to the list */
 	list_item_append(&ibd->list, &ipc->shared_ctx->comp_list);
 	return ret;
 }
 
+int ipc_buffer_new(struct ipc *ipc, struct sof_ipc_buffer *desc)
+{
+	return ipc_buffer_add(ipc, desc, NULL);
+}
+
+int ipc_buffer_new_pool(struct ipc *ipc, struct sof_ipc_buffer *desc,
+			void *pool)
+{
+	return ipc_buffer_add(ipc, desc, pool);
+}
+
 int ipc_buffer_free(struct ipc *ipc, uint32_t buffer_id)
 {
 	struct ipc_comp_dev *ibd;
+	bool pool;
 
 	/* check whether buffer exists */
 	ibd = ipc_get_comp(ipc, buffer_id);
@@ -243,10 +268,17 @@ int ipc_buffer_free(struct ipc *ipc, uint32_t buffer_id)
 		return -ENODEV;
 
 	/* free buffer and remove from list */
+	pool = ibd->cb->pool;
 	buffer_free(ibd->cb);
 	list_item_del(&ibd->list);
 	rfree(ibd);
 
+	/* free the buffer pool with its last buffer */
+	if (pool && !--ipc->buffer_pool_users) {
+		rfree(ipc->buffer_pool);
+		ipc->buffer_pool = NULL;
+	}
+
 	return 0;
 }
 
@@ -292,6 +324,177 @@ int ipc_comp_connect(struct ipc *ipc,
 }
 
 
+/*
+ * Pipelines load accounting. Load is committed per pipeline task, i.e. per
+ * scheduling pipeline, and covers all pipelines the task copies. It is
+ * committed when a stream is opened and released when the task's
+ * scheduling component is reset. A stream that would overload the task
+ * core is moved to a core with free capacity or fails to open.
+ */
+
+/* cycles per ms of a core pipelines can commit */
+static uint32_t ipc_core_capacity(uint32_t core)
+{
+#if CONFIG_HOST
+	/* testbench has no DSP clock to run out of */
+	return UINT32_MAX;
+#else
+	return clock_ms_to_ticks(CLK_CPU(core), 1) *
+		PPL_LOAD_MAX_PERCENT / 100;
+#endif
+}
+
+/* checks if a pipeline task can be moved to the core */
+static bool ipc_core_is_available(uint32_t core)
+{
+#if CONFIG_HOST
+	return false;
+#else
+	return core < PLATFORM_CORE_COUNT && cpu_is_core_enabled(core);
+#endif
+}
+
+/* pipeline scheduling the pipeline, its task runs the pipeline copy */
+static struct pipeline *ipc_sched_pipeline(struct pipeline *p)
+{
+	return p->sched_comp->pipeline ? p->sched_comp->pipeline : p;
+}
+
+/* load committed on the core in cycles per ms */
+static uint32_t ipc_core_load(struct ipc *ipc, uint32_t core)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	uint32_t load = 0;
+
+	list_for_item(clist, &ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_PIPELINE &&
+		    icd->pipeline->ipc_pipe.core == core)
+			load += icd->pipeline->load;
+	}
+
+	return load;
+}
+
+/* load of all pipelines copied by the task of scheduling pipeline sp */
+static uint32_t ipc_task_load(struct ipc *ipc, struct pipeline *sp)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	uint32_t load = 0;
+
+	if (sp->load_calib)
+		return sp->load_calib;
+
+	list_for_item(clist, &ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_PIPELINE &&
+		    ipc_sched_pipeline(icd->pipeline) == sp)
+			load += pipeline_load_estimate(icd->pipeline);
+	}
+
+	return load;
+}
+
+/* moves the task of scheduling pipeline sp with its pipelines to core */
+static void ipc_task_move(struct ipc *ipc, struct pipeline *sp,
+			  uint32_t core)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+
+	list_for_item(clist, &ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type == COMP_TYPE_PIPELINE &&
+		    ipc_sched_pipeline(icd->pipeline) == sp) {
+			icd->pipeline->ipc_pipe.core = core;
+			icd->pipeline->pipe_task.core = core;
+		}
+	}
+}
+
+int ipc_pipeline_load_commit(struct ipc *ipc, struct pipeline *p)
+{
+	struct pipeline *sp = ipc_sched_pipeline(p);
+	uint32_t core = sp->ipc_pipe.core;
+	uint32_t load = ipc_task_load(ipc, sp);
+	uint32_t free_max = 0;
+	uint32_t capacity;
+	uint32_t committed;
+	uint32_t i;
+
+	/* already running for another stream */
+	if (sp->load)
+		return 0;
+
+	/* prefer the topology core */
+	capacity = ipc_core_capacity(core);
+	committed = ipc_core_load(ipc, core);
+	if (committed <= capacity && load <= capacity - committed)
+		goto commit;
+
+	/* pick enabled core with most free cycles */
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		if (i == sp->ipc_pipe.core || !ipc_core_is_available(i))
+			continue;
+
+		capacity = ipc_core_capacity(i);
+		committed = ipc_core_load(ipc, i);
+		if (committed <= capacity && capacity - committed > free_max) {
+			free_max = capacity - committed;
+			core = i;
+		}
+	}
+
+	if (load > free_max) {
+		trace_ipc_error("ipc_pipeline_load_commit() error: pipe %d "
+				"load %u, no core has capacity",
+				sp->ipc_pipe.pipeline_id, load);
+		return -EBUSY;
+	}
+
+	trace_ipc("ipc_pipeline_load_commit(), pipe %d moved to core %d",
+		  sp->ipc_pipe.pipeline_id, core);
+	ipc_task_move(ipc, sp, core);
+
+commit:
+	sp->load = load;
+	trace_ipc("ipc_pipeline_load_commit(), pipe %d load %u core %d",
+		  sp->ipc_pipe.pipeline_id, load, core);
+	return 0;
+}
+
+void ipc_pipeline_load_release(struct ipc *ipc)
+{
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	struct pipeline *sp;
+
+	list_for_item(clist, &ipc->shared_ctx->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_PIPELINE)
+			continue;
+
+		/* task still copies other streams */
+		sp = icd->pipeline;
+		if (!sp->load || sp->sched_comp->state > COMP_STATE_READY)
+			continue;
+
+#if CONFIG_PIPELINE_LOAD_CALIB
+		/* worst measured period replaces the topology estimate */
+		if (sp->perf.count >= PPL_LOAD_CALIB_PERIODS) {
+			sp->load_calib = (uint64_t)sp->perf.max * 1000 /
+				pipeline_period(sp);
+			trace_ipc("ipc_pipeline_load_release(), pipe %d "
+				  "calibrated load %u",
+				  sp->ipc_pipe.pipeline_id, sp->load_calib);
+		}
+#endif
+		sp->load = 0;
+	}
+}
+
 int ipc_pipeline_new(struct ipc *ipc,
 	struct sof_ipc_pipe_new *pipe_desc)
 {
@@ -330,6 +533,15 @@ int ipc_pipeline_new(struct ipc *ipc,
 		return -ENOMEM;
 	}
 
+	/* reject pipelines no core can ever run */
+	if (pipeline_load_estimate(pipe) > ipc_core_capacity(pipe_desc->core)) {
+		trace_ipc_error("ipc_pipeline_new() error: load %u over core "
+				"capacity %u", pipeline_load_estimate(pipe),
+				ipc_core_capacity(pipe_desc->core));
+		pipeline_free(pipe);
+		return -EINVAL;
+	}
+
 	/* allocate the IPC pipeline container */
 	ipc_pipe = rzalloc(RZONE_RUNTIME | RZONE_FLAG_UNCACHED,
 			   SOF_MEM_CAPS_RAM, sizeof(struct ipc_comp_dev));
@@ -517,14 +729,11 @@ static void dma_complete(void *data, uint32_t type, struct dma_sg_elem *next)
 		wait_completed(complete);
 }
 
-/*
- * Copy the audio buffer page tables from the host to the DSP max of 4K.
- */
-int ipc_get_page_descriptors(struct dma *dmac, uint8_t *page_table,
-			     struct sof_ipc_host_buffer *ring)
+/* DMA host memory to DSP memory as described by elem_array and wait */
+static int ipc_dma_from_host(struct dma *dmac,
+			     struct dma_sg_elem_array *elem_array)
 {
 	struct dma_sg_config config;
-	struct dma_sg_elem elem;
 	completion_t complete;
 	int chan;
 	int ret = 0;
@@ -532,7 +741,7 @@ int ipc_get_page_descriptors(struct dma *dmac, uint8_t *page_table,
 	/* get DMA channel from DMAC */
 	chan = dma_channel_get(dmac, 0);
 	if (chan < 0) {
-		trace_ipc_error("ipc_get_page_descriptors() error: chan < 0");
+		trace_ipc_error("ipc_dma_from_host() error: chan < 0");
 		return chan;
 	}
 
@@ -542,21 +751,11 @@ int ipc_get_page_descriptors(struct dma *dmac, uint8_t *page_table,
 	config.dest_width = sizeof(uint32_t);
 	config.cyclic = 0;
 	config.irq_disabled = false;
-	dma_sg_init(&config.elem_array);
-
-	/* set up DMA descriptor */
-	elem.dest = (uint32_t)page_table;
-	elem.src = ring->phy_addr;
-
-	/* source buffer size is always PAGE_SIZE bytes */
-	/* 20 bits for each page, round up to 32 */
-	elem.size = (ring->pages * 5 * 16 + 31) / 32;
-	config.elem_array.elems = &elem;
-	config.elem_array.count = 1;
+	config.elem_array = *elem_array;
 
 	ret = dma_set_config(dmac, chan, &config);
 	if (ret < 0) {
-		trace_ipc_error("ipc_get_page_descriptors() error: "
+		trace_ipc_error("ipc_dma_from_host() error: "
 				"dma_set_config() failed");
 		goto out;
 	}
@@ -566,10 +765,10 @@ int ipc_get_page_descriptors(struct dma *dmac, uint8_t *page_table,
 
 	wait_init(&complete);
 
-	/* start the copy of page table to DSP */
+	/* start the copy to DSP */
 	ret = dma_start(dmac, chan);
 	if (ret < 0) {
-		trace_ipc_error("ipc_get_page_descriptors() error: "
+		trace_ipc_error("ipc_dma_from_host() error: "
 				"dma_start() failed");
 		goto out;
 	}
@@ -577,14 +776,82 @@ int ipc_get_page_descriptors(struct dma *dmac, uint8_t *page_table,
 	/* wait for DMA to complete */
 	ret = poll_for_completion_delay(&complete, PLATFORM_DMA_TIMEOUT);
 	if (ret < 0)
-		trace_ipc_error("ipc_get_page_descriptors() error: "
+		trace_ipc_error("ipc_dma_from_host() error: "
 				"poll_for_completion_delay() failed");
 
-	/* compressed page tables now in buffer at _ipc->page_table */
 out:
 	dma_channel_put(dmac, chan);
 	return ret;
 }
+
+/*
+ * Copy the audio buffer page tables from the host to the DSP max of 4K.
+ */
+int ipc_get_page_descriptors(struct dma *dmac, uint8_t *page_table,
+			     struct sof_ipc_host_buffer *ring)
+{
+	struct dma_sg_elem_array elem_array;
+	struct dma_sg_elem elem;
+
+	/* set up DMA descriptor */
+	elem.dest = (uint32_t)page_table;
+	elem.src = ring->phy_addr;
+
+	/* source buffer size is always PAGE_SIZE bytes */
+	/* 20 bits for each page, round up to 32 */
+	elem.size = (ring->pages * 5 * 16 + 31) / 32;
+	elem_array.elems = &elem;
+	elem_array.count = 1;
+
+	/* compressed page tables now in buffer at _ipc->page_table */
+	return ipc_dma_from_host(dmac, &elem_array);
+}
+
+/*
+ * Copy size bytes of data from a host buffer described by its page table
+ * to the DSP.
+ */
+int ipc_get_host_data(struct dma *dmac, uint8_t *page_table,
+		      struct sof_ipc_host_buffer *ring, void *data,
+		      uint32_t size)
+{
+	struct dma_sg_elem_array elem_array;
+	struct dma_sg_elem *e;
+	uint32_t offset = 0;
+	int ret;
+	int i;
+
+	if (size > ring->size) {
+		trace_ipc_error("ipc_get_host_data() error: size %u ring %u",
+				size, ring->size);
+		return -EINVAL;
+	}
+
+	ret = ipc_get_page_descriptors(dmac, page_table, ring);
+	if (ret < 0)
+		return ret;
+
+	ret = ipc_parse_page_descriptors(page_table, ring, &elem_array,
+					 SOF_IPC_STREAM_PLAYBACK);
+	if (ret < 0)
+		return ret;
+
+	/* DMA the pages into data, the last one may be partly used */
+	for (i = 0; i < elem_array.count && offset < size; i++) {
+		e = elem_array.elems + i;
+		e->dest = (uint32_t)data + offset;
+		e->size = MIN(e->size, size - offset);
+		offset += e->size;
+	}
+	elem_array.count = i;
+
+	ret = ipc_dma_from_host(dmac, &elem_array);
+	if (ret >= 0)
+		dcache_invalidate_region(data, size);
+
+	dma_sg_free(&elem_array);
+	return ret;
+}
 #endif
 
 int ipc_init(struct sof *sof)
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sof/lz.h>
+#include <errno.h>
+#include <stdint.h>
+
+static inline uint32_t lz_min(uint32_t a, uint32_t b)
+{
+	return a < b ? a : b;
+}
+
+void lz_dec_init(struct lz_dec *dec, void *out, uint32_t out_size)
+{
+	dec->out = out;
+	dec->out_size = out_size;
+	dec->out_pos = 0;
+	dec->lit_len = 0;
+	dec->match_len = 0;
+	dec->offset = 0;
+	dec->state = LZ_STATE_TOKEN;
+	dec->ext = 0;
+}
+
+/* the stream ends after literals that complete the segment */
+static inline void lz_dec_literals_end(struct lz_dec *dec)
+{
+	if (dec->out_pos == dec->out_size)
+		dec->state = LZ_STATE_DONE;
+	else
+		dec->state = LZ_STATE_OFFSET_LO;
+}
+
+int lz_dec_run(struct lz_dec *dec, const void *in, uint32_t in_size,
+	       uint32_t *in_used, uint32_t max_out)
+{
+	const uint8_t *src = in;
+	const uint8_t *end = src + in_size;
+	uint8_t *dst;
+	uint8_t *ref;
+	uint32_t produced = 0;
+	uint32_t left;
+	uint32_t n;
+	uint32_t i;
+	uint32_t b;
+
+	while (dec->state != LZ_STATE_DONE) {
+		left = dec->out_size - dec->out_pos;
+
+		switch (dec->state) {
+		case LZ_STATE_TOKEN:
+			if (src == end)
+				goto out;
+			b = *src++;
+			dec->lit_len = b >> 4;
+			dec->match_len = (b & LZ_NIBBLE_MAX) + LZ_MIN_MATCH;
+			dec->ext = (b & LZ_NIBBLE_MAX) == LZ_NIBBLE_MAX;
+
+			if (dec->lit_len == LZ_NIBBLE_MAX)
+				dec->state = LZ_STATE_LIT_EXT;
+			else if (dec->lit_len)
+				dec->state = LZ_STATE_LITERAL;
+			else
+				lz_dec_literals_end(dec);
+			break;
+		case LZ_STATE_LIT_EXT:
+			if (src == end)
+				goto out;
+			b = *src++;
+			dec->lit_len += b;
+			if (dec->lit_len > left)
+				return -EINVAL;
+			if (b != LZ_EXT_MAX)
+				dec->state = LZ_STATE_LITERAL;
+			break;
+		case LZ_STATE_LITERAL:
+			if (dec->lit_len > left)
+				return -EINVAL;
+			n = lz_min(dec->lit_len, end - src);
+			n = lz_min(n, max_out - produced);
+			if (!n)
+				goto out;
+
+			dst = dec->out + dec->out_pos;
+			for (i = 0; i < n; i++)
+				dst[i] = src[i];
+
+			src += n;
+			dec->out_pos += n;
+			dec->lit_len -= n;
+			produced += n;
+			if (!dec->lit_len)
+				lz_dec_literals_end(dec);
+			break;
+		case LZ_STATE_OFFSET_LO:
+			if (src == end)
+				goto out;
+			dec->offset = *src++;
+			dec->state = LZ_STATE_OFFSET_HI;
+			break;
+		case LZ_STATE_OFFSET_HI:
+			if (src == end)
+				goto out;
+			dec->offset |= (uint32_t)*src++ << 8;
+			if (!dec->offset || dec->offset > dec->out_pos)
+				return -EINVAL;
+			if (dec->ext)
+				dec->state = LZ_STATE_MATCH_EXT;
+			else
+				dec->state = LZ_STATE_MATCH;
+			break;
+		case LZ_STATE_MATCH_EXT:
+			if (src == end)
+				goto out;
+			b = *src++;
+			dec->match_len += b;
+			if (dec->match_len > left)
+				return -EINVAL;
+			if (b != LZ_EXT_MAX)
+				dec->state = LZ_STATE_MATCH;
+			break;
+		case LZ_STATE_MATCH:
+			if (dec->match_len > left)
+				return -EINVAL;
+			n = lz_min(dec->match_len, max_out - produced);
+			if (!n)
+				goto out;
+
+			/* byte copy, the match may overlap its own output */
+			dst = dec->out + dec->out_pos;
+			ref = dst - dec->offset;
+			for (i = 0; i < n; i++)
+				dst[i] = ref[i];
+
+			dec->out_pos += n;
+			dec->match_len -= n;
+			produced += n;
+			if (!dec->match_len)
+				dec->state = LZ_STATE_TOKEN;
+			break;
+		default:
+			return -EINVAL;
+		}
+	}
+
+out:
+	*in_used = src - (const uint8_t *)in;
+	return produced;
+}
@@ -36,8 +36,6 @@
 #include <sof/idc.h>
 #include <platform/idc.h>
 
-static struct notify_data _notify_data;
-
 void notifier_register(struct notifier *notifier)
 {
 	struct notify *notify = *arch_notify_get();
@@ -56,25 +54,21 @@ void notifier_unregister(struct notifier *notifier)
 	spin_unlock(&notify->lock);
 }
 
-void notifier_notify(void)
+void notifier_notify(struct notify_data *notify_data)
 {
 	struct notify *notify = *arch_notify_get();
 	struct list_item *wlist;
 	struct notifier *n;
 
 	if (!list_is_empty(&notify->list)) {
-		dcache_invalidate_region(&_notify_data, sizeof(_notify_data));
-		dcache_invalidate_region(_notify_data.data,
-					 _notify_data.data_size);
-
 		/* iterate through notifiers and send event to
 		 * interested clients
 		 */
 		list_for_item(wlist, &notify->list) {
 			n = container_of(wlist, struct notifier, list);
-			if (n->id == _notify_data.id)
-				n->cb(_notify_data.message, n->cb_data,
-				      _notify_data.data);
+			if (n->id == notify_data->id)
+				n->cb(notify_data->message, n->cb_data,
+				      notify_data->data);
 		}
 	}
 }
@@ -83,20 +77,39 @@ void notifier_event(struct notify_data *notify_data)
 {
 	struct notify *notify = *arch_notify_get();
 	struct idc_msg notify_msg = { IDC_MSG_NOTIFY, IDC_MSG_NOTIFY_EXT };
+	struct {
+		struct notify_data notify_data;
+		uint8_t data[IDC_MSG_DATA_SIZE - sizeof(struct notify_data)];
+	} payload;
+	uint32_t size = notify_data->data_size;
 	int i = 0;
 
 	spin_lock(&notify->lock);
 
-	_notify_data = *notify_data;
-	dcache_writeback_region(_notify_data.data, _notify_data.data_size);
-	dcache_writeback_region(&_notify_data, sizeof(_notify_data));
+	/* event data is copied with the message if it fits, larger data
+	 * stays shared with the remote cores
+	 */
+	payload.notify_data = *notify_data;
+	if (size > sizeof(payload.data)) {
+		dcache_writeback_region(notify_data->data, size);
+		size = 0;
+	} else if (size) {
+		memcpy_s(payload.data, sizeof(payload.data), notify_data->data,
+			 size);
+	}
+	notify_msg.data = &payload;
+	notify_msg.data_size = sizeof(payload.notify_data) + size;
 
 	/* notify selected targets */
 	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
-		if (_notify_data.target_core_mask & (1 << i)) {
+		if (notify_data->target_core_mask & (1 << i)) {
 			if (i == cpu_get_id()) {
-				notifier_notify();
+				notifier_notify(notify_data);
 			} else if (cpu_is_core_enabled(i)) {
+				/* wait for remote handling, callers rely on
+				 * ordered events and shared data stays owned
+				 * by the caller
+				 */
 				notify_msg.core = i;
 				idc_send_msg(&notify_msg, IDC_BLOCKING);
 			}
@@ -51,6 +51,11 @@
  */
 #define PLATFORM_WORKQ_DEFAULT_TIMEOUT	1000
 
+/* testbench runs on a single core */
+#define PLATFORM_CORE_COUNT	1
+
+#define PLATFORM_MASTER_CORE_ID	0
+
 /* Host page size */
 #define HOST_PAGE_SIZE		4096
 
@@ -67,7 +67,7 @@ int do_task_master_core(struct sof *sof)
 	/* init self-registered modules */
 	sys_module_init();
 
-#if STATIC_PIPE
+#if CONFIG_STATIC_PIPELINE
 	/* init static pipeline */
 	ret = init_static_pipeline(sof->ipc);
 	if (ret < 0)
@@ -103,12 +103,108 @@ static void test_audio_buffer_fill_10_bytes(void **state)
 	buffer_free(buf);
 }
 
+static void test_audio_buffer_xcore_fill_and_drain(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 16
+	};
+	struct comp_dev source = { 0 };
+	struct comp_dev sink = { 0 };
+
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+
+	assert_non_null(buf);
+	buf->source = &source;
+	buf->sink = &sink;
+	buf->xcore = true;
+
+	comp_update_buffer_produce(buf, 16);
+
+	assert_int_equal(buf->free, 0);
+	assert_ptr_equal(buf->w_ptr, buf->r_ptr);
+
+	/* consumer only sees produced data after its sync */
+	buffer_xcore_consumer_sync(buf);
+	assert_int_equal(buf->avail, 16);
+
+	comp_update_buffer_consume(buf, 6);
+	assert_int_equal(buf->avail, 10);
+
+	buffer_xcore_producer_sync(buf);
+	assert_int_equal(buf->free, 6);
+
+	comp_update_buffer_consume(buf, 10);
+	assert_int_equal(buf->avail, 0);
+	assert_ptr_equal(buf->w_ptr, buf->r_ptr);
+
+	buffer_xcore_producer_sync(buf);
+	assert_int_equal(buf->free, 16);
+
+	buffer_free(buf);
+}
+
+static void test_audio_buffer_conceal_underrun_fades(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 64
+	};
+	struct comp_dev source = { 0 };
+	struct comp_dev sink = { 0 };
+	int16_t *samples;
+	int i;
+
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+
+	assert_non_null(buf);
+	source.params.frame_fmt = SOF_IPC_FRAME_S16_LE;
+	source.params.channels = 2;
+	buf->source = &source;
+	buf->sink = &sink;
+
+	/* 4 frames of audio are queued */
+	samples = buf->w_ptr;
+	for (i = 0; i < 8; i++)
+		samples[i] = 4096;
+	comp_update_buffer_produce(buf, 16);
+
+	/* queued audio fades out into 4 frames of silence */
+	buffer_conceal_underrun(buf, 16);
+
+	assert_int_equal(buf->avail, 32);
+	assert_true(buf->fade_in);
+	samples = buf->r_ptr;
+	assert_int_equal(samples[0], 3072);
+	assert_int_equal(samples[3], 2048);
+	assert_int_equal(samples[4], 1024);
+	assert_int_equal(samples[7], 0);
+	for (i = 8; i < 16; i++)
+		assert_int_equal(samples[i], 0);
+
+	/* audio following the silence fades in */
+	samples = buf->w_ptr;
+	for (i = 0; i < 4; i++)
+		samples[i] = 4096;
+	comp_update_buffer_produce(buf, 8);
+
+	assert_false(buf->fade_in);
+	assert_int_equal(samples[0], 0);
+	assert_int_equal(samples[2], 2048);
+
+	buffer_free(buf);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test
 			(test_audio_buffer_write_10_bytes_out_of_256_and_read_back),
-		cmocka_unit_test(test_audio_buffer_fill_10_bytes)
+		cmocka_unit_test(test_audio_buffer_fill_10_bytes),
+		cmocka_unit_test(test_audio_buffer_xcore_fill_and_drain),
+		cmocka_unit_test(test_audio_buffer_conceal_underrun_fades)
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
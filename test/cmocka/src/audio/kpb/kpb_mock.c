@@ -36,6 +36,10 @@ void pipeline_xrun(struct pipeline *p, struct comp_dev *dev, int32_t bytes)
 {
 }
 
+void pipeline_comp_state_changed(struct comp_dev *dev)
+{
+}
+
 int comp_set_state(struct comp_dev *dev, int cmd)
 {
 	return 0;
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include "pipeline_mocks.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define BULK_UPDATES	2
+
+struct bulk_block {
+	struct pipeline_ctrl_bulk bulk;
+	struct pipeline_ctrl_update update[BULK_UPDATES];
+	struct sof_ipc_ctrl_data data[BULK_UPDATES];
+};
+
+struct bulk_test {
+	struct pipeline p;
+	struct comp_driver drv;
+	struct comp_dev dev;
+	struct bulk_block block;
+	uint32_t cmd_count;
+	uint32_t cmd_index[BULK_UPDATES];
+	int cmd_ret;
+};
+
+static struct bulk_test *test_data;
+
+static int mock_cmd(struct comp_dev *dev, int cmd, void *data,
+		    int max_data_size)
+{
+	struct sof_ipc_ctrl_data *cdata = data;
+
+	assert_int_equal(cmd, COMP_CMD_SET_VALUE);
+	assert_int_equal(max_data_size, sizeof(*cdata));
+
+	test_data->cmd_index[test_data->cmd_count++] = cdata->index;
+
+	return test_data->cmd_ret;
+}
+
+static int setup(void **state)
+{
+	struct bulk_block *block;
+	int i;
+
+	test_data = calloc(1, sizeof(*test_data));
+	test_data->drv.ops.cmd = mock_cmd;
+	test_data->dev.drv = &test_data->drv;
+	test_data->dev.pipeline = &test_data->p;
+
+	block = &test_data->block;
+	block->bulk.size = sizeof(*block);
+	block->bulk.count = BULK_UPDATES;
+
+	for (i = 0; i < BULK_UPDATES; i++) {
+		block->update[i].dev = &test_data->dev;
+		block->update[i].cmd = COMP_CMD_SET_VALUE;
+		block->update[i].offset = offsetof(struct bulk_block, data[i]);
+		block->data[i].rhdr.hdr.size = sizeof(block->data[i]);
+		block->data[i].index = i + 1;
+	}
+
+	*state = test_data;
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	free(*state);
+	return 0;
+}
+
+static void test_audio_pipeline_ctrl_bulk_inactive(void **state)
+{
+	struct bulk_test *td = *state;
+	int ret;
+
+	td->p.status = COMP_STATE_READY;
+
+	ret = pipeline_ctrl_bulk_queue(&td->p, &td->block.bulk);
+
+	assert_int_equal(ret, 0);
+	assert_int_equal(td->cmd_count, BULK_UPDATES);
+	assert_int_equal(td->cmd_index[0], 1);
+	assert_int_equal(td->cmd_index[1], 2);
+	assert_null(td->p.ctrl_bulk);
+}
+
+static void test_audio_pipeline_ctrl_bulk_inactive_error(void **state)
+{
+	struct bulk_test *td = *state;
+	int ret;
+
+	td->p.status = COMP_STATE_READY;
+	td->cmd_ret = -EINVAL;
+
+	ret = pipeline_ctrl_bulk_queue(&td->p, &td->block.bulk);
+
+	/* all updates are applied even if one fails */
+	assert_int_equal(ret, -EINVAL);
+	assert_int_equal(td->cmd_count, BULK_UPDATES);
+}
+
+static void test_audio_pipeline_ctrl_bulk_active(void **state)
+{
+	struct bulk_test *td = *state;
+	int ret;
+
+	td->p.status = COMP_STATE_ACTIVE;
+
+	ret = pipeline_ctrl_bulk_queue(&td->p, &td->block.bulk);
+
+	/* nothing applied before the period boundary */
+	assert_int_equal(ret, 0);
+	assert_int_equal(td->cmd_count, 0);
+	assert_ptr_equal(td->p.ctrl_bulk, &td->block.bulk);
+
+	pipeline_ctrl_bulk_apply(&td->p);
+
+	assert_int_equal(td->cmd_count, BULK_UPDATES);
+	assert_int_equal(td->cmd_index[0], 1);
+	assert_int_equal(td->cmd_index[1], 2);
+	assert_null(td->p.ctrl_bulk);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(
+			test_audio_pipeline_ctrl_bulk_inactive,
+			setup, teardown
+		),
+		cmocka_unit_test_setup_teardown(
+			test_audio_pipeline_ctrl_bulk_inactive_error,
+			setup, teardown
+		),
+		cmocka_unit_test_setup_teardown(
+			test_audio_pipeline_ctrl_bulk_active,
+			setup, teardown
+		),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
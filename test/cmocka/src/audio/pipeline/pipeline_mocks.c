@@ -31,6 +31,8 @@
 #include "pipeline_mocks.h"
 
 #include <mock_trace.h>
+#include <sof/clk.h>
+#include <sof/drivers/timer.h>
 
 TRACE_IMPL()
 
@@ -127,3 +129,66 @@ void __panic(uint32_t p, char *filename, uint32_t linenum)
 	(void)filename;
 	(void)linenum;
 }
+
+void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
+{
+	(void)buffer;
+	(void)bytes;
+}
+
+void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
+{
+	(void)buffer;
+	(void)bytes;
+}
+
+void buffer_xcore_producer_sync(struct comp_buffer *buffer)
+{
+	(void)buffer;
+}
+
+void buffer_xcore_consumer_sync(struct comp_buffer *buffer)
+{
+	(void)buffer;
+}
+
+void buffer_conceal_underrun(struct comp_buffer *buffer, uint32_t bytes)
+{
+	(void)buffer;
+	(void)bytes;
+}
+
+void buffer_conceal_overrun(struct comp_buffer *buffer, uint32_t bytes)
+{
+	(void)buffer;
+	(void)bytes;
+}
+
+void buffer_conceal_dma_underrun(struct comp_buffer *buffer, uint32_t bytes)
+{
+	(void)buffer;
+	(void)bytes;
+}
+
+void buffer_conceal_dma_overrun(struct comp_buffer *buffer, uint32_t bytes)
+{
+	(void)buffer;
+	(void)bytes;
+}
+
+struct timer *platform_timer;
+
+uint64_t platform_timer_get(struct timer *timer)
+{
+	(void)timer;
+
+	return 0;
+}
+
+uint64_t clock_ms_to_ticks(int clock, uint64_t ms)
+{
+	(void)clock;
+	(void)ms;
+
+	return 0;
+}
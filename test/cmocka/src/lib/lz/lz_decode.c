@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2019, Intel Corporation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *   * Neither the name of the Intel Corporation nor the
+ *     names of its contributors may be used to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <sof/lz.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <cmocka.h>
+
+#define LZ_TEST_OUT	512
+
+static uint8_t out[LZ_TEST_OUT];
+
+/* decode all of in, out_size bytes expected */
+static int lz_test_decode(struct lz_dec *dec, const uint8_t *in,
+			  uint32_t in_size, uint32_t out_size)
+{
+	uint32_t used;
+	int ret;
+
+	memset(out, 0, sizeof(out));
+	lz_dec_init(dec, out, out_size);
+
+	ret = lz_dec_run(dec, in, in_size, &used, out_size);
+	if (ret >= 0)
+		assert_true(used <= in_size);
+
+	return ret;
+}
+
+static void test_lib_lz_decode_literals_only(void **state)
+{
+	const uint8_t in[] = { 0x50, 'h', 'e', 'l', 'l', 'o' };
+	struct lz_dec dec;
+	int r;
+
+	(void) state;
+
+	r = lz_test_decode(&dec, in, sizeof(in), 5);
+	assert_int_equal(r, 5);
+	assert_true(lz_dec_done(&dec));
+	assert_memory_equal(out, "hello", 5);
+}
+
+static void test_lib_lz_decode_overlapping_match(void **state)
+{
+	/* 1 literal, 19 byte match at offset 1, then 1 final literal */
+	const uint8_t in[] = { 0x1f, 'a', 0x01, 0x00, 0x00, 0x10, 'b' };
+	uint8_t ref[21];
+	struct lz_dec dec;
+	int r;
+
+	(void) state;
+
+	memset(ref, 'a', 20);
+	ref[20] = 'b';
+
+	r = lz_test_decode(&dec, in, sizeof(in), sizeof(ref));
+	assert_int_equal(r, sizeof(ref));
+	assert_true(lz_dec_done(&dec));
+	assert_memory_equal(out, ref, sizeof(ref));
+}
+
+static void test_lib_lz_decode_literal_extension(void **state)
+{
+	/* 300 literals are 15 + 255 + 30 */
+	uint8_t in[3 + 300];
+	struct lz_dec dec;
+	int r;
+	int i;
+
+	(void) state;
+
+	in[0] = 0xf0;
+	in[1] = 0xff;
+	in[2] = 30;
+	for (i = 0; i < 300; i++)
+		in[3 + i] = i;
+
+	r = lz_test_decode(&dec, in, sizeof(in), 300);
+	assert_int_equal(r, 300);
+	assert_true(lz_dec_done(&dec));
+	assert_memory_equal(out, in + 3, 300);
+}
+
+static void test_lib_lz_decode_byte_by_byte(void **state)
+{
+	const uint8_t in[] = { 0x1f, 'a', 0x01, 0x00, 0x00, 0x10, 'b' };
+	struct lz_dec dec;
+	uint32_t pos = 0;
+	uint32_t total = 0;
+	uint32_t used;
+	int r;
+
+	(void) state;
+
+	memset(out, 0, sizeof(out));
+	lz_dec_init(&dec, out, 21);
+
+	/* one input byte and at most one output byte per call */
+	while (!lz_dec_done(&dec)) {
+		assert_true(pos < sizeof(in) || total < 21);
+		r = lz_dec_run(&dec, in + pos, pos < sizeof(in) ? 1 : 0,
+			       &used, 1);
+		assert_true(r == 0 || r == 1);
+		pos += used;
+		total += r;
+	}
+
+	assert_int_equal(pos, sizeof(in));
+	assert_int_equal(total, 21);
+	assert_int_equal(out[19], 'a');
+	assert_int_equal(out[20], 'b');
+}
+
+static void test_lib_lz_decode_zero_offset(void **state)
+{
+	const uint8_t in[] = { 0x10, 'a', 0x00, 0x00, 0x10, 'b' };
+	struct lz_dec dec;
+
+	(void) state;
+
+	assert_int_equal(lz_test_decode(&dec, in, sizeof(in), 6), -EINVAL);
+}
+
+static void test_lib_lz_decode_offset_before_start(void **state)
+{
+	const uint8_t in[] = { 0x10, 'a', 0x02, 0x00, 0x10, 'b' };
+	struct lz_dec dec;
+
+	(void) state;
+
+	assert_int_equal(lz_test_decode(&dec, in, sizeof(in), 6), -EINVAL);
+}
+
+static void test_lib_lz_decode_output_overflow(void **state)
+{
+	/* 19 byte match does not fit in 8 bytes of output */
+	const uint8_t in[] = { 0x1f, 'a', 0x01, 0x00, 0x00, 0x10, 'b' };
+	struct lz_dec dec;
+
+	(void) state;
+
+	assert_int_equal(lz_test_decode(&dec, in, sizeof(in), 8), -EINVAL);
+}
+
+static void test_lib_lz_decode_truncated(void **state)
+{
+	const uint8_t in[] = { 0x1f, 'a', 0x01, 0x00, 0x00, 0x10 };
+	struct lz_dec dec;
+	int r;
+
+	(void) state;
+
+	r = lz_test_decode(&dec, in, sizeof(in), 21);
+	assert_int_equal(r, 20);
+	assert_false(lz_dec_done(&dec));
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_lib_lz_decode_literals_only),
+		cmocka_unit_test(test_lib_lz_decode_overlapping_match),
+		cmocka_unit_test(test_lib_lz_decode_literal_extension),
+		cmocka_unit_test(test_lib_lz_decode_byte_by_byte),
+		cmocka_unit_test(test_lib_lz_decode_zero_offset),
+		cmocka_unit_test(test_lib_lz_decode_offset_before_start),
+		cmocka_unit_test(test_lib_lz_decode_output_overflow),
+		cmocka_unit_test(test_lib_lz_decode_truncated),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -177,94 +177,76 @@ static void print_entry_params(FILE *out_fd,
 	fflush(out_fd);
 }
 
+/* in memory logs dictionary, legacy dictionaries are indexed on load */
+struct ldc_dict {
+	struct snd_sof_ldc_header header;
+	const struct snd_sof_ldc_entry *entries;
+	const char *strings;
+	struct snd_sof_ldc_entry *index;	/* legacy file index */
+	uint8_t *file;
+};
+
+/* address is in the log entries section */
+static int ldc_in_section(const struct ldc_dict *dict, uint32_t address)
+{
+	return address >= dict->header.base_address &&
+		address <= dict->header.base_address +
+		dict->header.data_length;
+}
+
+/* binary search of the entry logged from address */
+static const struct snd_sof_ldc_entry *ldc_find(const struct ldc_dict *dict,
+						uint32_t address)
+{
+	uint32_t offset = address - dict->header.base_address;
+	uint32_t low = 0;
+	uint32_t high = dict->header.entry_count;
+	uint32_t mid;
+
+	while (low < high) {
+		mid = low + (high - low) / 2;
+		if (dict->entries[mid].address == offset)
+			return &dict->entries[mid];
+		if (dict->entries[mid].address < offset)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return NULL;
+}
+
 static int fetch_entry(const struct convert_config *config,
-	uint32_t base_address, uint32_t data_offset,
+	const struct ldc_dict *dict,
 	const struct log_entry_header *dma_log, uint64_t *last_timestamp)
 {
+	const struct snd_sof_ldc_entry *found;
 	struct ldc_entry entry;
-	uint32_t entry_offset;
-
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
 	int ret;
 
-	entry.file_name = NULL;
-	entry.text = NULL;
-	entry.params = NULL;
-
-	/* evaluate entry offset in input file */
-	entry_offset = dma_log->log_entry_address - base_address;
-
-	/* set file position to beginning of processed entry */
-	fseek(config->ldc_fd, entry_offset + data_offset, SEEK_SET);
-
-	/* fetching elf header params */
-	ret = fread(&entry.header, sizeof(entry.header), 1, config->ldc_fd);
-	if (!ret) {
-		ret = -ferror(config->ldc_fd);
-		goto out;
-	}
-	if (entry.header.file_name_len > TRACE_MAX_FILENAME_LEN) {
-		fprintf(stderr, "Error: Invalid filename length or ldc file does not match firmware\n");
-		ret = -EINVAL;
-		goto out;
-	}
-	entry.file_name = (char *)malloc(entry.header.file_name_len);
-
-	if (!entry.file_name) {
-		fprintf(stderr, "error: can't allocate %d byte for "
-			"entry.file_name\n", entry.header.file_name_len);
-		ret = -ENOMEM;
-		goto out;
-	}
-
-	ret = fread(entry.file_name, sizeof(char), entry.header.file_name_len,
-		config->ldc_fd);
-	if (ret != entry.header.file_name_len) {
-		ret = -ferror(config->ldc_fd);
-		goto out;
+	found = ldc_find(dict, dma_log->log_entry_address);
+	if (!found) {
+		fprintf(stderr, "Error: no log entry at 0x%x.\n",
+			dma_log->log_entry_address);
+		return -EINVAL;
 	}
 
-	/* fetching text */
-	if (entry.header.text_len > TRACE_MAX_TEXT_LEN) {
-		fprintf(stderr, "Error: Invalid text length. \n");
-		ret = -EINVAL;
-		goto out;
-	}
-	entry.text = (char *)malloc(entry.header.text_len);
-	if (entry.text == NULL) {
-		fprintf(stderr, "error: can't allocate %d byte for "
-			"entry.text\n", entry.header.text_len);
-		ret = -ENOMEM;
-		goto out;
-	}
-	ret = fread(entry.text, sizeof(char), entry.header.text_len, config->ldc_fd);
-	if (ret != entry.header.text_len) {
-		ret = -ferror(config->ldc_fd);
-		goto out;
-	}
+	entry.header.level = found->level;
+	entry.header.component_class = found->component_class;
+	entry.header.has_ids = found->has_ids;
+	entry.header.params_num = found->params_num;
+	entry.header.line_idx = found->line_idx;
+	entry.file_name = (char *)dict->strings + found->file_name;
+	entry.text = (char *)dict->strings + found->text;
+	entry.params = params;
 
 	/* fetching entry params from dma dump */
-	if (entry.header.params_num > TRACE_MAX_PARAMS_COUNT) {
-		fprintf(stderr, "Error: Invalid number of parameters. \n");
-		ret = -EINVAL;
-		goto out;
-	}
-	entry.params = (uint32_t *)malloc(sizeof(uint32_t) *
-		entry.header.params_num);
-	if (entry.params == NULL) {
-		fprintf(stderr, "error: can't allocate %d byte for "
-			"entry.params\n", (int)(sizeof(uint32_t) *
-			entry.header.params_num));
-		ret = -ENOMEM;
-		goto out;
-	}
-
 	if (config->serial_fd < 0) {
 		ret = fread(entry.params, sizeof(uint32_t),
 			    entry.header.params_num, config->in_fd);
-		if (ret != entry.header.params_num) {
-			ret = -ferror(config->in_fd);
-			goto out;
-		}
+		if (ret != entry.header.params_num)
+			return -ferror(config->in_fd);
 	} else {
 		size_t size = sizeof(uint32_t) * entry.header.params_num;
 		uint8_t *n;
@@ -272,10 +254,8 @@ static int fetch_entry(const struct convert_config *config,
 		for (n = (uint8_t *)entry.params; size;
 		     n += ret, size -= ret) {
 			ret = read(config->serial_fd, n, size);
-			if (ret < 0) {
-				ret = -errno;
-				goto out;
-			}
+			if (ret < 0)
+				return -errno;
 			if (ret != size)
 				fprintf(stderr,
 					"Partial read of %u bytes of %lu.\n",
@@ -288,21 +268,11 @@ static int fetch_entry(const struct convert_config *config,
 			   config->clock, config->use_colors, config->raw_output);
 	*last_timestamp = dma_log->timestamp;
 
-	/* set f_ldc file position to the beginning */
-	rewind(config->ldc_fd);
-
-	ret = 0;
-out:
-	/* free alocated memory */
-	free(entry.params);
-	free(entry.text);
-	free(entry.file_name);
-
-	return ret;
+	return 0;
 }
 
 static int serial_read(const struct convert_config *config,
-	struct snd_sof_logs_header *snd, uint64_t *last_timestamp)
+	const struct ldc_dict *dict, uint64_t *last_timestamp)
 {
 	struct log_entry_header dma_log;
 	size_t len;
@@ -322,8 +292,7 @@ static int serial_read(const struct convert_config *config,
 	}
 
 	/* Skip all trace_point() values, although this test isn't 100% reliable */
-	while ((dma_log.log_entry_address < snd->base_address) ||
-	       dma_log.log_entry_address > snd->base_address + snd->data_length) {
+	while (!ldc_in_section(dict, dma_log.log_entry_address)) {
 		/*
 		 * 8 characters and a '\n' come from the serial port, append a
 		 * '\0'
@@ -349,12 +318,11 @@ static int serial_read(const struct convert_config *config,
 	}
 
 	/* fetching entry from elf dump */
-	return fetch_entry(config, snd->base_address, snd->data_offset,
-			   &dma_log, last_timestamp);
+	return fetch_entry(config, dict, &dma_log, last_timestamp);
 }
 
 static int logger_read(const struct convert_config *config,
-	struct snd_sof_logs_header *snd)
+	const struct ldc_dict *dict)
 {
 	struct log_entry_header dma_log;
 	int ret = 0;
@@ -366,7 +334,7 @@ static int logger_read(const struct convert_config *config,
 	if (config->serial_fd >= 0)
 		/* Wait for CTRL-C */
 		for (;;) {
-			ret = serial_read(config, snd, &last_timestamp);
+			ret = serial_read(config, dict, &last_timestamp);
 			if (ret < 0)
 				return ret;
 		}
@@ -384,8 +352,7 @@ static int logger_read(const struct convert_config *config,
 		/* checking if received trace address is located in
 		 * entry section in elf file.
 		 */
-		if ((dma_log.log_entry_address < snd->base_address) ||
-			dma_log.log_entry_address > snd->base_address + snd->data_length) {
+		if (!ldc_in_section(dict, dma_log.log_entry_address)) {
 			/* in case the address is not correct input fd should be
 			 * move forward by one DWORD, not entire struct dma_log
 			 */
@@ -394,8 +361,7 @@ static int logger_read(const struct convert_config *config,
 		}
 
 		/* fetching entry from elf dump */
-		ret = fetch_entry(config, snd->base_address, snd->data_offset,
-				  &dma_log, &last_timestamp);
+		ret = fetch_entry(config, dict, &dma_log, &last_timestamp);
 		if (ret)
 			break;
 	}
@@ -403,21 +369,183 @@ static int logger_read(const struct convert_config *config,
 	return ret;
 }
 
-int convert(const struct convert_config *config) {
-	struct snd_sof_logs_header snd;
-	int count, ret = 0;
+/* log entry header as declared by _DECLARE_LOG_ENTRY in the firmware */
+#define LDC_FW_ENTRY_SIZE	sizeof(struct ldc_entry_header)
 
-	count = fread(&snd, sizeof(snd), 1, config->ldc_fd);
-	if (!count) {
-		fprintf(stderr, "Error while reading %s. \n", config->ldc_file);
-		return -ferror(config->ldc_fd);
+/* index a dictionary holding a raw copy of the log entries section */
+static int ldc_load_legacy(struct ldc_dict *dict, uint32_t file_size)
+{
+	struct snd_sof_logs_header *snd = (void *)dict->file;
+	const struct ldc_entry_header *fw;
+	struct snd_sof_ldc_entry *e;
+	const uint8_t *data;
+	uint32_t size;
+	uint32_t pos = 0;
+	uint32_t count = 0;
+
+	if (file_size < sizeof(*snd) || snd->data_offset > file_size ||
+	    file_size - snd->data_offset < snd->data_length) {
+		fprintf(stderr, "Error: Invalid ldc file size.\n");
+		return -EINVAL;
 	}
 
-	if (strncmp((char *) snd.sig, SND_SOF_LOGS_SIG, SND_SOF_LOGS_SIG_SIZE)) {
-		fprintf(stderr, "Error: Invalid ldc file signature. \n");
+	data = dict->file + snd->data_offset;
+	size = snd->data_length;
+
+	dict->index = calloc(size / LDC_FW_ENTRY_SIZE + 1, sizeof(*e));
+	if (!dict->index)
+		return -ENOMEM;
+
+	while (size - pos >= LDC_FW_ENTRY_SIZE) {
+		fw = (const void *)(data + pos);
+
+		/* skip alignment padding between object files */
+		if (!fw->level) {
+			pos += sizeof(uint32_t);
+			continue;
+		}
+
+		if (!fw->file_name_len || !fw->text_len ||
+		    fw->file_name_len > TRACE_MAX_FILENAME_LEN ||
+		    fw->text_len > TRACE_MAX_TEXT_LEN ||
+		    fw->params_num > TRACE_MAX_PARAMS_COUNT ||
+		    size - pos - LDC_FW_ENTRY_SIZE <
+		    fw->file_name_len + fw->text_len) {
+			fprintf(stderr, "Error: Invalid log entry at 0x%x.\n",
+				pos);
+			return -EINVAL;
+		}
+
+		e = &dict->index[count++];
+		e->address = pos;
+		e->file_name = pos + LDC_FW_ENTRY_SIZE;
+		e->text = e->file_name + fw->file_name_len;
+		e->component_class = fw->component_class;
+		e->line_idx = fw->line_idx;
+		e->level = fw->level;
+		e->has_ids = fw->has_ids;
+		e->params_num = fw->params_num;
+
+		/* strings are used in place, so they must be terminated */
+		if (data[e->file_name + fw->file_name_len - 1] ||
+		    data[e->text + fw->text_len - 1]) {
+			fprintf(stderr, "Error: Invalid log entry at 0x%x.\n",
+				pos);
+			return -EINVAL;
+		}
+
+		pos += (LDC_FW_ENTRY_SIZE + fw->file_name_len +
+			fw->text_len + 3) & ~3;
+	}
+
+	dict->header.base_address = snd->base_address;
+	dict->header.data_length = snd->data_length;
+	dict->header.entry_count = count;
+	dict->header.strings_size = size;
+	memcpy(&dict->header.version, &snd->version,
+	       sizeof(dict->header.version));
+	dict->entries = dict->index;
+	dict->strings = (const char *)data;
+
+	return 0;
+}
+
+/* check an indexed dictionary, entries are then used in place */
+static int ldc_load_indexed(struct ldc_dict *dict, uint32_t file_size)
+{
+	struct snd_sof_ldc_header *header = &dict->header;
+	const struct snd_sof_ldc_entry *e;
+	uint32_t i;
+
+	if (file_size < sizeof(*header)) {
+		fprintf(stderr, "Error: Invalid ldc file size.\n");
 		return -EINVAL;
 	}
 
+	memcpy(header, dict->file, sizeof(*header));
+
+	if (header->ldc_version != SND_SOF_LDC_VERSION ||
+	    header->header_size < sizeof(*header) ||
+	    header->entry_size != sizeof(*e)) {
+		fprintf(stderr, "Error: Unsupported ldc file version %u.\n",
+			header->ldc_version);
+		return -EINVAL;
+	}
+
+	if (header->entry_offset > file_size ||
+	    (file_size - header->entry_offset) / sizeof(*e) <
+	    header->entry_count ||
+	    header->strings_offset > file_size ||
+	    file_size - header->strings_offset < header->strings_size ||
+	    !header->strings_size) {
+		fprintf(stderr, "Error: Invalid ldc file size.\n");
+		return -EINVAL;
+	}
+
+	dict->entries = (const void *)(dict->file + header->entry_offset);
+	dict->strings = (const char *)dict->file + header->strings_offset;
+
+	/* the table ends with a NUL so every offset in it is a C string */
+	if (dict->strings[header->strings_size - 1]) {
+		fprintf(stderr, "Error: Invalid ldc string table.\n");
+		return -EINVAL;
+	}
+
+	for (i = 0; i < header->entry_count; i++) {
+		e = &dict->entries[i];
+		if (e->file_name >= header->strings_size ||
+		    e->text >= header->strings_size ||
+		    e->params_num > TRACE_MAX_PARAMS_COUNT ||
+		    (i && e->address <= dict->entries[i - 1].address)) {
+			fprintf(stderr, "Error: Invalid ldc entry %u.\n", i);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/* read the whole dictionary in one go and index it */
+static int ldc_load(const struct convert_config *config,
+		    struct ldc_dict *dict)
+{
+	long size;
+
+	fseek(config->ldc_fd, 0, SEEK_END);
+	size = ftell(config->ldc_fd);
+	rewind(config->ldc_fd);
+	if (size < SND_SOF_LOGS_SIG_SIZE) {
+		fprintf(stderr, "Error while reading %s.\n",
+			config->ldc_file);
+		return -EINVAL;
+	}
+
+	dict->file = malloc(size);
+	if (!dict->file)
+		return -ENOMEM;
+
+	if (fread(dict->file, 1, size, config->ldc_fd) != size) {
+		fprintf(stderr, "Error while reading %s.\n",
+			config->ldc_file);
+		return -ferror(config->ldc_fd);
+	}
+
+	if (!memcmp(dict->file, SND_SOF_LDC_SIG, SND_SOF_LOGS_SIG_SIZE))
+		return ldc_load_indexed(dict, size);
+
+	if (!memcmp(dict->file, SND_SOF_LOGS_SIG, SND_SOF_LOGS_SIG_SIZE))
+		return ldc_load_legacy(dict, size);
+
+	fprintf(stderr, "Error: Invalid ldc file signature.\n");
+	return -EINVAL;
+}
+
+static int convert_dict(const struct convert_config *config,
+			const struct ldc_dict *dict)
+{
+	const struct sof_ipc_fw_version *version = &dict->header.version;
+	int count, ret = 0;
+
 	/* fw verification */
 	if (config->version_fd) {
 		struct sof_ipc_fw_version ver;
@@ -429,7 +557,7 @@ int convert(const struct convert_config *config) {
 			return -ferror(config->version_fd);
 		}
 
-		ret = memcmp(&ver, &snd.version, sizeof(struct sof_ipc_fw_version));
+		ret = memcmp(&ver, version, sizeof(struct sof_ipc_fw_version));
 		if (ret) {
 			fprintf(stderr, "Error: fw version in %s file "
 				"does not coincide with fw version in "
@@ -455,7 +583,8 @@ int convert(const struct convert_config *config) {
 	}
 
 	/* default logger and ldc_file abi verification */
-	if SOF_ABI_VERSION_INCOMPATIBLE(SOF_ABI_VERSION, snd.version.abi_version) {
+	if (SOF_ABI_VERSION_INCOMPATIBLE(SOF_ABI_VERSION,
+					 version->abi_version)) {
 		fprintf(stderr, "Error: abi version in %s file "
 			"does not coincide with abi version used "
 			"by logger.\n", config->ldc_file);
@@ -464,10 +593,26 @@ int convert(const struct convert_config *config) {
 				SOF_ABI_VERSION_MINOR(SOF_ABI_VERSION),
 				SOF_ABI_VERSION_PATCH(SOF_ABI_VERSION));
 			fprintf(stderr, "ldc_file ABI Version is %d:%d:%d\n",
-				SOF_ABI_VERSION_MAJOR(snd.version.abi_version),
-				SOF_ABI_VERSION_MINOR(snd.version.abi_version),
-				SOF_ABI_VERSION_PATCH(snd.version.abi_version));
+				SOF_ABI_VERSION_MAJOR(version->abi_version),
+				SOF_ABI_VERSION_MINOR(version->abi_version),
+				SOF_ABI_VERSION_PATCH(version->abi_version));
 		return -EINVAL;
 	}
-	return logger_read(config, &snd);
+	return logger_read(config, dict);
+}
+
+int convert(const struct convert_config *config)
+{
+	struct ldc_dict dict;
+	int ret;
+
+	memset(&dict, 0, sizeof(dict));
+
+	ret = ldc_load(config, &dict);
+	if (!ret)
+		ret = convert_dict(config, &dict);
+
+	free(dict.index);
+	free(dict.file);
+	return ret;
 }
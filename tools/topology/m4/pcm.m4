@@ -6,8 +6,12 @@ dnl PCM name)
 define(`N_PCMP', `PCM'$1`P')
 define(`N_PCMC', `PCM'$1`C')
 
-dnl W_PCM_PLAYBACK(pcm, stream, periods_sink, periods_source)
-dnl  PCM platform configuration
+dnl PCM_DEEP_BUFFER(periods) deep buffer periods, defaults to 0 (disabled)
+define(`PCM_DEEP_BUFFER', `ifelse(`$1', `', `"0"', `"$1"')')
+
+dnl W_PCM_PLAYBACK(pcm, stream, periods_sink, periods_source[, deep_buffer])
+dnl  PCM platform configuration, deep_buffer is number of pipeline periods
+dnl  fetched and processed per copy, omitted or 0 disables deep buffer
 define(`W_PCM_PLAYBACK',
 `SectionVendorTuples."'N_PCMP($1)`_tuples_w_comp" {'
 `	tokens "sof_comp_tokens"'
@@ -19,6 +23,15 @@ define(`W_PCM_PLAYBACK',
 `SectionData."'N_PCMP($1)`_data_w_comp" {'
 `	tuples "'N_PCMP($1)`_tuples_w_comp"'
 `}'
+`SectionVendorTuples."'N_PCMP($1)`_tuples_w_pcm" {'
+`	tokens "sof_pcm_tokens"'
+`	tuples."word" {'
+`		SOF_TKN_PCM_DEEP_BUFFER		PCM_DEEP_BUFFER($5)'
+`	}'
+`}'
+`SectionData."'N_PCMP($1)`_data_w_pcm" {'
+`	tuples "'N_PCMP($1)`_tuples_w_pcm"'
+`}'
 `SectionWidget."'N_PCMP($1)`" {'
 `	index "'PIPELINE_ID`"'
 `	type "aif_in"'
@@ -26,11 +39,12 @@ define(`W_PCM_PLAYBACK',
 `	stream_name "'$2` '$1`"'
 `	data ['
 `		"'N_PCMP($1)`_data_w_comp"'
+`		"'N_PCMP($1)`_data_w_pcm"'
 `	]'
 `}')
 
 
-dnl W_PCM_CAPTURE(pcm, stream, periods_sink, periods_source)
+dnl W_PCM_CAPTURE(pcm, stream, periods_sink, periods_source[, deep_buffer])
 define(`W_PCM_CAPTURE',
 `SectionVendorTuples."'N_PCMC($1)`_tuples_w_comp" {'
 `	tokens "sof_comp_tokens"'
@@ -42,6 +56,15 @@ define(`W_PCM_CAPTURE',
 `SectionData."'N_PCMC($1)`_data_w_comp" {'
 `	tuples "'N_PCMC($1)`_tuples_w_comp"'
 `}'
+`SectionVendorTuples."'N_PCMC($1)`_tuples_w_pcm" {'
+`	tokens "sof_pcm_tokens"'
+`	tuples."word" {'
+`		SOF_TKN_PCM_DEEP_BUFFER		PCM_DEEP_BUFFER($5)'
+`	}'
+`}'
+`SectionData."'N_PCMC($1)`_data_w_pcm" {'
+`	tuples "'N_PCMC($1)`_tuples_w_pcm"'
+`}'
 `SectionWidget."'N_PCMC($1)`" {'
 `	index "'PIPELINE_ID`"'
 `	type "aif_out"'
@@ -49,6 +72,7 @@ define(`W_PCM_CAPTURE',
 `	stream_name "'$2` '$1`"'
 `	data ['
 `		"'N_PCMC($1)`_data_w_comp"'
+`		"'N_PCMC($1)`_data_w_pcm"'
 `	]'
 `}')
 
@@ -23,7 +23,7 @@ define(`N_STS', `Sound Trigger Capture '$1)
 
 # Host "Passthrough Capture" PCM
 # with 0 sink and 2 source periods
-W_PCM_CAPTURE(PCM_ID, Sound Trigger Capture, 0, 2, 2)
+W_PCM_CAPTURE(PCM_ID, Sound Trigger Capture, 0, 2)
 
 # "KPBM" has 2 source and 2 sink periods
 W_KPBM(0, PIPELINE_FORMAT, 2, 2, PIPELINE_ID)
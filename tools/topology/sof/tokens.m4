@@ -29,6 +29,7 @@ SectionVendorTokens."sof_sched_tokens" {
 	SOF_TKN_SCHED_CORE			"203"
 	SOF_TKN_SCHED_FRAMES			"204"
 	SOF_TKN_SCHED_TIME_DOMAIN		"205"
+	SOF_TKN_SCHED_XRUN_LIMIT		"206"
 }
 
 SectionVendorTokens."sof_volume_tokens" {
@@ -43,6 +44,7 @@ SectionVendorTokens."sof_src_tokens" {
 
 SectionVendorTokens."sof_pcm_tokens" {
 	SOF_TKN_PCM_DMAC_CONFIG			"353"
+	SOF_TKN_PCM_DEEP_BUFFER			"354"
 }
 
 SectionVendorTokens."sof_comp_tokens" {